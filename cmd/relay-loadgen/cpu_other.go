@@ -0,0 +1,10 @@
+//go:build !unix
+
+package main
+
+import "time"
+
+// processCPUTime 当前平台不支持，CPU 占用报告为 -1
+func processCPUTime() time.Duration {
+	return -1
+}
@@ -0,0 +1,60 @@
+package main
+
+import (
+	"bufio"
+	"encoding/json"
+	"io"
+	"sync"
+
+	"github.com/pion/webrtc/v4"
+)
+
+// 压测进程间的控制消息类型
+const (
+	msgOffer     = "offer"     // peers -> relay：订阅者 Offer（候选已收集完整）
+	msgAnswer    = "answer"    // relay -> peers：Relay Answer
+	msgCandidate = "candidate" // relay -> peers：Relay ICE 候选（trickle）
+	msgConnected = "connected" // peers -> relay：预热结束时已连通的订阅者数
+	msgStart     = "start"     // relay -> peers：开始推流和测量
+	msgStop      = "stop"      // relay -> peers：停止推流，回报结果
+	msgReport    = "report"    // peers -> relay：订阅者和源的测量结果
+	msgError     = "error"     // 任意方向：致命错误
+)
+
+// message 控制消息（JSON 行，经子进程的 stdin/stdout 传递）
+type message struct {
+	Type      string                   `json:"type"`
+	PeerID    string                   `json:"peer_id,omitempty"`
+	SDP       string                   `json:"sdp,omitempty"`
+	Candidate *webrtc.ICECandidateInit `json:"candidate,omitempty"`
+	Connected int                      `json:"connected,omitempty"`
+	Report    *peersReport             `json:"report,omitempty"`
+	Error     string                   `json:"error,omitempty"`
+}
+
+// link 一条双向消息通道，send 可并发调用
+type link struct {
+	mu  sync.Mutex
+	enc *json.Encoder
+	dec *json.Decoder
+}
+
+func newLink(r io.Reader, w io.Writer) *link {
+	return &link{
+		enc: json.NewEncoder(w),
+		dec: json.NewDecoder(bufio.NewReader(r)),
+	}
+}
+
+func (l *link) send(msg message) error {
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	return l.enc.Encode(msg)
+}
+
+// recv 只由一个协程调用
+func (l *link) recv() (message, error) {
+	var msg message
+	err := l.dec.Decode(&msg)
+	return msg, err
+}
@@ -0,0 +1,249 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Relay Load Generator - Relay 容量压测工具
+ *
+ * 完全在本机运行，分为两个进程，Relay 进程的 CPU/内存只包含 Relay 自身：
+ * - Relay 进程：ProxyModeCoordinator + RelayRoom（本机作为 Relay），从回环 UDP 接收源 RTP 并注入
+ * - Peers 子进程：合成音视频源（可配置码率、GOP、包大小分布、源端丢包）+ N 个无头 pion 订阅者
+ *   （在接收侧模拟丢包/延迟/抖动）
+ * - 两个进程通过子进程的 stdin/stdout 交换 SDP、ICE 候选和测量结果，媒体走 127.0.0.1
+ * - 输出每个订阅者的有效吞吐、端到端延迟、卡顿次数，以及 Relay 的 CPU/内存
+ *
+ * 构建命令: go build -o relay_loadgen ./cmd/relay-loadgen
+ * 示例:     ./relay_loadgen -subscribers 20 -video-bitrate 3000000 -loss 0.02 -delay 5ms -duration 60s
+ */
+package main
+
+import (
+	"encoding/json"
+	"flag"
+	"fmt"
+	"net"
+	"os"
+	"time"
+
+	"github.com/maiguangyang/relay_core/pkg/utils"
+	"github.com/pion/webrtc/v4"
+)
+
+const (
+	roomID      = "loadgen-room"
+	relayPeerID = "loadgen-relay"
+
+	videoPayloadType = 96
+	audioPayloadType = 111
+	videoClockRate   = 90000
+	audioClockRate   = 48000
+	audioFrameTime   = 20 * time.Millisecond
+
+	// 负载前 12 字节：发送时间 (UnixNano) + 帧序号，用于测量端到端延迟
+	probeHeaderLen = 12
+
+	// 子进程角色（内部使用）
+	rolePeers = "peers"
+)
+
+// config 命令行配置
+type config struct {
+	subscribers int
+	duration    time.Duration
+	warmup      time.Duration
+
+	videoBitrate  int
+	fps           int
+	gop           int
+	keyframeRatio float64
+	sizeJitter    float64
+	mtu           int
+	audioBitrate  int
+	sourceLoss    float64
+
+	loss   float64
+	delay  time.Duration
+	jitter time.Duration
+
+	freezeThreshold time.Duration
+	seed            int64
+	jsonOutput      bool
+
+	role   string
+	ingest string
+}
+
+func parseFlags() config {
+	var c config
+	flag.IntVar(&c.subscribers, "subscribers", 10, "number of headless subscribers")
+	flag.DurationVar(&c.duration, "duration", 30*time.Second, "measurement duration")
+	flag.DurationVar(&c.warmup, "warmup", 3*time.Second, "time allowed for subscribers to connect")
+
+	flag.IntVar(&c.videoBitrate, "video-bitrate", 2_000_000, "synthetic video bitrate (bps)")
+	flag.IntVar(&c.fps, "fps", 30, "video frame rate")
+	flag.IntVar(&c.gop, "gop", 60, "keyframe interval in frames")
+	flag.Float64Var(&c.keyframeRatio, "keyframe-ratio", 8, "keyframe size relative to an average delta frame")
+	flag.Float64Var(&c.sizeJitter, "size-jitter", 0.3, "relative std-dev of delta frame size")
+	flag.IntVar(&c.mtu, "mtu", 1200, "max RTP payload size")
+	flag.IntVar(&c.audioBitrate, "audio-bitrate", 32_000, "synthetic Opus bitrate (bps), 0 disables audio")
+	flag.Float64Var(&c.sourceLoss, "source-loss", 0, "packet loss before injection (0-1)")
+
+	flag.Float64Var(&c.loss, "loss", 0, "relay->subscriber media packet loss (0-1)")
+	flag.DurationVar(&c.delay, "delay", 0, "relay->subscriber one-way delay")
+	flag.DurationVar(&c.jitter, "jitter", 0, "relay->subscriber max jitter")
+
+	flag.DurationVar(&c.freezeThreshold, "freeze", 200*time.Millisecond, "frame gap counted as a freeze")
+	flag.Int64Var(&c.seed, "seed", 1, "random seed")
+	flag.BoolVar(&c.jsonOutput, "json", false, "print the report as JSON")
+
+	flag.StringVar(&c.role, "role", "", "internal: process role")
+	flag.StringVar(&c.ingest, "ingest", "", "internal: relay RTP ingest address")
+	flag.Parse()
+
+	if c.subscribers < 1 || c.subscribers > 250 {
+		fmt.Fprintln(os.Stderr, "subscribers must be between 1 and 250")
+		os.Exit(2)
+	}
+	if c.fps < 1 || c.gop < 1 || c.mtu < probeHeaderLen+1 {
+		fmt.Fprintln(os.Stderr, "invalid fps/gop/mtu")
+		os.Exit(2)
+	}
+	return c
+}
+
+func main() {
+	cfg := parseFlags()
+	utils.GetLogger().SetLevel(utils.LogLevelWarn)
+
+	if cfg.role == rolePeers {
+		if err := runPeers(cfg); err != nil {
+			fmt.Fprintf(os.Stderr, "peers: %v\n", err)
+			os.Exit(1)
+		}
+		return
+	}
+
+	lg, err := newLoadGen(cfg)
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "setup failed: %v\n", err)
+		os.Exit(1)
+	}
+	defer lg.close()
+
+	report, err := lg.run()
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "run failed: %v\n", err)
+		os.Exit(1)
+	}
+
+	if cfg.jsonOutput {
+		data, _ := json.MarshalIndent(report, "", "  ")
+		fmt.Println(string(data))
+	} else {
+		report.print()
+	}
+}
+
+// newLoopbackAPI 两个进程都只使用回环地址上的 UDP host 候选
+func newLoopbackAPI() (*webrtc.API, error) {
+	se := webrtc.SettingEngine{}
+	se.SetNetworkTypes([]webrtc.NetworkType{webrtc.NetworkTypeUDP4})
+	se.SetIncludeLoopbackCandidate(true)
+	se.SetIPFilter(func(ip net.IP) bool { return ip.IsLoopback() })
+
+	m := &webrtc.MediaEngine{}
+	if err := m.RegisterDefaultCodecs(); err != nil {
+		return nil, err
+	}
+	return webrtc.NewAPI(webrtc.WithMediaEngine(m), webrtc.WithSettingEngine(se)), nil
+}
+
+// ==========================================
+// 报告
+// ==========================================
+
+type subscriberReport struct {
+	PeerID       string  `json:"peer_id"`
+	Connected    bool    `json:"connected"`
+	GoodputKbps  float64 `json:"goodput_kbps"`
+	Packets      uint64  `json:"packets"`
+	LossPercent  float64 `json:"loss_percent"`
+	Frames       uint64  `json:"frames"`
+	Freezes      int     `json:"freezes"`
+	LatencyAvgMs float64 `json:"latency_avg_ms"`
+	LatencyP50Ms float64 `json:"latency_p50_ms"`
+	LatencyP95Ms float64 `json:"latency_p95_ms"`
+	LatencyMaxMs float64 `json:"latency_max_ms"`
+}
+
+// peersReport Peers 子进程回报的测量结果
+type peersReport struct {
+	Subscribers   []subscriberReport `json:"subscribers"`
+	SourcePackets uint64             `json:"source_packets"`
+	SourceBytes   uint64             `json:"source_bytes"`
+	SourceLost    uint64             `json:"source_lost"`
+	CPUPercent    float64            `json:"cpu_percent"`
+}
+
+type relayReport struct {
+	CPUPercent     float64 `json:"cpu_percent"`
+	HeapAllocMB    float64 `json:"heap_alloc_mb"`
+	SysMB          float64 `json:"sys_mb"`
+	NumGC          uint32  `json:"num_gc"`
+	Goroutines     int     `json:"goroutines"`
+	SourcePackets  uint64  `json:"source_packets"`
+	SourceKbps     float64 `json:"source_kbps"`
+	SourceLost     uint64  `json:"source_lost"`
+	IngestedPkts   uint64  `json:"ingested_packets"`
+	DeliveredPkts  uint64  `json:"delivered_packets"`
+	SubscriberKbps float64 `json:"aggregate_egress_kbps"`
+	PeersCPU       float64 `json:"peers_cpu_percent"`
+}
+
+type report struct {
+	DurationSec float64            `json:"duration_sec"`
+	Subscribers []subscriberReport `json:"subscribers"`
+	Relay       relayReport        `json:"relay"`
+}
+
+func (r *report) print() {
+	fmt.Printf("=== Relay Load Report (%.1fs) ===\n\n", r.DurationSec)
+	fmt.Printf("%-10s %5s %12s %9s %7s %7s %8s %8s %8s %8s\n",
+		"PEER", "CONN", "GOODPUT", "PACKETS", "LOSS%", "FREEZE", "AVG(ms)", "P50(ms)", "P95(ms)", "MAX(ms)")
+	for _, s := range r.Subscribers {
+		fmt.Printf("%-10s %5v %8.0fkbps %9d %7.2f %7d %8.1f %8.1f %8.1f %8.1f\n",
+			s.PeerID, s.Connected, s.GoodputKbps, s.Packets, s.LossPercent, s.Freezes,
+			s.LatencyAvgMs, s.LatencyP50Ms, s.LatencyP95Ms, s.LatencyMaxMs)
+	}
+
+	rr := r.Relay
+	fmt.Printf("\nRelay:\n")
+	fmt.Printf("  source:     %d packets, %.0f kbps (%d dropped before sending)\n", rr.SourcePackets, rr.SourceKbps, rr.SourceLost)
+	fmt.Printf("  ingested:   %d packets\n", rr.IngestedPkts)
+	fmt.Printf("  delivered:  %d packets received by subscribers, aggregate %.0f kbps\n", rr.DeliveredPkts, rr.SubscriberKbps)
+	fmt.Printf("  cpu:        %.1f%% of one core (relay process only; peers process %.1f%%)\n", rr.CPUPercent, rr.PeersCPU)
+	fmt.Printf("  memory:     heap %.1f MB, sys %.1f MB, %d GCs, %d goroutines\n", rr.HeapAllocMB, rr.SysMB, rr.NumGC, rr.Goroutines)
+}
+
+func ms(d time.Duration) float64 {
+	return float64(d) / float64(time.Millisecond)
+}
+
+// cpuSampler 统计测量窗口内的本进程 CPU 占用
+type cpuSampler struct {
+	wall time.Time
+	cpu  time.Duration
+}
+
+func newCPUSampler() *cpuSampler {
+	return &cpuSampler{wall: time.Now(), cpu: processCPUTime()}
+}
+
+// percent 返回占单核的百分比（不支持的平台返回 -1）
+func (c *cpuSampler) percent() float64 {
+	now := processCPUTime()
+	if now < 0 || c.cpu < 0 {
+		return -1
+	}
+	return float64(now-c.cpu) * 100 / float64(time.Since(c.wall))
+}
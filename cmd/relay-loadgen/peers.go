@@ -0,0 +1,493 @@
+package main
+
+import (
+	"encoding/binary"
+	"fmt"
+	"math"
+	"math/rand"
+	"net"
+	"os"
+	"os/signal"
+	"sort"
+	"sync"
+	"time"
+
+	"github.com/pion/rtp"
+	"github.com/pion/webrtc/v4"
+)
+
+// runPeers Peers 子进程：合成源 + 无头订阅者，经 stdin/stdout 与 Relay 进程交换信令
+func runPeers(cfg config) error {
+	// Ctrl+C 由 Relay 进程处理，再通过 stop 消息结束本进程
+	signal.Ignore(os.Interrupt)
+
+	l := newLink(os.Stdin, os.Stdout)
+	fail := func(err error) error {
+		l.send(message{Type: msgError, Error: err.Error()})
+		return err
+	}
+
+	ingest, err := net.ResolveUDPAddr("udp4", cfg.ingest)
+	if err != nil {
+		return fail(err)
+	}
+	api, err := newLoopbackAPI()
+	if err != nil {
+		return fail(err)
+	}
+
+	subs := make(map[string]*subscriber, cfg.subscribers)
+	ordered := make([]*subscriber, 0, cfg.subscribers)
+	for i := 0; i < cfg.subscribers; i++ {
+		sub, err := newSubscriber(api, subscriberID(i), cfg, cfg.seed+int64(i)+2)
+		if err != nil {
+			return fail(err)
+		}
+		defer sub.close()
+		subs[sub.id] = sub
+		ordered = append(ordered, sub)
+	}
+
+	// 读取 Relay 进程的消息：answer / candidate 直接交给订阅者，start / stop 交给主流程
+	control := make(chan message, 2)
+	go func() {
+		for {
+			msg, err := l.recv()
+			if err != nil {
+				close(control)
+				return
+			}
+			switch msg.Type {
+			case msgAnswer:
+				if sub := subs[msg.PeerID]; sub != nil {
+					if err := sub.setAnswer(msg.SDP); err != nil {
+						l.send(message{Type: msgError, Error: fmt.Sprintf("%s: %v", msg.PeerID, err)})
+					}
+				}
+			case msgCandidate:
+				if sub := subs[msg.PeerID]; sub != nil && msg.Candidate != nil {
+					sub.addRemoteCandidate(*msg.Candidate)
+				}
+			case msgStart, msgStop:
+				control <- msg
+			}
+		}
+	}()
+
+	for _, sub := range ordered {
+		offer, err := sub.createOffer()
+		if err != nil {
+			return fail(fmt.Errorf("%s: %w", sub.id, err))
+		}
+		if err := l.send(message{Type: msgOffer, PeerID: sub.id, SDP: offer}); err != nil {
+			return err
+		}
+	}
+
+	deadline := time.Now().Add(cfg.warmup)
+	for time.Now().Before(deadline) && connectedCount(ordered) < len(ordered) {
+		time.Sleep(50 * time.Millisecond)
+	}
+	if err := l.send(message{Type: msgConnected, Connected: connectedCount(ordered)}); err != nil {
+		return err
+	}
+
+	if msg, ok := <-control; !ok || msg.Type != msgStart {
+		return nil
+	}
+
+	conn, err := net.DialUDP("udp4", nil, ingest)
+	if err != nil {
+		return fail(err)
+	}
+	defer conn.Close()
+	conn.SetWriteBuffer(4 << 20)
+
+	for _, sub := range ordered {
+		sub.resetWindow()
+	}
+	src := newSyntheticSource(cfg, conn)
+	cpu := newCPUSampler()
+	stop := make(chan struct{})
+	done := make(chan struct{})
+	start := time.Now()
+	go func() {
+		defer close(done)
+		src.run(stop)
+	}()
+
+	<-control
+	close(stop)
+	<-done
+	elapsed := time.Since(start)
+
+	// 给在途包留一点时间
+	time.Sleep(100 * time.Millisecond)
+
+	report := &peersReport{
+		SourcePackets: src.packets,
+		SourceBytes:   src.bytes,
+		SourceLost:    src.sourceLost,
+		CPUPercent:    cpu.percent(),
+	}
+	for _, sub := range ordered {
+		report.Subscribers = append(report.Subscribers, sub.report(elapsed))
+	}
+	return l.send(message{Type: msgReport, Report: report})
+}
+
+func connectedCount(subs []*subscriber) int {
+	n := 0
+	for _, s := range subs {
+		if s.isConnected() {
+			n++
+		}
+	}
+	return n
+}
+
+// ==========================================
+// 合成音视频源
+// ==========================================
+
+// syntheticSource 按配置生成 VP8/Opus 形态的 RTP 包，经回环 UDP 发给 Relay 进程
+type syntheticSource struct {
+	cfg    config
+	target *net.UDPConn
+	rng    *rand.Rand
+
+	videoSeq   uint16
+	audioSeq   uint16
+	frames     uint64
+	packets    uint64
+	bytes      uint64
+	sourceLost uint64
+}
+
+func newSyntheticSource(cfg config, target *net.UDPConn) *syntheticSource {
+	return &syntheticSource{
+		cfg:    cfg,
+		target: target,
+		rng:    rand.New(rand.NewSource(cfg.seed + 1)),
+	}
+}
+
+// deltaFrameSize 平均 P 帧大小：使一个 GOP 的总字节数符合目标码率
+func (s *syntheticSource) deltaFrameSize() float64 {
+	gopBytes := float64(s.cfg.videoBitrate) / 8 * float64(s.cfg.gop) / float64(s.cfg.fps)
+	return gopBytes / (s.cfg.keyframeRatio + float64(s.cfg.gop-1))
+}
+
+func (s *syntheticSource) run(stop <-chan struct{}) {
+	frameInterval := time.Second / time.Duration(s.cfg.fps)
+	videoTicker := time.NewTicker(frameInterval)
+	defer videoTicker.Stop()
+
+	var audioC <-chan time.Time
+	if s.cfg.audioBitrate > 0 {
+		audioTicker := time.NewTicker(audioFrameTime)
+		defer audioTicker.Stop()
+		audioC = audioTicker.C
+	}
+
+	buf := make([]byte, s.cfg.mtu+12)
+	avg := s.deltaFrameSize()
+
+	for {
+		select {
+		case <-stop:
+			return
+		case <-videoTicker.C:
+			size := avg
+			if s.frames%uint64(s.cfg.gop) == 0 {
+				size *= s.cfg.keyframeRatio
+			} else {
+				size *= math.Max(0.1, 1+s.cfg.sizeJitter*s.rng.NormFloat64())
+			}
+			s.sendVideoFrame(buf, int(size))
+			s.frames++
+		case <-audioC:
+			s.sendAudioFrame(buf)
+		}
+	}
+}
+
+func (s *syntheticSource) sendVideoFrame(buf []byte, frameSize int) {
+	ts := uint32(s.frames * videoClockRate / uint64(s.cfg.fps))
+	for remaining := frameSize; remaining > 0; {
+		payload := s.cfg.mtu
+		if remaining <= payload {
+			payload = remaining
+		}
+		if payload < probeHeaderLen {
+			payload = probeHeaderLen
+		}
+		remaining -= payload
+		s.videoSeq++
+		s.send(buf, rtp.Header{
+			Version:        2,
+			Marker:         remaining <= 0,
+			PayloadType:    videoPayloadType,
+			SequenceNumber: s.videoSeq,
+			Timestamp:      ts,
+			SSRC:           0x11111111,
+		}, payload, uint32(s.frames))
+	}
+}
+
+func (s *syntheticSource) sendAudioFrame(buf []byte) {
+	s.audioSeq++
+	payload := s.cfg.audioBitrate / 8 / int(time.Second/audioFrameTime)
+	if payload < probeHeaderLen {
+		payload = probeHeaderLen
+	}
+	s.send(buf, rtp.Header{
+		Version:        2,
+		PayloadType:    audioPayloadType,
+		SequenceNumber: s.audioSeq,
+		Timestamp:      uint32(s.audioSeq) * uint32(audioClockRate*audioFrameTime/time.Second),
+		SSRC:           0x22222222,
+	}, payload, 0)
+}
+
+func (s *syntheticSource) send(buf []byte, hdr rtp.Header, payloadLen int, frame uint32) {
+	if s.cfg.sourceLoss > 0 && s.rng.Float64() < s.cfg.sourceLoss {
+		s.sourceLost++
+		return
+	}
+
+	n, err := hdr.MarshalTo(buf)
+	if err != nil || n+payloadLen > len(buf) {
+		return
+	}
+	payload := buf[n : n+payloadLen]
+	binary.BigEndian.PutUint64(payload[0:8], uint64(time.Now().UnixNano()))
+	binary.BigEndian.PutUint32(payload[8:12], frame)
+
+	if _, err := s.target.Write(buf[:n+payloadLen]); err == nil {
+		s.packets++
+		s.bytes += uint64(n + payloadLen)
+	}
+}
+
+// ==========================================
+// 无头订阅者
+// ==========================================
+
+// subscriber 经回环地址连接 Relay 的 pion 订阅者
+// 丢包/延迟/抖动在接收侧模拟：丢弃的包不计入统计，延迟计入到达时间
+type subscriber struct {
+	mu sync.Mutex
+
+	id              string
+	pc              *webrtc.PeerConnection
+	freezeThreshold time.Duration
+
+	loss   float64
+	delay  time.Duration
+	jitter time.Duration
+	rng    *rand.Rand
+
+	remoteSet bool
+	pending   []webrtc.ICECandidateInit
+	connected bool
+
+	// 测量窗口内的统计
+	bytes         uint64
+	packets       uint64
+	lost          uint64
+	freezes       int
+	latencies     []time.Duration
+	lastFrameAt   time.Time
+	lastVideoSeq  uint16
+	haveVideoSeq  bool
+	lastAudioSeq  uint16
+	haveAudioSeq  bool
+	measuring     bool
+	framesDecoded uint64
+}
+
+func newSubscriber(api *webrtc.API, id string, cfg config, seed int64) (*subscriber, error) {
+	pc, err := api.NewPeerConnection(webrtc.Configuration{})
+	if err != nil {
+		return nil, err
+	}
+
+	s := &subscriber{
+		id:              id,
+		pc:              pc,
+		freezeThreshold: cfg.freezeThreshold,
+		loss:            cfg.loss,
+		delay:           cfg.delay,
+		jitter:          cfg.jitter,
+		rng:             rand.New(rand.NewSource(seed)),
+	}
+	pc.OnICEConnectionStateChange(func(state webrtc.ICEConnectionState) {
+		s.mu.Lock()
+		s.connected = state == webrtc.ICEConnectionStateConnected || state == webrtc.ICEConnectionStateCompleted
+		s.mu.Unlock()
+	})
+	pc.OnTrack(func(track *webrtc.TrackRemote, _ *webrtc.RTPReceiver) {
+		go s.readLoop(track)
+	})
+	return s, nil
+}
+
+// createOffer 生成 Offer（订阅者候选随 Offer 一次性发送，Relay 候选走 trickle）
+func (s *subscriber) createOffer() (string, error) {
+	for _, kind := range []webrtc.RTPCodecType{webrtc.RTPCodecTypeVideo, webrtc.RTPCodecTypeAudio} {
+		if _, err := s.pc.AddTransceiverFromKind(kind, webrtc.RTPTransceiverInit{
+			Direction: webrtc.RTPTransceiverDirectionRecvonly,
+		}); err != nil {
+			return "", err
+		}
+	}
+
+	offer, err := s.pc.CreateOffer(nil)
+	if err != nil {
+		return "", err
+	}
+	gathered := webrtc.GatheringCompletePromise(s.pc)
+	if err := s.pc.SetLocalDescription(offer); err != nil {
+		return "", err
+	}
+	<-gathered
+	return s.pc.LocalDescription().SDP, nil
+}
+
+func (s *subscriber) setAnswer(answer string) error {
+	if err := s.pc.SetRemoteDescription(webrtc.SessionDescription{Type: webrtc.SDPTypeAnswer, SDP: answer}); err != nil {
+		return err
+	}
+
+	s.mu.Lock()
+	s.remoteSet = true
+	pending := s.pending
+	s.pending = nil
+	s.mu.Unlock()
+	for _, c := range pending {
+		s.pc.AddICECandidate(c)
+	}
+	return nil
+}
+
+func (s *subscriber) addRemoteCandidate(c webrtc.ICECandidateInit) {
+	s.mu.Lock()
+	if !s.remoteSet {
+		s.pending = append(s.pending, c)
+		s.mu.Unlock()
+		return
+	}
+	s.mu.Unlock()
+	s.pc.AddICECandidate(c)
+}
+
+func (s *subscriber) isConnected() bool {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	return s.connected
+}
+
+func (s *subscriber) resetWindow() {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	s.bytes, s.packets, s.lost, s.freezes, s.framesDecoded = 0, 0, 0, 0, 0
+	s.latencies = s.latencies[:0]
+	s.lastFrameAt = time.Time{}
+	s.measuring = true
+}
+
+func (s *subscriber) readLoop(track *webrtc.TrackRemote) {
+	isVideo := track.Kind() == webrtc.RTPCodecTypeVideo
+	for {
+		pkt, _, err := track.ReadRTP()
+		if err != nil {
+			return
+		}
+
+		s.mu.Lock()
+		if !s.measuring || (s.loss > 0 && s.rng.Float64() < s.loss) {
+			s.mu.Unlock()
+			continue
+		}
+		// 模拟单向延迟 + 抖动后的到达时间
+		arrival := time.Now().Add(s.delay)
+		if s.jitter > 0 {
+			arrival = arrival.Add(time.Duration(s.rng.Int63n(int64(s.jitter))))
+		}
+
+		s.bytes += uint64(pkt.MarshalSize())
+		s.packets++
+
+		if isVideo {
+			s.lost += seqGap(&s.lastVideoSeq, &s.haveVideoSeq, pkt.SequenceNumber)
+		} else {
+			s.lost += seqGap(&s.lastAudioSeq, &s.haveAudioSeq, pkt.SequenceNumber)
+		}
+
+		if len(pkt.Payload) >= probeHeaderLen {
+			sent := int64(binary.BigEndian.Uint64(pkt.Payload[0:8]))
+			s.latencies = append(s.latencies, arrival.Sub(time.Unix(0, sent)))
+		}
+
+		if isVideo && pkt.Marker {
+			if !s.lastFrameAt.IsZero() && arrival.Sub(s.lastFrameAt) > s.freezeThreshold {
+				s.freezes++
+			}
+			s.lastFrameAt = arrival
+			s.framesDecoded++
+		}
+		s.mu.Unlock()
+	}
+}
+
+// seqGap 返回序号跳变中丢失的包数（忽略乱序/回绕后的旧包）
+func seqGap(last *uint16, have *bool, seq uint16) uint64 {
+	if !*have {
+		*last, *have = seq, true
+		return 0
+	}
+	diff := seq - *last
+	if diff == 0 || diff > 0x8000 {
+		return 0
+	}
+	*last = seq
+	return uint64(diff - 1)
+}
+
+// report 结束测量并汇总本订阅者的结果
+func (s *subscriber) report(elapsed time.Duration) subscriberReport {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	s.measuring = false
+
+	secs := elapsed.Seconds()
+	sr := subscriberReport{
+		PeerID:      s.id,
+		Connected:   s.connected,
+		GoodputKbps: float64(s.bytes) * 8 / secs / 1000,
+		Packets:     s.packets,
+		Frames:      s.framesDecoded,
+		Freezes:     s.freezes,
+	}
+	if total := s.packets + s.lost; total > 0 {
+		sr.LossPercent = float64(s.lost) * 100 / float64(total)
+	}
+	if n := len(s.latencies); n > 0 {
+		lat := append([]time.Duration(nil), s.latencies...)
+		sort.Slice(lat, func(i, j int) bool { return lat[i] < lat[j] })
+		var sum time.Duration
+		for _, l := range lat {
+			sum += l
+		}
+		sr.LatencyAvgMs = ms(sum / time.Duration(n))
+		sr.LatencyP50Ms = ms(lat[n/2])
+		sr.LatencyP95Ms = ms(lat[n*95/100])
+		sr.LatencyMaxMs = ms(lat[n-1])
+	}
+	return sr
+}
+
+func (s *subscriber) close() {
+	s.pc.Close()
+}
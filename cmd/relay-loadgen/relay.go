@@ -0,0 +1,240 @@
+package main
+
+import (
+	"fmt"
+	"net"
+	"os"
+	"os/exec"
+	"os/signal"
+	"runtime"
+	"sync/atomic"
+	"time"
+
+	"github.com/maiguangyang/relay_core/pkg/sfu"
+	"github.com/pion/webrtc/v4"
+)
+
+// loadGen Relay 进程：只运行 Relay 本身，源和订阅者在 Peers 子进程中
+type loadGen struct {
+	cfg config
+
+	coordinator *sfu.ProxyModeCoordinator
+	room        *sfu.RelayRoom
+
+	// 源 RTP 接收（回环 UDP），与 LiveKitBridge 的读取循环等价
+	ingestConn *net.UDPConn
+	ingested   atomic.Uint64
+
+	peers *exec.Cmd
+	link  *link
+}
+
+func newLoadGen(cfg config) (*loadGen, error) {
+	lg := &loadGen{cfg: cfg}
+
+	// Coordinator：本机作为 Relay，心跳由本工具即时应答
+	coordinator, err := sfu.NewProxyModeCoordinator(roomID, relayPeerID, sfu.DefaultCoordinatorConfig())
+	if err != nil {
+		return nil, err
+	}
+	lg.coordinator = coordinator
+	coordinator.SetOnEvent(func(event sfu.CoordinatorEvent) {
+		if event.Type == sfu.CoordinatorEventPingRound {
+			peers, _ := event.Data["peers"].([]string)
+			seq, _ := event.Data["seq"].(uint64)
+			coordinator.HandlePongBatch(seq, peers)
+		}
+	})
+	coordinator.Start()
+	coordinator.SetCurrentRelay(relayPeerID, 1)
+
+	// RelayRoom：与 Coordinator 共享 SourceSwitcher（与 RelayRoomCreate FFI 相同）
+	api, err := newLoopbackAPI()
+	if err != nil {
+		return nil, err
+	}
+	room, err := sfu.NewRelayRoom(roomID, nil,
+		sfu.WithWebRTCAPI(api),
+		sfu.WithSourceSwitcher(coordinator.GetSourceSwitcher()),
+	)
+	if err != nil {
+		return nil, err
+	}
+	lg.room = room
+	room.BecomeRelay(relayPeerID)
+	room.SetCallbacks(nil, nil,
+		func(_, peerID string, c *webrtc.ICECandidate) {
+			if c == nil || lg.link == nil {
+				return
+			}
+			init := c.ToJSON()
+			lg.link.send(message{Type: msgCandidate, PeerID: peerID, Candidate: &init})
+		},
+		nil, nil,
+	)
+
+	conn, err := net.ListenUDP("udp4", &net.UDPAddr{IP: net.IPv4(127, 0, 0, 1)})
+	if err != nil {
+		return nil, err
+	}
+	conn.SetReadBuffer(4 << 20)
+	lg.ingestConn = conn
+
+	for i := 0; i < cfg.subscribers; i++ {
+		coordinator.AddPeer(subscriberID(i), 0, 2, 0)
+	}
+
+	// Peers 子进程：同一个可执行文件，沿用全部命令行参数
+	exe, err := os.Executable()
+	if err != nil {
+		return nil, err
+	}
+	args := append(append([]string{}, os.Args[1:]...), "-role="+rolePeers, "-ingest="+conn.LocalAddr().String())
+	lg.peers = exec.Command(exe, args...)
+	lg.peers.Stderr = os.Stderr
+	stdin, err := lg.peers.StdinPipe()
+	if err != nil {
+		return nil, err
+	}
+	stdout, err := lg.peers.StdoutPipe()
+	if err != nil {
+		return nil, err
+	}
+	lg.link = newLink(stdout, stdin)
+	if err := lg.peers.Start(); err != nil {
+		return nil, err
+	}
+
+	go lg.ingest()
+	return lg, nil
+}
+
+func subscriberID(i int) string {
+	return fmt.Sprintf("sub-%03d", i+1)
+}
+
+// ingest 接收源 RTP 并注入 Coordinator
+func (lg *loadGen) ingest() {
+	buf := make([]byte, 1500)
+	for {
+		n, _, err := lg.ingestConn.ReadFromUDP(buf)
+		if err != nil {
+			return
+		}
+		if n < 12 {
+			continue
+		}
+		isVideo := buf[1]&0x7f == videoPayloadType
+		if lg.coordinator.InjectSFUPacket(isVideo, buf[:n]) == nil {
+			lg.ingested.Add(1)
+		}
+	}
+}
+
+// run 应答订阅者、等待连通、测量并生成报告
+func (lg *loadGen) run() (*report, error) {
+	connected := 0
+	for connected == 0 {
+		msg, err := lg.link.recv()
+		if err != nil {
+			return nil, fmt.Errorf("peers process: %w", err)
+		}
+		switch msg.Type {
+		case msgOffer:
+			answer, err := lg.room.AddSubscriber(msg.PeerID, msg.SDP)
+			if err != nil {
+				return nil, fmt.Errorf("%s: %w", msg.PeerID, err)
+			}
+			lg.link.send(message{Type: msgAnswer, PeerID: msg.PeerID, SDP: answer})
+		case msgConnected:
+			if msg.Connected == 0 {
+				return nil, fmt.Errorf("no subscriber connected within %v", lg.cfg.warmup)
+			}
+			connected = msg.Connected
+		case msgError:
+			return nil, fmt.Errorf("peers process: %s", msg.Error)
+		}
+	}
+
+	interrupt := make(chan os.Signal, 1)
+	signal.Notify(interrupt, os.Interrupt)
+	defer signal.Stop(interrupt)
+
+	cpu := newCPUSampler()
+	lg.ingested.Store(0)
+	if err := lg.link.send(message{Type: msgStart}); err != nil {
+		return nil, err
+	}
+	start := time.Now()
+	select {
+	case <-time.After(lg.cfg.duration):
+	case <-interrupt:
+	}
+	elapsed := time.Since(start)
+	relayCPU := cpu.percent()
+	if err := lg.link.send(message{Type: msgStop}); err != nil {
+		return nil, err
+	}
+
+	for {
+		msg, err := lg.link.recv()
+		if err != nil {
+			return nil, fmt.Errorf("peers process: %w", err)
+		}
+		switch msg.Type {
+		case msgReport:
+			if msg.Report == nil {
+				return nil, fmt.Errorf("peers process sent an empty report")
+			}
+			return lg.buildReport(elapsed, relayCPU, msg.Report), nil
+		case msgError:
+			return nil, fmt.Errorf("peers process: %s", msg.Error)
+		}
+	}
+}
+
+func (lg *loadGen) buildReport(elapsed time.Duration, relayCPU float64, peers *peersReport) *report {
+	secs := elapsed.Seconds()
+	r := &report{DurationSec: secs, Subscribers: peers.Subscribers}
+
+	var aggregate float64
+	var delivered uint64
+	for _, s := range peers.Subscribers {
+		aggregate += s.GoodputKbps
+		delivered += s.Packets
+	}
+
+	var mem runtime.MemStats
+	runtime.ReadMemStats(&mem)
+	r.Relay = relayReport{
+		CPUPercent:     relayCPU,
+		HeapAllocMB:    float64(mem.HeapAlloc) / (1 << 20),
+		SysMB:          float64(mem.Sys) / (1 << 20),
+		NumGC:          mem.NumGC,
+		Goroutines:     runtime.NumGoroutine(),
+		SourcePackets:  peers.SourcePackets,
+		SourceKbps:     float64(peers.SourceBytes) * 8 / secs / 1000,
+		SourceLost:     peers.SourceLost,
+		IngestedPkts:   lg.ingested.Load(),
+		DeliveredPkts:  delivered,
+		SubscriberKbps: aggregate,
+		PeersCPU:       peers.CPUPercent,
+	}
+	return r
+}
+
+func (lg *loadGen) close() {
+	if lg.peers != nil && lg.peers.Process != nil {
+		lg.peers.Process.Kill()
+		lg.peers.Wait()
+	}
+	if lg.ingestConn != nil {
+		lg.ingestConn.Close()
+	}
+	if lg.room != nil {
+		lg.room.Close()
+	}
+	if lg.coordinator != nil {
+		lg.coordinator.Close()
+	}
+}
@@ -0,0 +1,63 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Event Queue FFI Exports
+ * Go → Dart 事件背压：Dart 调用 SetEventWindow 开启信用窗口，
+ * 处理完事件后调用 EventAck 归还信用；UI isolate 跟不上时，
+ * ping/活跃发言者等状态类事件在 Go 侧合并，提示类事件直接丢弃，
+ * ICE 候选者、SDP、Relay 变更等必达事件在 Go 侧排队。
+ */
+package main
+
+import "C"
+
+import (
+	"encoding/json"
+
+	"github.com/maiguangyang/relay_core/pkg/sfu"
+)
+
+// eventQueue 所有 emitEvent 的出口
+var eventQueue = sfu.NewEventQueue(defaultEventQueueConfig(), deliverEvent)
+
+// defaultEventQueueConfig 事件分类
+// 未列出的事件类型均为必达
+func defaultEventQueueConfig() sfu.EventQueueConfig {
+	config := sfu.DefaultEventQueueConfig()
+	config.Rules = map[int]sfu.EventRule{
+		// 每个心跳周期每个 Peer 一条，只需要最新一条
+		EventTypePing: {Class: sfu.EventCoalesce},
+		// 新一轮覆盖旧一轮
+		EventTypePingRound: {Class: sfu.EventCoalesce, PerRoom: true},
+		// 每次慢响应都会上报，积压时丢弃（在线/离线状态变化为必达）
+		EventTypePeerSlow: {Class: sfu.EventDroppable},
+		// 只关心房间当前的主发言者
+		EventTypeActiveSpeaker: {Class: sfu.EventCoalesce, PerRoom: true},
+	}
+	return config
+}
+
+// SetEventWindow 设置事件信用窗口（已投递未确认的事件上限）
+// window <= 0 关闭背压（默认），开启后 Dart 必须调用 EventAck
+//
+//export SetEventWindow
+func SetEventWindow(window C.int) {
+	eventQueue.SetWindow(int(window))
+}
+
+// EventAck 确认已处理 count 个事件
+//
+//export EventAck
+func EventAck(count C.int) {
+	eventQueue.Ack(int(count))
+}
+
+// EventQueueGetStats 获取事件队列统计 (JSON)
+//
+//export EventQueueGetStats
+func EventQueueGetStats() *C.char {
+	data, _ := json.Marshal(eventQueue.GetStats())
+	return C.CString(string(data))
+}
@@ -1,17 +1,30 @@
 /// 事件处理器
 ///
 /// 使用 NativeCallable 接收 Go 层的事件回调
+/// 通过信用窗口向 Go 层反馈处理进度，UI isolate 跟不上时由 Go 层合并/丢弃/排队事件
 library;
 
 import 'dart:async';
+import 'dart:convert';
 import 'dart:ffi';
 
 import 'package:ffi/ffi.dart';
 
 import '../bindings/bindings.dart';
+import '../bindings/utils.dart';
 import '../../flutter_sfu_relay_bindings_generated.dart';
 import '../enums.dart';
 
+// librelay.h 重新生成前，新导出函数直接按符号查找
+final _setEventWindow = dylib
+    .lookupFunction<Void Function(Int), void Function(int)>('SetEventWindow');
+final _eventAck = dylib
+    .lookupFunction<Void Function(Int), void Function(int)>('EventAck');
+final _eventQueueGetStats = dylib
+    .lookupFunction<Pointer<Char> Function(), Pointer<Char> Function()>(
+      'EventQueueGetStats',
+    );
+
 /// SFU 事件
 class SfuEvent {
   final SfuEventType type;
@@ -44,13 +57,22 @@ class EventHandler {
   static NativeCallable<EventCallbackFunction>? _nativeCallback;
   static bool _initialized = false;
 
+  /// 推荐的信用窗口（默认不启用背压，需要时传给 [init]）
+  static const int recommendedWindow = 256;
+
+  static int _window = 0;
+  static int _unacked = 0;
+  static bool _flushScheduled = false;
+
   /// 事件流
   static Stream<SfuEvent> get events => _controller.stream;
 
   /// 初始化事件处理器
   ///
   /// 必须在使用其他功能前调用
-  static void init() {
+  /// [window] 已投递未确认的事件上限，0（默认）表示不启用背压，
+  /// 开启时建议使用 [recommendedWindow]
+  static void init({int window = 0}) {
     if (_initialized) return;
 
     // 使用 NativeCallable.listener 创建线程安全的异步回调
@@ -59,9 +81,38 @@ class EventHandler {
 
     // 注册到 Go 层
     bindings.SetEventCallback(_nativeCallback!.nativeFunction);
+    _window = window;
+    _unacked = 0;
+    _setEventWindow(window);
     _initialized = true;
   }
 
+  /// Go 层事件队列统计（window/in_flight/pending/delivered/coalesced/dropped）
+  static Map<String, dynamic>? getQueueStats() {
+    final ptr = _eventQueueGetStats();
+    if (ptr == nullptr) return null;
+    return jsonDecode(fromCString(ptr)) as Map<String, dynamic>;
+  }
+
+  /// 归还信用：攒够 1/4 窗口立即确认，剩余部分在当前事件循环轮次后确认
+  static void _ack() {
+    if (_window <= 0) return;
+    _unacked++;
+    if (_unacked * 4 >= _window) {
+      _flushAck();
+    } else if (!_flushScheduled) {
+      _flushScheduled = true;
+      Timer.run(_flushAck);
+    }
+  }
+
+  static void _flushAck() {
+    _flushScheduled = false;
+    if (_unacked == 0 || !_initialized) return;
+    _eventAck(_unacked);
+    _unacked = 0;
+  }
+
   /// 原生回调处理函数
   static void _onEvent(
     int eventType,
@@ -95,10 +146,14 @@ class EventHandler {
     );
 
     _controller.add(event);
+    _ack();
   }
 
   /// 释放资源
   static void dispose() {
+    if (_initialized) _setEventWindow(0);
+    _window = 0;
+    _unacked = 0;
     _nativeCallback?.close();
     _nativeCallback = null;
     _initialized = false;
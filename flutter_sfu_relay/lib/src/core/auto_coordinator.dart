@@ -15,8 +15,16 @@ import 'dart:convert';
 import '../callbacks/callbacks.dart';
 import '../enums.dart';
 import '../signaling/signaling.dart';
+import '../webrtc/relay_control_channel.dart';
 import 'coordinator.dart';
 
+// librelay.h 重新生成前，新导出函数直接按符号查找
+final _bridgeReportSubscriber = dylib
+    .lookupFunction<
+      Int Function(Pointer<Char>, Pointer<Char>, Int, Int, Int64),
+      int Function(Pointer<Char>, Pointer<Char>, int, int, int)
+    >('LiveKitBridgeReportSubscriber');
+
 /// Bot Token 请求回调类型
 /// 当设备当选为 Relay 时调用，返回 Bot Token 用于影子连接
 typedef BotTokenCallback = Future<String?> Function(String roomId);
@@ -172,6 +180,13 @@ class AutoCoordinator {
   bool _bridgeCreated = false; // 是否已创建 LiveKit 桥接器（用于资源清理）
   Timer? _recoveryTimer;
 
+  // 批量心跳：一轮的 Pong 攒齐（或超时）后一次提交给 Go 层
+  static const Duration _pongFlushDelay = Duration(milliseconds: 50);
+  int _pingSeq = 0;
+  Set<String> _pingRoundPeers = {};
+  final Set<String> _pendingPongs = {};
+  Timer? _pongFlushTimer;
+
   final Set<String> _peers = {};
 
   // 订阅
@@ -183,9 +198,29 @@ class AutoCoordinator {
 
   // P2P 订阅者连接（当本机不是 Relay 且在局域网时使用）
   RTCPeerConnection? _p2pConnection;
+  RelayControlChannel? _p2pControl; // 带内控制通道（心跳/声明不经过信令服务器）
   MediaStream? _p2pRemoteStream;
   bool _p2pConnected = false;
 
+  // 计划内移交（Go 层 relay_handoff.go 驱动，事件 32）
+  String? _handoffSuccessor; // 旧 Relay：已指定的继任者
+  int _handoffEpoch = 0;
+  bool _handoffPreparing = false; // 继任者：等待上游关键帧，已接受订阅者预协商
+
+  // 订阅者：向继任者预协商的连接，继任者接管后替换 _p2pConnection（先建后断）
+  static const Duration _migrateRetryDelay = Duration(seconds: 1);
+  static const Duration _migrateTimeout = Duration(seconds: 15);
+  String? _migrateRelayId;
+  int _migrateEpoch = 0;
+  RTCPeerConnection? _migrateConnection;
+  RelayControlChannel? _migrateControl;
+  MediaStream? _migrateStream;
+  bool _migrateConnected = false;
+  bool _migrateAnswered = false;
+  final List<RTCIceCandidate> _migrateCandidates = [];
+  Timer? _migrateRetryTimer;
+  Timer? _migrateTimer;
+
   // 屏幕共享状态
   String? _screenSharerPeerId; // 当前屏幕共享者的 ID
   bool _isLocalScreenSharing = false; // 本机是否正在屏幕共享
@@ -382,6 +417,10 @@ class AutoCoordinator {
     // 取消恢复定时器
     _recoveryTimer?.cancel();
     _recoveryTimer = null;
+    _pongFlushTimer?.cancel();
+    _pongFlushTimer = null;
+    _pendingPongs.clear();
+    _pingRoundPeers = {};
 
     try {
       await signaling.leaveRoom(roomId);
@@ -389,6 +428,9 @@ class AutoCoordinator {
 
     // 断开 P2P 订阅者连接
     await _closeP2PConnection();
+    await _closeMigration();
+    _handoffSuccessor = null;
+    _handoffPreparing = false;
 
     _peers.clear();
     _currentRelay = null;
@@ -438,6 +480,59 @@ class AutoCoordinator {
     }
   }
 
+  /// 上报局域网订阅者的视口尺寸和下行带宽估计（仅 Relay 有效）
+  ///
+  /// Go 层按所有订阅者中最大的视口选择向 LiveKit 请求的 simulcast 层，
+  /// 并受最低带宽估计限制；全员缩略图时只拉 LOW 层。
+  /// [width]/[height]/[bandwidthBps] 为 0 表示未知。
+  bool reportSubscriberViewport(
+    String peerId, {
+    int width = 0,
+    int height = 0,
+    int bandwidthBps = 0,
+  }) {
+    if (!_bridgeCreated) return false;
+    final roomPtr = toCString(roomId);
+    final peerPtr = toCString(peerId);
+    final result = _bridgeReportSubscriber(
+      roomPtr,
+      peerPtr,
+      width,
+      height,
+      bandwidthBps,
+    );
+    calloc.free(roomPtr);
+    calloc.free(peerPtr);
+    return result == 0;
+  }
+
+  /// 上报本机温度和电量
+  ///
+  /// 由应用监听系统温度 / 电量变化后调用。过热或低电量时 Go 层限制订阅者数、
+  /// 降低上游质量并降低选举分数；需要移交 Relay 时发出 deviceThrottle 事件（handoff=true）。
+  bool updateDeviceState({
+    ThermalState thermalState = ThermalState.nominal,
+    int batteryPercent = -1,
+  }) {
+    return _coordinator.updateLocalDeviceEx(
+      deviceType: config.deviceType,
+      connectionType: config.connectionType,
+      powerState: config.powerState,
+      thermalState: thermalState,
+      batteryPercent: batteryPercent,
+    );
+  }
+
+  /// 发起计划内 Relay 移交（本机需为 Relay）
+  ///
+  /// 应用退到后台或用户离开前调用（过热 / 低电量时 Go 层自动发起）。
+  /// 订阅者经控制通道收到通知后保留当前连接、向继任者预协商，继任者接管后切换；
+  /// 本机在订阅者迁移完成前继续转发，随后 Go 层关闭 RelayRoom 和 Bridge。
+  bool startHandoff() {
+    if (!isRelay) return false;
+    return _coordinator.startHandoff();
+  }
+
   /// 手动触发选举
   void triggerElection() {
     _currentEpoch++;
@@ -657,7 +752,7 @@ class AutoCoordinator {
         break;
 
       case SignalingMessageType.pong:
-        _coordinator.handlePong(message.peerId);
+        _queuePong(message.peerId);
         // _keepalive?.handlePong(message.peerId); // Go 层自动处理
         break;
 
@@ -675,16 +770,26 @@ class AutoCoordinator {
         break;
 
       case SignalingMessageType.answer:
-        // 订阅者收到 Relay 的 Answer
+        // 订阅者收到 Relay 的 Answer（继任者的 Answer 属于预协商连接）
         if (message.data != null && message.data!['sdp'] != null) {
-          _handleP2PAnswer(message.peerId, message.data!['sdp'] as String);
+          final sdp = message.data!['sdp'] as String;
+          if (message.peerId == _migrateRelayId) {
+            _handleMigrationAnswer(sdp);
+          } else {
+            _handleP2PAnswer(message.peerId, sdp);
+          }
         }
         break;
 
       case SignalingMessageType.candidate:
         // 收到 ICE 候选
         if (message.data != null) {
-          if (isRelay) {
+          if (message.peerId == _migrateRelayId) {
+            // 继任者面向本机预协商连接的候选
+            final candidate = message.data!['candidate'] as String?;
+            if (candidate != null) _handleMigrationCandidate(candidate);
+          } else if ((isRelay || _handoffPreparing) &&
+              message.peerId != _currentRelay) {
             // Relay 收到订阅者的 ICE 候选
             _handleCandidateFromSubscriber(message.peerId, message.data);
           } else if (message.data!['candidate'] != null) {
@@ -828,6 +933,9 @@ class AutoCoordinator {
     // 忽略过期的 epoch
     if (epoch < _currentEpoch) return;
 
+    // 计划内移交：继任者接管，不走选举冲突解决
+    if (_handleHandoffTakeover(peerId, epoch, score)) return;
+
     // 更新 epoch
     if (epoch > _currentEpoch) {
       _currentEpoch = epoch;
@@ -1078,6 +1186,9 @@ class AutoCoordinator {
     // 忽略无效消息
     if (relayId.isEmpty || relayId == localPeerId) return;
 
+    // 计划内移交：继任者接管，不做分数比较
+    if (_handleHandoffTakeover(relayId, epoch, score)) return;
+
     // 只忽略明显过期的 epoch（小于当前 epoch），相同 epoch 仍需处理
     if (epoch < _currentEpoch) {
       // 关键修复：如果对方 Epoch 落后（例如刚重启），我们需要告诉它当前的正确 Epoch
@@ -1169,7 +1280,7 @@ class AutoCoordinator {
         // 发送 action="ping_request" 的数据，这不是真正的离线，而是需要发 Ping
         // 必须检查 data 字段，否则会导致误判离线，引发 Split Brain
         if (event.data != null && event.data!.contains('ping_request')) {
-          signaling.sendPing(roomId, event.peerId);
+          _sendPing(event.peerId);
           return;
         }
 
@@ -1178,8 +1289,13 @@ class AutoCoordinator {
         break;
 
       case SfuEventType.ping:
-        // Go 层需要发送 Ping，通过信令发送
-        signaling.sendPing(roomId, event.peerId);
+        // Go 层需要发送 Ping
+        _sendPing(event.peerId);
+        break;
+
+      case SfuEventType.pingRound:
+        // 一轮心跳：控制通道发不出去的 Peer 合并在一个事件中
+        _handlePingRound(event.data);
         break;
 
       case SfuEventType.iceCandidate:
@@ -1213,6 +1329,11 @@ class AutoCoordinator {
         }
         break;
 
+      case SfuEventType.handoff:
+        // 计划内 Relay 移交进度
+        _handleHandoffEvent(event);
+        break;
+
       case SfuEventType.error:
         _errorController.add(event.data ?? 'Unknown error');
         break;
@@ -1223,8 +1344,379 @@ class AutoCoordinator {
   }
 
   void _handlePingRequest(PingRequest request) {
-    // Go 层需要发送 Ping，通过信令发送
-    signaling.sendPing(roomId, request.peerId);
+    // Go 层需要发送 Ping
+    _sendPing(request.peerId);
+  }
+
+  void _handlePingRound(String? data) {
+    if (data == null) return;
+    try {
+      final round = jsonDecode(data) as Map<String, dynamic>;
+      final peers = (round['peers'] as List? ?? const []).cast<String>();
+      _flushPongs(); // 上一轮剩余的 Pong 先提交
+      _pingSeq = (round['seq'] as num?)?.toInt() ?? 0;
+      _pingRoundPeers = peers.toSet();
+      for (final peerId in peers) {
+        _sendPing(peerId);
+      }
+    } catch (e) {
+      print('[AutoCoordinator] Failed to parse ping round: $e');
+    }
+  }
+
+  /// 暂存 Pong：本轮 Peer 全部响应后立即提交，否则最多延迟 [_pongFlushDelay]
+  void _queuePong(String peerId) {
+    _pendingPongs.add(peerId);
+    if (_pendingPongs.containsAll(_pingRoundPeers)) {
+      _flushPongs();
+      return;
+    }
+    _pongFlushTimer ??= Timer(_pongFlushDelay, _flushPongs);
+  }
+
+  void _flushPongs() {
+    _pongFlushTimer?.cancel();
+    _pongFlushTimer = null;
+    if (_pendingPongs.isEmpty) return;
+    _coordinator.handlePongBatch(_pingSeq, _pendingPongs);
+    _pendingPongs.clear();
+  }
+
+  /// 发送 Ping：目标是当前 Relay 且控制通道可用时走 DataChannel，否则走信令
+  void _sendPing(String peerId) {
+    if (peerId == _currentRelay && _p2pControl?.sendPing() == true) {
+      return;
+    }
+    signaling.sendPing(roomId, peerId);
+  }
+
+  /// 处理 Relay 控制通道消息
+  void _handleControlMessage(String relayId, RelayControlMessage message) {
+    switch (message.type) {
+      case RelayControlMessageType.pong:
+        _coordinator.handlePong(relayId);
+        break;
+      case RelayControlMessageType.claim:
+        _handleRelayClaim(
+          message.peerId.isEmpty ? relayId : message.peerId,
+          {'epoch': message.epoch, 'score': message.score},
+        );
+        break;
+      case RelayControlMessageType.handoff:
+        // 旧 Relay 指定了继任者：继任者准备接管，其余订阅者收到 migrate 事件
+        _coordinator.handleHandoff(relayId, message.peerId, message.epoch);
+        break;
+      default:
+        break;
+    }
+  }
+
+  // ========== 计划内移交 ==========
+
+  /// 处理 Go 层移交事件（data.phase: nominated/prepare/migrate/committed/completed/aborted）
+  void _handleHandoffEvent(SfuEvent event) {
+    Map<String, dynamic> data;
+    try {
+      data = jsonDecode(event.data ?? '{}') as Map<String, dynamic>;
+    } catch (e) {
+      print('[Handoff] Failed to parse handoff event: $e');
+      return;
+    }
+    final epoch = (data['epoch'] as num?)?.toInt() ?? 0;
+    print('[Handoff] phase=${data['phase']} epoch=$epoch peer=${event.peerId}');
+
+    switch (data['phase']) {
+      case 'nominated':
+        // 旧 Relay：继续转发，等待继任者声明
+        _handoffSuccessor = data['successor'] as String? ?? event.peerId;
+        _handoffEpoch = epoch;
+        break;
+
+      case 'prepare':
+        // 继任者：连接 LiveKitBridge（RelayRoomCreate 的房间由 Coordinator 接管），
+        // 开始接受订阅者预协商；Go 层转发出第一个上游关键帧后接管
+        _handoffPreparing = true;
+        _handoffEpoch = epoch;
+        _connectLiveKitBridge();
+        break;
+
+      case 'migrate':
+        // 订阅者：保留当前连接，向继任者预协商
+        _startMigration(data['successor'] as String? ?? event.peerId, epoch);
+        break;
+
+      case 'committed':
+        _commitHandoff(
+          epoch,
+          (data['score'] as num?)?.toDouble() ?? _localScore,
+          data['claim_pending'] == true,
+        );
+        break;
+
+      case 'completed':
+        // 旧 Relay：Go 层已关闭 RelayRoom 和 Bridge
+        final successor = data['successor'] as String? ?? event.peerId;
+        if (_handoffSuccessor == successor) {
+          _followSuccessor(successor, epoch, 0);
+        }
+        _disconnectLiveKitBridge();
+        if (isOnLan && _currentRelay == successor) {
+          _createP2PConnectionToRelay(successor);
+        }
+        break;
+
+      case 'aborted':
+        if (data['from'] == 'nominated') {
+          // 旧 Relay：继任者没有接管，继续服务
+          _handoffSuccessor = null;
+        } else if (_handoffPreparing) {
+          // 继任者：Go 层已释放 RelayRoom，清理 Bridge
+          _handoffPreparing = false;
+          _disconnectLiveKitBridge();
+        }
+        break;
+    }
+  }
+
+  /// 继任者：已接管，通知旧 Relay 和其他 Peer，关闭本机订阅旧 Relay 的连接
+  void _commitHandoff(int epoch, double score, bool claimPending) {
+    _handoffPreparing = false;
+
+    // 声明优先经本机订阅旧 Relay 的控制通道送达，不可用时经信令
+    if (claimPending &&
+        _p2pControl?.sendClaim(epoch, score, localPeerId) != true) {
+      signaling.sendRelayClaim(roomId, epoch, score);
+    }
+
+    _currentEpoch = epoch;
+    _currentRelay = localPeerId;
+    _currentRelayScore = _localScore;
+    _electionTimer?.cancel();
+    _updateState(AutoCoordinatorState.asRelay);
+
+    // 控制通道未送达的订阅者（蜂窝 / 未预协商）经信令得知新 Relay
+    signaling.sendRelayChanged(roomId, localPeerId, epoch, _localScore);
+    _relayChangedController.add(localPeerId);
+
+    _closeP2PConnection();
+  }
+
+  /// 继任者的声明 / Relay 变更到达
+  /// - 旧 Relay：视为移交接管，不抢占、不立即断开 Bridge（Go 层在订阅者迁移完成后关闭并发出 completed）
+  /// - 订阅者：切到预协商的连接
+  bool _handleHandoffTakeover(String relayId, int epoch, double score) {
+    if (relayId == _handoffSuccessor && epoch >= _handoffEpoch) {
+      _coordinator.receiveClaim(relayId, epoch, score);
+      _followSuccessor(relayId, epoch, score);
+      return true;
+    }
+    if (relayId == _migrateRelayId && epoch >= _migrateEpoch) {
+      _switchToMigration(relayId, epoch, score);
+      return true;
+    }
+    return false;
+  }
+
+  /// 旧 Relay：记录继任者为当前 Relay
+  void _followSuccessor(String relayId, int epoch, double score) {
+    _handoffSuccessor = null;
+    _currentEpoch = epoch;
+    _currentRelay = relayId;
+    _currentRelayScore = score;
+    _electionTimer?.cancel();
+    if (_state != AutoCoordinatorState.idle) {
+      _updateState(AutoCoordinatorState.connected);
+    }
+    _relayChangedController.add(relayId);
+  }
+
+  /// 订阅者：向继任者预协商（继任者的 RelayRoom 可能还没就绪，未收到 Answer 时重发 Offer）
+  Future<void> _startMigration(String successor, int epoch) async {
+    if (!isOnLan || isRelay || successor == localPeerId) return;
+
+    await _closeMigration();
+    _migrateRelayId = successor;
+    _migrateEpoch = epoch;
+    // 继任者没有接管（Go 层 HandoffTimeout 后放弃），丢弃预协商的连接
+    _migrateTimer = Timer(_migrateTimeout, _closeMigration);
+    await _offerMigration(successor);
+  }
+
+  Future<void> _offerMigration(String relayId) async {
+    await _closeMigrationConnection();
+    if (_migrateRelayId != relayId) return;
+
+    try {
+      final pc = await createPeerConnection({
+        'iceServers': [
+          {'urls': 'stun:stun.l.google.com:19302'},
+        ],
+        'sdpSemantics': 'unified-plan',
+      });
+      _migrateConnection = pc;
+
+      await pc.addTransceiver(
+        kind: RTCRtpMediaType.RTCRtpMediaTypeVideo,
+        init: RTCRtpTransceiverInit(direction: TransceiverDirection.RecvOnly),
+      );
+      await pc.addTransceiver(
+        kind: RTCRtpMediaType.RTCRtpMediaTypeAudio,
+        init: RTCRtpTransceiverInit(direction: TransceiverDirection.RecvOnly),
+      );
+
+      _migrateControl = await RelayControlChannel.create(pc);
+      _migrateControl!.onMessage = (message) {
+        // 继任者接管（epoch 为移交后的纪元号）时切换，其余消息按普通 Relay 处理
+        if (message.type == RelayControlMessageType.claim &&
+            message.epoch >= _migrateEpoch) {
+          _switchToMigration(relayId, message.epoch, message.score);
+          return;
+        }
+        _handleControlMessage(relayId, message);
+      };
+
+      pc.onTrack = (RTCTrackEvent event) {
+        if (event.streams.isNotEmpty) {
+          _migrateStream = event.streams.first;
+        }
+      };
+      pc.onConnectionState = (RTCPeerConnectionState state) {
+        _migrateConnected =
+            state == RTCPeerConnectionState.RTCPeerConnectionStateConnected;
+      };
+      pc.onIceCandidate = (RTCIceCandidate candidate) {
+        signaling.sendCandidate(roomId, relayId, jsonEncode(candidate.toMap()));
+      };
+
+      final offer = await pc.createOffer({
+        'offerToReceiveVideo': true,
+        'offerToReceiveAudio': true,
+      });
+      await pc.setLocalDescription(offer);
+      signaling.sendOffer(roomId, relayId, offer.sdp!);
+      print('[Handoff] Sent pre-negotiation offer to successor: $relayId');
+    } catch (e) {
+      print('[Handoff] Failed to pre-negotiate with $relayId: $e');
+    }
+
+    _migrateRetryTimer?.cancel();
+    _migrateRetryTimer = Timer(_migrateRetryDelay, () {
+      if (_migrateRelayId == relayId && !_migrateAnswered) {
+        _offerMigration(relayId);
+      }
+    });
+  }
+
+  /// 继任者的 Answer
+  Future<void> _handleMigrationAnswer(String sdp) async {
+    final pc = _migrateConnection;
+    if (pc == null || _migrateAnswered) return;
+    try {
+      await pc.setRemoteDescription(RTCSessionDescription(sdp, 'answer'));
+      _migrateAnswered = true;
+      for (final candidate in _migrateCandidates) {
+        await pc.addCandidate(candidate);
+      }
+      _migrateCandidates.clear();
+    } catch (e) {
+      print('[Handoff] Failed to set successor answer: $e');
+    }
+  }
+
+  /// 继任者的 ICE 候选（Answer 之前到达的先缓存）
+  Future<void> _handleMigrationCandidate(String candidateJsonStr) async {
+    final pc = _migrateConnection;
+    if (pc == null) return;
+    try {
+      final map = jsonDecode(candidateJsonStr) as Map<String, dynamic>;
+      final candidate = RTCIceCandidate(
+        map['candidate'],
+        map['sdpMid'],
+        map['sdpMLineIndex'],
+      );
+      if (!_migrateAnswered) {
+        _migrateCandidates.add(candidate);
+        return;
+      }
+      await pc.addCandidate(candidate);
+    } catch (e) {
+      print('[Handoff] Failed to add successor candidate: $e');
+    }
+  }
+
+  /// 订阅者：继任者已接管，预协商的连接成为当前连接，再关闭旧连接
+  Future<void> _switchToMigration(
+    String relayId,
+    int epoch,
+    double score,
+  ) async {
+    if (_migrateRelayId != relayId) return;
+
+    final pc = _migrateConnection;
+    if (pc == null || !_migrateConnected) {
+      // 预协商没有连通：按普通 Relay 变更重新连接
+      await _closeMigration();
+      _acceptRelay(relayId, epoch, score);
+      return;
+    }
+
+    final oldConnection = _p2pConnection;
+    final oldControl = _p2pControl;
+    oldConnection?.onConnectionState = null;
+    _connectionRetryTimer?.cancel();
+    _connectionRetryTimer = null;
+
+    _p2pConnection = pc;
+    _p2pControl = _migrateControl;
+    _p2pRemoteStream = _migrateStream;
+    _p2pConnected = true;
+    _pendingIceCandidates.clear();
+    pc.onConnectionState = (RTCPeerConnectionState state) =>
+        _handleP2PConnectionState(relayId, state);
+    _p2pControl?.onMessage =
+        (message) => _handleControlMessage(relayId, message);
+
+    _migrateConnection = null;
+    _migrateControl = null;
+    _migrateStream = null;
+    await _closeMigration();
+
+    _currentEpoch = epoch;
+    _currentRelay = relayId;
+    _currentRelayScore = score;
+    _coordinator.receiveClaim(relayId, epoch, score);
+    _relayChangedController.add(relayId);
+    if (!_disposed) {
+      _remoteStreamController.add(_p2pRemoteStream);
+    }
+    print('[Handoff] Switched to successor $relayId (epoch $epoch)');
+
+    await oldControl?.close();
+    await oldConnection?.close();
+  }
+
+  /// 放弃预协商
+  Future<void> _closeMigration() async {
+    _migrateTimer?.cancel();
+    _migrateTimer = null;
+    _migrateRelayId = null;
+    await _closeMigrationConnection();
+  }
+
+  Future<void> _closeMigrationConnection() async {
+    _migrateRetryTimer?.cancel();
+    _migrateRetryTimer = null;
+    _migrateAnswered = false;
+    _migrateConnected = false;
+    _migrateCandidates.clear();
+    _migrateStream = null;
+
+    final control = _migrateControl;
+    final pc = _migrateConnection;
+    _migrateControl = null;
+    _migrateConnection = null;
+    await control?.close();
+    await pc?.close();
   }
 
   void _startElection({bool isInitial = false}) {
@@ -1376,6 +1868,11 @@ class AutoCoordinator {
         init: RTCRtpTransceiverInit(direction: TransceiverDirection.RecvOnly),
       );
 
+      // 控制通道必须在 createOffer 之前创建，才能进入 Offer
+      _p2pControl = await RelayControlChannel.create(_p2pConnection!);
+      _p2pControl!.onMessage =
+          (message) => _handleControlMessage(relayId, message);
+
       // 监听远程流
       _p2pConnection!.onTrack = (RTCTrackEvent event) {
         if (event.streams.isNotEmpty) {
@@ -1396,32 +1893,8 @@ class AutoCoordinator {
       };
 
       // 监听连接状态
-      _p2pConnection!.onConnectionState = (RTCPeerConnectionState state) {
-        print('[P2P] Connection state changed: $state for relay $relayId');
-        if (state == RTCPeerConnectionState.RTCPeerConnectionStateConnected) {
-          print('[P2P] Remote stream connected! Ready to render.');
-          _p2pConnected = true;
-        } else if (state ==
-                RTCPeerConnectionState.RTCPeerConnectionStateFailed ||
-            state ==
-                RTCPeerConnectionState.RTCPeerConnectionStateDisconnected ||
-            state == RTCPeerConnectionState.RTCPeerConnectionStateClosed) {
-          print('[P2P] Remote stream disconnected or failed: $state');
-          _p2pConnected = false;
-          _p2pRemoteStream = null;
-          if (!_disposed) {
-            _remoteStreamController.add(null);
-
-            // 触发云端订阅管理回调：P2P 已断开，应恢复云端订阅作为回退
-            if (_screenSharerPeerId != null) {
-              config.onCloudSubscriptionChanged?.call(
-                _screenSharerPeerId!,
-                true,
-              );
-            }
-          }
-        }
-      };
+      _p2pConnection!.onConnectionState = (RTCPeerConnectionState state) =>
+          _handleP2PConnectionState(relayId, state);
 
       // 监听 ICE 候选
       _p2pConnection!.onIceCandidate = (RTCIceCandidate candidate) {
@@ -1465,11 +1938,41 @@ class AutoCoordinator {
     }
   }
 
+  /// P2P 连接状态变化（订阅者到当前 Relay）
+  void _handleP2PConnectionState(
+    String relayId,
+    RTCPeerConnectionState state,
+  ) {
+    print('[P2P] Connection state changed: $state for relay $relayId');
+    if (state == RTCPeerConnectionState.RTCPeerConnectionStateConnected) {
+      print('[P2P] Remote stream connected! Ready to render.');
+      _p2pConnected = true;
+    } else if (state == RTCPeerConnectionState.RTCPeerConnectionStateFailed ||
+        state == RTCPeerConnectionState.RTCPeerConnectionStateDisconnected ||
+        state == RTCPeerConnectionState.RTCPeerConnectionStateClosed) {
+      print('[P2P] Remote stream disconnected or failed: $state');
+      _p2pConnected = false;
+      _p2pRemoteStream = null;
+      if (!_disposed) {
+        _remoteStreamController.add(null);
+
+        // 触发云端订阅管理回调：P2P 已断开，应恢复云端订阅作为回退
+        if (_screenSharerPeerId != null) {
+          config.onCloudSubscriptionChanged?.call(_screenSharerPeerId!, true);
+        }
+      }
+    }
+  }
+
   /// 关闭 P2P 连接
   Future<void> _closeP2PConnection() async {
     _connectionRetryTimer?.cancel();
     _connectionRetryTimer = null;
 
+    if (_p2pControl != null) {
+      await _p2pControl!.close();
+      _p2pControl = null;
+    }
     if (_p2pConnection != null) {
       await _p2pConnection!.close();
       _p2pConnection = null;
@@ -1556,8 +2059,8 @@ class AutoCoordinator {
     String subscriberId,
     Map<String, dynamic>? data,
   ) {
-    // 只有 Relay 才处理 Offer
-    if (!isRelay) return;
+    // 只有 Relay（或准备接管的继任者）才处理 Offer
+    if (!isRelay && !_handoffPreparing) return;
 
     final sdp = data?['sdp'] as String?;
     if (sdp == null) return;
@@ -1613,8 +2116,8 @@ class AutoCoordinator {
     String subscriberId,
     Map<String, dynamic>? data,
   ) {
-    // 只有 Relay 才处理
-    if (!isRelay) return;
+    // 只有 Relay（或准备接管的继任者）才处理
+    if (!isRelay && !_handoffPreparing) return;
 
     // data['candidate'] 是 JSON 字符串
     final candidateJsonStr = data?['candidate'] as String?;
@@ -10,6 +10,37 @@ import 'package:ffi/ffi.dart';
 import '../bindings/bindings.dart';
 import '../bindings/utils.dart';
 import '../enums.dart';
+import '../media/packet_arena.dart';
+
+// librelay.h 重新生成前，新导出函数直接按符号查找
+final _handlePongBatch = dylib
+    .lookupFunction<
+      Int Function(Pointer<Char>, Uint64, Pointer<Char>),
+      int Function(Pointer<Char>, int, Pointer<Char>)
+    >('CoordinatorHandlePongBatch');
+
+final _updateLocalDeviceEx = dylib
+    .lookupFunction<
+      Int Function(Pointer<Char>, Int, Int, Int, Int, Int),
+      int Function(Pointer<Char>, int, int, int, int, int)
+    >('CoordinatorUpdateLocalDeviceEx');
+
+final _startHandoff = dylib
+    .lookupFunction<Int Function(Pointer<Char>), int Function(Pointer<Char>)>(
+      'CoordinatorStartHandoff',
+    );
+
+final _handleHandoff = dylib
+    .lookupFunction<
+      Int Function(Pointer<Char>, Pointer<Char>, Pointer<Char>, Uint64),
+      int Function(Pointer<Char>, Pointer<Char>, Pointer<Char>, int)
+    >('CoordinatorHandleHandoff');
+
+final _setLANMode = dylib
+    .lookupFunction<
+      Int Function(Pointer<Char>, Int, Int),
+      int Function(Pointer<Char>, int, int)
+    >('CoordinatorSetLANMode');
 
 /// 代理模式协调器
 ///
@@ -18,10 +49,15 @@ class Coordinator {
   final String roomId;
   final String localPeerId;
 
-  Coordinator({required this.roomId, required this.localPeerId});
+  /// 协调器 SourceSwitcher 的句柄和单包注入暂存区（注入时不再传房间 ID）
+  final PacketInjector _injector;
+
+  Coordinator({required this.roomId, required this.localPeerId})
+    : _injector = PacketInjector(roomId);
 
   /// 启用协调器
   bool enable() {
+    _releaseNative();
     final roomPtr = toCString(roomId);
     final peerPtr = toCString(localPeerId);
     final result = bindings.CoordinatorEnable(roomPtr, peerPtr);
@@ -32,6 +68,7 @@ class Coordinator {
 
   /// 禁用协调器
   bool disable() {
+    _releaseNative();
     final roomPtr = toCString(roomId);
     final result = bindings.CoordinatorDisable(roomPtr);
     calloc.free(roomPtr);
@@ -79,6 +116,18 @@ class Coordinator {
     return result == 0;
   }
 
+  /// 批量处理一轮 Pong
+  ///
+  /// [seq] 为 pingRound 事件中的轮次（0 表示未知）
+  bool handlePongBatch(int seq, Iterable<String> peerIds) {
+    final roomPtr = toCString(roomId);
+    final peersPtr = toCString(peerIds.join('\n'));
+    final result = _handlePongBatch(roomPtr, seq, peersPtr);
+    calloc.free(roomPtr);
+    calloc.free(peersPtr);
+    return result >= 0;
+  }
+
   /// 设置当前 Relay
   bool setRelay(String relayId, int epoch) {
     final roomPtr = toCString(roomId);
@@ -89,6 +138,67 @@ class Coordinator {
     return result == 0;
   }
 
+  /// 更新本机设备信息（含温度和电量）
+  ///
+  /// [batteryPercent] 为 0-100，-1 表示未知。
+  /// 过热或低电量时 Go 层自动减负，并发出 deviceThrottle 事件
+  bool updateLocalDeviceEx({
+    required DeviceType deviceType,
+    required ConnectionType connectionType,
+    required PowerState powerState,
+    ThermalState thermalState = ThermalState.nominal,
+    int batteryPercent = -1,
+  }) {
+    final roomPtr = toCString(roomId);
+    final result = _updateLocalDeviceEx(
+      roomPtr,
+      deviceType.value,
+      connectionType.value,
+      powerState.value,
+      thermalState.value,
+      batteryPercent,
+    );
+    calloc.free(roomPtr);
+    return result == 0;
+  }
+
+  /// 设置本机成为 Relay 时是否使用局域网模式
+  ///
+  /// Relay 作为 ICE-lite 端，只收集 host 候选（[mdns] 为 true 时收集 mDNS 候选），
+  /// 缩短订阅者建连时间。对之后创建的 RelayRoom 生效。
+  bool setLANMode(bool enabled, {bool mdns = false}) {
+    final roomPtr = toCString(roomId);
+    final result = _setLANMode(roomPtr, enabled ? 1 : 0, mdns ? 1 : 0);
+    calloc.free(roomPtr);
+    return result == 0;
+  }
+
+  /// 发起计划内 Relay 移交（本机需为 Relay）
+  ///
+  /// 继任者通过 handoff 事件（phase=nominated）返回，
+  /// 本机在订阅者迁移完成前继续转发
+  bool startHandoff() {
+    final roomPtr = toCString(roomId);
+    final result = _startHandoff(roomPtr);
+    calloc.free(roomPtr);
+    return result == 0;
+  }
+
+  /// 处理旧 Relay 的移交通知
+  ///
+  /// 本机为继任者时准备接管（phase=prepare），
+  /// 否则发出 phase=migrate 事件，应向继任者预协商并保留当前连接
+  bool handleHandoff(String relayId, String successorId, int epoch) {
+    final roomPtr = toCString(roomId);
+    final relayPtr = toCString(relayId);
+    final successorPtr = toCString(successorId);
+    final result = _handleHandoff(roomPtr, relayPtr, successorPtr, epoch);
+    calloc.free(roomPtr);
+    calloc.free(relayPtr);
+    calloc.free(successorPtr);
+    return result == 0;
+  }
+
   /// 接收 Relay 声明
   bool receiveClaim(String peerId, int epoch, double score) {
     final roomPtr = toCString(roomId);
@@ -122,38 +232,27 @@ class Coordinator {
     return result == 0;
   }
 
-  /// 注入 SFU RTP 包
+  void _releaseNative() => _injector.release();
+
+  /// 协调器 SourceSwitcher 句柄，首次使用时打开
+  int get switcherHandle => _injector.handle;
+
+  /// 注入 SFU RTP 包（同一轮事件循环内的包合并为一次 FFI 调用）
   bool injectSfuPacket(bool isVideo, Uint8List data) {
-    final roomPtr = toCString(roomId);
-    final dataPtr = calloc<Uint8>(data.length);
-    dataPtr.asTypedList(data.length).setAll(0, data);
-    final result = bindings.CoordinatorInjectSFU(
-      roomPtr,
-      isVideo ? 1 : 0,
-      dataPtr.cast(),
-      data.length,
-    );
-    calloc.free(roomPtr);
-    calloc.free(dataPtr);
-    return result == 0;
+    return _injector.add(isVideo, false, data);
   }
 
-  /// 注入本地 RTP 包
+  /// 注入本地 RTP 包（同一轮事件循环内的包合并为一次 FFI 调用）
   bool injectLocalPacket(bool isVideo, Uint8List data) {
-    final roomPtr = toCString(roomId);
-    final dataPtr = calloc<Uint8>(data.length);
-    dataPtr.asTypedList(data.length).setAll(0, data);
-    final result = bindings.CoordinatorInjectLocal(
-      roomPtr,
-      isVideo ? 1 : 0,
-      dataPtr.cast(),
-      data.length,
-    );
-    calloc.free(roomPtr);
-    calloc.free(dataPtr);
-    return result == 0;
+    return _injector.add(isVideo, true, data);
   }
 
+  /// 立即注入尚未注入的单包，返回注入的包数，失败返回 -1
+  int flush() => _injector.flush();
+
+  /// 批量注入（见 [PacketArena]），返回成功注入的包数，失败返回 -1
+  int injectBatch(PacketArena arena) => _injector.inject(arena);
+
   /// 获取状态 (JSON)
   Map<String, dynamic> getStatus() {
     final roomPtr = toCString(roomId);
@@ -35,6 +35,17 @@ enum PowerState {
   final int value;
 }
 
+/// 设备温度状态（对应 iOS ProcessInfo.thermalState）
+enum ThermalState {
+  nominal(0),
+  fair(1),
+  serious(2),
+  critical(3);
+
+  const ThermalState(this.value);
+  final int value;
+}
+
 /// Peer 状态
 enum PeerStatus {
   unknown(0),
@@ -51,6 +62,16 @@ enum PeerStatus {
   );
 }
 
+/// 订阅者视频模式
+enum SubscriberVideoMode {
+  full(0),
+  thumbnail(1),
+  paused(2);
+
+  const SubscriberVideoMode(this.value);
+  final int value;
+}
+
 /// 事件类型
 enum SfuEventType {
   unknown(0),
@@ -75,7 +96,17 @@ enum SfuEventType {
   peerOffline(22),
   ping(23),
   // 降级事件
-  relayDisabled(24);
+  relayDisabled(24),
+  // 批量心跳（来自 Coordinator，data: {"seq":n,"peers":[...]}）
+  pingRound(25),
+  // 活跃发言者变化（peerId 为主发言者，data.speakers 按能量降序）
+  activeSpeaker(30),
+  // 设备负载限制变化（data: level/reason/max_subscribers/max_upstream/handoff）
+  deviceThrottle(31),
+  // 计划内 Relay 移交（data.phase: nominated/prepare/migrate/committed/completed/aborted）
+  handoff(32),
+  // 订阅者渲染路径切换（data: path relay/direct, reason）
+  fallbackPath(33);
 
   const SfuEventType(this.value);
   final int value;
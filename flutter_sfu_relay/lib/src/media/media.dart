@@ -2,4 +2,5 @@
 library;
 
 export 'source_switcher.dart';
+export 'packet_arena.dart';
 export 'jitter_buffer.dart';
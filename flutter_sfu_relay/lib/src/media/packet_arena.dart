@@ -0,0 +1,201 @@
+/// 原生 RTP 暂存区
+///
+/// Go 层 malloc 的长期内存，Dart 顺序追加 RTP 包（bump 指针），
+/// 一次 FFI 调用注入整批，替代每个包 calloc/free + toNativeUtf8。
+/// 记录格式与 Go 层 pkg/sfu/inject_batch.go 保持一致：
+/// len(2, 小端) + flags(1) + reserved(1) + RTP 数据
+library;
+
+import 'dart:async';
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import '../bindings/bindings.dart';
+import '../bindings/utils.dart';
+
+// librelay.h 重新生成前，新导出函数直接按符号查找
+final _arenaCreate = dylib.lookupFunction<Int Function(Int), int Function(int)>(
+  'PacketArenaCreate',
+);
+final _arenaGetBuffer = dylib
+    .lookupFunction<Pointer<Void> Function(Int), Pointer<Void> Function(int)>(
+      'PacketArenaGetBuffer',
+    );
+final _arenaDestroy = dylib
+    .lookupFunction<Int Function(Int), int Function(int)>('PacketArenaDestroy');
+final _openHandle = dylib
+    .lookupFunction<Int Function(Pointer<Char>), int Function(Pointer<Char>)>(
+      'SourceSwitcherOpenHandle',
+    );
+final _closeHandle = dylib.lookupFunction<Int Function(Int), int Function(int)>(
+  'SourceSwitcherCloseHandle',
+);
+final _injectArena = dylib
+    .lookupFunction<Int Function(Int, Int, Int), int Function(int, int, int)>(
+      'SourceSwitcherInjectArena',
+    );
+
+/// [PacketArena.injectInto] 返回值：句柄对应的切换器已销毁或重建（Go 侧已关闭该句柄）
+const int staleSwitcherHandle = -2;
+
+/// 打开房间 SourceSwitcher 句柄（房间 ID 只转换一次），失败返回 -1
+int openSourceSwitcherHandle(String roomId) {
+  final roomPtr = toCString(roomId);
+  final handle = _openHandle(roomPtr);
+  calloc.free(roomPtr);
+  return handle;
+}
+
+/// 关闭句柄（不会销毁 SourceSwitcher）
+void closeSourceSwitcherHandle(int handle) {
+  if (handle > 0) _closeHandle(handle);
+}
+
+/// 原生 RTP 暂存区（只能在创建它的 isolate 中使用）
+class PacketArena {
+  static const int _headerSize = 4;
+  static const int _flagVideo = 1 << 0;
+  static const int _flagLocal = 1 << 1;
+
+  final int capacity;
+  final int _handle;
+  final Uint8List _view;
+  final ByteData _bytes;
+  int _used = 0;
+  int _count = 0;
+  bool _disposed = false;
+
+  PacketArena._(this.capacity, this._handle, this._view)
+    : _bytes = ByteData.sublistView(_view);
+
+  /// 创建暂存区，失败返回 null
+  static PacketArena? create({int capacity = 256 * 1024}) {
+    final handle = _arenaCreate(capacity);
+    if (handle <= 0) return null;
+    final base = _arenaGetBuffer(handle);
+    if (base == nullptr) {
+      _arenaDestroy(handle);
+      return null;
+    }
+    return PacketArena._(
+      capacity,
+      handle,
+      base.cast<Uint8>().asTypedList(capacity),
+    );
+  }
+
+  /// 已写入字节数
+  int get used => _used;
+
+  /// 待注入的包数
+  int get pending => _count;
+
+  /// 追加一个包，空间不足时返回 false（先 [injectInto] 再重试）
+  bool add(Uint8List packet, {required bool isVideo, bool local = false}) {
+    if (_disposed || packet.isEmpty || packet.length > 0xffff) return false;
+    final end = _used + _headerSize + packet.length;
+    if (end > capacity) return false;
+
+    var flags = 0;
+    if (isVideo) flags |= _flagVideo;
+    if (local) flags |= _flagLocal;
+    _bytes
+      ..setUint16(_used, packet.length, Endian.little)
+      ..setUint8(_used + 2, flags)
+      ..setUint8(_used + 3, 0);
+    _view.setRange(_used + _headerSize, end, packet);
+    _used = end;
+    _count++;
+    return true;
+  }
+
+  /// 把暂存区中的包注入 SourceSwitcher 句柄，并清空暂存区
+  /// 返回成功注入的包数，失败返回 -1；
+  /// 返回 [staleSwitcherHandle] 时暂存区保留原内容，重新打开句柄后可再次注入
+  int injectInto(int switcherHandle) {
+    if (_disposed || _used == 0) return 0;
+    final result = _injectArena(switcherHandle, _handle, _used);
+    if (result != staleSwitcherHandle) reset();
+    return result;
+  }
+
+  /// 清空（不释放内存）
+  void reset() {
+    _used = 0;
+    _count = 0;
+  }
+
+  /// 释放原生内存
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    _arenaDestroy(_handle);
+  }
+}
+
+/// 房间句柄 + 单包注入暂存区（SourceSwitcher / Coordinator 共用）
+///
+/// 单包注入先追加到暂存区，同一轮事件循环内的包在微任务中一次注入；
+/// 暂存区满时立即注入。句柄过期（房间的切换器重建）时自动重新打开并重试一次。
+class PacketInjector {
+  final String roomId;
+
+  int _handle = -1;
+  PacketArena? _arena;
+  bool _flushScheduled = false;
+
+  PacketInjector(this.roomId);
+
+  /// 房间句柄，首次使用时打开
+  int get handle {
+    if (_handle <= 0) _handle = openSourceSwitcherHandle(roomId);
+    return _handle;
+  }
+
+  /// 追加一个包，在本轮事件循环结束前注入；房间不存在或包无效时返回 false
+  bool add(bool isVideo, bool local, Uint8List data) {
+    if (handle <= 0) return false;
+    final arena = _arena ??= PacketArena.create(capacity: 64 * 1024);
+    if (arena == null) return false;
+    if (!arena.add(data, isVideo: isVideo, local: local)) {
+      if (arena.pending == 0) return false;
+      flush();
+      if (!arena.add(data, isVideo: isVideo, local: local)) return false;
+    }
+    if (!_flushScheduled) {
+      _flushScheduled = true;
+      scheduleMicrotask(flush);
+    }
+    return true;
+  }
+
+  /// 立即注入暂存区中的包，返回成功注入的包数，失败返回 -1
+  int flush() {
+    _flushScheduled = false;
+    final arena = _arena;
+    if (arena == null || arena.pending == 0) return 0;
+    return inject(arena);
+  }
+
+  /// 注入外部暂存区（见 [PacketArena]），返回成功注入的包数，失败返回 -1
+  int inject(PacketArena arena) {
+    var result = handle <= 0 ? -1 : arena.injectInto(_handle);
+    if (result == staleSwitcherHandle) {
+      _handle = -1;
+      result = handle <= 0 ? -1 : arena.injectInto(_handle);
+    }
+    if (result < 0) arena.reset();
+    return result;
+  }
+
+  /// 关闭句柄并释放暂存区（未注入的包丢弃）
+  void release() {
+    closeSourceSwitcherHandle(_handle);
+    _handle = -1;
+    _arena?.dispose();
+    _arena = null;
+    _flushScheduled = false;
+  }
+}
@@ -2,13 +2,13 @@
 library;
 
 import 'dart:convert';
-import 'dart:ffi';
 import 'dart:typed_data';
 
 import 'package:ffi/ffi.dart';
 
 import '../bindings/bindings.dart';
 import '../bindings/utils.dart';
+import 'packet_arena.dart';
 
 /// 源切换器
 ///
@@ -16,10 +16,14 @@ import '../bindings/utils.dart';
 class SourceSwitcher {
   final String roomId;
 
-  SourceSwitcher({required this.roomId});
+  /// 房间句柄和单包注入暂存区（注入时不再传房间 ID）
+  final PacketInjector _injector;
+
+  SourceSwitcher({required this.roomId}) : _injector = PacketInjector(roomId);
 
   /// 创建源切换器
   bool create() {
+    _releaseNative();
     final roomPtr = toCString(roomId);
     final result = bindings.SourceSwitcherCreate(roomPtr);
     calloc.free(roomPtr);
@@ -28,44 +32,35 @@ class SourceSwitcher {
 
   /// 销毁源切换器
   bool destroy() {
+    _releaseNative();
     final roomPtr = toCString(roomId);
     final result = bindings.SourceSwitcherDestroy(roomPtr);
     calloc.free(roomPtr);
     return result == 0;
   }
 
-  /// 注入 SFU RTP 包
+  /// 房间句柄，首次使用时打开
+  int get handle => _injector.handle;
+
+  void _releaseNative() => _injector.release();
+
+  /// 注入 SFU RTP 包（同一轮事件循环内的包合并为一次 FFI 调用）
   bool injectSfuPacket(bool isVideo, Uint8List data) {
-    final roomPtr = toCString(roomId);
-    final dataPtr = calloc<Uint8>(data.length);
-    dataPtr.asTypedList(data.length).setAll(0, data);
-    final result = bindings.SourceSwitcherInjectSFU(
-      roomPtr,
-      isVideo ? 1 : 0,
-      dataPtr.cast(),
-      data.length,
-    );
-    calloc.free(roomPtr);
-    calloc.free(dataPtr);
-    return result == 0;
+    return _injector.add(isVideo, false, data);
   }
 
-  /// 注入本地 RTP 包
+  /// 注入本地 RTP 包（同一轮事件循环内的包合并为一次 FFI 调用）
   bool injectLocalPacket(bool isVideo, Uint8List data) {
-    final roomPtr = toCString(roomId);
-    final dataPtr = calloc<Uint8>(data.length);
-    dataPtr.asTypedList(data.length).setAll(0, data);
-    final result = bindings.SourceSwitcherInjectLocal(
-      roomPtr,
-      isVideo ? 1 : 0,
-      dataPtr.cast(),
-      data.length,
-    );
-    calloc.free(roomPtr);
-    calloc.free(dataPtr);
-    return result == 0;
+    return _injector.add(isVideo, true, data);
   }
 
+  /// 立即注入尚未注入的单包，返回注入的包数，失败返回 -1
+  int flush() => _injector.flush();
+
+  /// 批量注入：先用 [PacketArena.add] 写入一批包，再一次性注入
+  /// 返回成功注入的包数，失败返回 -1
+  int injectBatch(PacketArena arena) => _injector.inject(arena);
+
   /// 开始本地分享
   bool startLocalShare(String sharerId) {
     final roomPtr = toCString(roomId);
@@ -11,6 +11,19 @@ import 'package:ffi/ffi.dart';
 
 import '../bindings/bindings.dart';
 import '../bindings/utils.dart';
+import '../enums.dart';
+
+// librelay.h 重新生成前，新导出函数直接按符号查找
+final _setSubscriberVideoMode = dylib
+    .lookupFunction<
+      Int Function(Pointer<Char>, Pointer<Char>, Int),
+      int Function(Pointer<Char>, Pointer<Char>, int)
+    >('RelayRoomSetSubscriberVideoMode');
+final _createLAN = dylib
+    .lookupFunction<
+      Int Function(Pointer<Char>, Int),
+      int Function(Pointer<Char>, int)
+    >('RelayRoomCreateLAN');
 
 /// RelayRoom P2P 管理器
 ///
@@ -58,6 +71,19 @@ class RelayRoomP2P {
     }
   }
 
+  /// 以局域网模式创建 Relay 房间
+  ///
+  /// Relay 作为 ICE-lite 端，只收集 host 候选，不使用 STUN/TURN，ICE 超时按局域网调短。
+  /// [mdns] 为 true 时收集 mDNS 候选（隐藏本机 IP，订阅者需要能解析 .local 地址）
+  bool createLAN({bool mdns = false}) {
+    final roomPtr = toCString(roomId);
+    try {
+      return _createLAN(roomPtr, mdns ? 1 : 0) == 0;
+    } finally {
+      calloc.free(roomPtr);
+    }
+  }
+
   /// 销毁房间
   bool destroy() {
     final roomPtr = toCString(roomId);
@@ -136,6 +162,22 @@ class RelayRoomP2P {
     }
   }
 
+  /// 设置订阅者视频模式
+  ///
+  /// 订阅者应用切后台或视频不可见时设为 [SubscriberVideoMode.paused]，
+  /// Relay 停止向其转发视频（音频照常），恢复时立即请求关键帧，无需重协商。
+  /// [SubscriberVideoMode.thumbnail] 参与 LiveKit 上游 simulcast 层选择。
+  bool setSubscriberVideoMode(String peerId, SubscriberVideoMode mode) {
+    final roomPtr = toCString(roomId);
+    final peerPtr = toCString(peerId);
+    try {
+      return _setSubscriberVideoMode(roomPtr, peerPtr, mode.value) == 0;
+    } finally {
+      calloc.free(roomPtr);
+      calloc.free(peerPtr);
+    }
+  }
+
   /// 获取订阅者列表
   List<String> getSubscribers() {
     final roomPtr = toCString(roomId);
@@ -3,3 +3,4 @@ library;
 
 export 'relay_room.dart';
 export 'relay_room_p2p.dart';
+export 'subscriber_fallback.dart';
@@ -0,0 +1,148 @@
+/// 订阅者双路接收
+///
+/// 经局域网 Relay 接收的同时保留一路直连 SFU 的备用订阅（只拉 LOW 层），
+/// Relay 媒体停顿时立即切到直连路径，新 Relay 恢复后再切回。
+library;
+
+import 'dart:convert';
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+import '../bindings/bindings.dart';
+import '../bindings/utils.dart';
+import 'relay_room_p2p.dart';
+
+// librelay.h 重新生成前，新导出函数直接按符号查找
+final _create = dylib
+    .lookupFunction<
+      Int Function(Pointer<Char>, Pointer<Char>),
+      int Function(Pointer<Char>, Pointer<Char>)
+    >('SubscriberFallbackCreate');
+final _connect = dylib
+    .lookupFunction<
+      Int Function(Pointer<Char>, Pointer<Char>, Pointer<Char>),
+      int Function(Pointer<Char>, Pointer<Char>, Pointer<Char>)
+    >('SubscriberFallbackConnect');
+final _reportRelay = dylib
+    .lookupFunction<
+      Int Function(Pointer<Char>, Uint64),
+      int Function(Pointer<Char>, int)
+    >('SubscriberFallbackReportRelay');
+final _relayLost = dylib
+    .lookupFunction<
+      Int Function(Pointer<Char>, Pointer<Char>),
+      int Function(Pointer<Char>, Pointer<Char>)
+    >('SubscriberFallbackRelayLost');
+final _getStatus = dylib
+    .lookupFunction<
+      Pointer<Char> Function(Pointer<Char>),
+      Pointer<Char> Function(Pointer<Char>)
+    >('SubscriberFallbackGetStatus');
+final _destroy = dylib
+    .lookupFunction<
+      Int Function(Pointer<Char>),
+      int Function(Pointer<Char>)
+    >('SubscriberFallbackDestroy');
+
+/// 订阅者双路接收
+///
+/// 直连路径的媒体经本机回环 RelayRoom（[loopbackRoom]）交给 flutter_webrtc 渲染，
+/// 切换由 [SfuEventType.fallbackPath] 事件通知（data.path: relay/direct）。
+///
+/// ```dart
+/// final fallback = SubscriberFallback('room-1');
+/// fallback.create('my-peer-id');
+/// fallback.connect(livekitUrl, subscribeOnlyToken);
+///
+/// // 本机以任意订阅者 ID 向回环房间发 Offer
+/// final answer = fallback.loopbackRoom.addSubscriber('local', offerSdp);
+///
+/// // 每帧间隔上报 Relay 连接 inbound-rtp 的 packetsReceived
+/// fallback.reportRelay(packetsReceived);
+///
+/// // 控制通道关闭或收到移交通知时
+/// fallback.relayLost('handoff');
+/// ```
+class SubscriberFallback {
+  final String roomId;
+
+  SubscriberFallback(this.roomId);
+
+  /// 直连路径的回环 RelayRoom
+  RelayRoomP2P get loopbackRoom => RelayRoomP2P('$roomId/fallback');
+
+  /// 创建双路接收（同时创建回环 RelayRoom，本机为其 Relay）
+  bool create(String localPeerId) {
+    final roomPtr = toCString(roomId);
+    final peerPtr = toCString(localPeerId);
+    try {
+      return _create(roomPtr, peerPtr) == 0;
+    } finally {
+      calloc.free(roomPtr);
+      calloc.free(peerPtr);
+    }
+  }
+
+  /// 备用路径连接 LiveKit（异步）
+  bool connect(String url, String token) {
+    final roomPtr = toCString(roomId);
+    final urlPtr = toCString(url);
+    final tokenPtr = toCString(token);
+    try {
+      return _connect(roomPtr, urlPtr, tokenPtr) == 0;
+    } finally {
+      calloc.free(roomPtr);
+      calloc.free(urlPtr);
+      calloc.free(tokenPtr);
+    }
+  }
+
+  /// 上报 Relay 路径累计收到的包数
+  bool reportRelay(int packetsReceived) {
+    final roomPtr = toCString(roomId);
+    try {
+      return _reportRelay(roomPtr, packetsReceived) == 0;
+    } finally {
+      calloc.free(roomPtr);
+    }
+  }
+
+  /// Relay 连接断开，立即切到直连
+  bool relayLost(String reason) {
+    final roomPtr = toCString(roomId);
+    final reasonPtr = toCString(reason);
+    try {
+      return _relayLost(roomPtr, reasonPtr) == 0;
+    } finally {
+      calloc.free(roomPtr);
+      calloc.free(reasonPtr);
+    }
+  }
+
+  /// 获取状态
+  ///
+  /// 返回包含 path, switches, relay_packets, direct_ms, bridge 等信息的 Map
+  Map<String, dynamic>? getStatus() {
+    final roomPtr = toCString(roomId);
+    try {
+      final resultPtr = _getStatus(roomPtr);
+      if (resultPtr == nullptr) return null;
+      final json = fromCString(resultPtr);
+      if (json.isEmpty) return {};
+      return Map<String, dynamic>.from(jsonDecode(json));
+    } finally {
+      calloc.free(roomPtr);
+    }
+  }
+
+  /// 销毁（断开备用连接并关闭回环 RelayRoom）
+  bool destroy() {
+    final roomPtr = toCString(roomId);
+    try {
+      return _destroy(roomPtr) == 0;
+    } finally {
+      calloc.free(roomPtr);
+    }
+  }
+}
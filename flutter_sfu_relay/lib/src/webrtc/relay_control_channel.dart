@@ -0,0 +1,210 @@
+/// Relay 控制通道
+///
+/// 订阅者到 Relay 的 P2P 连接上的无序、不重传 DataChannel（label: relay-ctrl），
+/// 心跳、Relay 声明、关键帧请求、计划内移交通知不再经过信令服务器。
+/// 二进制格式与 Go 层 pkg/sfu/control_channel.go 保持一致（大端）。
+library;
+
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:flutter_webrtc/flutter_webrtc.dart';
+
+/// 控制消息类型
+enum RelayControlMessageType {
+  ping(1),
+  pong(2),
+  claim(3),
+  keyframeRequest(4),
+  handoff(5);
+
+  final int value;
+  const RelayControlMessageType(this.value);
+
+  static RelayControlMessageType? fromValue(int value) {
+    for (final type in values) {
+      if (type.value == value) return type;
+    }
+    return null;
+  }
+}
+
+/// 控制消息
+class RelayControlMessage {
+  static const int _version = 1;
+
+  final RelayControlMessageType type;
+
+  /// Ping / Pong
+  final int nonce;
+  final int timestamp;
+
+  /// Claim / Handoff（Handoff 的 epoch 为移交后的纪元号，peerId 为继任者）
+  final int epoch;
+  final double score;
+  final String peerId;
+
+  const RelayControlMessage({
+    required this.type,
+    this.nonce = 0,
+    this.timestamp = 0,
+    this.epoch = 0,
+    this.score = 0,
+    this.peerId = '',
+  });
+
+  /// 编码
+  Uint8List encode() {
+    final header = (_version << 4) | type.value;
+    switch (type) {
+      case RelayControlMessageType.ping:
+      case RelayControlMessageType.pong:
+        final data = ByteData(13)
+          ..setUint8(0, header)
+          ..setUint32(1, nonce)
+          ..setInt64(5, timestamp);
+        return data.buffer.asUint8List();
+      case RelayControlMessageType.claim:
+      case RelayControlMessageType.handoff:
+        var id = utf8.encode(peerId);
+        if (id.length > 255) id = id.sublist(0, 255);
+        final data = ByteData(18 + id.length)
+          ..setUint8(0, header)
+          ..setUint64(1, epoch)
+          ..setFloat64(9, score)
+          ..setUint8(17, id.length);
+        final bytes = data.buffer.asUint8List();
+        bytes.setRange(18, 18 + id.length, id);
+        return bytes;
+      case RelayControlMessageType.keyframeRequest:
+        return Uint8List.fromList([header]);
+    }
+  }
+
+  /// 解码，格式错误返回 null
+  static RelayControlMessage? decode(Uint8List bytes) {
+    if (bytes.isEmpty || bytes[0] >> 4 != _version) return null;
+    final type = RelayControlMessageType.fromValue(bytes[0] & 0x0f);
+    if (type == null) return null;
+
+    final data = ByteData.sublistView(bytes);
+    switch (type) {
+      case RelayControlMessageType.ping:
+      case RelayControlMessageType.pong:
+        if (bytes.length < 13) return null;
+        return RelayControlMessage(
+          type: type,
+          nonce: data.getUint32(1),
+          timestamp: data.getInt64(5),
+        );
+      case RelayControlMessageType.claim:
+      case RelayControlMessageType.handoff:
+        if (bytes.length < 18) return null;
+        final n = bytes[17];
+        if (bytes.length < 18 + n) return null;
+        return RelayControlMessage(
+          type: type,
+          epoch: data.getUint64(1),
+          score: data.getFloat64(9),
+          peerId: utf8.decode(
+            bytes.sublist(18, 18 + n),
+            allowMalformed: true,
+          ),
+        );
+      case RelayControlMessageType.keyframeRequest:
+        return RelayControlMessage(type: type);
+    }
+  }
+}
+
+/// 订阅者侧控制通道
+///
+/// 必须在 createOffer 之前创建，Relay 在 Answer 中接受该通道。
+/// 收到 Ping 自动回复 Pong，其余消息交给 [onMessage]。
+class RelayControlChannel {
+  static const String label = 'relay-ctrl';
+
+  final RTCDataChannel _channel;
+  int _nonce = 0;
+
+  /// 收到 Pong / Claim / Handoff
+  void Function(RelayControlMessage message)? onMessage;
+
+  RelayControlChannel._(this._channel) {
+    _channel.onMessage = _handleMessage;
+  }
+
+  /// 在 P2P 连接上创建控制通道
+  static Future<RelayControlChannel> create(RTCPeerConnection pc) async {
+    final init = RTCDataChannelInit()
+      ..ordered = false
+      ..maxRetransmits = 0;
+    final channel = await pc.createDataChannel(label, init);
+    return RelayControlChannel._(channel);
+  }
+
+  /// 通道是否可用
+  bool get isOpen =>
+      _channel.state == RTCDataChannelState.RTCDataChannelOpen;
+
+  void _handleMessage(RTCDataChannelMessage message) {
+    if (!message.isBinary) return;
+    final msg = RelayControlMessage.decode(message.binary);
+    if (msg == null) return;
+
+    if (msg.type == RelayControlMessageType.ping) {
+      // Relay 探测本机：原样回显
+      _send(
+        RelayControlMessage(
+          type: RelayControlMessageType.pong,
+          nonce: msg.nonce,
+          timestamp: msg.timestamp,
+        ),
+      );
+      return;
+    }
+    onMessage?.call(msg);
+  }
+
+  bool _send(RelayControlMessage message) {
+    if (!isOpen) return false;
+    _channel.send(RTCDataChannelMessage.fromBinary(message.encode()));
+    return true;
+  }
+
+  /// 发送 Ping（通道不可用时返回 false，调用方回退到信令）
+  bool sendPing() {
+    return _send(
+      RelayControlMessage(
+        type: RelayControlMessageType.ping,
+        nonce: ++_nonce & 0xffffffff,
+        timestamp: DateTime.now().microsecondsSinceEpoch * 1000,
+      ),
+    );
+  }
+
+  /// 向 Relay 发送 Relay 声明（计划内移交的继任者接管时通知旧 Relay）
+  bool sendClaim(int epoch, double score, String peerId) {
+    return _send(
+      RelayControlMessage(
+        type: RelayControlMessageType.claim,
+        epoch: epoch,
+        score: score,
+        peerId: peerId,
+      ),
+    );
+  }
+
+  /// 请求关键帧
+  bool requestKeyframe() {
+    return _send(
+      const RelayControlMessage(type: RelayControlMessageType.keyframeRequest),
+    );
+  }
+
+  /// 关闭通道
+  Future<void> close() async {
+    onMessage = null;
+    await _channel.close();
+  }
+}
@@ -4,3 +4,4 @@ library;
 export 'webrtc_manager.dart';
 export 'sdp_handler.dart';
 export 'rtp_forwarder.dart';
+export 'relay_control_channel.dart';
@@ -71,6 +71,7 @@ const (
 	EventTypePeerSlow    = 21 // Peer 响应缓慢
 	EventTypePeerOffline = 22 // Peer 离线
 	EventTypePing        = 23 // 需要发送 Ping
+	EventTypePingRound   = 25 // 一轮需要经信令发送的 Ping，data: {"seq":n,"peers":[...]}
 )
 
 // registerKeepaliveManager 注册 KeepaliveManager
@@ -53,7 +53,11 @@ func LiveKitBridgeCreate(roomID *C.char) C.int {
 	}
 
 	// 创建桥接器
-	sfu.CreateBridge(rid, switcher)
+	bridge := sfu.CreateBridge(rid, switcher)
+	if coord != nil {
+		// 设备过热 / 低电量时的上游质量上限
+		bridge.SetMaxUpstreamQuality(coord.DeviceThrottle().MaxUpstream)
+	}
 	return 0
 }
 
@@ -146,6 +150,45 @@ func LiveKitBridgeIsConnected(roomID *C.char) C.int {
 	return 0
 }
 
+// LiveKitBridgeReportSubscriber 上报局域网订阅者的视口尺寸和带宽估计
+// 桥接器据此选择向上游请求的视频质量（带迟滞，切层对齐关键帧）
+// width/height: 订阅者渲染视频的视口像素尺寸，0 表示未知
+// bandwidthBps: 订阅者的下行带宽估计，0 表示未知
+// 返回: 0 成功, -1 桥接器不存在
+//
+//export LiveKitBridgeReportSubscriber
+func LiveKitBridgeReportSubscriber(roomID, peerID *C.char, width, height C.int, bandwidthBps C.int64_t) C.int {
+	rid := C.GoString(roomID)
+
+	bridge := sfu.GetBridge(rid)
+	if bridge == nil {
+		return -1
+	}
+
+	bw := int64(bandwidthBps)
+	if bw < 0 {
+		bw = 0
+	}
+	bridge.UpdateSubscriberViewport(C.GoString(peerID), int(width), int(height), uint64(bw))
+	return 0
+}
+
+// LiveKitBridgeRemoveSubscriber 订阅者不再观看（离开或关闭视频）
+// 返回: 0 成功, -1 桥接器不存在
+//
+//export LiveKitBridgeRemoveSubscriber
+func LiveKitBridgeRemoveSubscriber(roomID, peerID *C.char) C.int {
+	rid := C.GoString(roomID)
+
+	bridge := sfu.GetBridge(rid)
+	if bridge == nil {
+		return -1
+	}
+
+	bridge.RemoveSubscriberViewport(C.GoString(peerID))
+	return 0
+}
+
 // ========================================
 // 辅助函数
 // ========================================
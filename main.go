@@ -89,6 +89,7 @@ import (
 	"unsafe"
 
 	"github.com/maiguangyang/relay_core/pkg/election"
+	"github.com/maiguangyang/relay_core/pkg/sfu"
 	"github.com/maiguangyang/relay_core/pkg/utils"
 )
 
@@ -264,9 +265,11 @@ func CleanupAll() {
 	// to allow any in-flight goroutines to complete their work
 	C.invalidateAllCallbacks()
 	clearPingCallback() // defined in keepalive_codec_ffi.go
+	eventQueue.Reset()  // defined in event_queue_ffi.go
 
 	// 3. Now safely clean up resources (no callbacks will fire)
 	cleanupAllElectors()
+	cleanupPacketArenas() // defined in packet_arena_ffi.go
 
 	// Note: We cannot log here because we disabled the callback.
 }
@@ -276,16 +279,21 @@ func GetVersion() *C.char {
 	return C.CString("1.0.0-relay")
 }
 
-// emitEvent sends an event through the callback
+// emitEvent queues an event for delivery (see event_queue_ffi.go for backpressure)
+func emitEvent(eventType int, roomID, peerID, data string) {
+	eventQueue.Push(sfu.QueuedEvent{Type: eventType, RoomID: roomID, PeerID: peerID, Data: data})
+}
+
+// deliverEvent sends an event through the callback
 // IMPORTANT: Since Dart uses NativeCallable.listener (async), we transfer memory
 // ownership to Dart. Dart is responsible for calling FreeString() on these pointers.
-func emitEvent(eventType int, roomID, peerID, data string) {
-	cRoomID := C.CString(roomID)
-	cPeerID := C.CString(peerID)
-	cData := C.CString(data)
+func deliverEvent(ev sfu.QueuedEvent) {
+	cRoomID := C.CString(ev.RoomID)
+	cPeerID := C.CString(ev.PeerID)
+	cData := C.CString(ev.Data)
 
 	// Do NOT free here - Dart owns this memory now and will call FreeString()
-	C.callEventCallback(C.int(eventType), cRoomID, cPeerID, cData)
+	C.callEventCallback(C.int(ev.Type), cRoomID, cPeerID, cData)
 }
 
 // main is required but not used for c-shared library
@@ -0,0 +1,194 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Packet Arena FFI Exports
+ * 长期存在的原生暂存区 + 句柄化的房间引用，用于 Dart 高频注入 RTP 包
+ * Dart 直接把包写进暂存区（bump 指针顺序追加），一次调用注入整批，
+ * Go 侧直接读取暂存区内存，不再 GoBytes 拷贝；房间 ID 只在打开句柄时转换一次。
+ * 同一个暂存区只能由一个 isolate 使用。
+ * 房间句柄记录打开时的切换器代数，房间的切换器重建后旧句柄注入返回 -2，调用方重新打开即可。
+ */
+package main
+
+/*
+#include <stdlib.h>
+*/
+import "C"
+
+import (
+	"sync"
+	"sync/atomic"
+	"unsafe"
+
+	"github.com/maiguangyang/relay_core/pkg/sfu"
+	"github.com/maiguangyang/relay_core/pkg/utils"
+)
+
+// maxPacketArenaSize 单个暂存区上限
+const maxPacketArenaSize = 16 << 20
+
+// staleSwitcherHandle 句柄对应的切换器已销毁或重建（需要重新打开句柄）
+const staleSwitcherHandle = -2
+
+// packetArena C 内存暂存区（不受 Go GC 移动影响，Dart 可以直接写）
+type packetArena struct {
+	base unsafe.Pointer
+	size int
+}
+
+// switcherHandle 房间句柄：打开时的切换器及其代数
+type switcherHandle struct {
+	ss         *sfu.SourceSwitcher
+	generation uint32
+	current    *atomic.Uint32 // 房间当前代数
+}
+
+var (
+	packetArenas        sync.Map // handle -> *packetArena
+	switcherHandles     sync.Map // handle -> *switcherHandle
+	switcherGenerations sync.Map // roomID -> *atomic.Uint32
+	nextNativeHandle    atomic.Int32
+)
+
+// switcherGeneration 获取房间的切换器代数
+func switcherGeneration(roomID string) *atomic.Uint32 {
+	v, _ := switcherGenerations.LoadOrStore(roomID, new(atomic.Uint32))
+	return v.(*atomic.Uint32)
+}
+
+// bumpSwitcherGeneration 房间的切换器创建/销毁时调用，使已打开的句柄失效
+func bumpSwitcherGeneration(roomID string) {
+	switcherGeneration(roomID).Add(1)
+}
+
+func newNativeHandle() C.int {
+	return C.int(nextNativeHandle.Add(1))
+}
+
+// ==========================================
+// 暂存区
+// ==========================================
+
+// PacketArenaCreate 创建暂存区
+// 返回句柄（>0），失败返回 -1
+//
+//export PacketArenaCreate
+func PacketArenaCreate(capacity C.int) C.int {
+	size := int(capacity)
+	if size < sfu.InjectRecordHeaderSize || size > maxPacketArenaSize {
+		return C.int(-1)
+	}
+	base := C.malloc(C.size_t(size))
+	if base == nil {
+		return C.int(-1)
+	}
+
+	handle := newNativeHandle()
+	packetArenas.Store(handle, &packetArena{base: base, size: size})
+	return handle
+}
+
+// PacketArenaGetBuffer 获取暂存区内存地址（生命周期与句柄相同）
+//
+//export PacketArenaGetBuffer
+func PacketArenaGetBuffer(arena C.int) unsafe.Pointer {
+	if v, ok := packetArenas.Load(arena); ok {
+		return v.(*packetArena).base
+	}
+	return nil
+}
+
+// PacketArenaDestroy 释放暂存区
+//
+//export PacketArenaDestroy
+func PacketArenaDestroy(arena C.int) C.int {
+	v, ok := packetArenas.LoadAndDelete(arena)
+	if !ok {
+		return C.int(-1)
+	}
+	C.free(v.(*packetArena).base)
+	return C.int(0)
+}
+
+// ==========================================
+// 房间句柄
+// ==========================================
+
+// SourceSwitcherOpenHandle 获取房间 SourceSwitcher 的句柄（后续注入不再传房间 ID）
+// 返回句柄（>0），房间不存在返回 -1
+//
+//export SourceSwitcherOpenHandle
+func SourceSwitcherOpenHandle(roomID *C.char) C.int {
+	goRoomID := C.GoString(roomID)
+	// 先取代数再解析：两者之间发生重建时句柄会被判为过期，不会指向旧切换器
+	current := switcherGeneration(goRoomID)
+	generation := current.Load()
+	ss := resolveSourceSwitcher(goRoomID)
+	if ss == nil {
+		return C.int(-1)
+	}
+	handle := newNativeHandle()
+	switcherHandles.Store(handle, &switcherHandle{ss: ss, generation: generation, current: current})
+	return handle
+}
+
+// SourceSwitcherCloseHandle 关闭句柄（不会销毁 SourceSwitcher）
+//
+//export SourceSwitcherCloseHandle
+func SourceSwitcherCloseHandle(handle C.int) C.int {
+	if _, ok := switcherHandles.LoadAndDelete(handle); !ok {
+		return C.int(-1)
+	}
+	return C.int(0)
+}
+
+// SourceSwitcherInjectArena 注入暂存区中 [0, used) 范围内的记录
+// 记录格式见 pkg/sfu/inject_batch.go
+// 返回成功注入的包数；句柄对应的切换器已重建返回 -2（句柄同时关闭，暂存区内容未消费）；
+// 句柄无效、记录格式错误或切换器已关闭时返回 -1
+//
+//export SourceSwitcherInjectArena
+func SourceSwitcherInjectArena(handle C.int, arena C.int, used C.int) C.int {
+	v, ok := switcherHandles.Load(handle)
+	if !ok {
+		return C.int(-1)
+	}
+	h := v.(*switcherHandle)
+	if h.current.Load() != h.generation {
+		switcherHandles.Delete(handle)
+		return C.int(staleSwitcherHandle)
+	}
+
+	a, ok := packetArenas.Load(arena)
+	if !ok {
+		return C.int(-1)
+	}
+	pa := a.(*packetArena)
+	if used <= 0 || int(used) > pa.size {
+		return C.int(-1)
+	}
+
+	// 直接引用 C 内存：InjectBatch 返回后不再持有
+	data := unsafe.Slice((*byte)(pa.base), int(used))
+	injected, err := h.ss.InjectBatch(data)
+	if err != nil {
+		utils.Warn("InjectArena stopped after %d packets: %v", injected, err)
+		return C.int(-1)
+	}
+	return C.int(injected)
+}
+
+// cleanupPacketArenas 释放所有暂存区和句柄 - 应用关闭时调用
+func cleanupPacketArenas() {
+	packetArenas.Range(func(key, value interface{}) bool {
+		C.free(value.(*packetArena).base)
+		packetArenas.Delete(key)
+		return true
+	})
+	switcherHandles.Range(func(key, _ interface{}) bool {
+		switcherHandles.Delete(key)
+		return true
+	})
+}
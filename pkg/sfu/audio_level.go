@@ -0,0 +1,356 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * AudioLevelObserver - 活跃发言者检测
+ * 解析 RFC 6464 音量扩展头（ssrc-audio-level），按上游音频 SSRC 统计滑动窗口能量，
+ * 只转发最响的 N 路音频，并在发言者变化时通知上层。
+ *
+ * 能量按 (127 - level) 累加到固定数量的时间桶里，排名按固定间隔重算，
+ * 包路径上只有 map 查找和几次整数运算。
+ */
+package sfu
+
+import (
+	"sort"
+	"sync"
+	"time"
+)
+
+const (
+	// AudioLevelExtensionURI RFC 6464 扩展头 URI
+	AudioLevelExtensionURI = "urn:ietf:params:rtp-hdrext:ssrc-audio-level"
+
+	// audioLevelBuckets 滑动窗口时间桶数量
+	audioLevelBuckets = 10
+	// audioLevelSilent RFC 6464 最小音量 (-127 dBov)
+	audioLevelSilent = 127
+)
+
+// AudioLevelConfig 活跃发言者检测配置
+type AudioLevelConfig struct {
+	Enabled bool
+
+	// ExtensionID 音量扩展头 ID（以上游协商结果为准，可通过 SetExtensionID 更新）
+	// 0 表示上游没有协商音量扩展头，不解析（避免把 mid / abs-send-time 等误当作音量）
+	ExtensionID uint8
+
+	// MaxForwarded 最多转发的音频流数量（<=0 表示全部转发，只做检测）
+	MaxForwarded int
+
+	// Window 能量统计的滑动窗口
+	Window time.Duration
+	// RankInterval 重新排名的间隔
+	RankInterval time.Duration
+
+	// SpeechLevel 音量不低于该值（-dBov 小于等于）才计为发言
+	SpeechLevel uint8
+	// SwitchRatio 挑战者能量超过当前发言者的倍数才切换（防止来回抖动）
+	SwitchRatio float64
+
+	// StaleTimeout 超过该时间没有包的流会被移除
+	StaleTimeout time.Duration
+}
+
+// DefaultAudioLevelConfig 默认配置
+// 订阅者只有一条音频轨道，多路 SSRC 交错写入会破坏接收端抖动缓冲，因此默认只转发主发言者
+func DefaultAudioLevelConfig() AudioLevelConfig {
+	return AudioLevelConfig{
+		Enabled:      true,
+		ExtensionID:  0,
+		MaxForwarded: 1,
+		Window:       time.Second,
+		RankInterval: 200 * time.Millisecond,
+		SpeechLevel:  60,
+		SwitchRatio:  1.5,
+		StaleTimeout: 2 * time.Second,
+	}
+}
+
+// ActiveSpeaker 活跃发言者
+type ActiveSpeaker struct {
+	SSRC          uint32  `json:"ssrc"`
+	ParticipantID string  `json:"participant_id,omitempty"`
+	Energy        float64 `json:"energy"` // 窗口内平均能量（每秒）
+}
+
+// AudioLevelStats 检测统计
+type AudioLevelStats struct {
+	Streams        int             `json:"streams"`
+	ActiveSpeakers []ActiveSpeaker `json:"active_speakers"`
+	Forwarded      uint64          `json:"forwarded"`
+	Dropped        uint64          `json:"dropped"`
+}
+
+// audioLevelStream 单个上游音频流的能量窗口
+type audioLevelStream struct {
+	ssrc          uint32
+	participantID string
+
+	hasLevel    bool // 是否收到过音量扩展头（没有的流无法判断，总是转发）
+	buckets     [audioLevelBuckets]uint32
+	bucketIdx   int
+	bucketStart time.Time
+	lastSeen    time.Time
+
+	energy float64
+}
+
+// advance 把窗口推进到 now，过期的桶清零
+func (s *audioLevelStream) advance(now time.Time, bucketDur time.Duration) {
+	steps := int(now.Sub(s.bucketStart) / bucketDur)
+	if steps <= 0 {
+		return
+	}
+	if steps >= audioLevelBuckets {
+		s.buckets = [audioLevelBuckets]uint32{}
+		s.bucketStart = now
+		return
+	}
+	for i := 0; i < steps; i++ {
+		s.bucketIdx = (s.bucketIdx + 1) % audioLevelBuckets
+		s.buckets[s.bucketIdx] = 0
+	}
+	s.bucketStart = s.bucketStart.Add(time.Duration(steps) * bucketDur)
+}
+
+// AudioLevelObserver 活跃发言者检测与音频流选择
+type AudioLevelObserver struct {
+	mu sync.RWMutex
+
+	config    AudioLevelConfig
+	bucketDur time.Duration
+
+	streams      map[uint32]*audioLevelStream
+	participants map[uint32]string // SSRC -> 参与者 ID（由桥接层注册）
+
+	// 当前选中转发的流（按能量降序）
+	speakers []ActiveSpeaker
+	selected map[uint32]bool
+	lastRank time.Time
+
+	forwarded uint64
+	dropped   uint64
+
+	onSpeakersChanged func(speakers []ActiveSpeaker)
+}
+
+// NewAudioLevelObserver 创建检测器
+func NewAudioLevelObserver(config AudioLevelConfig) *AudioLevelObserver {
+	if config.Window <= 0 {
+		config.Window = time.Second
+	}
+	if config.SwitchRatio < 1 {
+		config.SwitchRatio = 1
+	}
+	return &AudioLevelObserver{
+		config:       config,
+		bucketDur:    config.Window / audioLevelBuckets,
+		streams:      make(map[uint32]*audioLevelStream),
+		participants: make(map[uint32]string),
+		selected:     make(map[uint32]bool),
+	}
+}
+
+// SetOnSpeakersChanged 设置发言者变化回调（在包路径上同步调用，回调内不要阻塞）
+func (o *AudioLevelObserver) SetOnSpeakersChanged(fn func(speakers []ActiveSpeaker)) {
+	o.mu.Lock()
+	defer o.mu.Unlock()
+	o.onSpeakersChanged = fn
+}
+
+// ExtensionID 当前音量扩展头 ID
+func (o *AudioLevelObserver) ExtensionID() uint8 {
+	o.mu.RLock()
+	defer o.mu.RUnlock()
+	return o.config.ExtensionID
+}
+
+// SetExtensionID 更新音量扩展头 ID（上游协商结果）
+func (o *AudioLevelObserver) SetExtensionID(id uint8) {
+	o.mu.Lock()
+	defer o.mu.Unlock()
+	o.config.ExtensionID = id
+}
+
+// RegisterSource 关联 SSRC 和参与者 ID
+func (o *AudioLevelObserver) RegisterSource(ssrc uint32, participantID string) {
+	o.mu.Lock()
+	defer o.mu.Unlock()
+	o.participants[ssrc] = participantID
+	if s, ok := o.streams[ssrc]; ok {
+		s.participantID = participantID
+	}
+}
+
+// UnregisterSource 上游轨道取消订阅
+func (o *AudioLevelObserver) UnregisterSource(ssrc uint32) {
+	o.mu.Lock()
+	defer o.mu.Unlock()
+	delete(o.participants, ssrc)
+	delete(o.streams, ssrc)
+	delete(o.selected, ssrc)
+}
+
+// parseAudioLevel 解析 RFC 6464 一字节扩展：V(1) | level(7)
+func parseAudioLevel(ext []byte) (level uint8, ok bool) {
+	if len(ext) < 1 {
+		return 0, false
+	}
+	return ext[0] & 0x7f, true
+}
+
+// Observe 记录一个音频包，返回是否应该转发
+// ext: 音量扩展头内容（没有时传 nil）
+func (o *AudioLevelObserver) Observe(ssrc uint32, ext []byte, now time.Time) bool {
+	var (
+		changed  bool
+		speakers []ActiveSpeaker
+		fn       func([]ActiveSpeaker)
+	)
+
+	o.mu.Lock()
+	if !o.config.Enabled {
+		o.mu.Unlock()
+		return true
+	}
+
+	s, known := o.streams[ssrc]
+	if !known {
+		s = &audioLevelStream{
+			ssrc:          ssrc,
+			participantID: o.participants[ssrc],
+			bucketStart:   now,
+		}
+		o.streams[ssrc] = s
+	}
+	s.lastSeen = now
+	s.advance(now, o.bucketDur)
+
+	if level, ok := parseAudioLevel(ext); ok {
+		s.hasLevel = true
+		if level <= o.config.SpeechLevel {
+			s.buckets[s.bucketIdx] += uint32(audioLevelSilent - level)
+		}
+	}
+
+	// 新流加入或到达排名间隔时重新排名
+	if !known || now.Sub(o.lastRank) >= o.config.RankInterval {
+		changed = o.rank(now)
+		if changed {
+			speakers = append([]ActiveSpeaker(nil), o.speakers...)
+			fn = o.onSpeakersChanged
+		}
+	}
+
+	forward := o.config.MaxForwarded <= 0 || !s.hasLevel || o.selected[ssrc]
+	if forward {
+		o.forwarded++
+	} else {
+		o.dropped++
+	}
+	o.mu.Unlock()
+
+	if changed && fn != nil {
+		fn(speakers)
+	}
+	return forward
+}
+
+// rank 重新计算选中的流，返回发言者列表是否变化（调用方持有锁）
+func (o *AudioLevelObserver) rank(now time.Time) bool {
+	o.lastRank = now
+	windowSec := o.config.Window.Seconds()
+
+	candidates := make([]*audioLevelStream, 0, len(o.streams))
+	for ssrc, s := range o.streams {
+		if now.Sub(s.lastSeen) > o.config.StaleTimeout {
+			delete(o.streams, ssrc)
+			continue
+		}
+		s.advance(now, o.bucketDur)
+		var sum uint32
+		for _, e := range s.buckets {
+			sum += e
+		}
+		s.energy = float64(sum) / windowSec
+		if s.hasLevel {
+			candidates = append(candidates, s)
+		}
+	}
+	sort.Slice(candidates, func(i, j int) bool {
+		if candidates[i].energy != candidates[j].energy {
+			return candidates[i].energy > candidates[j].energy
+		}
+		return candidates[i].ssrc < candidates[j].ssrc
+	})
+
+	n := o.config.MaxForwarded
+	if n <= 0 || n > len(candidates) {
+		n = len(candidates)
+	}
+	next := append([]*audioLevelStream(nil), candidates[:n]...)
+
+	// 迟滞：被挤出的现任发言者只在挑战者明显更响时才让位，全场静音时保持不变
+	for _, incumbent := range candidates[n:] {
+		if !o.selected[incumbent.ssrc] {
+			continue
+		}
+		weakest := -1
+		for i := len(next) - 1; i >= 0; i-- {
+			if !o.selected[next[i].ssrc] {
+				weakest = i
+				break
+			}
+		}
+		if weakest < 0 {
+			continue
+		}
+		if next[weakest].energy <= incumbent.energy*o.config.SwitchRatio {
+			next[weakest] = incumbent
+		}
+	}
+	sort.SliceStable(next, func(i, j int) bool { return next[i].energy > next[j].energy })
+
+	changed := len(next) != len(o.selected)
+	for _, s := range next {
+		if !o.selected[s.ssrc] {
+			changed = true
+		}
+	}
+	if !changed && len(next) > 0 && len(o.speakers) > 0 && o.speakers[0].SSRC != next[0].ssrc {
+		changed = true // 主发言者变化
+	}
+
+	clear(o.selected)
+	o.speakers = o.speakers[:0]
+	for _, s := range next {
+		o.selected[s.ssrc] = true
+		o.speakers = append(o.speakers, ActiveSpeaker{
+			SSRC:          s.ssrc,
+			ParticipantID: s.participantID,
+			Energy:        s.energy,
+		})
+	}
+	return changed
+}
+
+// ActiveSpeakers 当前选中的发言者（按能量降序）
+func (o *AudioLevelObserver) ActiveSpeakers() []ActiveSpeaker {
+	o.mu.RLock()
+	defer o.mu.RUnlock()
+	return append([]ActiveSpeaker(nil), o.speakers...)
+}
+
+// GetStats 获取统计
+func (o *AudioLevelObserver) GetStats() AudioLevelStats {
+	o.mu.RLock()
+	defer o.mu.RUnlock()
+	return AudioLevelStats{
+		Streams:        len(o.streams),
+		ActiveSpeakers: append([]ActiveSpeaker{}, o.speakers...),
+		Forwarded:      o.forwarded,
+		Dropped:        o.dropped,
+	}
+}
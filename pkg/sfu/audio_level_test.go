@@ -0,0 +1,232 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * AudioLevelObserver Tests
+ */
+package sfu
+
+import (
+	"testing"
+	"time"
+
+	"github.com/pion/rtp"
+)
+
+// levelExt 构造 RFC 6464 扩展内容
+func levelExt(level uint8) []byte {
+	return []byte{0x80 | level}
+}
+
+// feedAudio 模拟 20ms 间隔的音频包，返回每个 SSRC 被转发的包数
+func feedAudio(o *AudioLevelObserver, start time.Time, d time.Duration, levels map[uint32]uint8) (time.Time, map[uint32]int) {
+	forwarded := make(map[uint32]int)
+	now := start
+	for end := start.Add(d); now.Before(end); now = now.Add(20 * time.Millisecond) {
+		for ssrc, level := range levels {
+			if o.Observe(ssrc, levelExt(level), now) {
+				forwarded[ssrc]++
+			}
+		}
+	}
+	return now, forwarded
+}
+
+func TestParseAudioLevel(t *testing.T) {
+	if level, ok := parseAudioLevel([]byte{0x80 | 42}); !ok || level != 42 {
+		t.Errorf("Unexpected level %d ok=%v", level, ok)
+	}
+	if _, ok := parseAudioLevel(nil); ok {
+		t.Error("Expected missing extension to be reported")
+	}
+}
+
+func TestAudioLevelObserverSelectsLoudest(t *testing.T) {
+	o := NewAudioLevelObserver(DefaultAudioLevelConfig())
+	o.RegisterSource(1, "alice")
+	o.RegisterSource(2, "bob")
+
+	var events [][]ActiveSpeaker
+	o.SetOnSpeakersChanged(func(speakers []ActiveSpeaker) {
+		events = append(events, speakers)
+	})
+
+	// alice 说话，bob 静音
+	now, fwd := feedAudio(o, time.Unix(0, 0), 2*time.Second, map[uint32]uint8{1: 30, 2: 127})
+	if fwd[2] > 1 {
+		t.Errorf("Silent stream forwarded %d packets", fwd[2])
+	}
+	if speakers := o.ActiveSpeakers(); len(speakers) != 1 || speakers[0].ParticipantID != "alice" {
+		t.Fatalf("Expected alice as active speaker, got %+v", speakers)
+	}
+
+	// bob 开始大声说话，alice 静音
+	_, fwd = feedAudio(o, now, 2*time.Second, map[uint32]uint8{1: 127, 2: 20})
+	if speakers := o.ActiveSpeakers(); len(speakers) != 1 || speakers[0].ParticipantID != "bob" {
+		t.Fatalf("Expected bob as active speaker, got %+v", speakers)
+	}
+	if fwd[2] == 0 {
+		t.Error("Expected bob's audio to be forwarded after switching")
+	}
+	if len(events) == 0 || events[len(events)-1][0].ParticipantID != "bob" {
+		t.Errorf("Expected speaker change event for bob, got %+v", events)
+	}
+
+	stats := o.GetStats()
+	if stats.Streams != 2 || stats.Dropped == 0 {
+		t.Errorf("Unexpected stats: %+v", stats)
+	}
+}
+
+func TestAudioLevelObserverHysteresis(t *testing.T) {
+	o := NewAudioLevelObserver(DefaultAudioLevelConfig())
+
+	now, _ := feedAudio(o, time.Unix(0, 0), time.Second, map[uint32]uint8{1: 40, 2: 127})
+	if speakers := o.ActiveSpeakers(); len(speakers) != 1 || speakers[0].SSRC != 1 {
+		t.Fatalf("Expected SSRC 1, got %+v", speakers)
+	}
+
+	// 挑战者只是略响一点，不切换
+	now, _ = feedAudio(o, now, 2*time.Second, map[uint32]uint8{1: 40, 2: 35})
+	if speakers := o.ActiveSpeakers(); speakers[0].SSRC != 1 {
+		t.Errorf("Expected incumbent to be kept, got %+v", speakers)
+	}
+
+	// 全场静音时保持当前发言者
+	feedAudio(o, now, 2*time.Second, map[uint32]uint8{1: 127, 2: 127})
+	if speakers := o.ActiveSpeakers(); speakers[0].SSRC != 1 {
+		t.Errorf("Expected speaker to be kept during silence, got %+v", speakers)
+	}
+}
+
+func TestAudioLevelObserverForwardsUnknownStreams(t *testing.T) {
+	o := NewAudioLevelObserver(DefaultAudioLevelConfig())
+	now := time.Unix(0, 0)
+
+	// 没有音量扩展头的流无法判断，总是转发
+	for i := 0; i < 50; i++ {
+		o.Observe(1, levelExt(20), now)
+		if !o.Observe(2, nil, now) {
+			t.Fatal("Stream without audio level must be forwarded")
+		}
+		now = now.Add(20 * time.Millisecond)
+	}
+}
+
+func TestAudioLevelObserverStaleStreams(t *testing.T) {
+	o := NewAudioLevelObserver(DefaultAudioLevelConfig())
+	now, _ := feedAudio(o, time.Unix(0, 0), time.Second, map[uint32]uint8{1: 20, 2: 127})
+
+	// SSRC 1 停止发送，超时后 SSRC 2 接替
+	feedAudio(o, now, 3*time.Second, map[uint32]uint8{2: 50})
+	if speakers := o.ActiveSpeakers(); len(speakers) != 1 || speakers[0].SSRC != 2 {
+		t.Errorf("Expected SSRC 2 after SSRC 1 went stale, got %+v", speakers)
+	}
+	if o.GetStats().Streams != 1 {
+		t.Errorf("Expected stale stream to be removed")
+	}
+}
+
+func TestAudioLevelObserverDisabled(t *testing.T) {
+	config := DefaultAudioLevelConfig()
+	config.Enabled = false
+	o := NewAudioLevelObserver(config)
+
+	_, fwd := feedAudio(o, time.Unix(0, 0), time.Second, map[uint32]uint8{1: 20, 2: 127})
+	if fwd[1] != 50 || fwd[2] != 50 {
+		t.Errorf("Expected all packets forwarded when disabled, got %v", fwd)
+	}
+}
+
+func TestSourceSwitcherForwardsActiveSpeaker(t *testing.T) {
+	switcher, err := NewSourceSwitcher("test-room")
+	if err != nil {
+		t.Fatalf("Failed to create SourceSwitcher: %v", err)
+	}
+	defer switcher.Close()
+	switcher.GetAudioLevelObserver().SetExtensionID(1) // 上游协商的音量扩展头 ID
+
+	packet := func(ssrc uint32, seq uint16, level uint8) []byte {
+		pkt := &rtp.Packet{
+			Header: rtp.Header{
+				Version:        2,
+				PayloadType:    111,
+				SequenceNumber: seq,
+				Timestamp:      uint32(seq) * 960,
+				SSRC:           ssrc,
+			},
+			Payload: make([]byte, 80),
+		}
+		pkt.Header.SetExtension(1, []byte{level})
+		data, _ := pkt.Marshal()
+		return data
+	}
+
+	for i := 0; i < 100; i++ {
+		switcher.InjectSFUPacket(false, packet(1, uint16(i), 25))
+		switcher.InjectSFUPacket(false, packet(2, uint16(1000+i), 127))
+	}
+
+	stats := switcher.GetStatus().AudioLevels
+	if len(stats.ActiveSpeakers) != 1 || stats.ActiveSpeakers[0].SSRC != 1 {
+		t.Errorf("Expected SSRC 1 as active speaker, got %+v", stats.ActiveSpeakers)
+	}
+	if stats.Dropped == 0 {
+		t.Error("Expected the silent stream to be dropped")
+	}
+}
+
+// TestSourceSwitcherIgnoresUnnegotiatedAudioLevel 上游没有协商音量扩展头时，同 ID 的其他扩展头不参与发言者选择
+func TestSourceSwitcherIgnoresUnnegotiatedAudioLevel(t *testing.T) {
+	switcher, err := NewSourceSwitcher("test-room")
+	if err != nil {
+		t.Fatalf("Failed to create SourceSwitcher: %v", err)
+	}
+	defer switcher.Close()
+
+	if id := switcher.GetAudioLevelObserver().ExtensionID(); id != 0 {
+		t.Fatalf("Expected audio level parsing disabled by default, got ID %d", id)
+	}
+
+	// ID 1 上是 mid 之类的其他扩展头，内容恰好像音量
+	packet := func(ssrc uint32, seq uint16, value byte) []byte {
+		pkt := &rtp.Packet{
+			Header: rtp.Header{
+				Version:        2,
+				PayloadType:    111,
+				SequenceNumber: seq,
+				Timestamp:      uint32(seq) * 960,
+				SSRC:           ssrc,
+			},
+			Payload: make([]byte, 80),
+		}
+		pkt.Header.SetExtension(1, []byte{value})
+		data, _ := pkt.Marshal()
+		return data
+	}
+
+	for i := 0; i < 50; i++ {
+		switcher.InjectSFUPacket(false, packet(1, uint16(i), '0'))
+		switcher.InjectSFUPacket(false, packet(2, uint16(1000+i), 127))
+	}
+
+	stats := switcher.GetStatus().AudioLevels
+	if len(stats.ActiveSpeakers) != 0 || stats.Dropped != 0 {
+		t.Errorf("Unnegotiated extension should not drive speaker selection, got %+v", stats)
+	}
+}
+
+// BenchmarkAudioLevelObserve 包路径开销
+func BenchmarkAudioLevelObserve(b *testing.B) {
+	o := NewAudioLevelObserver(DefaultAudioLevelConfig())
+	ext := levelExt(30)
+	now := time.Unix(0, 0)
+	b.ReportAllocs()
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		now = now.Add(time.Millisecond)
+		o.Observe(uint32(i%8), ext, now)
+	}
+}
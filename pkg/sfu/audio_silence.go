@@ -0,0 +1,52 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Audio Silence - Opus DTX / 静音帧识别
+ * 静音期间 Opus DTX 每 400ms 发送一个 1~2 字节的帧，未开启 DTX 的发送端则持续发送音量为 -127dBov 的帧。
+ * 这里只看负载长度、PT 和音量扩展头，不解码 Opus。
+ */
+package sfu
+
+import "time"
+
+const (
+	// opusDTXMaxPayload DTX 帧只有 TOC（可能带 1 字节填充）
+	opusDTXMaxPayload = 2
+	// payloadTypeCN RFC 3389 舒适噪声
+	payloadTypeCN = 13
+
+	// silenceKeepaliveInterval 抑制静音时仍按 Opus DTX 的节奏放行一个包，保持接收端统计和 RTCP
+	silenceKeepaliveInterval = 400 * time.Millisecond
+
+	// audioFrameDivisor 20ms 一帧：ClockRate / 50
+	audioFrameDivisor = 50
+)
+
+// isSilentAudio 判断音频包是否为 DTX / 舒适噪声 / 静音帧
+// levelExt: 音量扩展头内容（没有时为 nil）
+func isSilentAudio(payloadType uint8, payload []byte, levelExt []byte) bool {
+	if payloadType == payloadTypeCN || len(payload) <= opusDTXMaxPayload {
+		return true
+	}
+	level, ok := parseAudioLevel(levelExt)
+	return ok && level >= audioLevelSilent
+}
+
+// audioGapTicks 计算重新同步时的时间戳增量：按真实间隔换算，并对齐到整帧
+// 静音 / DTX 间隙会被保留，而不是固定压缩成一帧（960 @ 48kHz）
+func audioGapTicks(elapsed time.Duration, clockRate uint32) uint32 {
+	if clockRate == 0 {
+		clockRate = 48000
+	}
+	frame := clockRate / audioFrameDivisor
+	if elapsed <= 0 {
+		return frame
+	}
+	frames := (uint64(elapsed)*uint64(clockRate)/uint64(time.Second) + uint64(frame)/2) / uint64(frame)
+	if frames < 1 {
+		frames = 1
+	}
+	return uint32(frames * uint64(frame))
+}
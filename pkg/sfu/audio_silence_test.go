@@ -0,0 +1,117 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Audio Silence Tests
+ */
+package sfu
+
+import (
+	"testing"
+	"time"
+)
+
+func TestIsSilentAudio(t *testing.T) {
+	speech := make([]byte, 80)
+
+	tests := []struct {
+		name     string
+		pt       uint8
+		payload  []byte
+		levelExt []byte
+		want     bool
+	}{
+		{"speech", 111, speech, nil, false},
+		{"speech with level", 111, speech, []byte{0x80 | 30}, false},
+		{"dtx toc only", 111, []byte{0xf8}, nil, true},
+		{"dtx with padding", 111, []byte{0xf8, 0x00}, nil, true},
+		{"comfort noise", payloadTypeCN, speech, nil, true},
+		{"silent level", 111, speech, []byte{127}, true},
+	}
+	for _, tt := range tests {
+		if got := isSilentAudio(tt.pt, tt.payload, tt.levelExt); got != tt.want {
+			t.Errorf("%s: got %v, want %v", tt.name, got, tt.want)
+		}
+	}
+}
+
+func TestAudioGapTicks(t *testing.T) {
+	tests := []struct {
+		elapsed   time.Duration
+		clockRate uint32
+		want      uint32
+	}{
+		{0, 48000, 960},
+		{5 * time.Millisecond, 48000, 960},
+		{20 * time.Millisecond, 48000, 960},
+		{29 * time.Millisecond, 48000, 960},
+		{31 * time.Millisecond, 48000, 1920},
+		{2 * time.Second, 48000, 96000},
+		{time.Second, 16000, 16000},
+		{time.Second, 0, 48000},
+	}
+	for _, tt := range tests {
+		if got := audioGapTicks(tt.elapsed, tt.clockRate); got != tt.want {
+			t.Errorf("audioGapTicks(%v, %d) = %d, want %d", tt.elapsed, tt.clockRate, got, tt.want)
+		}
+	}
+}
+
+func TestSourceSwitcherSilenceSuppression(t *testing.T) {
+	switcher, err := NewSourceSwitcher("test-room")
+	if err != nil {
+		t.Fatalf("Failed to create SourceSwitcher: %v", err)
+	}
+	defer switcher.Close()
+	switcher.SetSilenceSuppression(true)
+
+	seq := uint16(0)
+	inject := func(n, size int) {
+		for i := 0; i < n; i++ {
+			switcher.InjectSFUPacket(false, createTestRTPPacket(seq, size))
+			seq++
+		}
+	}
+
+	inject(10, 100) // 语音
+	inject(50, 13)  // DTX（1 字节负载）
+	inject(10, 100) // 语音
+
+	status := switcher.GetStatus()
+	if status.AudioSilentPackets != 50 || status.AudioSuppressed != 50 {
+		t.Errorf("Expected 50 silent/suppressed packets, got %d/%d",
+			status.AudioSilentPackets, status.AudioSuppressed)
+	}
+
+	// 被抑制的包不占用输出序列号
+	if switcher.lastAudioSn != 19 {
+		t.Errorf("Expected contiguous output SN ending at 19, got %d", switcher.lastAudioSn)
+	}
+}
+
+func TestSourceSwitcherAudioResetKeepsWallClockGap(t *testing.T) {
+	switcher, err := NewSourceSwitcher("test-room")
+	if err != nil {
+		t.Fatalf("Failed to create SourceSwitcher: %v", err)
+	}
+	defer switcher.Close()
+
+	switcher.InjectSFUPacket(false, createTestRTPPacket(1, 100))
+	lastTs := switcher.lastAudioTs
+
+	// 切换到本地源，100ms 后第一个本地音频包
+	switcher.StartLocalShare("sharer")
+	time.Sleep(100 * time.Millisecond)
+	local := createTestRTPPacket(5000, 100)
+	local[8] = 0xaa // 不同的 SSRC
+	switcher.InjectLocalPacket(false, local)
+
+	gap := switcher.lastAudioTs - lastTs
+	if gap < 4800 || gap%960 != 0 {
+		t.Errorf("Expected TS gap >= 100ms aligned to 20ms frames, got %d", gap)
+	}
+	if switcher.lastAudioSn != 2 {
+		t.Errorf("Expected contiguous SN across source switch, got %d", switcher.lastAudioSn)
+	}
+}
@@ -0,0 +1,386 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Bandwidth Accountant - 公网 / 局域网流量核算
+ * 量化 Relay 节省的公网带宽：
+ * - WAN 入口：LiveKitBridge 从 SFU 拉取的字节（只有 Relay 一份）
+ * - LAN 出口：共享 Track 每写出一个包，当前已连接的每个订阅者各收到一份（暂停视频的订阅者只收音频）
+ * - 反事实 WAN：如果没有 Relay，每个订阅者（加上 Relay 本机）都要各自从 SFU 拉一份（暂停视频的只拉音频）
+ * 节省比例 = 1 - WAN / 反事实 WAN，并按分钟汇总到固定大小的环形缓冲（没有流量的分钟记为 0）
+ */
+package sfu
+
+import (
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// bandwidthRollupSize 保留的分钟汇总条数（1 小时）
+const bandwidthRollupSize = 60
+
+// 按媒体类型分开的计数下标
+const (
+	mediaSlotAudio = 0
+	mediaSlotVideo = 1
+)
+
+func mediaSlot(isVideo bool) int {
+	if isVideo {
+		return mediaSlotVideo
+	}
+	return mediaSlotAudio
+}
+
+// BandwidthRollup 一分钟的流量汇总
+type BandwidthRollup struct {
+	Minute                 int64   `json:"minute"` // Unix 秒，对齐到分钟
+	WANIngressBytes        uint64  `json:"wan_ingress_bytes"`
+	LANEgressBytes         uint64  `json:"lan_egress_bytes"`
+	CounterfactualWANBytes uint64  `json:"counterfactual_wan_bytes"`
+	SavingsRatio           float64 `json:"savings_ratio"`
+	PeakSubscribers        int     `json:"peak_subscribers"`
+}
+
+// SubscriberBandwidth 单个订阅者的局域网流量
+type SubscriberBandwidth struct {
+	ID        string `json:"id"`
+	Bytes     uint64 `json:"bytes"`
+	Packets   uint64 `json:"packets"`
+	Connected bool   `json:"connected"`
+}
+
+// BandwidthStats 流量核算统计
+type BandwidthStats struct {
+	WANIngressBytes        uint64                `json:"wan_ingress_bytes"`
+	LANEgressBytes         uint64                `json:"lan_egress_bytes"`
+	CounterfactualWANBytes uint64                `json:"counterfactual_wan_bytes"`
+	SavedWANBytes          uint64                `json:"saved_wan_bytes"`
+	SavingsRatio           float64               `json:"savings_ratio"`
+	ConnectedSubscribers   int                   `json:"connected_subscribers"`
+	VideoSubscribers       int                   `json:"video_subscribers"` // 已连接且未暂停视频
+	Subscribers            []SubscriberBandwidth `json:"subscribers"`
+	CurrentMinute          BandwidthRollup       `json:"current_minute"`
+	Minutes                []BandwidthRollup     `json:"minutes"` // 从旧到新
+}
+
+// subscriberUsage 订阅者在共享 Track 上的计数基线（按 [音频, 视频] 分别记录）
+type subscriberUsage struct {
+	connected   bool
+	videoPaused bool
+	baseBytes   [2]uint64 // 开始接收时的 forwardedBytes
+	basePackets [2]uint64
+	bytes       uint64 // 已结算（断开 / 暂停视频前）的字节
+	packets     uint64
+}
+
+// receiving 是否正在接收该类媒体
+func (u *subscriberUsage) receiving(slot int) bool {
+	return u.connected && (slot == mediaSlotAudio || !u.videoPaused)
+}
+
+// bandwidthTotals 累计计数快照
+type bandwidthTotals struct {
+	wan, lan, counterfactual uint64
+}
+
+// BandwidthAccountant 房间级流量核算
+// 包路径上只有原子操作；每分钟第一次调用时加锁滚动汇总
+type BandwidthAccountant struct {
+	mu sync.Mutex
+
+	// 累计计数（原子）
+	wanIngress       atomic.Uint64
+	lanEgress        atomic.Uint64
+	counterfactual   atomic.Uint64
+	forwardedBytes   [2]atomic.Uint64 // [音频, 视频]
+	forwardedPackets [2]atomic.Uint64
+	receivers        [2]atomic.Int64 // 正在接收音频 / 视频的订阅者数
+
+	subscribers map[string]*subscriberUsage
+
+	// 分钟汇总
+	currentMinute   atomic.Int64
+	minuteBase      bandwidthTotals
+	peakSubscribers int
+	rollups         [bandwidthRollupSize]BandwidthRollup
+	rollupHead      int
+	rollupCount     int
+}
+
+// NewBandwidthAccountant 创建流量核算
+func NewBandwidthAccountant() *BandwidthAccountant {
+	a := &BandwidthAccountant{
+		subscribers: make(map[string]*subscriberUsage),
+	}
+	a.currentMinute.Store(minuteOf(time.Now()))
+	return a
+}
+
+// minuteOf 对齐到分钟的 Unix 秒
+func minuteOf(t time.Time) int64 {
+	return t.Unix() / 60 * 60
+}
+
+// AddWANIngress 记录从 SFU 拉取的字节
+func (a *BandwidthAccountant) AddWANIngress(n int, isVideo bool) {
+	a.maybeRoll(time.Now())
+	a.wanIngress.Add(uint64(n))
+	// 没有 Relay 时，Relay 本机和每个接收该媒体的订阅者都要各拉一份
+	a.counterfactual.Add(uint64(n) * uint64(a.receivers[mediaSlot(isVideo)].Load()+1))
+}
+
+// AddForwarded 记录共享 Track 写出的字节（每个接收该媒体的订阅者各收到一份）
+func (a *BandwidthAccountant) AddForwarded(n int, isVideo bool) {
+	a.maybeRoll(time.Now())
+	slot := mediaSlot(isVideo)
+	a.forwardedBytes[slot].Add(uint64(n))
+	a.forwardedPackets[slot].Add(1)
+	if c := a.receivers[slot].Load(); c > 0 {
+		a.lanEgress.Add(uint64(n) * uint64(c))
+	}
+}
+
+// SubscriberConnected 订阅者连接成功，开始计入局域网流量
+func (a *BandwidthAccountant) SubscriberConnected(id string) {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+
+	usage := a.usageLocked(id)
+	if usage.connected {
+		return
+	}
+	usage.connected = true
+	a.startLocked(usage, mediaSlotAudio)
+	if !usage.videoPaused {
+		a.startLocked(usage, mediaSlotVideo)
+	}
+
+	if c := int(a.receivers[mediaSlotAudio].Load()); c > a.peakSubscribers {
+		a.peakSubscribers = c
+	}
+}
+
+// SetSubscriberVideoPaused 订阅者暂停 / 恢复接收视频（音频照常计入）
+// 可以在连接前调用，连接后按暂停状态开始计数
+func (a *BandwidthAccountant) SetSubscriberVideoPaused(id string, paused bool) {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+
+	usage := a.usageLocked(id)
+	if usage.videoPaused == paused {
+		return
+	}
+	if usage.connected {
+		if paused {
+			a.settleLocked(usage, mediaSlotVideo)
+		} else {
+			a.startLocked(usage, mediaSlotVideo)
+		}
+	}
+	usage.videoPaused = paused
+}
+
+// SubscriberDisconnected 订阅者断开，结算其流量
+func (a *BandwidthAccountant) SubscriberDisconnected(id string) {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+	a.disconnectLocked(id)
+}
+
+// RemoveSubscriber 移除订阅者记录（累计总量不受影响）
+func (a *BandwidthAccountant) RemoveSubscriber(id string) {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+	a.disconnectLocked(id)
+	delete(a.subscribers, id)
+}
+
+func (a *BandwidthAccountant) disconnectLocked(id string) {
+	usage, exists := a.subscribers[id]
+	if !exists || !usage.connected {
+		return
+	}
+	for slot := range a.receivers {
+		if usage.receiving(slot) {
+			a.settleLocked(usage, slot)
+		}
+	}
+	usage.connected = false
+}
+
+func (a *BandwidthAccountant) usageLocked(id string) *subscriberUsage {
+	usage, exists := a.subscribers[id]
+	if !exists {
+		usage = &subscriberUsage{}
+		a.subscribers[id] = usage
+	}
+	return usage
+}
+
+// startLocked 开始计入一类媒体
+func (a *BandwidthAccountant) startLocked(usage *subscriberUsage, slot int) {
+	usage.baseBytes[slot] = a.forwardedBytes[slot].Load()
+	usage.basePackets[slot] = a.forwardedPackets[slot].Load()
+	a.receivers[slot].Add(1)
+}
+
+// settleLocked 结算一类媒体并停止计入
+func (a *BandwidthAccountant) settleLocked(usage *subscriberUsage, slot int) {
+	usage.bytes += a.forwardedBytes[slot].Load() - usage.baseBytes[slot]
+	usage.packets += a.forwardedPackets[slot].Load() - usage.basePackets[slot]
+	a.receivers[slot].Add(-1)
+}
+
+// usageTotalsLocked 订阅者累计流量（含正在接收的部分）
+func (a *BandwidthAccountant) usageTotalsLocked(usage *subscriberUsage) (bytes, packets uint64) {
+	bytes, packets = usage.bytes, usage.packets
+	for slot := range a.receivers {
+		if usage.receiving(slot) {
+			bytes += a.forwardedBytes[slot].Load() - usage.baseBytes[slot]
+			packets += a.forwardedPackets[slot].Load() - usage.basePackets[slot]
+		}
+	}
+	return bytes, packets
+}
+
+// maybeRoll 跨分钟时把上一分钟的增量写入环形缓冲
+func (a *BandwidthAccountant) maybeRoll(now time.Time) {
+	minute := minuteOf(now)
+	if minute <= a.currentMinute.Load() {
+		return
+	}
+
+	a.mu.Lock()
+	defer a.mu.Unlock()
+
+	if minute <= a.currentMinute.Load() {
+		return
+	}
+	totals := a.totals()
+	a.pendingLocked(minute, totals, a.pushLocked)
+
+	a.minuteBase = totals
+	a.peakSubscribers = int(a.receivers[mediaSlotAudio].Load())
+	a.currentMinute.Store(minute)
+}
+
+// pendingLocked 按时间顺序产出 currentMinute 到 minute 之间尚未写入环形缓冲的汇总（不修改状态）
+// 当前分钟结算后，中间没有任何流量的分钟记为 0，订阅者数沿用当前连接数
+func (a *BandwidthAccountant) pendingLocked(minute int64, totals bandwidthTotals, fn func(BandwidthRollup)) {
+	prev := a.currentMinute.Load()
+	if minute <= prev {
+		return
+	}
+	fn(a.rollupLocked(prev, totals))
+
+	idle := (minute-prev)/60 - 1
+	if idle > bandwidthRollupSize {
+		idle = bandwidthRollupSize // 更早的分钟会被环形缓冲覆盖
+	}
+	connected := int(a.receivers[mediaSlotAudio].Load())
+	for m := minute - idle*60; m < minute; m += 60 {
+		fn(BandwidthRollup{Minute: m, PeakSubscribers: connected})
+	}
+}
+
+// pushLocked 写入环形缓冲，满时覆盖最旧的一条
+func (a *BandwidthAccountant) pushLocked(r BandwidthRollup) {
+	a.rollups[(a.rollupHead+a.rollupCount)%bandwidthRollupSize] = r
+	if a.rollupCount < bandwidthRollupSize {
+		a.rollupCount++
+	} else {
+		a.rollupHead = (a.rollupHead + 1) % bandwidthRollupSize
+	}
+}
+
+func (a *BandwidthAccountant) totals() bandwidthTotals {
+	return bandwidthTotals{
+		wan:            a.wanIngress.Load(),
+		lan:            a.lanEgress.Load(),
+		counterfactual: a.counterfactual.Load(),
+	}
+}
+
+// rollupLocked 当前分钟相对 minuteBase 的增量
+func (a *BandwidthAccountant) rollupLocked(minute int64, totals bandwidthTotals) BandwidthRollup {
+	r := BandwidthRollup{
+		Minute:                 minute,
+		WANIngressBytes:        totals.wan - a.minuteBase.wan,
+		LANEgressBytes:         totals.lan - a.minuteBase.lan,
+		CounterfactualWANBytes: totals.counterfactual - a.minuteBase.counterfactual,
+		PeakSubscribers:        a.peakSubscribers,
+	}
+	r.SavingsRatio = savingsRatio(r.WANIngressBytes, r.CounterfactualWANBytes)
+	return r
+}
+
+// savingsRatio 1 - 实际 / 反事实
+func savingsRatio(actual, counterfactual uint64) float64 {
+	if counterfactual == 0 || actual >= counterfactual {
+		return 0
+	}
+	return 1 - float64(actual)/float64(counterfactual)
+}
+
+// GetStats 获取统计（只读，不滚动汇总）
+func (a *BandwidthAccountant) GetStats() BandwidthStats {
+	return a.statsAt(time.Now())
+}
+
+func (a *BandwidthAccountant) statsAt(now time.Time) BandwidthStats {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+
+	totals := a.totals()
+	minute := minuteOf(now)
+	stats := BandwidthStats{
+		WANIngressBytes:        totals.wan,
+		LANEgressBytes:         totals.lan,
+		CounterfactualWANBytes: totals.counterfactual,
+		SavingsRatio:           savingsRatio(totals.wan, totals.counterfactual),
+		ConnectedSubscribers:   int(a.receivers[mediaSlotAudio].Load()),
+		VideoSubscribers:       int(a.receivers[mediaSlotVideo].Load()),
+		Subscribers:            make([]SubscriberBandwidth, 0, len(a.subscribers)),
+		CurrentMinute:          a.rollupLocked(a.currentMinute.Load(), totals),
+		Minutes:                make([]BandwidthRollup, 0, bandwidthRollupSize+1),
+	}
+	if minute > a.currentMinute.Load() {
+		// 包路径还没有滚动到本分钟：本分钟暂无流量
+		stats.CurrentMinute = BandwidthRollup{Minute: minute, PeakSubscribers: stats.ConnectedSubscribers}
+	}
+	if totals.counterfactual > totals.wan {
+		stats.SavedWANBytes = totals.counterfactual - totals.wan
+	}
+
+	for id, usage := range a.subscribers {
+		sb := SubscriberBandwidth{ID: id, Connected: usage.connected}
+		sb.Bytes, sb.Packets = a.usageTotalsLocked(usage)
+		stats.Subscribers = append(stats.Subscribers, sb)
+	}
+
+	for i := 0; i < a.rollupCount; i++ {
+		stats.Minutes = append(stats.Minutes, a.rollups[(a.rollupHead+i)%bandwidthRollupSize])
+	}
+	a.pendingLocked(minute, totals, func(r BandwidthRollup) {
+		stats.Minutes = append(stats.Minutes, r)
+	})
+	if n := len(stats.Minutes); n > bandwidthRollupSize {
+		stats.Minutes = stats.Minutes[n-bandwidthRollupSize:]
+	}
+	return stats
+}
+
+// SubscriberUsage 获取单个订阅者的局域网流量
+func (a *BandwidthAccountant) SubscriberUsage(id string) (bytes, packets uint64) {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+
+	usage, exists := a.subscribers[id]
+	if !exists {
+		return 0, 0
+	}
+	return a.usageTotalsLocked(usage)
+}
@@ -0,0 +1,259 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Bandwidth Accountant Tests
+ */
+package sfu
+
+import (
+	"math"
+	"sync"
+	"testing"
+	"time"
+)
+
+func TestBandwidthAccountantSavings(t *testing.T) {
+	a := NewBandwidthAccountant()
+	for _, id := range []string{"a", "b", "c", "d"} {
+		a.SubscriberConnected(id)
+	}
+
+	// 4 个订阅者：Relay 拉 1 份，直连需要 5 份
+	for i := 0; i < 100; i++ {
+		a.AddWANIngress(1000, true)
+		a.AddForwarded(1000, true)
+	}
+
+	stats := a.GetStats()
+	if stats.WANIngressBytes != 100_000 {
+		t.Errorf("WAN ingress = %d", stats.WANIngressBytes)
+	}
+	if stats.LANEgressBytes != 400_000 {
+		t.Errorf("LAN egress = %d", stats.LANEgressBytes)
+	}
+	if stats.CounterfactualWANBytes != 500_000 || stats.SavedWANBytes != 400_000 {
+		t.Errorf("Counterfactual = %d, saved = %d", stats.CounterfactualWANBytes, stats.SavedWANBytes)
+	}
+	if math.Abs(stats.SavingsRatio-0.8) > 1e-9 {
+		t.Errorf("Savings ratio = %f, want 0.8", stats.SavingsRatio)
+	}
+	if stats.ConnectedSubscribers != 4 || len(stats.Subscribers) != 4 {
+		t.Errorf("Unexpected subscribers: %+v", stats)
+	}
+}
+
+func TestBandwidthAccountantSubscriberLifecycle(t *testing.T) {
+	a := NewBandwidthAccountant()
+
+	a.AddForwarded(500, true) // 无订阅者时不计入
+	a.SubscriberConnected("a")
+	a.AddForwarded(1000, true)
+	a.SubscriberConnected("b")
+	a.AddForwarded(1000, true)
+	a.SubscriberDisconnected("a")
+	a.AddForwarded(1000, true)
+
+	if bytes, packets := a.SubscriberUsage("a"); bytes != 2000 || packets != 2 {
+		t.Errorf("a: bytes=%d packets=%d", bytes, packets)
+	}
+	if bytes, _ := a.SubscriberUsage("b"); bytes != 2000 {
+		t.Errorf("b: bytes=%d", bytes)
+	}
+	if lan := a.GetStats().LANEgressBytes; lan != 4000 {
+		t.Errorf("LAN egress = %d, want 4000", lan)
+	}
+
+	// 重连后继续累计
+	a.SubscriberConnected("a")
+	a.AddForwarded(1000, true)
+	if bytes, _ := a.SubscriberUsage("a"); bytes != 3000 {
+		t.Errorf("a after reconnect: bytes=%d", bytes)
+	}
+
+	a.RemoveSubscriber("a")
+	if bytes, _ := a.SubscriberUsage("a"); bytes != 0 {
+		t.Error("Removed subscriber still reported")
+	}
+	if stats := a.GetStats(); stats.ConnectedSubscribers != 1 || stats.LANEgressBytes != 6000 {
+		t.Errorf("Unexpected stats after removal: %+v", stats)
+	}
+}
+
+// TestBandwidthAccountantVideoPaused 暂停视频的订阅者只停止计入视频，音频照常
+func TestBandwidthAccountantVideoPaused(t *testing.T) {
+	a := NewBandwidthAccountant()
+	a.SubscriberConnected("a")
+	a.SubscriberConnected("b")
+
+	a.SetSubscriberVideoPaused("a", true)
+	a.AddWANIngress(1000, true)
+	a.AddForwarded(1000, true)
+	a.AddWANIngress(100, false)
+	a.AddForwarded(100, false)
+
+	if bytes, packets := a.SubscriberUsage("a"); bytes != 100 || packets != 1 {
+		t.Errorf("Paused a: bytes=%d packets=%d, want audio only", bytes, packets)
+	}
+	if bytes, _ := a.SubscriberUsage("b"); bytes != 1100 {
+		t.Errorf("b: bytes=%d", bytes)
+	}
+	stats := a.GetStats()
+	if stats.ConnectedSubscribers != 2 || stats.VideoSubscribers != 1 {
+		t.Errorf("Unexpected subscriber counts: %+v", stats)
+	}
+	// 视频：Relay + b；音频：Relay + a + b
+	if stats.LANEgressBytes != 1200 || stats.CounterfactualWANBytes != 2*1000+3*100 {
+		t.Errorf("Unexpected accounting: lan=%d counterfactual=%d", stats.LANEgressBytes, stats.CounterfactualWANBytes)
+	}
+
+	// 恢复后重新计入视频；断开时一并结算
+	a.SetSubscriberVideoPaused("a", false)
+	a.AddForwarded(1000, true)
+	a.SubscriberDisconnected("a")
+	a.AddForwarded(1000, true)
+	if bytes, packets := a.SubscriberUsage("a"); bytes != 1100 || packets != 2 {
+		t.Errorf("Resumed a: bytes=%d packets=%d", bytes, packets)
+	}
+
+	// 连接前设置的暂停状态在连接后生效
+	a.SetSubscriberVideoPaused("c", true)
+	a.SubscriberConnected("c")
+	if stats := a.GetStats(); stats.ConnectedSubscribers != 2 || stats.VideoSubscribers != 1 {
+		t.Errorf("Pause before connect not honoured: %+v", stats)
+	}
+}
+
+func TestBandwidthAccountantMinuteRollups(t *testing.T) {
+	a := NewBandwidthAccountant()
+	a.SubscriberConnected("a")
+
+	start := time.Unix(a.currentMinute.Load(), 0)
+	for m := 1; m <= bandwidthRollupSize+5; m++ {
+		a.AddWANIngress(m, true)
+		a.maybeRoll(start.Add(time.Duration(m) * time.Minute))
+	}
+
+	stats := a.GetStats()
+	if len(stats.Minutes) != bandwidthRollupSize {
+		t.Fatalf("Expected %d rollups, got %d", bandwidthRollupSize, len(stats.Minutes))
+	}
+	// 环形缓冲只保留最近 60 分钟，从旧到新
+	first, last := stats.Minutes[0], stats.Minutes[len(stats.Minutes)-1]
+	if first.WANIngressBytes != 6 || last.WANIngressBytes != bandwidthRollupSize+5 {
+		t.Errorf("Unexpected window: first=%+v last=%+v", first, last)
+	}
+	if last.Minute-first.Minute != int64(bandwidthRollupSize-1)*60 {
+		t.Errorf("Unexpected minute span: %d..%d", first.Minute, last.Minute)
+	}
+	if last.CounterfactualWANBytes != 2*last.WANIngressBytes || last.PeakSubscribers != 1 {
+		t.Errorf("Unexpected rollup: %+v", last)
+	}
+	if stats.CurrentMinute.WANIngressBytes != 0 {
+		t.Errorf("Current minute should be empty, got %+v", stats.CurrentMinute)
+	}
+}
+
+// TestBandwidthAccountantIdleMinutes 空闲期之后旧分钟不会被当作最近流量，读取统计不改变状态
+func TestBandwidthAccountantIdleMinutes(t *testing.T) {
+	a := NewBandwidthAccountant()
+	a.SubscriberConnected("a")
+
+	start := time.Unix(a.currentMinute.Load(), 0)
+	a.AddWANIngress(100, true)
+
+	// 10 分钟没有任何包，只读取统计
+	now := start.Add(10*time.Minute + time.Second)
+	stats := a.statsAt(now)
+	if a.currentMinute.Load() != start.Unix() || a.rollupCount != 0 {
+		t.Fatalf("Reading stats should not roll the ring (minute=%d count=%d)", a.currentMinute.Load(), a.rollupCount)
+	}
+	if len(stats.Minutes) != 10 || stats.Minutes[0].WANIngressBytes != 100 {
+		t.Fatalf("Expected the active minute plus 9 idle minutes, got %+v", stats.Minutes)
+	}
+	for i, r := range stats.Minutes[1:] {
+		if r.WANIngressBytes != 0 || r.Minute != start.Unix()+int64(i+1)*60 || r.PeakSubscribers != 1 {
+			t.Errorf("Idle minute %d should be empty, got %+v", i+1, r)
+		}
+	}
+	if stats.CurrentMinute.Minute != now.Unix()/60*60 || stats.CurrentMinute.WANIngressBytes != 0 {
+		t.Errorf("Unexpected current minute %+v", stats.CurrentMinute)
+	}
+
+	// 包路径滚动后与只读视图一致
+	a.maybeRoll(now)
+	if rolled := a.statsAt(now); len(rolled.Minutes) != len(stats.Minutes) ||
+		rolled.Minutes[9] != stats.Minutes[9] || rolled.CurrentMinute != stats.CurrentMinute {
+		t.Errorf("Rolled view differs: %+v vs %+v", rolled.Minutes, stats.Minutes)
+	}
+
+	// 空闲超过一小时：窗口内全部是 0
+	later := now.Add(3 * time.Hour)
+	if stats := a.statsAt(later); len(stats.Minutes) != bandwidthRollupSize || stats.Minutes[0].WANIngressBytes != 0 ||
+		stats.Minutes[bandwidthRollupSize-1].Minute != later.Unix()/60*60-60 {
+		t.Errorf("Unexpected window after a long idle period: first=%+v last=%+v",
+			stats.Minutes[0], stats.Minutes[len(stats.Minutes)-1])
+	}
+}
+
+func TestBandwidthAccountantConcurrent(t *testing.T) {
+	a := NewBandwidthAccountant()
+	a.SubscriberConnected("a")
+
+	var wg sync.WaitGroup
+	for g := 0; g < 4; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := 0; i < 1000; i++ {
+				a.AddWANIngress(100, true)
+				a.AddForwarded(100, true)
+			}
+		}()
+	}
+	for i := 0; i < 10; i++ {
+		a.GetStats()
+	}
+	wg.Wait()
+
+	if stats := a.GetStats(); stats.WANIngressBytes != 400_000 || stats.LANEgressBytes != 400_000 {
+		t.Errorf("Unexpected totals: %+v", stats)
+	}
+}
+
+func TestSourceSwitcherAccountsForwardedBytes(t *testing.T) {
+	switcher, err := NewSourceSwitcher("test-room")
+	if err != nil {
+		t.Fatalf("Failed to create SourceSwitcher: %v", err)
+	}
+	defer switcher.Close()
+	switcher.SetPacerConfig(PacerConfig{Enabled: false})
+
+	accountant := switcher.GetBandwidthAccountant()
+	accountant.SubscriberConnected("a")
+	accountant.SubscriberConnected("b")
+
+	for i := 0; i < 10; i++ {
+		pkt := createTestRTPPacket(uint16(i), 200)
+		accountant.AddWANIngress(len(pkt), true)
+		switcher.InjectSFUPacket(true, pkt)
+	}
+
+	stats := accountant.GetStats()
+	if stats.WANIngressBytes != 2000 || stats.LANEgressBytes != 4000 {
+		t.Errorf("Unexpected accounting: wan=%d lan=%d", stats.WANIngressBytes, stats.LANEgressBytes)
+	}
+}
+
+// BenchmarkBandwidthAccountant 包路径开销
+func BenchmarkBandwidthAccountant(b *testing.B) {
+	a := NewBandwidthAccountant()
+	a.SubscriberConnected("a")
+	b.ReportAllocs()
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		a.AddForwarded(1200, true)
+	}
+}
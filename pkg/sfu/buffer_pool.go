@@ -33,10 +33,14 @@ type BufferPool struct {
 	standardReuses uint64
 	largeAllocs    uint64
 	largeReuses    uint64
+	dropped        uint64
+
+	// 内存预算（nil 时不统计）：借出的 buffer 计入占用，压力下归还的 buffer 不再入池
+	memory *MemoryGovernor
 }
 
-// 全局缓冲池实例
-var globalBufferPool = NewBufferPool()
+// 全局缓冲池实例（计入全局内存预算）
+var globalBufferPool = NewBufferPoolWithGovernor(globalMemoryGovernor)
 
 // NewBufferPool 创建缓冲池
 func NewBufferPool() *BufferPool {
@@ -54,6 +58,14 @@ func NewBufferPool() *BufferPool {
 	}
 }
 
+// NewBufferPoolWithGovernor 创建计入内存预算的缓冲池
+// 借出的 buffer 必须归还，否则占用统计不会下降
+func NewBufferPoolWithGovernor(memory *MemoryGovernor) *BufferPool {
+	p := NewBufferPool()
+	p.memory = memory
+	return p
+}
+
 // GetBuffer 获取标准缓冲区
 func (p *BufferPool) GetBuffer() []byte {
 	buf := p.standardPool.Get().([]byte)
@@ -62,13 +74,16 @@ func (p *BufferPool) GetBuffer() []byte {
 	} else {
 		atomic.AddUint64(&p.standardAllocs, 1)
 	}
+	p.memory.Reserve(MemoryClassBufferPool, int64(cap(buf)))
 	return buf[:DefaultRTPBufferSize]
 }
 
 // PutBuffer 归还标准缓冲区
 func (p *BufferPool) PutBuffer(buf []byte) {
 	if cap(buf) >= DefaultRTPBufferSize {
-		p.standardPool.Put(buf[:cap(buf)])
+		if p.release(buf) {
+			p.standardPool.Put(buf[:cap(buf)])
+		}
 	}
 }
 
@@ -80,14 +95,30 @@ func (p *BufferPool) GetLargeBuffer() []byte {
 	} else {
 		atomic.AddUint64(&p.largeAllocs, 1)
 	}
+	p.memory.Reserve(MemoryClassBufferPool, int64(cap(buf)))
 	return buf[:LargeRTPBufferSize]
 }
 
 // PutLargeBuffer 归还大缓冲区
 func (p *BufferPool) PutLargeBuffer(buf []byte) {
 	if cap(buf) >= LargeRTPBufferSize {
-		p.largePool.Put(buf[:cap(buf)])
+		if p.release(buf) {
+			p.largePool.Put(buf[:cap(buf)])
+		}
+	}
+}
+
+// release 释放 buffer 的占用，返回是否放回池中（内存压力下交给 GC 回收）
+func (p *BufferPool) release(buf []byte) bool {
+	if p.memory == nil {
+		return true
+	}
+	p.memory.Release(MemoryClassBufferPool, int64(cap(buf)))
+	if p.memory.Pressure() >= MemoryPressureShrink {
+		atomic.AddUint64(&p.dropped, 1)
+		return false
 	}
+	return true
 }
 
 // GetBufferWithSize 获取指定大小的缓冲区
@@ -114,6 +145,7 @@ type BufferPoolStats struct {
 	StandardReuses uint64  `json:"standard_reuses"`
 	LargeAllocs    uint64  `json:"large_allocs"`
 	LargeReuses    uint64  `json:"large_reuses"`
+	Dropped        uint64  `json:"dropped"`
 	ReuseRatio     float64 `json:"reuse_ratio"`
 }
 
@@ -137,6 +169,7 @@ func (p *BufferPool) GetStats() BufferPoolStats {
 		StandardReuses: standardReuses,
 		LargeAllocs:    largeAllocs,
 		LargeReuses:    largeReuses,
+		Dropped:        atomic.LoadUint64(&p.dropped),
 		ReuseRatio:     reuseRatio,
 	}
 }
@@ -147,6 +180,7 @@ func (p *BufferPool) ResetStats() {
 	atomic.StoreUint64(&p.standardReuses, 0)
 	atomic.StoreUint64(&p.largeAllocs, 0)
 	atomic.StoreUint64(&p.largeReuses, 0)
+	atomic.StoreUint64(&p.dropped, 0)
 }
 
 // 全局便捷函数
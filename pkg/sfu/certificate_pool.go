@@ -0,0 +1,176 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Certificate Pool - 共享 DTLS 证书
+ * PeerConnection 没有指定 Certificates 时，pion 会为每个订阅者现场生成 ECDSA 密钥和自签名证书，
+ * 手机 Relay 上每次加入都要多花几毫秒 CPU，多人同时加入时形成尖峰。
+ *
+ * CertificatePool 在后台生成一张证书供 Relay 上所有订阅者 PeerConnection 复用：
+ *   - 首次使用前由 Warm 在后台生成，Get 在证书就绪前等待这一次生成
+ *   - 证书使用超过 RotateInterval 后，Get 继续返回旧证书并在后台生成新证书（已建立的连接不受影响）
+ *   - 证书过期或生成失败时返回 nil，调用方回退到 pion 自己生成
+ */
+package sfu
+
+import (
+	"crypto/ecdsa"
+	"crypto/elliptic"
+	"crypto/rand"
+	"sync"
+	"time"
+
+	"github.com/maiguangyang/relay_core/pkg/utils"
+	"github.com/pion/webrtc/v4"
+)
+
+// CertificatePoolConfig 证书池配置
+type CertificatePoolConfig struct {
+	// 证书轮换周期（pion 生成的证书有效期为一个月）
+	RotateInterval time.Duration
+}
+
+// DefaultCertificatePoolConfig 返回默认配置
+func DefaultCertificatePoolConfig() CertificatePoolConfig {
+	return CertificatePoolConfig{
+		RotateInterval: 24 * time.Hour,
+	}
+}
+
+// CertificatePoolStats 证书池统计
+type CertificatePoolStats struct {
+	Ready          bool    `json:"ready"`
+	AgeMs          int64   `json:"age_ms"`
+	Generations    uint64  `json:"generations"`
+	Reuses         uint64  `json:"reuses"`
+	Failures       uint64  `json:"failures"`
+	LastGenerateMs float64 `json:"last_generate_ms"`
+}
+
+// CertificatePool 共享 DTLS 证书池
+type CertificatePool struct {
+	mu sync.Mutex
+
+	config CertificatePoolConfig
+
+	current     *webrtc.Certificate
+	generatedAt time.Time
+	pending     chan struct{} // 生成中时非 nil，生成结束后关闭
+
+	generations  uint64
+	reuses       uint64
+	failures     uint64
+	lastGenerate time.Duration
+}
+
+// 全局证书池（Relay 上所有 RelayRoom 共享）
+var globalCertificatePool = NewCertificatePool(DefaultCertificatePoolConfig())
+
+// NewCertificatePool 创建证书池（不会立即生成证书）
+func NewCertificatePool(config CertificatePoolConfig) *CertificatePool {
+	return &CertificatePool{config: config}
+}
+
+// Warm 在后台生成证书（已有可用证书或正在生成时不做任何事）
+func (p *CertificatePool) Warm() {
+	if p == nil {
+		return
+	}
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	if !p.usableLocked(time.Now()) {
+		p.generateLocked()
+	}
+}
+
+// Get 获取当前证书，需要轮换时在后台生成新证书
+// 没有可用证书时等待正在进行的生成；生成失败返回 nil
+func (p *CertificatePool) Get() *webrtc.Certificate {
+	if p == nil {
+		return nil
+	}
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	now := time.Now()
+	if !p.usableLocked(now) {
+		done := p.generateLocked()
+		p.mu.Unlock()
+		<-done
+		p.mu.Lock()
+		if !p.usableLocked(time.Now()) {
+			return nil
+		}
+	} else if now.Sub(p.generatedAt) >= p.config.RotateInterval {
+		p.generateLocked()
+	}
+
+	p.reuses++
+	return p.current
+}
+
+// GetStats 获取统计
+func (p *CertificatePool) GetStats() CertificatePoolStats {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	now := time.Now()
+	stats := CertificatePoolStats{
+		Ready:          p.usableLocked(now),
+		Generations:    p.generations,
+		Reuses:         p.reuses,
+		Failures:       p.failures,
+		LastGenerateMs: float64(p.lastGenerate) / float64(time.Millisecond),
+	}
+	if p.current != nil {
+		stats.AgeMs = now.Sub(p.generatedAt).Milliseconds()
+	}
+	return stats
+}
+
+// usableLocked 当前证书是否可用（未过期）
+func (p *CertificatePool) usableLocked(now time.Time) bool {
+	return p.current != nil && now.Before(p.current.Expires())
+}
+
+// generateLocked 启动后台生成，已在生成时返回同一个完成通知
+func (p *CertificatePool) generateLocked() chan struct{} {
+	if p.pending != nil {
+		return p.pending
+	}
+	done := make(chan struct{})
+	p.pending = done
+	go p.generate(done)
+	return done
+}
+
+func (p *CertificatePool) generate(done chan struct{}) {
+	start := time.Now()
+	cert, err := newDTLSCertificate()
+	elapsed := time.Since(start)
+
+	p.mu.Lock()
+	if err != nil {
+		p.failures++
+		utils.Warn("[CertificatePool] Failed to generate certificate: %v", err)
+	} else {
+		p.current = cert
+		p.generatedAt = time.Now()
+		p.generations++
+	}
+	p.lastGenerate = elapsed
+	p.pending = nil
+	p.mu.Unlock()
+
+	close(done)
+}
+
+// newDTLSCertificate 生成与 pion 默认一致的 ECDSA P-256 自签名证书
+func newDTLSCertificate() (*webrtc.Certificate, error) {
+	key, err := ecdsa.GenerateKey(elliptic.P256(), rand.Reader)
+	if err != nil {
+		return nil, err
+	}
+	return webrtc.GenerateCertificate(key)
+}
@@ -0,0 +1,135 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Certificate Pool Tests
+ */
+package sfu
+
+import (
+	"sync"
+	"testing"
+	"time"
+)
+
+func TestCertificatePoolReuse(t *testing.T) {
+	pool := NewCertificatePool(DefaultCertificatePoolConfig())
+	pool.Warm()
+
+	// 并发获取只生成一次
+	certs := make(chan string, 8)
+	var wg sync.WaitGroup
+	for i := 0; i < 8; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			cert := pool.Get()
+			if cert == nil {
+				t.Error("Expected a certificate")
+				return
+			}
+			fingerprints, err := cert.GetFingerprints()
+			if err != nil || len(fingerprints) == 0 {
+				t.Errorf("Failed to get fingerprints: %v", err)
+				return
+			}
+			certs <- fingerprints[0].Value
+		}()
+	}
+	wg.Wait()
+	close(certs)
+
+	first := ""
+	for fingerprint := range certs {
+		if first == "" {
+			first = fingerprint
+		} else if fingerprint != first {
+			t.Error("All callers should share one certificate")
+		}
+	}
+
+	stats := pool.GetStats()
+	if !stats.Ready || stats.Generations != 1 || stats.Reuses != 8 {
+		t.Errorf("Unexpected stats %+v", stats)
+	}
+}
+
+func TestCertificatePoolRotate(t *testing.T) {
+	pool := NewCertificatePool(CertificatePoolConfig{RotateInterval: 10 * time.Millisecond})
+	first := pool.Get()
+	if first == nil {
+		t.Fatal("Expected a certificate")
+	}
+
+	// 超过轮换周期：先返回旧证书，后台生成新证书
+	time.Sleep(20 * time.Millisecond)
+	if cert := pool.Get(); cert != first {
+		t.Error("Rotation should keep serving the old certificate until the new one is ready")
+	}
+
+	deadline := time.Now().Add(2 * time.Second)
+	for pool.GetStats().Generations < 2 {
+		if time.Now().After(deadline) {
+			t.Fatal("Certificate was not rotated")
+		}
+		time.Sleep(5 * time.Millisecond)
+	}
+	if cert := pool.Get(); cert == first {
+		t.Error("Expected the rotated certificate")
+	}
+}
+
+func TestRelayRoomUsesCertificatePool(t *testing.T) {
+	pool := NewCertificatePool(DefaultCertificatePoolConfig())
+	room, err := NewRelayRoom("cert-room", nil, WithCertificatePool(pool))
+	if err != nil {
+		t.Fatalf("Failed to create RelayRoom: %v", err)
+	}
+	defer room.Close()
+
+	for i := 0; i < 3; i++ {
+		w, err := room.newSubscriberPeerConnection()
+		if err != nil {
+			t.Fatalf("Failed to create PeerConnection: %v", err)
+		}
+		w.pc.Close()
+	}
+
+	status := room.GetStatus()
+	if status.Certificate == nil || status.Certificate.Generations != 1 || status.Certificate.Reuses != 3 {
+		t.Errorf("Unexpected certificate stats %+v", status.Certificate)
+	}
+}
+
+// BenchmarkSubscriberPeerConnection 订阅者加入时创建 PeerConnection 的开销：
+// fresh 为 pion 为每个连接生成证书，pooled 为复用共享证书
+func BenchmarkSubscriberPeerConnection(b *testing.B) {
+	cases := []struct {
+		name string
+		pool *CertificatePool
+	}{
+		{"fresh", nil},
+		{"pooled", NewCertificatePool(DefaultCertificatePoolConfig())},
+	}
+	for _, c := range cases {
+		b.Run(c.name, func(b *testing.B) {
+			room, err := NewRelayRoom("bench-room", nil, WithCertificatePool(c.pool))
+			if err != nil {
+				b.Fatalf("Failed to create RelayRoom: %v", err)
+			}
+			defer room.Close()
+			c.pool.Get()
+
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				w, err := room.newSubscriberPeerConnection()
+				if err != nil {
+					b.Fatal(err)
+				}
+				w.pc.Close()
+			}
+		})
+	}
+}
@@ -0,0 +1,273 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Control Channel - Relay 与订阅者之间的带内控制通道
+ * 复用已有的 P2P PeerConnection，建立一个无序、不重传的 DataChannel（label: relay-ctrl），
+ * 心跳、Relay 声明和关键帧请求不再经过 Dart 和应用信令服务器。
+ *
+ * 消息格式（大端）：
+ *   byte 0: 高 4 位版本号 | 低 4 位消息类型
+ *   Ping / Pong:     nonce(4) + timestamp(8, UnixNano，Pong 原样回显)
+ *   Claim:           epoch(8) + score(8, float64) + peerID 长度(1) + peerID
+ *   Handoff:         同 Claim，epoch 为移交后的纪元号，score / peerID 为继任者
+ *   KeyframeRequest: 无负载
+ */
+package sfu
+
+import (
+	"encoding/binary"
+	"math"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	"github.com/pion/webrtc/v4"
+)
+
+// ControlChannelLabel 控制通道 DataChannel 标签（由订阅者在 Offer 中创建）
+const ControlChannelLabel = "relay-ctrl"
+
+const (
+	controlVersion = 1
+
+	controlPingSize  = 1 + 4 + 8
+	controlClaimBase = 1 + 8 + 8 + 1
+)
+
+// ControlMessageType 控制消息类型
+type ControlMessageType uint8
+
+const (
+	ControlMessagePing            ControlMessageType = 1
+	ControlMessagePong            ControlMessageType = 2
+	ControlMessageClaim           ControlMessageType = 3
+	ControlMessageKeyframeRequest ControlMessageType = 4
+	ControlMessageHandoff         ControlMessageType = 5
+)
+
+func (t ControlMessageType) String() string {
+	switch t {
+	case ControlMessagePing:
+		return "ping"
+	case ControlMessagePong:
+		return "pong"
+	case ControlMessageClaim:
+		return "claim"
+	case ControlMessageKeyframeRequest:
+		return "keyframe_request"
+	case ControlMessageHandoff:
+		return "handoff"
+	default:
+		return "unknown"
+	}
+}
+
+// ControlMessage 控制消息
+type ControlMessage struct {
+	Type ControlMessageType
+
+	// Ping / Pong
+	Nonce     uint32
+	Timestamp int64 // 发送 Ping 时的 UnixNano，Pong 原样回显
+
+	// Claim / Handoff
+	Epoch  uint64
+	Score  float64
+	PeerID string
+}
+
+// AppendControlMessage 编码控制消息并追加到 dst
+func AppendControlMessage(dst []byte, msg ControlMessage) []byte {
+	dst = append(dst, controlVersion<<4|byte(msg.Type)&0x0f)
+
+	switch msg.Type {
+	case ControlMessagePing, ControlMessagePong:
+		dst = binary.BigEndian.AppendUint32(dst, msg.Nonce)
+		dst = binary.BigEndian.AppendUint64(dst, uint64(msg.Timestamp))
+	case ControlMessageClaim, ControlMessageHandoff:
+		peerID := msg.PeerID
+		if len(peerID) > math.MaxUint8 {
+			peerID = peerID[:math.MaxUint8]
+		}
+		dst = binary.BigEndian.AppendUint64(dst, msg.Epoch)
+		dst = binary.BigEndian.AppendUint64(dst, math.Float64bits(msg.Score))
+		dst = append(dst, byte(len(peerID)))
+		dst = append(dst, peerID...)
+	}
+	return dst
+}
+
+// MarshalControlMessage 编码控制消息
+func MarshalControlMessage(msg ControlMessage) []byte {
+	return AppendControlMessage(make([]byte, 0, controlClaimBase+len(msg.PeerID)), msg)
+}
+
+// UnmarshalControlMessage 解码控制消息
+func UnmarshalControlMessage(data []byte) (ControlMessage, error) {
+	if len(data) == 0 || data[0]>>4 != controlVersion {
+		return ControlMessage{}, ErrInvalidControlMessage
+	}
+
+	msg := ControlMessage{Type: ControlMessageType(data[0] & 0x0f)}
+	switch msg.Type {
+	case ControlMessagePing, ControlMessagePong:
+		if len(data) < controlPingSize {
+			return ControlMessage{}, ErrInvalidControlMessage
+		}
+		msg.Nonce = binary.BigEndian.Uint32(data[1:])
+		msg.Timestamp = int64(binary.BigEndian.Uint64(data[5:]))
+	case ControlMessageClaim, ControlMessageHandoff:
+		if len(data) < controlClaimBase {
+			return ControlMessage{}, ErrInvalidControlMessage
+		}
+		n := int(data[controlClaimBase-1])
+		if len(data) < controlClaimBase+n {
+			return ControlMessage{}, ErrInvalidControlMessage
+		}
+		msg.Epoch = binary.BigEndian.Uint64(data[1:])
+		msg.Score = math.Float64frombits(binary.BigEndian.Uint64(data[9:]))
+		msg.PeerID = string(data[controlClaimBase : controlClaimBase+n])
+	case ControlMessageKeyframeRequest:
+	default:
+		return ControlMessage{}, ErrInvalidControlMessage
+	}
+	return msg, nil
+}
+
+// ControlChannelStats 控制通道统计
+type ControlChannelStats struct {
+	Open        bool    `json:"open"`
+	MessagesIn  uint64  `json:"messages_in"`
+	MessagesOut uint64  `json:"messages_out"`
+	Invalid     uint64  `json:"invalid"`
+	LastRTT     float64 `json:"last_rtt_ms"`
+}
+
+// ControlChannel 单个订阅者的控制通道
+// 收到 Ping 时直接回复 Pong，其余消息交给 onMessage
+type ControlChannel struct {
+	mu sync.RWMutex
+
+	peerID string
+	dc     *webrtc.DataChannel
+	open   bool
+
+	nonce       atomic.Uint32
+	messagesIn  atomic.Uint64
+	messagesOut atomic.Uint64
+	invalid     atomic.Uint64
+	lastRTT     atomic.Int64
+
+	onOpen    func(peerID string)
+	onMessage func(peerID string, msg ControlMessage)
+}
+
+// NewControlChannel 绑定 DataChannel
+func NewControlChannel(peerID string, dc *webrtc.DataChannel, onOpen func(peerID string), onMessage func(peerID string, msg ControlMessage)) *ControlChannel {
+	c := &ControlChannel{
+		peerID:    peerID,
+		dc:        dc,
+		onOpen:    onOpen,
+		onMessage: onMessage,
+	}
+
+	dc.OnOpen(func() {
+		c.mu.Lock()
+		c.open = true
+		fn := c.onOpen
+		c.mu.Unlock()
+		if fn != nil {
+			fn(c.peerID)
+		}
+	})
+	dc.OnClose(func() {
+		c.mu.Lock()
+		c.open = false
+		c.mu.Unlock()
+	})
+	dc.OnMessage(func(m webrtc.DataChannelMessage) {
+		c.handleMessage(m.Data)
+	})
+	return c
+}
+
+// handleMessage 处理收到的消息
+func (c *ControlChannel) handleMessage(data []byte) {
+	msg, err := UnmarshalControlMessage(data)
+	if err != nil {
+		c.invalid.Add(1)
+		return
+	}
+	c.messagesIn.Add(1)
+
+	switch msg.Type {
+	case ControlMessagePing:
+		// 对端探测本机：原样回显
+		msg.Type = ControlMessagePong
+		c.Send(msg)
+		return
+	case ControlMessagePong:
+		if msg.Timestamp > 0 {
+			if rtt := time.Now().UnixNano() - msg.Timestamp; rtt >= 0 {
+				c.lastRTT.Store(rtt)
+			}
+		}
+	}
+
+	c.mu.RLock()
+	fn := c.onMessage
+	c.mu.RUnlock()
+	if fn != nil {
+		fn(c.peerID, msg)
+	}
+}
+
+// IsOpen 通道是否可用
+func (c *ControlChannel) IsOpen() bool {
+	c.mu.RLock()
+	defer c.mu.RUnlock()
+	return c.open
+}
+
+// Send 发送控制消息
+func (c *ControlChannel) Send(msg ControlMessage) error {
+	if !c.IsOpen() {
+		return ErrControlChannelNotOpen
+	}
+	var buf [controlClaimBase + math.MaxUint8]byte
+	if err := c.dc.Send(AppendControlMessage(buf[:0], msg)); err != nil {
+		return err
+	}
+	c.messagesOut.Add(1)
+	return nil
+}
+
+// SendPing 发送 Ping
+func (c *ControlChannel) SendPing() error {
+	return c.Send(ControlMessage{
+		Type:      ControlMessagePing,
+		Nonce:     c.nonce.Add(1),
+		Timestamp: time.Now().UnixNano(),
+	})
+}
+
+// GetStats 获取统计
+func (c *ControlChannel) GetStats() ControlChannelStats {
+	return ControlChannelStats{
+		Open:        c.IsOpen(),
+		MessagesIn:  c.messagesIn.Load(),
+		MessagesOut: c.messagesOut.Load(),
+		Invalid:     c.invalid.Load(),
+		LastRTT:     float64(c.lastRTT.Load()) / float64(time.Millisecond),
+	}
+}
+
+// Close 关闭通道
+func (c *ControlChannel) Close() {
+	c.mu.Lock()
+	c.open = false
+	c.mu.Unlock()
+	c.dc.Close()
+}
@@ -0,0 +1,230 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Control Channel Tests
+ */
+package sfu
+
+import (
+	"testing"
+	"time"
+
+	"github.com/pion/logging"
+	"github.com/pion/transport/v3/vnet"
+	"github.com/pion/webrtc/v4"
+)
+
+func TestControlMessageRoundTrip(t *testing.T) {
+	messages := []ControlMessage{
+		{Type: ControlMessagePing, Nonce: 7, Timestamp: 1_700_000_000_123_456_789},
+		{Type: ControlMessagePong, Nonce: 0xffffffff, Timestamp: 42},
+		{Type: ControlMessageClaim, Epoch: 12, Score: 87.5, PeerID: "relay-peer"},
+		{Type: ControlMessageKeyframeRequest},
+		{Type: ControlMessageHandoff, Epoch: 13, Score: 92, PeerID: "successor-peer"},
+	}
+	for _, msg := range messages {
+		data := MarshalControlMessage(msg)
+		got, err := UnmarshalControlMessage(data)
+		if err != nil {
+			t.Fatalf("%s: %v", msg.Type, err)
+		}
+		if got != msg {
+			t.Errorf("%s: got %+v, want %+v", msg.Type, got, msg)
+		}
+	}
+
+	// 二进制格式远小于 JSON 信令
+	if n := len(MarshalControlMessage(messages[0])); n != controlPingSize {
+		t.Errorf("Ping size = %d", n)
+	}
+	if n := len(MarshalControlMessage(messages[3])); n != 1 {
+		t.Errorf("Keyframe request size = %d", n)
+	}
+}
+
+func TestControlMessageInvalid(t *testing.T) {
+	valid := MarshalControlMessage(ControlMessage{Type: ControlMessageClaim, Epoch: 1, PeerID: "abc"})
+	inputs := [][]byte{
+		nil,
+		{0x00},                     // 版本错误
+		{controlVersion<<4 | 0x0f}, // 未知类型
+		MarshalControlMessage(ControlMessage{Type: ControlMessagePing})[:5],
+		valid[:len(valid)-1], // peerID 截断
+	}
+	for i, data := range inputs {
+		if _, err := UnmarshalControlMessage(data); err != ErrInvalidControlMessage {
+			t.Errorf("input %d: expected ErrInvalidControlMessage, got %v", i, err)
+		}
+	}
+}
+
+func TestRelayRoomControlChannel(t *testing.T) {
+	wan, err := vnet.NewRouter(&vnet.RouterConfig{
+		CIDR:          "1.2.3.0/24",
+		LoggerFactory: logging.NewDefaultLoggerFactory(),
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	net1, _ := vnet.NewNet(&vnet.NetConfig{StaticIP: "1.2.3.4"})
+	wan.AddNet(net1)
+	net2, _ := vnet.NewNet(&vnet.NetConfig{StaticIP: "1.2.3.5"})
+	wan.AddNet(net2)
+	if err := wan.Start(); err != nil {
+		t.Fatal(err)
+	}
+	defer wan.Stop()
+
+	se1 := webrtc.SettingEngine{}
+	se1.SetNet(net1)
+	relay, err := NewRelayRoom("ctrl-room", nil, WithWebRTCAPI(webrtc.NewAPI(webrtc.WithSettingEngine(se1))))
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer relay.Close()
+	relay.BecomeRelay("relay-1")
+
+	opened := make(chan string, 1)
+	pongs := make(chan ControlMessage, 4)
+	keyframes := make(chan struct{}, 4)
+	relay.SetControlCallbacks(
+		func(roomID, peerID string) {
+			relay.SendControl(peerID, ControlMessage{Type: ControlMessageClaim, Epoch: 3, Score: 90, PeerID: "relay-1"})
+			opened <- peerID
+		},
+		func(roomID, peerID string, msg ControlMessage) {
+			if msg.Type == ControlMessagePong {
+				pongs <- msg
+			}
+		},
+	)
+	relay.SetKeyframeRequestCallback(func(roomID string) {
+		select {
+		case keyframes <- struct{}{}:
+		default:
+		}
+	})
+
+	se2 := webrtc.SettingEngine{}
+	se2.SetNet(net2)
+	clientPC, err := webrtc.NewAPI(webrtc.WithSettingEngine(se2)).NewPeerConnection(webrtc.Configuration{})
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer clientPC.Close()
+
+	relay.SetCallbacks(nil, nil, func(roomID, peerID string, c *webrtc.ICECandidate) {
+		if c != nil {
+			clientPC.AddICECandidate(c.ToJSON())
+		}
+	}, nil, nil)
+	clientPC.OnICECandidate(func(c *webrtc.ICECandidate) {
+		if c != nil {
+			relay.AddICECandidate("client-1", c.ToJSON())
+		}
+	})
+
+	// 订阅者创建无序、不重传的控制通道，收到 Ping 回 Pong
+	ordered := false
+	maxRetransmits := uint16(0)
+	dc, err := clientPC.CreateDataChannel(ControlChannelLabel, &webrtc.DataChannelInit{
+		Ordered:        &ordered,
+		MaxRetransmits: &maxRetransmits,
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	claims := make(chan ControlMessage, 1)
+	dc.OnMessage(func(m webrtc.DataChannelMessage) {
+		msg, err := UnmarshalControlMessage(m.Data)
+		if err != nil {
+			return
+		}
+		switch msg.Type {
+		case ControlMessagePing:
+			msg.Type = ControlMessagePong
+			dc.Send(MarshalControlMessage(msg))
+		case ControlMessageClaim:
+			claims <- msg
+		}
+	})
+
+	clientPC.AddTransceiverFromKind(webrtc.RTPCodecTypeVideo, webrtc.RTPTransceiverInit{
+		Direction: webrtc.RTPTransceiverDirectionRecvonly,
+	})
+	offer, _ := clientPC.CreateOffer(nil)
+	clientPC.SetLocalDescription(offer)
+	answer, err := relay.AddSubscriber("client-1", offer.SDP)
+	if err != nil {
+		t.Fatalf("AddSubscriber failed: %v", err)
+	}
+	clientPC.SetRemoteDescription(webrtc.SessionDescription{Type: webrtc.SDPTypeAnswer, SDP: answer})
+
+	select {
+	case peerID := <-opened:
+		if peerID != "client-1" {
+			t.Errorf("Unexpected peer %s", peerID)
+		}
+	case <-time.After(10 * time.Second):
+		t.Fatal("Control channel did not open")
+	}
+
+	select {
+	case claim := <-claims:
+		if claim.Epoch != 3 || claim.PeerID != "relay-1" {
+			t.Errorf("Unexpected claim %+v", claim)
+		}
+	case <-time.After(2 * time.Second):
+		t.Error("Claim not received")
+	}
+
+	if !relay.HasControlChannel("client-1") {
+		t.Fatal("Expected control channel to be open")
+	}
+	if err := relay.SendControlPing("client-1"); err != nil {
+		t.Fatalf("SendControlPing failed: %v", err)
+	}
+	select {
+	case <-pongs:
+	case <-time.After(2 * time.Second):
+		t.Error("Pong not received")
+	}
+
+	// 订阅者通过控制通道请求关键帧
+	for len(keyframes) > 0 {
+		<-keyframes
+	}
+	dc.Send(MarshalControlMessage(ControlMessage{Type: ControlMessageKeyframeRequest}))
+	select {
+	case <-keyframes:
+	case <-time.After(2 * time.Second):
+		t.Error("Keyframe request not forwarded")
+	}
+
+	status := relay.GetStatus()
+	if len(status.Subscribers) != 1 || status.Subscribers[0].ControlChannel == nil ||
+		status.Subscribers[0].ControlChannel.MessagesIn < 2 {
+		t.Errorf("Unexpected control channel stats: %+v", status.Subscribers)
+	}
+
+	if err := relay.SendControlPing("unknown"); err != ErrControlChannelNotOpen {
+		t.Errorf("Expected ErrControlChannelNotOpen, got %v", err)
+	}
+}
+
+// BenchmarkControlMessageCodec 编解码开销
+func BenchmarkControlMessageCodec(b *testing.B) {
+	msg := ControlMessage{Type: ControlMessagePing, Nonce: 1, Timestamp: time.Now().UnixNano()}
+	buf := make([]byte, 0, 64)
+	b.ReportAllocs()
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		buf = AppendControlMessage(buf[:0], msg)
+		if _, err := UnmarshalControlMessage(buf); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
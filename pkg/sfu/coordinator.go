@@ -11,6 +11,8 @@
  * - FailoverManager 协调切换
  * - RelayRoom 管理 P2P 连接
  * - SourceSwitcher 切换数据源
+ * - DevicePolicy 按设备温度 / 电量调整 Relay 负载
+ * - Relay 主动离开时计划内移交（先建后断）
  *
  * 用户只需调用一个 Enable 方法，其他全自动。
  */
@@ -22,6 +24,7 @@ import (
 	"time"
 
 	"github.com/maiguangyang/relay_core/pkg/election"
+	"github.com/maiguangyang/relay_core/pkg/utils"
 )
 
 // CoordinatorConfig 协调器配置
@@ -36,6 +39,10 @@ type CoordinatorConfig struct {
 
 	// Election 配置
 	ElectionInterval time.Duration
+
+	// 计划内移交配置
+	HandoffTimeout time.Duration // 继任者接管超时，超时放弃移交
+	HandoffDrain   time.Duration // 继任者接管后旧 Relay 最多继续转发的时间
 }
 
 // DefaultCoordinatorConfig 默认配置
@@ -46,6 +53,8 @@ func DefaultCoordinatorConfig() CoordinatorConfig {
 		FailoverBackoffPerPoint:  10 * time.Millisecond,
 		FailoverOfflineThreshold: 4, // 增加到 4 次重试，防止误判
 		ElectionInterval:         5 * time.Second,
+		HandoffTimeout:           10 * time.Second,
+		HandoffDrain:             5 * time.Second,
 	}
 }
 
@@ -53,11 +62,15 @@ func DefaultCoordinatorConfig() CoordinatorConfig {
 type CoordinatorEventType int
 
 const (
-	CoordinatorEventRelayChanged CoordinatorEventType = iota // Relay 节点变更
-	CoordinatorEventBecomeRelay                              // 本机成为 Relay
-	CoordinatorEventRelayFailed                              // Relay 失效
-	CoordinatorEventPeerJoined                               // 新 Peer 加入
-	CoordinatorEventPeerLeft                                 // Peer 离开
+	CoordinatorEventRelayChanged   CoordinatorEventType = iota // Relay 节点变更
+	CoordinatorEventBecomeRelay                                // 本机成为 Relay
+	CoordinatorEventRelayFailed                                // Relay 失效
+	CoordinatorEventPeerJoined                                 // 新 Peer 加入
+	CoordinatorEventPeerLeft                                   // Peer 离开
+	CoordinatorEventActiveSpeaker                              // 活跃发言者变化
+	CoordinatorEventPingRound                                  // 一轮需要经信令发送的 ping
+	CoordinatorEventDeviceThrottle                             // 设备负载限制变化（过热 / 低电量）
+	CoordinatorEventHandoff                                    // 计划内 Relay 移交进度
 )
 
 // CoordinatorEvent 协调器事件
@@ -84,6 +97,10 @@ type ProxyModeCoordinator struct {
 	failover  *FailoverManager
 	relayRoom *RelayRoom
 	switcher  *SourceSwitcher
+	policy    *DevicePolicy
+
+	// 创建 RelayRoom 时附加的选项
+	roomOptions []RelayRoomOption
 
 	// 状态
 	isRelay        bool
@@ -93,6 +110,12 @@ type ProxyModeCoordinator struct {
 	// 所有已知的 Peer
 	peers map[string]bool
 
+	// 进行中的计划内移交
+	handoff relayHandoff
+
+	// 本机作为订阅者连接当前 Relay 的控制通道（连接由外部持有）
+	relayControl func(relayID string, msg ControlMessage) error
+
 	// 事件回调
 	onEvent func(event CoordinatorEvent)
 
@@ -141,6 +164,7 @@ func NewProxyModeCoordinator(roomID, localPeerID string, config CoordinatorConfi
 		keepalive:   keepalive,
 		failover:    failover,
 		switcher:    switcher,
+		policy:      NewDevicePolicy(DefaultDevicePolicyConfig()),
 		peers:       make(map[string]bool),
 		stopCh:      make(chan struct{}),
 	}
@@ -153,13 +177,23 @@ func NewProxyModeCoordinator(roomID, localPeerID string, config CoordinatorConfi
 
 // setupCallbacks 设置所有组件的回调
 func (pmc *ProxyModeCoordinator) setupCallbacks() {
-	// Keepalive: Ping 请求 -> 由外部信令发送
-	pmc.keepalive.SetOnPing(func(peerID string) {
+	// Keepalive: 每轮 Ping -> 优先走控制通道，其余 Peer 合并成一个事件由外部信令发送
+	pmc.keepalive.SetOnPingRound(func(round PingRound) {
+		room := pmc.GetRelayRoom()
+		pending := round.PeerIDs[:0]
+		for _, peerID := range round.PeerIDs {
+			if room != nil && room.SendControlPing(peerID) == nil {
+				continue
+			}
+			pending = append(pending, peerID)
+		}
+		if len(pending) == 0 {
+			return
+		}
 		pmc.emitEvent(CoordinatorEvent{
-			Type:   CoordinatorEventPeerLeft, // 用特殊 type 触发 ping
+			Type:   CoordinatorEventPingRound,
 			RoomID: pmc.roomID,
-			PeerID: peerID,
-			Data:   map[string]interface{}{"action": "ping_request"},
+			Data:   map[string]interface{}{"seq": round.Seq, "peers": pending},
 		})
 	})
 
@@ -199,6 +233,23 @@ func (pmc *ProxyModeCoordinator) setupCallbacks() {
 		},
 	)
 
+	// 活跃发言者变化
+	pmc.switcher.SetOnActiveSpeakersChanged(func(roomID string, speakers []ActiveSpeaker) {
+		dominant := ""
+		if len(speakers) > 0 {
+			dominant = speakers[0].ParticipantID
+		}
+		pmc.emitEvent(CoordinatorEvent{
+			Type:   CoordinatorEventActiveSpeaker,
+			RoomID: roomID,
+			PeerID: dominant,
+			Data:   map[string]interface{}{"speakers": speakers},
+		})
+	})
+
+	// 设备过热 / 低电量：调整负载
+	pmc.policy.SetOnChange(pmc.applyDeviceThrottle)
+
 	// 源切换器回调
 	pmc.switcher.SetOnSourceChanged(func(roomID string, sourceType SourceType, sharerID string) {
 		pmc.emitEvent(CoordinatorEvent{
@@ -241,32 +292,8 @@ func (pmc *ProxyModeCoordinator) handleBecomeRelay() {
 	pmc.mu.Unlock()
 
 	// 自动创建 RelayRoom（如果还没有）
-	if pmc.relayRoom == nil {
-		// 传入 Coordinator 的 SourceSwitcher，确保与 LiveKitBridge 共享同一个实例
-		room, err := NewRelayRoom(pmc.roomID, nil, WithSourceSwitcher(pmc.switcher))
-		if err == nil {
-			pmc.relayRoom = room
-			room.BecomeRelay(pmc.localPeerID)
-
-			// 设置 RelayRoom 回调
-			room.SetCallbacks(
-				func(roomID, peerID string) {
-					pmc.emitEvent(CoordinatorEvent{
-						Type:   CoordinatorEventPeerJoined,
-						RoomID: roomID,
-						PeerID: peerID,
-					})
-				},
-				func(roomID, peerID string) {
-					pmc.emitEvent(CoordinatorEvent{
-						Type:   CoordinatorEventPeerLeft,
-						RoomID: roomID,
-						PeerID: peerID,
-					})
-				},
-				nil, nil, nil,
-			)
-		}
+	if _, err := pmc.ensureRelayRoom(); err != nil {
+		utils.Error("[Coordinator] Failed to create RelayRoom %s: %v", pmc.roomID, err)
 	}
 
 	pmc.emitEvent(CoordinatorEvent{
@@ -279,6 +306,139 @@ func (pmc *ProxyModeCoordinator) handleBecomeRelay() {
 	})
 }
 
+// ensureRelayRoom 获取 RelayRoom，不存在时创建
+func (pmc *ProxyModeCoordinator) ensureRelayRoom() (*RelayRoom, error) {
+	if room := pmc.GetRelayRoom(); room != nil {
+		return room, nil
+	}
+
+	// 传入 Coordinator 的 SourceSwitcher，确保与 LiveKitBridge 共享同一个实例
+	pmc.mu.RLock()
+	opts := append([]RelayRoomOption{WithSourceSwitcher(pmc.switcher)}, pmc.roomOptions...)
+	pmc.mu.RUnlock()
+	room, err := NewRelayRoom(pmc.roomID, nil, opts...)
+	if err != nil {
+		return nil, err
+	}
+
+	pmc.mu.Lock()
+	if existing := pmc.relayRoom; existing != nil {
+		pmc.mu.Unlock()
+		room.Close()
+		return existing, nil
+	}
+	pmc.relayRoom = room
+	pmc.mu.Unlock()
+	room.BecomeRelay(pmc.localPeerID)
+	pmc.bindRelayRoom(room)
+
+	// 新订阅者（包括移交时预协商的订阅者）需要关键帧
+	room.SetKeyframeRequestCallback(func(roomID string) {
+		if bridge := GetBridge(roomID); bridge != nil {
+			bridge.RequestKeyframe()
+		}
+	})
+
+	// 设置 RelayRoom 回调
+	room.SetCallbacks(
+		func(roomID, peerID string) {
+			pmc.emitEvent(CoordinatorEvent{
+				Type:   CoordinatorEventPeerJoined,
+				RoomID: roomID,
+				PeerID: peerID,
+			})
+		},
+		func(roomID, peerID string) {
+			// 离开的订阅者不再参与上游质量需求
+			if bridge := GetBridge(roomID); bridge != nil {
+				bridge.RemoveSubscriberViewport(peerID)
+			}
+			pmc.emitEvent(CoordinatorEvent{
+				Type:   CoordinatorEventPeerLeft,
+				RoomID: roomID,
+				PeerID: peerID,
+			})
+			pmc.checkHandoffDrained()
+		},
+		nil, nil, nil,
+	)
+	return room, nil
+}
+
+// bindRelayRoom 订阅者上限跟随设备策略，控制通道的心跳 Pong 和 Relay 声明直接在 Go 层消费
+func (pmc *ProxyModeCoordinator) bindRelayRoom(room *RelayRoom) {
+	room.SetMaxSubscribers(pmc.policy.Current().MaxSubscribers)
+	room.SetControlCallbacks(
+		func(roomID, peerID string) {
+			room.SendControl(peerID, pmc.relayClaim())
+		},
+		pmc.handleControlMessage,
+	)
+}
+
+// AttachRelayRoom 改用外部创建的 RelayRoom（FFI RelayRoomCreate），自动创建的房间随之关闭
+// 订阅者实际连接在外部房间上，控制通道、移交通知和迁移等待都需要作用于它；
+// 外部房间的订阅者离开时调用 HandleSubscriberLeft
+func (pmc *ProxyModeCoordinator) AttachRelayRoom(room *RelayRoom) {
+	pmc.mu.Lock()
+	old := pmc.relayRoom
+	pmc.relayRoom = room
+	pmc.mu.Unlock()
+
+	if old != nil && old != room {
+		old.Close()
+	}
+	pmc.bindRelayRoom(room)
+}
+
+// DetachRelayRoom 外部房间销毁时解除关联
+func (pmc *ProxyModeCoordinator) DetachRelayRoom(room *RelayRoom) {
+	pmc.mu.Lock()
+	if pmc.relayRoom == room {
+		pmc.relayRoom = nil
+	}
+	pmc.mu.Unlock()
+}
+
+// HandleSubscriberLeft 外部房间的订阅者离开（移交中的旧 Relay 据此判断迁移是否完成）
+func (pmc *ProxyModeCoordinator) HandleSubscriberLeft(peerID string) {
+	pmc.checkHandoffDrained()
+}
+
+// SetRelayRoomOptions 设置创建 RelayRoom 时附加的选项（例如自定义 WebRTC API）
+func (pmc *ProxyModeCoordinator) SetRelayRoomOptions(opts ...RelayRoomOption) {
+	pmc.mu.Lock()
+	defer pmc.mu.Unlock()
+	pmc.roomOptions = opts
+}
+
+// relayClaim 本机的 Relay 声明
+func (pmc *ProxyModeCoordinator) relayClaim() ControlMessage {
+	pmc.mu.RLock()
+	epoch := pmc.epoch
+	pmc.mu.RUnlock()
+	return ControlMessage{
+		Type:   ControlMessageClaim,
+		Epoch:  epoch,
+		Score:  pmc.failover.GetLocalScore(),
+		PeerID: pmc.localPeerID,
+	}
+}
+
+// handleControlMessage 处理订阅者控制通道消息
+func (pmc *ProxyModeCoordinator) handleControlMessage(roomID, peerID string, msg ControlMessage) {
+	switch msg.Type {
+	case ControlMessagePong:
+		pmc.HandlePong(peerID)
+	case ControlMessageClaim:
+		claimer := msg.PeerID
+		if claimer == "" {
+			claimer = peerID
+		}
+		pmc.ReceiveRelayClaim(claimer, msg.Epoch, msg.Score)
+	}
+}
+
 // Start 启动协调器
 func (pmc *ProxyModeCoordinator) Start() {
 	pmc.mu.Lock()
@@ -339,6 +499,14 @@ func (pmc *ProxyModeCoordinator) HandlePong(peerID string) {
 	pmc.failover.ResetOfflineCount(peerID)
 }
 
+// HandlePongBatch 批量处理第 seq 轮的 Pong 响应（seq 为 0 表示未知轮次）
+func (pmc *ProxyModeCoordinator) HandlePongBatch(seq uint64, peerIDs []string) {
+	pmc.keepalive.HandlePongBatch(seq, peerIDs)
+	for _, peerID := range peerIDs {
+		pmc.failover.ResetOfflineCount(peerID)
+	}
+}
+
 // SetCurrentRelay 设置当前 Relay（由外部信令通知）
 func (pmc *ProxyModeCoordinator) SetCurrentRelay(relayID string, epoch uint64) {
 	pmc.mu.Lock()
@@ -348,6 +516,7 @@ func (pmc *ProxyModeCoordinator) SetCurrentRelay(relayID string, epoch uint64) {
 	pmc.mu.Unlock()
 
 	pmc.failover.SetCurrentRelay(relayID, epoch)
+	pmc.handleSuccessorClaim(relayID, epoch)
 }
 
 // ReceiveRelayClaim 接收 Relay 声明（来自其他节点）
@@ -361,6 +530,9 @@ func (pmc *ProxyModeCoordinator) ReceiveRelayClaim(peerID string, epoch uint64,
 		pmc.isRelay = false
 	}
 	pmc.mu.Unlock()
+
+	// 继任者已接管：旧 Relay 等待订阅者迁移
+	pmc.handleSuccessorClaim(peerID, epoch)
 }
 
 // UpdateLocalDeviceInfo 更新本机设备信息
@@ -372,16 +544,76 @@ func (pmc *ProxyModeCoordinator) UpdateLocalDeviceInfo(deviceType, connectionTyp
 		election.PowerState(powerState),
 	)
 
-	// 更新本机在 Failover 中的分数
+	pmc.updateLocalScore()
+}
+
+// UpdateLocalDeviceState 更新本机温度和电量（batteryPercent 为负数表示未知）
+// 充电状态取自最近一次上报的 PowerState
+func (pmc *ProxyModeCoordinator) UpdateLocalDeviceState(thermal ThermalState, batteryPercent int) {
+	charging := false
+	for _, c := range pmc.elector.GetCandidates() {
+		if c.PeerID == pmc.localPeerID {
+			charging = c.PowerState == election.PowerStatePluggedIn
+			break
+		}
+	}
+	pmc.policy.Update(DeviceState{
+		Thermal:        thermal,
+		BatteryPercent: batteryPercent,
+		Charging:       charging,
+	})
+}
+
+// DeviceThrottle 当前生效的设备负载限制
+func (pmc *ProxyModeCoordinator) DeviceThrottle() DeviceThrottle {
+	return pmc.policy.Current()
+}
+
+// updateLocalScore 更新本机在 Failover 中的分数（选举分数 x 设备策略倍数）
+func (pmc *ProxyModeCoordinator) updateLocalScore() {
 	candidates := pmc.elector.GetCandidates()
 	for _, c := range candidates {
 		if c.PeerID == pmc.localPeerID {
-			pmc.failover.UpdateLocalScore(c.Score)
+			pmc.failover.UpdateLocalScore(c.Score * pmc.policy.Current().ScoreMultiplier)
 			break
 		}
 	}
 }
 
+// applyDeviceThrottle 应用设备负载限制
+func (pmc *ProxyModeCoordinator) applyDeviceThrottle(throttle DeviceThrottle) {
+	if room := pmc.GetRelayRoom(); room != nil {
+		room.SetMaxSubscribers(throttle.MaxSubscribers)
+	}
+	if bridge := GetBridge(pmc.roomID); bridge != nil {
+		bridge.SetMaxUpstreamQuality(throttle.MaxUpstream)
+	}
+	pmc.keepalive.SetInterval(time.Duration(float64(pmc.config.KeepaliveInterval) * throttle.KeepaliveScale))
+	pmc.updateLocalScore()
+
+	// 本机是 Relay 且需要移交时，发起计划内移交（新 Relay 接管前继续转发）
+	handoff := throttle.Level == ThrottleHandoff && pmc.IsRelay()
+	if handoff {
+		go func() {
+			if _, err := pmc.StartHandoff(throttle.Reason); err != nil && err != ErrHandoffInProgress {
+				utils.Warn("[Coordinator] Handoff on %s throttle failed: %v", throttle.Reason, err)
+			}
+		}()
+	}
+	pmc.emitEvent(CoordinatorEvent{
+		Type:   CoordinatorEventDeviceThrottle,
+		RoomID: pmc.roomID,
+		PeerID: pmc.localPeerID,
+		Data: map[string]interface{}{
+			"level":           throttle.Level.String(),
+			"reason":          throttle.Reason,
+			"max_subscribers": throttle.MaxSubscribers,
+			"max_upstream":    throttle.MaxUpstream.String(),
+			"handoff":         handoff,
+		},
+	})
+}
+
 // InjectSFUPacket 注入 SFU RTP 包
 func (pmc *ProxyModeCoordinator) InjectSFUPacket(isVideo bool, data []byte) error {
 	return pmc.switcher.InjectSFUPacket(isVideo, data)
@@ -434,6 +666,8 @@ func (pmc *ProxyModeCoordinator) GetStatus() map[string]interface{} {
 		"epoch":          pmc.epoch,
 		"peer_count":     len(pmc.peers),
 		"failover_state": pmc.failover.GetState().String(),
+		"device_policy":  pmc.policy.GetStatus(),
+		"handoff":        pmc.handoff.status(),
 	}
 
 	if pmc.switcher != nil {
@@ -470,6 +704,8 @@ func (pmc *ProxyModeCoordinator) IsRelay() bool {
 
 // GetRelayRoom 获取 RelayRoom（仅当本机是 Relay 时有效）
 func (pmc *ProxyModeCoordinator) GetRelayRoom() *RelayRoom {
+	pmc.mu.RLock()
+	defer pmc.mu.RUnlock()
 	return pmc.relayRoom
 }
 
@@ -490,17 +726,27 @@ func (pmc *ProxyModeCoordinator) Close() {
 
 	close(pmc.stopCh)
 
+	pmc.mu.Lock()
+	if pmc.handoff.timer != nil {
+		pmc.handoff.timer.Stop()
+	}
+	pmc.handoff = relayHandoff{}
+	pmc.mu.Unlock()
+
 	if pmc.keepalive != nil {
 		pmc.keepalive.Stop()
 	}
+	if pmc.policy != nil {
+		pmc.policy.Close()
+	}
 	if pmc.elector != nil {
 		pmc.elector.Close()
 	}
 	if pmc.failover != nil {
 		pmc.failover.Close()
 	}
-	if pmc.relayRoom != nil {
-		pmc.relayRoom.Close()
+	if room := pmc.GetRelayRoom(); room != nil {
+		room.Close()
 	}
 	if pmc.switcher != nil {
 		pmc.switcher.Close()
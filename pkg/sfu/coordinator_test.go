@@ -184,6 +184,47 @@ func TestCoordinatorHandlePong(t *testing.T) {
 	// 主要验证不崩溃
 }
 
+func TestCoordinatorPingRound(t *testing.T) {
+	pmc, err := NewProxyModeCoordinator("test-room", "local-peer", DefaultCoordinatorConfig())
+	if err != nil {
+		t.Fatalf("Failed to create coordinator: %v", err)
+	}
+	defer pmc.Close()
+
+	events := make(chan CoordinatorEvent, 4)
+	pmc.SetOnEvent(func(event CoordinatorEvent) {
+		if event.Type == CoordinatorEventPingRound {
+			events <- event
+		}
+	})
+	for _, peerID := range []string{"peer-1", "peer-2", "peer-3"} {
+		pmc.AddPeer(peerID, 1, 1, 1)
+	}
+
+	// 没有控制通道时，整轮 ping 合并为一个事件
+	pmc.keepalive.checkAll()
+	var event CoordinatorEvent
+	select {
+	case event = <-events:
+	case <-time.After(time.Second):
+		t.Fatal("Ping round event not emitted")
+	}
+	peers, _ := event.Data["peers"].([]string)
+	if len(peers) != 3 || event.Data["seq"] != uint64(1) {
+		t.Errorf("Unexpected ping round data %+v", event.Data)
+	}
+	select {
+	case extra := <-events:
+		t.Errorf("Expected a single ping round event, got extra %+v", extra.Data)
+	case <-time.After(50 * time.Millisecond):
+	}
+
+	pmc.HandlePongBatch(1, peers)
+	if status := pmc.keepalive.GetPeerStatus("peer-2"); status != PeerStatusOnline {
+		t.Errorf("Expected peer-2 online, got %v", status)
+	}
+}
+
 func TestCoordinatorGetStatusJSON(t *testing.T) {
 	config := DefaultCoordinatorConfig()
 	pmc, err := NewProxyModeCoordinator("test-room", "local-peer", config)
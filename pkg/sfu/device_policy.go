@@ -0,0 +1,309 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Device Policy - 按设备温度和电量调整 Relay 负载
+ * 移动端 Relay 发热或电量下降时，在系统降频之前主动减负：
+ *
+ *   Light    限制订阅者数量，放宽心跳间隔，选举分数降权
+ *   Heavy    进一步限制订阅者，上游最高只拉 MEDIUM 层
+ *   Handoff  上游只拉 LOW 层，并请求把 Relay 交给其他设备
+ *
+ * 等级取温度和电量两者中较高的一个；充电时不按电量降级。
+ * 升级立即生效，降级需要目标等级持续 RelaxHold（温度状态通常来回抖动）。
+ */
+package sfu
+
+import (
+	"sync"
+	"time"
+)
+
+// ThermalState 设备温度状态（与 iOS ProcessInfo.ThermalState 一致，Android 按 THERMAL_STATUS 映射）
+type ThermalState int
+
+const (
+	ThermalNominal  ThermalState = iota // 正常
+	ThermalFair                         // 偏热
+	ThermalSerious                      // 过热，系统即将降频
+	ThermalCritical                     // 严重过热
+)
+
+func (t ThermalState) String() string {
+	switch t {
+	case ThermalFair:
+		return "fair"
+	case ThermalSerious:
+		return "serious"
+	case ThermalCritical:
+		return "critical"
+	default:
+		return "nominal"
+	}
+}
+
+// ThrottleLevel 负载限制等级
+type ThrottleLevel int
+
+const (
+	ThrottleNone    ThrottleLevel = iota // 不限制
+	ThrottleLight                        // 轻度限制
+	ThrottleHeavy                        // 重度限制
+	ThrottleHandoff                      // 请求移交 Relay
+	throttleLevelCount
+)
+
+func (l ThrottleLevel) String() string {
+	switch l {
+	case ThrottleLight:
+		return "light"
+	case ThrottleHeavy:
+		return "heavy"
+	case ThrottleHandoff:
+		return "handoff"
+	default:
+		return "none"
+	}
+}
+
+// ThrottleLimits 某一等级下的负载限制
+type ThrottleLimits struct {
+	// 最大订阅者数，0 表示不限制（已连接的订阅者不会被断开）
+	MaxSubscribers int
+	// 向上游请求的最高视频质量
+	MaxUpstream UpstreamQuality
+	// 心跳间隔倍数
+	KeepaliveScale float64
+	// 选举分数倍数（过热 / 低电量的设备不应被选为 Relay）
+	ScoreMultiplier float64
+}
+
+// DevicePolicyConfig 设备策略配置
+type DevicePolicyConfig struct {
+	// 未充电时电量低于该百分比进入对应等级
+	LightBattery   int
+	HeavyBattery   int
+	HandoffBattery int
+	// 各等级的负载限制，按 ThrottleLevel 索引
+	Limits [throttleLevelCount]ThrottleLimits
+	// 降级前目标等级需要持续的时间
+	RelaxHold time.Duration
+}
+
+// DefaultDevicePolicyConfig 返回默认配置
+func DefaultDevicePolicyConfig() DevicePolicyConfig {
+	return DevicePolicyConfig{
+		LightBattery:   40,
+		HeavyBattery:   20,
+		HandoffBattery: 10,
+		Limits: [throttleLevelCount]ThrottleLimits{
+			ThrottleNone:    {MaxSubscribers: 0, MaxUpstream: UpstreamQualityHigh, KeepaliveScale: 1, ScoreMultiplier: 1},
+			ThrottleLight:   {MaxSubscribers: 8, MaxUpstream: UpstreamQualityHigh, KeepaliveScale: 1.5, ScoreMultiplier: 0.8},
+			ThrottleHeavy:   {MaxSubscribers: 4, MaxUpstream: UpstreamQualityMedium, KeepaliveScale: 2, ScoreMultiplier: 0.5},
+			ThrottleHandoff: {MaxSubscribers: 4, MaxUpstream: UpstreamQualityLow, KeepaliveScale: 2, ScoreMultiplier: 0.1},
+		},
+		RelaxHold: 30 * time.Second,
+	}
+}
+
+// DeviceState 设备状态
+type DeviceState struct {
+	Thermal        ThermalState
+	BatteryPercent int // 0-100，负数表示未知
+	Charging       bool
+}
+
+// DeviceThrottle 当前生效的负载限制
+type DeviceThrottle struct {
+	ThrottleLimits
+	Level  ThrottleLevel
+	Reason string // thermal / battery，不限制时为空
+}
+
+// DevicePolicyStatus 设备策略状态
+type DevicePolicyStatus struct {
+	Level           string  `json:"level"`
+	Reason          string  `json:"reason,omitempty"`
+	Thermal         string  `json:"thermal"`
+	BatteryPercent  int     `json:"battery_percent"`
+	Charging        bool    `json:"charging"`
+	MaxSubscribers  int     `json:"max_subscribers"`
+	MaxUpstream     string  `json:"max_upstream"`
+	KeepaliveScale  float64 `json:"keepalive_scale"`
+	ScoreMultiplier float64 `json:"score_multiplier"`
+	Changes         uint64  `json:"changes"`
+}
+
+// DevicePolicy 设备策略引擎
+type DevicePolicy struct {
+	mu sync.Mutex
+
+	config DevicePolicyConfig
+	state  DeviceState
+
+	level  ThrottleLevel
+	reason string
+
+	candidate      ThrottleLevel
+	candidateSince time.Time
+	relaxTimer     *time.Timer
+
+	changes uint64
+	closed  bool
+
+	onChange func(throttle DeviceThrottle)
+}
+
+// NewDevicePolicy 创建设备策略引擎
+func NewDevicePolicy(config DevicePolicyConfig) *DevicePolicy {
+	return &DevicePolicy{
+		config: config,
+		state:  DeviceState{BatteryPercent: -1},
+	}
+}
+
+// SetOnChange 设置负载限制变化回调
+func (p *DevicePolicy) SetOnChange(fn func(throttle DeviceThrottle)) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	p.onChange = fn
+}
+
+// Update 更新设备状态
+func (p *DevicePolicy) Update(state DeviceState) {
+	p.evaluate(time.Now(), &state)
+}
+
+// Evaluate 重新评估（降级迟滞到期时由定时器触发）
+func (p *DevicePolicy) Evaluate() {
+	p.evaluate(time.Now(), nil)
+}
+
+// Current 当前生效的负载限制
+func (p *DevicePolicy) Current() DeviceThrottle {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	return p.throttleLocked()
+}
+
+// GetStatus 获取状态
+func (p *DevicePolicy) GetStatus() DevicePolicyStatus {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	throttle := p.throttleLocked()
+	return DevicePolicyStatus{
+		Level:           throttle.Level.String(),
+		Reason:          throttle.Reason,
+		Thermal:         p.state.Thermal.String(),
+		BatteryPercent:  p.state.BatteryPercent,
+		Charging:        p.state.Charging,
+		MaxSubscribers:  throttle.MaxSubscribers,
+		MaxUpstream:     throttle.MaxUpstream.String(),
+		KeepaliveScale:  throttle.KeepaliveScale,
+		ScoreMultiplier: throttle.ScoreMultiplier,
+		Changes:         p.changes,
+	}
+}
+
+// Close 停止降级定时器
+func (p *DevicePolicy) Close() {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	p.closed = true
+	if p.relaxTimer != nil {
+		p.relaxTimer.Stop()
+		p.relaxTimer = nil
+	}
+}
+
+// evaluate 在锁内更新状态，然后按迟滞规则决定是否切换等级
+func (p *DevicePolicy) evaluate(now time.Time, state *DeviceState) {
+	p.mu.Lock()
+	if p.closed {
+		p.mu.Unlock()
+		return
+	}
+	if state != nil {
+		p.state = *state
+	}
+
+	target, reason := p.targetLocked()
+	if target == p.level {
+		p.candidate = target
+		p.reason = reason
+		p.mu.Unlock()
+		return
+	}
+	if target != p.candidate {
+		p.candidate = target
+		p.candidateSince = now
+	}
+
+	// 降级：目标等级持续 RelaxHold 后才生效
+	if target < p.level {
+		if wait := p.config.RelaxHold - now.Sub(p.candidateSince); wait > 0 {
+			p.scheduleRelaxLocked(wait)
+			p.mu.Unlock()
+			return
+		}
+	}
+
+	p.level = target
+	p.reason = reason
+	p.changes++
+	throttle := p.throttleLocked()
+	fn := p.onChange
+	p.mu.Unlock()
+
+	if fn != nil {
+		fn(throttle)
+	}
+}
+
+// scheduleRelaxLocked 迟滞到期后重新评估
+func (p *DevicePolicy) scheduleRelaxLocked(wait time.Duration) {
+	if p.relaxTimer != nil {
+		p.relaxTimer.Stop()
+	}
+	p.relaxTimer = time.AfterFunc(wait, p.Evaluate)
+}
+
+// targetLocked 按温度和电量计算目标等级
+func (p *DevicePolicy) targetLocked() (ThrottleLevel, string) {
+	level, reason := ThrottleNone, ""
+
+	switch p.state.Thermal {
+	case ThermalFair:
+		level, reason = ThrottleLight, "thermal"
+	case ThermalSerious:
+		level, reason = ThrottleHeavy, "thermal"
+	case ThermalCritical:
+		level, reason = ThrottleHandoff, "thermal"
+	}
+
+	if battery := p.state.BatteryPercent; battery >= 0 && !p.state.Charging {
+		batteryLevel := ThrottleNone
+		switch {
+		case battery <= p.config.HandoffBattery:
+			batteryLevel = ThrottleHandoff
+		case battery <= p.config.HeavyBattery:
+			batteryLevel = ThrottleHeavy
+		case battery <= p.config.LightBattery:
+			batteryLevel = ThrottleLight
+		}
+		if batteryLevel > level {
+			level, reason = batteryLevel, "battery"
+		}
+	}
+	return level, reason
+}
+
+func (p *DevicePolicy) throttleLocked() DeviceThrottle {
+	return DeviceThrottle{
+		ThrottleLimits: p.config.Limits[p.level],
+		Level:          p.level,
+		Reason:         p.reason,
+	}
+}
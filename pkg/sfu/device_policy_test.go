@@ -0,0 +1,227 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Device Policy Tests
+ */
+package sfu
+
+import (
+	"fmt"
+	"sync"
+	"sync/atomic"
+	"testing"
+	"time"
+)
+
+// 按模拟时间回放一段温度 / 电量读数，检查等级切换序列
+func TestDevicePolicySimulation(t *testing.T) {
+	p := NewDevicePolicy(DefaultDevicePolicyConfig())
+	defer p.Close()
+
+	var changes []DeviceThrottle
+	p.SetOnChange(func(throttle DeviceThrottle) {
+		changes = append(changes, throttle)
+	})
+
+	start := time.Now()
+	readings := []struct {
+		at    time.Duration
+		state DeviceState
+	}{
+		{0, DeviceState{Thermal: ThermalNominal, BatteryPercent: 80}},
+		{10 * time.Second, DeviceState{Thermal: ThermalFair, BatteryPercent: 78}},    // -> light
+		{20 * time.Second, DeviceState{Thermal: ThermalSerious, BatteryPercent: 76}}, // -> heavy
+		{25 * time.Second, DeviceState{Thermal: ThermalFair, BatteryPercent: 75}},    // 降级等待
+		{40 * time.Second, DeviceState{Thermal: ThermalSerious, BatteryPercent: 74}}, // 抖动回来，重新计时
+		{45 * time.Second, DeviceState{Thermal: ThermalFair, BatteryPercent: 73}},
+		{70 * time.Second, DeviceState{Thermal: ThermalFair, BatteryPercent: 72}},
+		{76 * time.Second, DeviceState{Thermal: ThermalFair, BatteryPercent: 71}},    // -> light
+		{80 * time.Second, DeviceState{Thermal: ThermalNominal, BatteryPercent: 15}}, // -> heavy (battery)
+		{90 * time.Second, DeviceState{Thermal: ThermalNominal, BatteryPercent: 15, Charging: true}},
+		{125 * time.Second, DeviceState{Thermal: ThermalNominal, BatteryPercent: 16, Charging: true}},  // -> none
+		{130 * time.Second, DeviceState{Thermal: ThermalCritical, BatteryPercent: 17, Charging: true}}, // -> handoff
+	}
+	for _, r := range readings {
+		state := r.state
+		p.evaluate(start.Add(r.at), &state)
+	}
+
+	want := []struct {
+		level  ThrottleLevel
+		reason string
+	}{
+		{ThrottleLight, "thermal"},
+		{ThrottleHeavy, "thermal"},
+		{ThrottleLight, "thermal"},
+		{ThrottleHeavy, "battery"},
+		{ThrottleNone, ""},
+		{ThrottleHandoff, "thermal"},
+	}
+	if len(changes) != len(want) {
+		t.Fatalf("Expected %d changes, got %+v", len(want), changes)
+	}
+	for i, w := range want {
+		if changes[i].Level != w.level || changes[i].Reason != w.reason {
+			t.Errorf("Change %d: got %s/%s, want %s/%s", i, changes[i].Level, changes[i].Reason, w.level, w.reason)
+		}
+	}
+
+	last := changes[len(changes)-1]
+	if last.MaxUpstream != UpstreamQualityLow || last.ScoreMultiplier >= 1 {
+		t.Errorf("Unexpected handoff limits %+v", last.ThrottleLimits)
+	}
+	if status := p.GetStatus(); status.Level != "handoff" || status.Changes != uint64(len(want)) {
+		t.Errorf("Unexpected status %+v", status)
+	}
+}
+
+func TestDevicePolicyTakesWorseSignal(t *testing.T) {
+	p := NewDevicePolicy(DefaultDevicePolicyConfig())
+	defer p.Close()
+
+	// 偏热 + 极低电量：按电量进入 handoff
+	p.Update(DeviceState{Thermal: ThermalFair, BatteryPercent: 8})
+	if throttle := p.Current(); throttle.Level != ThrottleHandoff || throttle.Reason != "battery" {
+		t.Errorf("Expected handoff by battery, got %s/%s", throttle.Level, throttle.Reason)
+	}
+
+	// 电量未知时只看温度
+	q := NewDevicePolicy(DefaultDevicePolicyConfig())
+	defer q.Close()
+	q.Update(DeviceState{Thermal: ThermalSerious, BatteryPercent: -1})
+	if throttle := q.Current(); throttle.Level != ThrottleHeavy || throttle.Reason != "thermal" {
+		t.Errorf("Expected heavy by thermal, got %s/%s", throttle.Level, throttle.Reason)
+	}
+}
+
+func TestUpstreamQualityMaxQuality(t *testing.T) {
+	c, switches := newTestUpstreamQuality(t)
+	now := time.Now()
+
+	// 订阅者要全屏，但上限为 MEDIUM
+	c.UpdateSubscriber("sub-1", 1920, 1080, 0)
+	c.SetMaxQuality(UpstreamQualityMedium)
+	c.evaluate(now.Add(2*time.Second), nil)
+	if len(*switches) != 1 || (*switches)[0] != UpstreamQualityMedium {
+		t.Fatalf("Expected switch to MEDIUM, got %v", *switches)
+	}
+	if status := c.GetStatus(); status.Max != "medium" {
+		t.Errorf("Expected max medium, got %+v", status)
+	}
+
+	// 解除上限后按升级规则恢复
+	c.OnKeyframe()
+	c.SetMaxQuality(UpstreamQualityHigh)
+	c.evaluate(now.Add(10*time.Second), nil)
+	if len(*switches) != 2 || (*switches)[1] != UpstreamQualityHigh {
+		t.Fatalf("Expected switch to HIGH, got %v", *switches)
+	}
+}
+
+func TestRelayRoomMaxSubscribers(t *testing.T) {
+	room, err := NewRelayRoom("limit-room", nil)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer room.Close()
+	room.BecomeRelay("relay-1")
+	room.SetMaxSubscribers(1)
+
+	if _, err := room.AddSubscriber("sub-1", subscriberOffer(t)); err != nil {
+		t.Fatalf("AddSubscriber failed: %v", err)
+	}
+	if _, err := room.AddSubscriber("sub-2", subscriberOffer(t)); err != ErrSubscriberLimit {
+		t.Errorf("Expected ErrSubscriberLimit, got %v", err)
+	}
+	// 同一订阅者重连不受限制
+	if _, err := room.AddSubscriber("sub-1", subscriberOffer(t)); err != nil {
+		t.Errorf("Reconnect should be allowed, got %v", err)
+	}
+
+	room.SetMaxSubscribers(0)
+	if _, err := room.AddSubscriber("sub-2", subscriberOffer(t)); err != nil {
+		t.Errorf("AddSubscriber after lifting limit failed: %v", err)
+	}
+}
+
+// TestRelayRoomMaxSubscribersConcurrent 并发加入不会超过上限，协商失败释放占用的名额
+func TestRelayRoomMaxSubscribersConcurrent(t *testing.T) {
+	room, err := NewRelayRoom("limit-room", nil)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer room.Close()
+	room.BecomeRelay("relay-1")
+	room.SetMaxSubscribers(2)
+
+	offers := make([]string, 8)
+	for i := range offers {
+		offers[i] = subscriberOffer(t)
+	}
+	var joined atomic.Int32
+	var wg sync.WaitGroup
+	for i, offer := range offers {
+		wg.Add(1)
+		go func(peerID, offer string) {
+			defer wg.Done()
+			if _, err := room.AddSubscriber(peerID, offer); err == nil {
+				joined.Add(1)
+			} else if err != ErrSubscriberLimit {
+				t.Errorf("%s: unexpected error %v", peerID, err)
+			}
+		}(fmt.Sprintf("sub-%d", i), offer)
+	}
+	wg.Wait()
+	if joined.Load() != 2 || room.GetSubscriberCount() != 2 {
+		t.Fatalf("Expected exactly 2 subscribers, joined %d, count %d", joined.Load(), room.GetSubscriberCount())
+	}
+
+	// 失败的加入不占名额
+	room.SetMaxSubscribers(3)
+	if _, err := room.AddSubscriber("bad-peer", "not an offer"); err == nil {
+		t.Fatal("Expected the malformed offer to be rejected")
+	}
+	if _, err := room.AddSubscriber("sub-last", subscriberOffer(t)); err != nil {
+		t.Errorf("Failed join should release its slot, got %v", err)
+	}
+}
+
+func TestCoordinatorDeviceThrottle(t *testing.T) {
+	config := DefaultCoordinatorConfig()
+	pmc, err := NewProxyModeCoordinator("throttle-room", "local-peer", config)
+	if err != nil {
+		t.Fatalf("Failed to create coordinator: %v", err)
+	}
+	defer pmc.Close()
+
+	events := make(chan CoordinatorEvent, 4)
+	pmc.SetOnEvent(func(event CoordinatorEvent) {
+		if event.Type == CoordinatorEventDeviceThrottle {
+			events <- event
+		}
+	})
+
+	pmc.UpdateLocalDeviceState(ThermalSerious, -1)
+
+	var event CoordinatorEvent
+	select {
+	case event = <-events:
+	case <-time.After(time.Second):
+		t.Fatal("Device throttle event not emitted")
+	}
+	if event.Data["level"] != "heavy" || event.Data["max_upstream"] != "medium" || event.Data["handoff"] != false {
+		t.Errorf("Unexpected event data %+v", event.Data)
+	}
+	if throttle := pmc.DeviceThrottle(); throttle.Level != ThrottleHeavy {
+		t.Errorf("Expected heavy throttle, got %s", throttle.Level)
+	}
+
+	pmc.keepalive.mu.RLock()
+	interval := pmc.keepalive.config.Interval
+	pmc.keepalive.mu.RUnlock()
+	if interval != 2*config.KeepaliveInterval {
+		t.Errorf("Expected keepalive interval %v, got %v", 2*config.KeepaliveInterval, interval)
+	}
+}
@@ -31,4 +31,31 @@ var (
 
 	// ErrTrackNotFound indicates the track was not found
 	ErrTrackNotFound = errors.New("track not found")
+
+	// ErrInvalidControlMessage indicates a malformed relay control message
+	ErrInvalidControlMessage = errors.New("invalid control message")
+
+	// ErrControlChannelNotOpen indicates the relay control channel is not open
+	ErrControlChannelNotOpen = errors.New("control channel not open")
+
+	// ErrInvalidInjectRecord indicates a malformed batch inject record
+	ErrInvalidInjectRecord = errors.New("invalid inject record")
+
+	// ErrSubscriberLimit indicates the relay has reached its subscriber limit
+	ErrSubscriberLimit = errors.New("subscriber limit reached")
+
+	// ErrMemoryBudgetExceeded indicates the relay is over its memory budget and refuses new subscribers
+	ErrMemoryBudgetExceeded = errors.New("memory budget exceeded")
+
+	// ErrNotRelay indicates the operation requires the local peer to be the relay
+	ErrNotRelay = errors.New("not the relay")
+
+	// ErrHandoffInProgress indicates a relay handoff is already in progress
+	ErrHandoffInProgress = errors.New("handoff in progress")
+
+	// ErrNoHandoffCandidate indicates no online peer can take over the relay
+	ErrNoHandoffCandidate = errors.New("no handoff candidate")
+
+	// ErrStaleHandoff indicates a handoff notice for an epoch that is not newer than the current one
+	ErrStaleHandoff = errors.New("stale handoff")
 )
@@ -0,0 +1,256 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Event Queue - 带背压的事件队列
+ * Go → Dart 的事件按类别处理：
+ *   - 必达（MustDeliver）：排队，永不丢弃（ICE 候选者、SDP、Relay 变更等）
+ *   - 合并（Coalesce）：同一 key 只保留最新一条（ping 请求、活跃发言者等状态类事件）
+ *   - 可丢弃（Droppable）：消费端跟不上时直接丢弃（周期性重复上报的提示类事件）
+ * 消费端通过信用窗口（Window）反馈处理进度：已投递未确认的事件数达到窗口上限后，
+ * 新事件留在 Go 侧排队/合并/丢弃，而不是堆积在 UI isolate 的消息端口里。
+ */
+package sfu
+
+import (
+	"strconv"
+	"sync"
+)
+
+// EventClass 事件类别
+type EventClass int
+
+const (
+	EventMustDeliver EventClass = iota // 必达
+	EventCoalesce                      // 按 key 合并
+	EventDroppable                     // 积压时丢弃
+)
+
+func (c EventClass) String() string {
+	switch c {
+	case EventCoalesce:
+		return "coalesce"
+	case EventDroppable:
+		return "droppable"
+	default:
+		return "must_deliver"
+	}
+}
+
+// EventRule 事件类型的处理规则
+type EventRule struct {
+	Class EventClass
+	// PerRoom 合并 key 只按房间区分（否则按房间 + Peer）
+	PerRoom bool
+}
+
+// QueuedEvent 待投递事件
+type QueuedEvent struct {
+	Type   int
+	RoomID string
+	PeerID string
+	Data   string
+}
+
+// EventQueueConfig 事件队列配置
+type EventQueueConfig struct {
+	// Window 已投递未确认事件上限，<= 0 表示不启用背压（直接投递）
+	Window int
+	// MaxPending 积压上限，超过后新的合并/可丢弃事件直接丢弃（必达事件不受限）
+	MaxPending int
+	// Rules 事件类型 -> 规则，未配置的类型按必达处理
+	Rules map[int]EventRule
+}
+
+// DefaultEventQueueConfig 默认配置（不启用背压，由消费端通过 SetWindow 开启）
+func DefaultEventQueueConfig() EventQueueConfig {
+	return EventQueueConfig{
+		Window:     0,
+		MaxPending: 4096,
+	}
+}
+
+// EventQueueStats 事件队列统计
+type EventQueueStats struct {
+	Window    int    `json:"window"`
+	InFlight  int    `json:"in_flight"`
+	Pending   int    `json:"pending"`
+	Delivered uint64 `json:"delivered"`
+	Coalesced uint64 `json:"coalesced"`
+	Dropped   uint64 `json:"dropped"`
+}
+
+// pendingEvent 排队中的事件（合并时原地更新，保持原有顺序）
+type pendingEvent struct {
+	event QueuedEvent
+	key   string
+}
+
+// EventQueue 带信用窗口的事件队列
+// deliver 在队列锁内调用以保证投递顺序，必须是非阻塞的（例如投递到 Dart 消息端口）
+type EventQueue struct {
+	mu sync.Mutex
+
+	config  EventQueueConfig
+	deliver func(QueuedEvent)
+
+	pending  []*pendingEvent
+	head     int
+	byKey    map[string]*pendingEvent
+	inFlight int
+
+	delivered uint64
+	coalesced uint64
+	dropped   uint64
+}
+
+// NewEventQueue 创建事件队列
+func NewEventQueue(config EventQueueConfig, deliver func(QueuedEvent)) *EventQueue {
+	if config.MaxPending <= 0 {
+		config.MaxPending = DefaultEventQueueConfig().MaxPending
+	}
+	return &EventQueue{
+		config:  config,
+		deliver: deliver,
+		byKey:   make(map[string]*pendingEvent),
+	}
+}
+
+// Push 提交事件
+func (q *EventQueue) Push(ev QueuedEvent) {
+	q.mu.Lock()
+	defer q.mu.Unlock()
+
+	// 有信用且没有积压时直接投递
+	if q.pendingLen() == 0 && q.hasCredit() {
+		q.deliverLocked(ev)
+		return
+	}
+
+	rule := q.config.Rules[ev.Type]
+	switch rule.Class {
+	case EventDroppable:
+		q.dropped++
+		return
+	case EventCoalesce:
+		key := coalesceKey(ev, rule.PerRoom)
+		if p, ok := q.byKey[key]; ok {
+			p.event = ev
+			q.coalesced++
+			return
+		}
+		if q.pendingLen() >= q.config.MaxPending {
+			q.dropped++
+			return
+		}
+		p := &pendingEvent{event: ev, key: key}
+		q.byKey[key] = p
+		q.pending = append(q.pending, p)
+	default:
+		q.pending = append(q.pending, &pendingEvent{event: ev})
+	}
+}
+
+// Ack 消费端确认已处理 n 个事件，归还信用并投递积压事件
+func (q *EventQueue) Ack(n int) {
+	if n <= 0 {
+		return
+	}
+	q.mu.Lock()
+	defer q.mu.Unlock()
+
+	q.inFlight -= n
+	if q.inFlight < 0 {
+		q.inFlight = 0
+	}
+	q.drainLocked()
+}
+
+// SetWindow 设置信用窗口，<= 0 关闭背压并立即投递全部积压事件
+func (q *EventQueue) SetWindow(window int) {
+	q.mu.Lock()
+	defer q.mu.Unlock()
+
+	q.config.Window = window
+	if window <= 0 {
+		q.inFlight = 0
+	}
+	q.drainLocked()
+}
+
+// Reset 丢弃积压事件并清空信用状态（消费端重建时调用，例如 Hot Restart）
+func (q *EventQueue) Reset() {
+	q.mu.Lock()
+	defer q.mu.Unlock()
+
+	q.dropped += uint64(q.pendingLen())
+	q.pending = nil
+	q.head = 0
+	q.byKey = make(map[string]*pendingEvent)
+	q.inFlight = 0
+	q.config.Window = 0
+}
+
+// GetStats 获取统计
+func (q *EventQueue) GetStats() EventQueueStats {
+	q.mu.Lock()
+	defer q.mu.Unlock()
+
+	return EventQueueStats{
+		Window:    q.config.Window,
+		InFlight:  q.inFlight,
+		Pending:   q.pendingLen(),
+		Delivered: q.delivered,
+		Coalesced: q.coalesced,
+		Dropped:   q.dropped,
+	}
+}
+
+func (q *EventQueue) pendingLen() int {
+	return len(q.pending) - q.head
+}
+
+func (q *EventQueue) hasCredit() bool {
+	return q.config.Window <= 0 || q.inFlight < q.config.Window
+}
+
+func (q *EventQueue) deliverLocked(ev QueuedEvent) {
+	if q.config.Window > 0 {
+		q.inFlight++
+	}
+	q.delivered++
+	if q.deliver != nil {
+		q.deliver(ev)
+	}
+}
+
+func (q *EventQueue) drainLocked() {
+	for q.pendingLen() > 0 && q.hasCredit() {
+		p := q.pending[q.head]
+		q.pending[q.head] = nil
+		q.head++
+		if p.key != "" {
+			delete(q.byKey, p.key)
+		}
+		q.deliverLocked(p.event)
+	}
+
+	// 队列清空或已消费过半时回收底层数组
+	if q.head > 0 && (q.pendingLen() == 0 || q.head*2 >= len(q.pending)) {
+		n := copy(q.pending, q.pending[q.head:])
+		for i := n; i < len(q.pending); i++ {
+			q.pending[i] = nil
+		}
+		q.pending = q.pending[:n]
+		q.head = 0
+	}
+}
+
+func coalesceKey(ev QueuedEvent, perRoom bool) string {
+	key := strconv.Itoa(ev.Type) + "\x00" + ev.RoomID
+	if !perRoom {
+		key += "\x00" + ev.PeerID
+	}
+	return key
+}
@@ -0,0 +1,173 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Event Queue Tests
+ */
+package sfu
+
+import (
+	"testing"
+)
+
+const (
+	testEventICE     = 5
+	testEventSlow    = 21
+	testEventPing    = 23
+	testEventSpeaker = 30
+)
+
+func newTestEventQueue(window int) (*EventQueue, *[]QueuedEvent) {
+	var got []QueuedEvent
+	config := DefaultEventQueueConfig()
+	config.Window = window
+	config.Rules = map[int]EventRule{
+		testEventSlow:    {Class: EventDroppable},
+		testEventPing:    {Class: EventCoalesce},
+		testEventSpeaker: {Class: EventCoalesce, PerRoom: true},
+	}
+	q := NewEventQueue(config, func(ev QueuedEvent) {
+		got = append(got, ev)
+	})
+	return q, &got
+}
+
+func TestEventQueueNoBackpressure(t *testing.T) {
+	q, got := newTestEventQueue(0)
+	for i := 0; i < 100; i++ {
+		q.Push(QueuedEvent{Type: testEventPing, RoomID: "room", PeerID: "peer"})
+	}
+	if len(*got) != 100 {
+		t.Errorf("Expected all 100 events delivered, got %d", len(*got))
+	}
+}
+
+func TestEventQueueWindow(t *testing.T) {
+	q, got := newTestEventQueue(2)
+
+	for i := 0; i < 5; i++ {
+		q.Push(QueuedEvent{Type: testEventICE, RoomID: "room", PeerID: "peer", Data: string(rune('a' + i))})
+	}
+	if len(*got) != 2 {
+		t.Fatalf("Expected 2 delivered before ack, got %d", len(*got))
+	}
+	if stats := q.GetStats(); stats.InFlight != 2 || stats.Pending != 3 {
+		t.Errorf("Unexpected stats %+v", stats)
+	}
+
+	q.Ack(1)
+	if len(*got) != 3 {
+		t.Fatalf("Expected 3 delivered after ack, got %d", len(*got))
+	}
+	q.Ack(10)
+	if len(*got) != 5 {
+		t.Fatalf("Expected 5 delivered, got %d", len(*got))
+	}
+
+	// 必达事件保持顺序
+	for i, ev := range *got {
+		if ev.Data != string(rune('a'+i)) {
+			t.Errorf("Event %d out of order: %q", i, ev.Data)
+		}
+	}
+}
+
+func TestEventQueueCoalesceAndDrop(t *testing.T) {
+	q, got := newTestEventQueue(1)
+
+	q.Push(QueuedEvent{Type: testEventICE, RoomID: "room", PeerID: "p0"}) // 占满窗口
+
+	q.Push(QueuedEvent{Type: testEventPing, RoomID: "room", PeerID: "p1", Data: "1"})
+	q.Push(QueuedEvent{Type: testEventPing, RoomID: "room", PeerID: "p2", Data: "1"})
+	q.Push(QueuedEvent{Type: testEventPing, RoomID: "room", PeerID: "p1", Data: "2"})
+	q.Push(QueuedEvent{Type: testEventSpeaker, RoomID: "room", PeerID: "p1"})
+	q.Push(QueuedEvent{Type: testEventSpeaker, RoomID: "room", PeerID: "p2"})
+	q.Push(QueuedEvent{Type: testEventSlow, RoomID: "room", PeerID: "p1"})
+
+	stats := q.GetStats()
+	if stats.Pending != 3 || stats.Coalesced != 2 || stats.Dropped != 1 {
+		t.Fatalf("Unexpected stats %+v", stats)
+	}
+
+	for i := 0; i < 4; i++ {
+		q.Ack(1)
+	}
+	want := []QueuedEvent{
+		{Type: testEventICE, RoomID: "room", PeerID: "p0"},
+		{Type: testEventPing, RoomID: "room", PeerID: "p1", Data: "2"},
+		{Type: testEventPing, RoomID: "room", PeerID: "p2", Data: "1"},
+		{Type: testEventSpeaker, RoomID: "room", PeerID: "p2"},
+	}
+	if len(*got) != len(want) {
+		t.Fatalf("Expected %d events, got %d: %+v", len(want), len(*got), *got)
+	}
+	for i := range want {
+		if (*got)[i] != want[i] {
+			t.Errorf("Event %d = %+v, want %+v", i, (*got)[i], want[i])
+		}
+	}
+
+	// 合并 key 在投递后释放
+	q.Push(QueuedEvent{Type: testEventPing, RoomID: "room", PeerID: "p1"})
+	if len(*got) != 5 {
+		t.Errorf("Expected ping delivered after drain, got %d events", len(*got))
+	}
+}
+
+func TestEventQueueMaxPending(t *testing.T) {
+	var delivered int
+	q := NewEventQueue(EventQueueConfig{
+		Window:     1,
+		MaxPending: 2,
+		Rules:      map[int]EventRule{testEventPing: {Class: EventCoalesce}},
+	}, func(QueuedEvent) { delivered++ })
+
+	q.Push(QueuedEvent{Type: testEventICE})
+	q.Push(QueuedEvent{Type: testEventPing, PeerID: "p1"})
+	q.Push(QueuedEvent{Type: testEventPing, PeerID: "p2"})
+	q.Push(QueuedEvent{Type: testEventPing, PeerID: "p3"}) // 超出积压上限
+	q.Push(QueuedEvent{Type: testEventICE})                // 必达不受上限限制
+
+	stats := q.GetStats()
+	if stats.Pending != 3 || stats.Dropped != 1 {
+		t.Errorf("Unexpected stats %+v", stats)
+	}
+}
+
+func TestEventQueueSetWindowAndReset(t *testing.T) {
+	q, got := newTestEventQueue(1)
+	for i := 0; i < 4; i++ {
+		q.Push(QueuedEvent{Type: testEventICE})
+	}
+
+	// 关闭背压时积压全部投递
+	q.SetWindow(0)
+	if len(*got) != 4 {
+		t.Fatalf("Expected 4 delivered, got %d", len(*got))
+	}
+
+	q.SetWindow(1)
+	q.Push(QueuedEvent{Type: testEventICE})
+	q.Push(QueuedEvent{Type: testEventICE})
+	q.Reset()
+	stats := q.GetStats()
+	if stats.Pending != 0 || stats.InFlight != 0 || stats.Window != 0 || stats.Dropped != 1 {
+		t.Errorf("Unexpected stats after reset %+v", stats)
+	}
+}
+
+// BenchmarkEventQueuePingBurst 消费端停滞时 100 个 Peer 的 ping 请求
+func BenchmarkEventQueuePingBurst(b *testing.B) {
+	q, _ := newTestEventQueue(1)
+	peers := make([]string, 100)
+	for i := range peers {
+		peers[i] = "peer-" + string(rune('A'+i%26)) + string(rune('a'+i/26))
+	}
+	b.ReportAllocs()
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		q.Push(QueuedEvent{Type: testEventPing, RoomID: "room", PeerID: peers[i%len(peers)]})
+	}
+}
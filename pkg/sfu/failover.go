@@ -172,6 +172,13 @@ func (fm *FailoverManager) UpdateLocalScore(score float64) {
 	fm.localScore = score
 }
 
+// GetLocalScore 获取本机分数
+func (fm *FailoverManager) GetLocalScore() float64 {
+	fm.mu.RLock()
+	defer fm.mu.RUnlock()
+	return fm.localScore
+}
+
 // handlePeerOffline 处理 Peer 离线事件
 func (fm *FailoverManager) handlePeerOffline(peerID string) {
 	fm.mu.Lock()
@@ -0,0 +1,361 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * FEC - 前向纠错编码
+ * Relay -> 订阅者最后一跳通常是 2.4GHz Wi-Fi，突发丢包严重
+ * - 视频：FlexFEC-03（XOR 奇偶校验，单 SSRC，15 位掩码）
+ * - 音频：RED (RFC 2198)，携带前 1~2 帧 Opus 冗余
+ * - 冗余度由订阅者 RTCP RR 的丢包率自适应调整
+ *
+ * 编码器在保护组内增量 XOR（按 8 字节宽字处理），所有缓冲区预分配，
+ * 热路径上没有任何内存分配。
+ */
+package sfu
+
+import (
+	"encoding/binary"
+	"math"
+	"sync/atomic"
+)
+
+const (
+	// flexFECHeaderLen FlexFEC-03 头长度（R=0,F=0，单 SSRC，k=1 的 15 位掩码）
+	flexFECHeaderLen = 20
+	// flexFECMaxGroup 15 位掩码可保护的最大连续包数
+	flexFECMaxGroup = 15
+	// fecMaxProtectedLen 可保护的最大长度（RTP 固定头之后的部分）
+	fecMaxProtectedLen = DefaultRTPBufferSize
+
+	rtpFixedHeaderLen = 12
+
+	// RED 块头限制
+	redMaxBlockLen   = 1<<10 - 1
+	redMaxTSOffset   = 1<<14 - 1
+	redMaxRedundancy = 2
+)
+
+// FECConfig FEC 配置
+type FECConfig struct {
+	Enabled bool
+
+	// MinLoss 低于该丢包率时不发送冗余
+	MinLoss float64
+	// HighLoss 达到该丢包率时 RED 使用 2 帧冗余
+	HighLoss float64
+	// LossAlpha 丢包率上升时的平滑系数（下降时使用 LossAlpha/2，快升慢降）
+	LossAlpha float64
+
+	// SDP 协商用的 Payload Type（订阅者 Offer 中存在时以 Offer 为准）
+	FlexFECPayloadType uint8
+	REDPayloadType     uint8
+}
+
+// DefaultFECConfig 默认 FEC 配置
+func DefaultFECConfig() FECConfig {
+	return FECConfig{
+		Enabled:            true,
+		MinLoss:            0.01,
+		HighLoss:           0.10,
+		LossAlpha:          0.5,
+		FlexFECPayloadType: 118,
+		REDPayloadType:     63,
+	}
+}
+
+// xorBytes dst[i] ^= src[i]，按 32/8 字节宽字处理
+// 调用方保证 len(dst) >= len(src)
+func xorBytes(dst, src []byte) {
+	n := len(src)
+	dst = dst[:n]
+	i := 0
+	for ; i+32 <= n; i += 32 {
+		d := dst[i : i+32 : i+32]
+		s := src[i : i+32 : i+32]
+		binary.LittleEndian.PutUint64(d[0:], binary.LittleEndian.Uint64(d[0:])^binary.LittleEndian.Uint64(s[0:]))
+		binary.LittleEndian.PutUint64(d[8:], binary.LittleEndian.Uint64(d[8:])^binary.LittleEndian.Uint64(s[8:]))
+		binary.LittleEndian.PutUint64(d[16:], binary.LittleEndian.Uint64(d[16:])^binary.LittleEndian.Uint64(s[16:]))
+		binary.LittleEndian.PutUint64(d[24:], binary.LittleEndian.Uint64(d[24:])^binary.LittleEndian.Uint64(s[24:]))
+	}
+	for ; i+8 <= n; i += 8 {
+		binary.LittleEndian.PutUint64(dst[i:], binary.LittleEndian.Uint64(dst[i:])^binary.LittleEndian.Uint64(src[i:]))
+	}
+	for ; i < n; i++ {
+		dst[i] ^= src[i]
+	}
+}
+
+// ==========================================
+// 自适应冗余控制
+// ==========================================
+
+// FECRateController 根据订阅者丢包率决定冗余度
+// UpdateLoss 在 RTCP 读取协程调用，查询在写包路径调用，全部无锁
+type FECRateController struct {
+	config   FECConfig
+	lossBits atomic.Uint64 // float64 bits
+}
+
+// NewFECRateController 创建冗余控制器
+func NewFECRateController(config FECConfig) *FECRateController {
+	return &FECRateController{config: config}
+}
+
+// UpdateLoss 输入 RTCP RR 中的 fraction lost（0-255）
+func (c *FECRateController) UpdateLoss(fractionLost uint8) {
+	sample := float64(fractionLost) / 256
+	for {
+		oldBits := c.lossBits.Load()
+		old := math.Float64frombits(oldBits)
+		alpha := c.config.LossAlpha
+		if sample < old {
+			alpha /= 2
+		}
+		next := old + alpha*(sample-old)
+		if c.lossBits.CompareAndSwap(oldBits, math.Float64bits(next)) {
+			return
+		}
+	}
+}
+
+// Loss 当前平滑后的丢包率
+func (c *FECRateController) Loss() float64 {
+	return math.Float64frombits(c.lossBits.Load())
+}
+
+// VideoGroupSize 每个 FEC 包保护的媒体包数（0 = 不发送）
+// 冗余开销约为丢包率的 2 倍：5% 丢包 -> 每 10 个包 1 个 FEC
+func (c *FECRateController) VideoGroupSize() int {
+	loss := c.Loss()
+	if !c.config.Enabled || loss < c.config.MinLoss {
+		return 0
+	}
+	k := int(math.Round(1 / (2 * loss)))
+	if k < 2 {
+		k = 2
+	}
+	if k > flexFECMaxGroup {
+		k = flexFECMaxGroup
+	}
+	return k
+}
+
+// AudioRedundancy RED 冗余帧数（0 = 不使用 RED）
+func (c *FECRateController) AudioRedundancy() int {
+	loss := c.Loss()
+	switch {
+	case !c.config.Enabled || loss < c.config.MinLoss:
+		return 0
+	case loss >= c.config.HighLoss:
+		return 2
+	default:
+		return 1
+	}
+}
+
+// ==========================================
+// FlexFEC-03 编码器
+// ==========================================
+
+// FlexFECEncoder 单个视频流的 FlexFEC 编码器（非并发安全，由调用方串行调用）
+// 每个保护组累积 XOR，组满时输出一个 FEC 包
+type FlexFECEncoder struct {
+	mediaSSRC uint32
+
+	count        int
+	baseSN       uint16
+	mask         uint16 // bit i -> baseSN + i
+	byte0        uint8  // P|X|CC 恢复位
+	byte1        uint8  // M|PT 恢复位
+	lenRecovery  uint16
+	tsRecovery   uint32
+	protectedLen int
+
+	acc [fecMaxProtectedLen]byte
+	out [flexFECHeaderLen + fecMaxProtectedLen]byte
+}
+
+// NewFlexFECEncoder 创建 FlexFEC 编码器
+func NewFlexFECEncoder(mediaSSRC uint32) *FlexFECEncoder {
+	return &FlexFECEncoder{mediaSSRC: mediaSSRC}
+}
+
+// Protect 将一个已发送的媒体包计入保护组
+// header: 序列化后的完整 RTP 头（含 CSRC/扩展）
+// groupSize: 当前目标组大小（来自 FECRateController，0 表示关闭）
+// 返回 FEC 负载（FlexFEC 头 + 恢复数据），仅在下一次调用前有效
+func (e *FlexFECEncoder) Protect(header, payload []byte, groupSize int) ([]byte, bool) {
+	if len(header) < rtpFixedHeaderLen {
+		return nil, false
+	}
+	sn := binary.BigEndian.Uint16(header[2:])
+	protectedLen := len(header) - rtpFixedHeaderLen + len(payload)
+
+	if groupSize <= 0 || protectedLen > fecMaxProtectedLen {
+		// 关闭或无法保护：结束当前组（不输出，剩余包无冗余）
+		e.reset()
+		return nil, false
+	}
+
+	var fec []byte
+	if e.count > 0 {
+		// 序号超出掩码范围、回退或重复：先结束当前组
+		if offset := sn - e.baseSN; offset >= flexFECMaxGroup || e.mask&(1<<offset) != 0 {
+			fec = e.emit()
+		}
+	}
+
+	e.add(header, payload, sn, protectedLen)
+
+	if e.count >= groupSize {
+		fec = e.emit()
+	}
+	return fec, fec != nil
+}
+
+// add 增量 XOR 一个媒体包
+func (e *FlexFECEncoder) add(header, payload []byte, sn uint16, protectedLen int) {
+	if e.count == 0 {
+		e.baseSN = sn
+	}
+	e.count++
+	e.mask |= 1 << (sn - e.baseSN)
+
+	e.byte0 ^= header[0]
+	e.byte1 ^= header[1]
+	e.lenRecovery ^= uint16(protectedLen)
+	e.tsRecovery ^= binary.BigEndian.Uint32(header[4:])
+
+	if protectedLen > e.protectedLen {
+		e.protectedLen = protectedLen
+	}
+	ext := header[rtpFixedHeaderLen:]
+	xorBytes(e.acc[:], ext)
+	xorBytes(e.acc[len(ext):], payload)
+}
+
+// emit 生成当前组的 FEC 负载并重置
+func (e *FlexFECEncoder) emit() []byte {
+	out := e.out[:flexFECHeaderLen+e.protectedLen]
+
+	out[0] = e.byte0 & 0x3f // R=0, F=0
+	out[1] = e.byte1
+	binary.BigEndian.PutUint16(out[2:], e.lenRecovery)
+	binary.BigEndian.PutUint32(out[4:], e.tsRecovery)
+	out[8] = 1 // SSRCCount
+	out[9], out[10], out[11] = 0, 0, 0
+	binary.BigEndian.PutUint32(out[12:], e.mediaSSRC)
+	binary.BigEndian.PutUint16(out[16:], e.baseSN)
+
+	// k=1 + 15 位掩码，最高位对应 baseSN
+	var mask uint16
+	for i := 0; i < flexFECMaxGroup; i++ {
+		if e.mask&(1<<i) != 0 {
+			mask |= 1 << (14 - i)
+		}
+	}
+	binary.BigEndian.PutUint16(out[18:], 0x8000|mask)
+
+	copy(out[flexFECHeaderLen:], e.acc[:e.protectedLen])
+	e.reset()
+	return out
+}
+
+// reset 清空保护组（只清零用过的部分）
+func (e *FlexFECEncoder) reset() {
+	clear(e.acc[:e.protectedLen])
+	e.count = 0
+	e.mask = 0
+	e.byte0, e.byte1 = 0, 0
+	e.lenRecovery = 0
+	e.tsRecovery = 0
+	e.protectedLen = 0
+}
+
+// ==========================================
+// RED (RFC 2198) 编码器
+// ==========================================
+
+// redFrame 历史帧
+type redFrame struct {
+	ts  uint32
+	n   int
+	buf [redMaxBlockLen]byte
+}
+
+// REDEncoder 单个音频流的 RED 编码器（非并发安全）
+type REDEncoder struct {
+	history [redMaxRedundancy]redFrame
+	count   int // 有效历史帧数
+	next    int // 下一个写入位置（环形）
+
+	out [redMaxRedundancy*(4+redMaxBlockLen) + 1 + fecMaxProtectedLen]byte
+}
+
+// NewREDEncoder 创建 RED 编码器
+func NewREDEncoder() *REDEncoder {
+	return &REDEncoder{}
+}
+
+// Encode 将 primary 帧封装为 RED 负载
+// redundancy: 冗余帧数（0 = 不封装，调用方按原 PT 发送）
+// 返回的负载仅在下一次调用前有效
+func (e *REDEncoder) Encode(primaryPT uint8, ts uint32, payload []byte, redundancy int) ([]byte, bool) {
+	defer e.remember(ts, payload)
+
+	if redundancy > redMaxRedundancy {
+		redundancy = redMaxRedundancy
+	}
+	if redundancy > e.count {
+		redundancy = e.count
+	}
+	if redundancy <= 0 || len(payload) > fecMaxProtectedLen {
+		return nil, false
+	}
+
+	// 选出可用的冗余帧（从旧到新），时间戳偏移必须落在 14 位内
+	var blocks [redMaxRedundancy]*redFrame
+	nBlocks := 0
+	for i := redundancy; i >= 1; i-- {
+		f := &e.history[(e.next-i+redMaxRedundancy)%redMaxRedundancy]
+		if offset := ts - f.ts; offset == 0 || offset > redMaxTSOffset {
+			continue
+		}
+		blocks[nBlocks] = f
+		nBlocks++
+	}
+	if nBlocks == 0 {
+		return nil, false
+	}
+
+	pos := 0
+	for i := 0; i < nBlocks; i++ {
+		f := blocks[i]
+		offset := ts - f.ts
+		binary.BigEndian.PutUint32(e.out[pos:], uint32(0x80|primaryPT&0x7f)<<24|offset<<10|uint32(f.n))
+		pos += 4
+	}
+	e.out[pos] = primaryPT & 0x7f
+	pos++
+	for i := 0; i < nBlocks; i++ {
+		pos += copy(e.out[pos:], blocks[i].buf[:blocks[i].n])
+	}
+	pos += copy(e.out[pos:], payload)
+	return e.out[:pos], true
+}
+
+// remember 保存历史帧（超过 RED 块长度上限的帧不作为冗余）
+func (e *REDEncoder) remember(ts uint32, payload []byte) {
+	if len(payload) > redMaxBlockLen {
+		e.count = 0
+		return
+	}
+	f := &e.history[e.next]
+	f.ts = ts
+	f.n = copy(f.buf[:], payload)
+	e.next = (e.next + 1) % redMaxRedundancy
+	if e.count < redMaxRedundancy {
+		e.count++
+	}
+}
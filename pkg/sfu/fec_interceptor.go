@@ -0,0 +1,340 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * FEC Interceptor - 每个订阅者独立的 FEC 生成
+ * 每个订阅者 PeerConnection 拥有独立的 interceptor 实例：
+ * - BindLocalStream：视频流协商了 flexfec-03 时生成 FlexFEC；音频流协商了 RED 时封装 RED
+ * - BindRTCPReader：从该订阅者的 RTCP RR 中提取丢包率，驱动冗余度
+ */
+package sfu
+
+import (
+	"encoding/binary"
+	"strconv"
+	"strings"
+	"sync"
+	"sync/atomic"
+
+	"github.com/pion/interceptor"
+	"github.com/pion/rtp"
+	"github.com/pion/webrtc/v4"
+)
+
+const (
+	// MimeTypeFlexFEC03 FlexFEC-03 的 MIME 类型
+	MimeTypeFlexFEC03 = "video/flexfec-03"
+	// MimeTypeRED RED 的 MIME 类型
+	MimeTypeRED = "audio/red"
+
+	rtcpTypeSR = 200
+	rtcpTypeRR = 201
+)
+
+// FECController 房间级 FEC 控制（所有订阅者共享同一个 Factory）
+type FECController struct {
+	mu sync.RWMutex
+
+	config  FECConfig
+	enabled atomic.Bool
+
+	// 媒体 SSRC (每个订阅者 sender 不同) -> 该订阅者协商到的 RED PT
+	redPayloadTypes map[uint32]uint8
+
+	// 统计
+	fecPackets atomic.Uint64
+	fecBytes   atomic.Uint64
+	redPackets atomic.Uint64
+}
+
+// FECStats FEC 统计
+type FECStats struct {
+	Enabled    bool   `json:"enabled"`
+	FECPackets uint64 `json:"fec_packets"`
+	FECBytes   uint64 `json:"fec_bytes"`
+	REDPackets uint64 `json:"red_packets"`
+}
+
+// NewFECController 创建 FEC 控制器
+func NewFECController(config FECConfig) *FECController {
+	c := &FECController{
+		config:          config,
+		redPayloadTypes: make(map[uint32]uint8),
+	}
+	c.enabled.Store(config.Enabled)
+	return c
+}
+
+// SetEnabled 运行时开关（关闭后已绑定的流立即停止生成冗余）
+func (c *FECController) SetEnabled(enabled bool) {
+	c.enabled.Store(enabled)
+}
+
+// IsEnabled 是否开启
+func (c *FECController) IsEnabled() bool {
+	return c.enabled.Load()
+}
+
+// RegisterCodecs 在 MediaEngine 中注册 FlexFEC 和 RED，使其可被协商
+func (c *FECController) RegisterCodecs(m *webrtc.MediaEngine) error {
+	if err := m.RegisterCodec(webrtc.RTPCodecParameters{
+		RTPCodecCapability: webrtc.RTPCodecCapability{
+			MimeType:    MimeTypeFlexFEC03,
+			ClockRate:   90000,
+			SDPFmtpLine: "repair-window=10000000",
+		},
+		PayloadType: webrtc.PayloadType(c.config.FlexFECPayloadType),
+	}, webrtc.RTPCodecTypeVideo); err != nil {
+		return err
+	}
+	return m.RegisterCodec(webrtc.RTPCodecParameters{
+		RTPCodecCapability: webrtc.RTPCodecCapability{
+			MimeType:    MimeTypeRED,
+			ClockRate:   48000,
+			Channels:    2,
+			SDPFmtpLine: "111/111",
+		},
+		PayloadType: webrtc.PayloadType(c.config.REDPayloadType),
+	}, webrtc.RTPCodecTypeAudio)
+}
+
+// SetREDPayloadType 记录某个音频 sender 协商到的 RED PT（0 表示不支持）
+// 必须在 SetLocalDescription 之前调用（此时流尚未绑定）
+func (c *FECController) SetREDPayloadType(mediaSSRC uint32, pt uint8) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if pt == 0 {
+		delete(c.redPayloadTypes, mediaSSRC)
+		return
+	}
+	c.redPayloadTypes[mediaSSRC] = pt
+}
+
+// Forget 订阅者离开时清理
+func (c *FECController) Forget(mediaSSRC uint32) {
+	c.SetREDPayloadType(mediaSSRC, 0)
+}
+
+func (c *FECController) redPayloadType(mediaSSRC uint32) uint8 {
+	c.mu.RLock()
+	defer c.mu.RUnlock()
+	return c.redPayloadTypes[mediaSSRC]
+}
+
+// GetStats 获取统计
+func (c *FECController) GetStats() FECStats {
+	return FECStats{
+		Enabled:    c.IsEnabled(),
+		FECPackets: c.fecPackets.Load(),
+		FECBytes:   c.fecBytes.Load(),
+		REDPackets: c.redPackets.Load(),
+	}
+}
+
+// NewInterceptor 实现 interceptor.Factory（每个 PeerConnection 调用一次）
+func (c *FECController) NewInterceptor(_ string) (interceptor.Interceptor, error) {
+	return &fecInterceptor{
+		controller: c,
+		rates:      make(map[uint32]*FECRateController),
+	}, nil
+}
+
+// fecInterceptor 单个订阅者的 FEC interceptor
+type fecInterceptor struct {
+	interceptor.NoOp
+
+	controller *FECController
+
+	mu    sync.RWMutex
+	rates map[uint32]*FECRateController // 媒体 SSRC -> 丢包驱动的冗余控制
+}
+
+func (i *fecInterceptor) rateFor(ssrc uint32) *FECRateController {
+	i.mu.Lock()
+	defer i.mu.Unlock()
+	rc, ok := i.rates[ssrc]
+	if !ok {
+		rc = NewFECRateController(i.controller.config)
+		i.rates[ssrc] = rc
+	}
+	return rc
+}
+
+// BindRTCPReader 从 RR/SR 报告块提取该订阅者的丢包率
+func (i *fecInterceptor) BindRTCPReader(reader interceptor.RTCPReader) interceptor.RTCPReader {
+	return interceptor.RTCPReaderFunc(func(b []byte, a interceptor.Attributes) (int, interceptor.Attributes, error) {
+		n, attr, err := reader.Read(b, a)
+		if err == nil {
+			forEachReportBlock(b[:n], func(ssrc uint32, fractionLost uint8) {
+				i.mu.RLock()
+				rc := i.rates[ssrc]
+				i.mu.RUnlock()
+				if rc != nil {
+					rc.UpdateLoss(fractionLost)
+				}
+			})
+		}
+		return n, attr, err
+	})
+}
+
+// BindLocalStream 为视频/音频流挂载 FEC 生成
+func (i *fecInterceptor) BindLocalStream(info *interceptor.StreamInfo, writer interceptor.RTPWriter) interceptor.RTPWriter {
+	mime := strings.ToLower(info.MimeType)
+
+	switch {
+	case strings.HasPrefix(mime, "video/") && info.SSRCForwardErrorCorrection != 0 && info.PayloadTypeForwardErrorCorrection != 0:
+		return i.bindFlexFEC(info, writer)
+	case mime == strings.ToLower(webrtc.MimeTypeOpus):
+		return i.bindRED(info, writer)
+	default:
+		return writer
+	}
+}
+
+// UnbindLocalStream 清理流状态
+func (i *fecInterceptor) UnbindLocalStream(info *interceptor.StreamInfo) {
+	i.mu.Lock()
+	delete(i.rates, info.SSRC)
+	i.mu.Unlock()
+}
+
+// bindFlexFEC 媒体包照常发送，保护组满时额外发送一个 FEC 包
+func (i *fecInterceptor) bindFlexFEC(info *interceptor.StreamInfo, writer interceptor.RTPWriter) interceptor.RTPWriter {
+	rc := i.rateFor(info.SSRC)
+	enc := NewFlexFECEncoder(info.SSRC)
+	fecSSRC := info.SSRCForwardErrorCorrection
+	fecPT := info.PayloadTypeForwardErrorCorrection
+	c := i.controller
+
+	var (
+		mu      sync.Mutex
+		fecSeq  uint16
+		hdrBuf  [rtpFixedHeaderLen + 4*15 + 4 + 256]byte
+		fecHead rtp.Header
+	)
+
+	return interceptor.RTPWriterFunc(func(header *rtp.Header, payload []byte, attributes interceptor.Attributes) (int, error) {
+		n, err := writer.Write(header, payload, attributes)
+		if err != nil || !c.IsEnabled() {
+			return n, err
+		}
+
+		mu.Lock()
+		defer mu.Unlock()
+
+		hn, merr := header.MarshalTo(hdrBuf[:])
+		if merr != nil {
+			return n, err
+		}
+		fec, ok := enc.Protect(hdrBuf[:hn], payload, rc.VideoGroupSize())
+		if !ok {
+			return n, err
+		}
+
+		fecSeq++
+		fecHead = rtp.Header{
+			Version:        2,
+			PayloadType:    fecPT,
+			SequenceNumber: fecSeq,
+			Timestamp:      header.Timestamp,
+			SSRC:           fecSSRC,
+		}
+		if _, werr := writer.Write(&fecHead, fec, attributes); werr == nil {
+			c.fecPackets.Add(1)
+			c.fecBytes.Add(uint64(len(fec)))
+		}
+		return n, err
+	})
+}
+
+// bindRED 丢包时将 Opus 封装为 RED（携带前 1~2 帧），丢包恢复后退回普通 Opus
+func (i *fecInterceptor) bindRED(info *interceptor.StreamInfo, writer interceptor.RTPWriter) interceptor.RTPWriter {
+	rc := i.rateFor(info.SSRC)
+	enc := NewREDEncoder()
+	c := i.controller
+	ssrc := info.SSRC
+
+	var (
+		mu     sync.Mutex
+		redHdr rtp.Header
+	)
+
+	return interceptor.RTPWriterFunc(func(header *rtp.Header, payload []byte, attributes interceptor.Attributes) (int, error) {
+		redPT := c.redPayloadType(ssrc)
+		if redPT == 0 || !c.IsEnabled() {
+			return writer.Write(header, payload, attributes)
+		}
+
+		mu.Lock()
+		defer mu.Unlock()
+
+		red, ok := enc.Encode(header.PayloadType, header.Timestamp, payload, rc.AudioRedundancy())
+		if !ok {
+			return writer.Write(header, payload, attributes)
+		}
+
+		redHdr = *header
+		redHdr.PayloadType = redPT
+		n, err := writer.Write(&redHdr, red, attributes)
+		if err == nil {
+			c.redPackets.Add(1)
+		}
+		return n, err
+	})
+}
+
+// forEachReportBlock 遍历复合 RTCP 中 SR/RR 的报告块（不分配内存）
+func forEachReportBlock(buf []byte, fn func(ssrc uint32, fractionLost uint8)) {
+	for len(buf) >= 4 {
+		count := int(buf[0] & 0x1f)
+		pt := buf[1]
+		length := (int(binary.BigEndian.Uint16(buf[2:])) + 1) * 4
+		if length > len(buf) {
+			return
+		}
+
+		var blocks []byte
+		switch pt {
+		case rtcpTypeSR:
+			if length >= 28 {
+				blocks = buf[28:length]
+			}
+		case rtcpTypeRR:
+			if length >= 8 {
+				blocks = buf[8:length]
+			}
+		}
+		for j := 0; j < count && len(blocks) >= 24; j++ {
+			fn(binary.BigEndian.Uint32(blocks[0:]), blocks[4])
+			blocks = blocks[24:]
+		}
+
+		buf = buf[length:]
+	}
+}
+
+// offerREDPayloadType 从订阅者 Offer 的音频段中找出 red/48000 的 PT（0 表示未提供）
+func offerREDPayloadType(offerSDP string) uint8 {
+	inAudio := false
+	for _, line := range strings.Split(offerSDP, "\n") {
+		line = strings.TrimSpace(line)
+		if strings.HasPrefix(line, "m=") {
+			inAudio = strings.HasPrefix(line, "m=audio")
+			continue
+		}
+		if !inAudio || !strings.HasPrefix(line, "a=rtpmap:") {
+			continue
+		}
+		rest := strings.TrimPrefix(line, "a=rtpmap:")
+		sp := strings.IndexByte(rest, ' ')
+		if sp < 0 || !strings.HasPrefix(strings.ToLower(rest[sp+1:]), "red/48000") {
+			continue
+		}
+		if pt, err := strconv.Atoi(rest[:sp]); err == nil && pt > 0 && pt < 128 {
+			return uint8(pt)
+		}
+	}
+	return 0
+}
@@ -0,0 +1,295 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * FEC Tests
+ */
+package sfu
+
+import (
+	"bytes"
+	"encoding/binary"
+	"testing"
+)
+
+func TestXorBytes(t *testing.T) {
+	for _, n := range []int{0, 1, 7, 8, 31, 32, 33, 100, 1200} {
+		a := make([]byte, n)
+		b := make([]byte, n)
+		want := make([]byte, n)
+		for i := 0; i < n; i++ {
+			a[i] = byte(i * 7)
+			b[i] = byte(i*13 + 5)
+			want[i] = a[i] ^ b[i]
+		}
+		xorBytes(a, b)
+		if !bytes.Equal(a, want) {
+			t.Errorf("xorBytes mismatch for n=%d", n)
+		}
+	}
+}
+
+// recoverFlexFEC 测试用解码：用 FEC 包和组内其余包恢复丢失的包
+func recoverFlexFEC(fec []byte, received [][]byte) []byte {
+	lenRecovery := binary.BigEndian.Uint16(fec[2:])
+	tsRecovery := binary.BigEndian.Uint32(fec[4:])
+	byte0, byte1 := fec[0], fec[1]
+	acc := make([]byte, len(fec)-flexFECHeaderLen)
+	copy(acc, fec[flexFECHeaderLen:])
+
+	for _, pkt := range received {
+		byte0 ^= pkt[0]
+		byte1 ^= pkt[1]
+		lenRecovery ^= uint16(len(pkt) - rtpFixedHeaderLen)
+		tsRecovery ^= binary.BigEndian.Uint32(pkt[4:])
+		xorBytes(acc, pkt[rtpFixedHeaderLen:])
+	}
+
+	out := make([]byte, rtpFixedHeaderLen+int(lenRecovery))
+	out[0] = 0x80 | byte0&0x3f
+	out[1] = byte1
+	binary.BigEndian.PutUint32(out[4:], tsRecovery)
+	copy(out[8:12], fec[12:16]) // 受保护 SSRC
+	copy(out[rtpFixedHeaderLen:], acc[:lenRecovery])
+	return out
+}
+
+func TestFlexFECRecoversSingleLoss(t *testing.T) {
+	const groupSize = 5
+	enc := NewFlexFECEncoder(0x12345678)
+
+	var group [][]byte
+	var fec []byte
+	for i := 0; i < groupSize; i++ {
+		pkt := createTestRTPPacket(uint16(100+i), 200+i*150)
+		if i == groupSize-1 {
+			pkt[1] |= 0x80 // marker
+		}
+		group = append(group, pkt)
+
+		out, ok := enc.Protect(pkt[:rtpFixedHeaderLen], pkt[rtpFixedHeaderLen:], groupSize)
+		if ok != (i == groupSize-1) {
+			t.Fatalf("Packet %d: unexpected emit=%v", i, ok)
+		}
+		if ok {
+			fec = append([]byte(nil), out...)
+		}
+	}
+
+	if ssrc := binary.BigEndian.Uint32(fec[12:]); ssrc != 0x12345678 {
+		t.Errorf("Protected SSRC = %#x", ssrc)
+	}
+	if base := binary.BigEndian.Uint16(fec[16:]); base != 100 {
+		t.Errorf("SN base = %d, want 100", base)
+	}
+	if mask := binary.BigEndian.Uint16(fec[18:]); mask != 0x8000|0x7c00 {
+		t.Errorf("Mask = %#x, want %#x", mask, 0x8000|0x7c00)
+	}
+
+	for lost := 0; lost < groupSize; lost++ {
+		var received [][]byte
+		for i, pkt := range group {
+			if i != lost {
+				received = append(received, pkt)
+			}
+		}
+		got := recoverFlexFEC(fec, received)
+		want := group[lost]
+		// 序列号由 SN base + 掩码位置推算，不在恢复数据中
+		binary.BigEndian.PutUint16(got[2:], binary.BigEndian.Uint16(want[2:]))
+		if !bytes.Equal(got, want) {
+			t.Errorf("Failed to recover packet %d", lost)
+		}
+	}
+}
+
+func TestFlexFECGroupBoundaries(t *testing.T) {
+	enc := NewFlexFECEncoder(1)
+	pkt := createTestRTPPacket(10, 300)
+
+	// 关闭时不输出
+	if _, ok := enc.Protect(pkt[:12], pkt[12:], 0); ok {
+		t.Error("Expected no FEC when group size is 0")
+	}
+
+	// 重复序号提前结束当前组
+	enc.Protect(pkt[:12], pkt[12:], 4)
+	if _, ok := enc.Protect(pkt[:12], pkt[12:], 4); !ok {
+		t.Error("Expected duplicate SN to flush the group")
+	}
+
+	// 序号跳跃超过掩码范围
+	enc = NewFlexFECEncoder(1)
+	enc.Protect(pkt[:12], pkt[12:], 4)
+	far := createTestRTPPacket(40, 300)
+	out, ok := enc.Protect(far[:12], far[12:], 4)
+	if !ok || binary.BigEndian.Uint16(out[16:]) != 10 {
+		t.Error("Expected SN gap to flush the previous group")
+	}
+}
+
+func TestREDEncoderLayout(t *testing.T) {
+	enc := NewREDEncoder()
+
+	// 没有历史帧时不封装
+	if _, ok := enc.Encode(111, 0, []byte{1, 2, 3}, 2); ok {
+		t.Fatal("Expected no RED without history")
+	}
+	enc.Encode(111, 960, []byte{4, 5}, 2)
+
+	red, ok := enc.Encode(111, 1920, []byte{6, 7, 8, 9}, 2)
+	if !ok {
+		t.Fatal("Expected RED payload")
+	}
+
+	// 2 个冗余块头 + 1 字节主块头 + 3 + 2 + 4
+	if len(red) != 4+4+1+3+2+4 {
+		t.Fatalf("RED length = %d", len(red))
+	}
+	h0 := binary.BigEndian.Uint32(red[0:])
+	h1 := binary.BigEndian.Uint32(red[4:])
+	if h0>>31 != 1 || (h0>>24)&0x7f != 111 || (h0>>10)&0x3fff != 1920 || h0&0x3ff != 3 {
+		t.Errorf("Unexpected first block header %#x", h0)
+	}
+	if (h1>>10)&0x3fff != 960 || h1&0x3ff != 2 {
+		t.Errorf("Unexpected second block header %#x", h1)
+	}
+	if red[8] != 111 {
+		t.Errorf("Primary header = %d", red[8])
+	}
+	if !bytes.Equal(red[9:], []byte{1, 2, 3, 4, 5, 6, 7, 8, 9}) {
+		t.Errorf("Unexpected block data %v", red[9:])
+	}
+
+	// redundancy=0 调用方按原 PT 发送
+	if _, ok := enc.Encode(111, 2880, []byte{1}, 0); ok {
+		t.Error("Expected no RED when redundancy is 0")
+	}
+}
+
+func TestFECRateControllerAdapts(t *testing.T) {
+	rc := NewFECRateController(DefaultFECConfig())
+	if rc.VideoGroupSize() != 0 || rc.AudioRedundancy() != 0 {
+		t.Fatal("Expected no redundancy without loss")
+	}
+
+	// 5% 丢包
+	for i := 0; i < 20; i++ {
+		rc.UpdateLoss(13)
+	}
+	if k := rc.VideoGroupSize(); k < 9 || k > 11 {
+		t.Errorf("Group size at 5%% loss = %d", k)
+	}
+	if rc.AudioRedundancy() != 1 {
+		t.Errorf("Audio redundancy at 5%% loss = %d", rc.AudioRedundancy())
+	}
+
+	// 突发 30% 丢包，快速上升
+	rc.UpdateLoss(77)
+	rc.UpdateLoss(77)
+	if rc.AudioRedundancy() != 2 || rc.VideoGroupSize() > 3 {
+		t.Errorf("Expected fast attack: loss=%.3f k=%d red=%d", rc.Loss(), rc.VideoGroupSize(), rc.AudioRedundancy())
+	}
+
+	// 恢复后慢慢下降直至关闭
+	rc.UpdateLoss(0)
+	if rc.AudioRedundancy() == 0 {
+		t.Error("Expected slow release after a single clean report")
+	}
+	for i := 0; i < 50; i++ {
+		rc.UpdateLoss(0)
+	}
+	if rc.VideoGroupSize() != 0 || rc.AudioRedundancy() != 0 {
+		t.Errorf("Expected redundancy off after recovery, loss=%.4f", rc.Loss())
+	}
+}
+
+func TestForEachReportBlock(t *testing.T) {
+	// SR (1 个报告块) + RR (2 个报告块) 复合包
+	sr := make([]byte, 28+24)
+	sr[0] = 0x81
+	sr[1] = rtcpTypeSR
+	binary.BigEndian.PutUint16(sr[2:], uint16(len(sr)/4-1))
+	binary.BigEndian.PutUint32(sr[28:], 0xaaaa)
+	sr[32] = 10
+
+	rr := make([]byte, 8+48)
+	rr[0] = 0x82
+	rr[1] = rtcpTypeRR
+	binary.BigEndian.PutUint16(rr[2:], uint16(len(rr)/4-1))
+	binary.BigEndian.PutUint32(rr[8:], 0xbbbb)
+	rr[12] = 20
+	binary.BigEndian.PutUint32(rr[32:], 0xcccc)
+	rr[36] = 30
+
+	got := map[uint32]uint8{}
+	forEachReportBlock(append(sr, rr...), func(ssrc uint32, fractionLost uint8) {
+		got[ssrc] = fractionLost
+	})
+	if len(got) != 3 || got[0xaaaa] != 10 || got[0xbbbb] != 20 || got[0xcccc] != 30 {
+		t.Errorf("Unexpected report blocks: %v", got)
+	}
+
+	// 截断的包不越界
+	forEachReportBlock(rr[:20], func(uint32, uint8) {
+		t.Error("Unexpected report block from truncated packet")
+	})
+}
+
+func TestOfferREDPayloadType(t *testing.T) {
+	offer := "v=0\r\n" +
+		"m=video 9 UDP/TLS/RTP/SAVPF 96 63\r\n" +
+		"a=rtpmap:63 red/90000\r\n" +
+		"m=audio 9 UDP/TLS/RTP/SAVPF 111 63\r\n" +
+		"a=rtpmap:111 opus/48000/2\r\n" +
+		"a=rtpmap:63 red/48000/2\r\n"
+	if pt := offerREDPayloadType(offer); pt != 63 {
+		t.Errorf("RED PT = %d, want 63", pt)
+	}
+	if pt := offerREDPayloadType("m=audio 9 UDP/TLS/RTP/SAVPF 111\r\na=rtpmap:111 opus/48000/2\r\n"); pt != 0 {
+		t.Errorf("Expected 0 without RED, got %d", pt)
+	}
+}
+
+func TestFECEncodersDoNotAllocate(t *testing.T) {
+	fecEnc := NewFlexFECEncoder(1)
+	redEnc := NewREDEncoder()
+	video := createTestRTPPacket(1, 1200)
+	audio := make([]byte, 120)
+
+	var seq uint16
+	allocs := testing.AllocsPerRun(1000, func() {
+		seq++
+		binary.BigEndian.PutUint16(video[2:], seq)
+		fecEnc.Protect(video[:12], video[12:], 10)
+		redEnc.Encode(111, uint32(seq)*960, audio, 2)
+	})
+	if allocs != 0 {
+		t.Errorf("Expected zero allocations, got %.1f", allocs)
+	}
+}
+
+func BenchmarkFlexFECProtect(b *testing.B) {
+	enc := NewFlexFECEncoder(1)
+	pkt := createTestRTPPacket(1, 1200)
+	b.SetBytes(int64(len(pkt)))
+	b.ReportAllocs()
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		binary.BigEndian.PutUint16(pkt[2:], uint16(i))
+		enc.Protect(pkt[:12], pkt[12:], 10)
+	}
+}
+
+func BenchmarkREDEncode(b *testing.B) {
+	enc := NewREDEncoder()
+	payload := make([]byte, 120)
+	b.ReportAllocs()
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		enc.Encode(111, uint32(i)*960, payload, 2)
+	}
+}
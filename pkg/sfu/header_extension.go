@@ -0,0 +1,294 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Header Extension - RTP 扩展头改写
+ * 上游（LiveKit / 本地分享）的扩展头 ID 由上游协商决定，与每个订阅者协商的 ID 不一定一致，原样转发会被误读。
+ * 改写分两段，都在原有缓冲区上完成，不分配内存：
+ *
+ *   - 入口（SourceSwitcher）：上游 ID 改写为房间内部 ID；abs-send-time / transport-cc 等逐跳扩展头和未知扩展头直接剥离
+ *   - 出口（每个订阅者 PeerConnection 的 interceptor）：内部 ID 改写为该订阅者协商的 ID，没有协商的剥离；
+ *     协商了 transport-cc 时为每个包打上该连接独立递增的 transport-wide 序号
+ *
+ * 出口 interceptor 在 RelayRoom 的 API 上最后注册（最外层），FEC 保护的是改写后的包。
+ */
+package sfu
+
+import (
+	"encoding/binary"
+	"sync"
+	"sync/atomic"
+
+	"github.com/pion/interceptor"
+	"github.com/pion/rtp"
+	"github.com/pion/webrtc/v4"
+)
+
+const (
+	// TransportCCExtensionURI transport-wide-cc 扩展头 URI
+	TransportCCExtensionURI = "http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01"
+	// VideoOrientationExtensionURI CVO 视频方向扩展头 URI
+	VideoOrientationExtensionURI = "urn:3gpp:video-orientation"
+	// DependencyDescriptorExtensionURI 依赖描述符扩展头 URI
+	DependencyDescriptorExtensionURI = "https://aomediacodec.github.io/av1-rtp-spec/#dependency-descriptor-rtp-header-extension"
+)
+
+// 房间内部扩展头 ID（SourceSwitcher 输出轨道上使用）
+const (
+	relayExtAudioLevel uint8 = iota + 1
+	relayExtVideoOrientation
+	relayExtDependencyDescriptor
+)
+
+// relayExtensionURIs 端到端转发的扩展头，下标为内部 ID
+var relayExtensionURIs = [...]string{
+	relayExtAudioLevel:           AudioLevelExtensionURI,
+	relayExtVideoOrientation:     VideoOrientationExtensionURI,
+	relayExtDependencyDescriptor: DependencyDescriptorExtensionURI,
+}
+
+// maxMappedExtensions 一张映射表最多的条目数（端到端转发的扩展头个数）
+const maxMappedExtensions = len(relayExtensionURIs) - 1
+
+// HeaderExtensionConfig 与订阅者协商的扩展头
+type HeaderExtensionConfig struct {
+	// 转发音量（RFC 6464）
+	AudioLevel bool
+	// 转发视频方向（移动端摄像头旋转）
+	VideoOrientation bool
+	// 转发依赖描述符（AV1 / VP9 SVC）
+	DependencyDescriptor bool
+	// 协商 transport-cc 并为每个包打上新的序号
+	// 开启后订阅者改为发送 TWCC 反馈，不再发送 REMB，需要配合发送端带宽估计使用
+	TransportCC bool
+}
+
+// DefaultHeaderExtensionConfig 返回默认配置
+func DefaultHeaderExtensionConfig() HeaderExtensionConfig {
+	return HeaderExtensionConfig{
+		AudioLevel:       true,
+		VideoOrientation: true,
+	}
+}
+
+// Register 在 MediaEngine 中注册需要协商的扩展头（使用 WithWebRTCAPI 自定义 API 时自行调用）
+func (c HeaderExtensionConfig) Register(m *webrtc.MediaEngine) error {
+	extensions := []struct {
+		enabled bool
+		uri     string
+		kind    webrtc.RTPCodecType
+	}{
+		{c.AudioLevel, AudioLevelExtensionURI, webrtc.RTPCodecTypeAudio},
+		{c.VideoOrientation, VideoOrientationExtensionURI, webrtc.RTPCodecTypeVideo},
+		{c.DependencyDescriptor, DependencyDescriptorExtensionURI, webrtc.RTPCodecTypeVideo},
+		{c.TransportCC, TransportCCExtensionURI, webrtc.RTPCodecTypeVideo},
+		{c.TransportCC, TransportCCExtensionURI, webrtc.RTPCodecTypeAudio},
+	}
+	for _, ext := range extensions {
+		if !ext.enabled {
+			continue
+		}
+		if err := m.RegisterHeaderExtension(webrtc.RTPHeaderExtensionCapability{URI: ext.uri}, ext.kind); err != nil {
+			return err
+		}
+	}
+	if c.TransportCC {
+		m.RegisterFeedback(webrtc.RTCPFeedback{Type: webrtc.TypeRTCPFBTransportCC}, webrtc.RTPCodecTypeVideo)
+		m.RegisterFeedback(webrtc.RTCPFeedback{Type: webrtc.TypeRTCPFBTransportCC}, webrtc.RTPCodecTypeAudio)
+	}
+	return nil
+}
+
+// extensionMapping 一条 ID 改写
+type extensionMapping struct {
+	from uint8
+	to   uint8
+}
+
+// HeaderExtensionMap 扩展头 ID 改写表（不在表中的扩展头被剥离）
+// nil 表示没有映射，所有扩展头都被剥离
+type HeaderExtensionMap struct {
+	mappings [maxMappedExtensions]extensionMapping
+	n        int
+}
+
+func (m *HeaderExtensionMap) add(from, to uint8) {
+	if from == 0 || to == 0 || m.n == len(m.mappings) {
+		return
+	}
+	m.mappings[m.n] = extensionMapping{from: from, to: to}
+	m.n++
+}
+
+// NewIngressExtensionMap 上游协商的扩展头 -> 房间内部 ID
+func NewIngressExtensionMap(upstream []webrtc.RTPHeaderExtensionParameter) *HeaderExtensionMap {
+	m := &HeaderExtensionMap{}
+	for _, ext := range upstream {
+		for id, uri := range relayExtensionURIs {
+			if id != 0 && ext.URI == uri {
+				m.add(uint8(ext.ID), uint8(id))
+			}
+		}
+	}
+	return m
+}
+
+// newLocalExtensionMap 本地分享的默认映射：按房间内部 ID 识别（音量 1、视频方向 2、依赖描述符 3），原样保留
+// 本地分享的 RTP 由应用自行打包，没有上游协商结果；使用其他 ID 时调用 SetHeaderExtensions(SourceTypeLocal, ...) 覆盖
+func newLocalExtensionMap() *HeaderExtensionMap {
+	m := &HeaderExtensionMap{}
+	for id := range relayExtensionURIs {
+		m.add(uint8(id), uint8(id))
+	}
+	return m
+}
+
+// newEgressExtensionMap 房间内部 ID -> 订阅者协商的 ID，同时返回 transport-cc 的协商 ID（0 表示未协商）
+func newEgressExtensionMap(negotiated []interceptor.RTPHeaderExtension) (*HeaderExtensionMap, uint8) {
+	m := &HeaderExtensionMap{}
+	var transportCC uint8
+	for _, ext := range negotiated {
+		if ext.URI == TransportCCExtensionURI {
+			transportCC = uint8(ext.ID)
+			continue
+		}
+		for id, uri := range relayExtensionURIs {
+			if id != 0 && ext.URI == uri {
+				m.add(uint8(id), uint8(ext.ID))
+			}
+		}
+	}
+	return m, transportCC
+}
+
+// Rewrite 按映射表重建 header 的扩展头，extraID 非 0 时再追加一个扩展头（例如 transport-cc 序号）
+// 重建结果写入 dst 的底层数组（容量足够时不分配内存），负载仍引用原缓冲区；返回被剥离的扩展头个数
+func (m *HeaderExtensionMap) Rewrite(h *rtp.Header, dst []rtp.Extension, extraID uint8, extra []byte) int {
+	var kept [maxMappedExtensions + 1]struct {
+		id      uint8
+		payload []byte
+	}
+	n, total := 0, 0
+	twoByte := false
+
+	if h.Extension {
+		total = len(h.Extensions)
+		if m != nil {
+			for _, mapping := range m.mappings[:m.n] {
+				if payload := h.GetExtension(mapping.from); payload != nil {
+					kept[n].id, kept[n].payload = mapping.to, payload
+					n++
+					twoByte = twoByte || mapping.to > 14 || len(payload) > 16
+				}
+			}
+		}
+	}
+	stripped := total - n
+
+	if extraID != 0 {
+		kept[n].id, kept[n].payload = extraID, extra
+		n++
+		twoByte = twoByte || extraID > 14 || len(extra) > 16
+	}
+
+	// 负载已取出，可以覆盖原 Extensions 的底层数组
+	h.Extensions = dst[:0]
+	h.Extension = n > 0
+	h.ExtensionProfile = 0
+	if n > 0 {
+		h.ExtensionProfile = rtp.ExtensionProfileOneByte
+		if twoByte {
+			h.ExtensionProfile = rtp.ExtensionProfileTwoByte
+		}
+	}
+	for _, ext := range kept[:n] {
+		_ = h.SetExtension(ext.id, ext.payload)
+	}
+	return stripped
+}
+
+// HeaderExtensionStats 出口扩展头改写统计
+type HeaderExtensionStats struct {
+	Packets     uint64 `json:"packets"`      // 改写过扩展头的包数
+	Stripped    uint64 `json:"stripped"`     // 剥离的扩展头个数（订阅者未协商）
+	TransportCC uint64 `json:"transport_cc"` // 打上 transport-cc 序号的包数
+}
+
+// HeaderExtensionRewriter 房间级出口扩展头改写（实现 interceptor.Factory，所有订阅者 PeerConnection 共享）
+type HeaderExtensionRewriter struct {
+	packets     atomic.Uint64
+	stripped    atomic.Uint64
+	transportCC atomic.Uint64
+}
+
+// NewHeaderExtensionRewriter 创建出口改写器
+func NewHeaderExtensionRewriter() *HeaderExtensionRewriter {
+	return &HeaderExtensionRewriter{}
+}
+
+// GetStats 获取统计
+func (r *HeaderExtensionRewriter) GetStats() HeaderExtensionStats {
+	return HeaderExtensionStats{
+		Packets:     r.packets.Load(),
+		Stripped:    r.stripped.Load(),
+		TransportCC: r.transportCC.Load(),
+	}
+}
+
+// NewInterceptor 实现 interceptor.Factory（每个 PeerConnection 调用一次）
+func (r *HeaderExtensionRewriter) NewInterceptor(_ string) (interceptor.Interceptor, error) {
+	return &headerExtensionInterceptor{rewriter: r}, nil
+}
+
+// headerExtensionInterceptor 按该订阅者的协商结果改写每条发送流的扩展头
+type headerExtensionInterceptor struct {
+	interceptor.NoOp
+
+	rewriter *HeaderExtensionRewriter
+
+	// transport-wide 序号：同一个 PeerConnection 的所有流共用
+	transportSeq atomic.Uint32
+}
+
+// BindLocalStream 按协商结果建立改写表
+func (i *headerExtensionInterceptor) BindLocalStream(info *interceptor.StreamInfo, writer interceptor.RTPWriter) interceptor.RTPWriter {
+	egress, transportCCID := newEgressExtensionMap(info.RTPHeaderExtensions)
+	r := i.rewriter
+
+	var (
+		mu           sync.Mutex
+		scratch      [maxMappedExtensions + 1]rtp.Extension
+		transportSeq [2]byte
+	)
+
+	return interceptor.RTPWriterFunc(func(header *rtp.Header, payload []byte, attributes interceptor.Attributes) (int, error) {
+		if !header.Extension && transportCCID == 0 {
+			return writer.Write(header, payload, attributes)
+		}
+
+		mu.Lock()
+		defer mu.Unlock()
+
+		var extra []byte
+		if transportCCID != 0 {
+			binary.BigEndian.PutUint16(transportSeq[:], uint16(i.transportSeq.Add(1)-1))
+			extra = transportSeq[:]
+		}
+
+		// TrackLocalStaticRTP 对所有订阅者复用同一个 header，写完恢复
+		extension, profile, extensions := header.Extension, header.ExtensionProfile, header.Extensions
+		stripped := egress.Rewrite(header, scratch[:], transportCCID, extra)
+		n, err := writer.Write(header, payload, attributes)
+		header.Extension, header.ExtensionProfile, header.Extensions = extension, profile, extensions
+
+		r.packets.Add(1)
+		if stripped > 0 {
+			r.stripped.Add(uint64(stripped))
+		}
+		if transportCCID != 0 {
+			r.transportCC.Add(1)
+		}
+		return n, err
+	})
+}
@@ -0,0 +1,229 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Header Extension Tests
+ */
+package sfu
+
+import (
+	"bytes"
+	"encoding/binary"
+	"strings"
+	"testing"
+
+	"github.com/pion/interceptor"
+	"github.com/pion/rtp"
+	"github.com/pion/webrtc/v4"
+)
+
+// upstreamHeader LiveKit 风格的上游包：音量 5、abs-send-time 2、transport-cc 3、未知扩展头 9
+func upstreamHeader(t testing.TB) rtp.Header {
+	t.Helper()
+	h := rtp.Header{Version: 2, SSRC: 0x1111, Extension: true, ExtensionProfile: rtp.ExtensionProfileOneByte}
+	for _, ext := range []struct {
+		id      uint8
+		payload []byte
+	}{
+		{5, []byte{0x85}},
+		{2, []byte{1, 2, 3}},
+		{3, []byte{0, 7}},
+		{9, []byte{0xff}},
+	} {
+		if err := h.SetExtension(ext.id, ext.payload); err != nil {
+			t.Fatal(err)
+		}
+	}
+	return h
+}
+
+var upstreamExtensions = []webrtc.RTPHeaderExtensionParameter{
+	{URI: AudioLevelExtensionURI, ID: 5},
+	{URI: "http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time", ID: 2},
+	{URI: TransportCCExtensionURI, ID: 3},
+}
+
+func TestHeaderExtensionMapIngressRewrite(t *testing.T) {
+	h := upstreamHeader(t)
+	stripped := NewIngressExtensionMap(upstreamExtensions).Rewrite(&h, h.Extensions, 0, nil)
+
+	if stripped != 3 {
+		t.Errorf("Expected 3 stripped extensions, got %d", stripped)
+	}
+	if len(h.Extensions) != 1 || !bytes.Equal(h.GetExtension(relayExtAudioLevel), []byte{0x85}) {
+		t.Errorf("Expected only the audio level under the internal ID, got %+v", h.Extensions)
+	}
+	if h.ExtensionProfile != rtp.ExtensionProfileOneByte {
+		t.Errorf("Expected one-byte profile, got %#x", h.ExtensionProfile)
+	}
+
+	// 没有映射：全部剥离，不再带扩展头
+	h = upstreamHeader(t)
+	var none *HeaderExtensionMap
+	if stripped := none.Rewrite(&h, h.Extensions, 0, nil); stripped != 4 || h.Extension || len(h.Extensions) != 0 {
+		t.Errorf("Expected all extensions stripped, got %d %+v", stripped, h)
+	}
+
+	// 本地分享默认映射：内部 ID 原样保留，其余剥离
+	ss, err := NewSourceSwitcher("ext-room")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer ss.Close()
+	h = upstreamHeader(t)
+	local := ss.extensionMaps[SourceTypeLocal][extensionSlot(true)].Load()
+	if stripped := local.Rewrite(&h, h.Extensions, 0, nil); stripped != 2 || len(h.Extensions) != 2 {
+		t.Errorf("Expected the internal IDs kept for local share, got %d %+v", stripped, h.Extensions)
+	}
+	if !bytes.Equal(h.GetExtension(relayExtVideoOrientation), []byte{1, 2, 3}) {
+		t.Errorf("Expected video orientation kept under its internal ID, got %+v", h.Extensions)
+	}
+}
+
+// captureWriter 记录每次写出的包（按 pion 的方式序列化）
+type captureWriter struct {
+	packets []*rtp.Packet
+}
+
+func (w *captureWriter) Write(header *rtp.Header, payload []byte, _ interceptor.Attributes) (int, error) {
+	data, err := (&rtp.Packet{Header: *header, Payload: payload}).Marshal()
+	if err != nil {
+		return 0, err
+	}
+	packet := &rtp.Packet{}
+	if err := packet.Unmarshal(data); err != nil {
+		return 0, err
+	}
+	w.packets = append(w.packets, packet)
+	return len(data), nil
+}
+
+// TestHeaderExtensionRewriterPerSubscriber 同一个 header 依次写给协商结果不同的两个订阅者
+func TestHeaderExtensionRewriterPerSubscriber(t *testing.T) {
+	rewriter := NewHeaderExtensionRewriter()
+	newBinding := func(extensions []interceptor.RTPHeaderExtension) (*captureWriter, interceptor.RTPWriter) {
+		i, err := rewriter.NewInterceptor("")
+		if err != nil {
+			t.Fatal(err)
+		}
+		w := &captureWriter{}
+		return w, i.BindLocalStream(&interceptor.StreamInfo{SSRC: 0xaaaa, RTPHeaderExtensions: extensions}, w)
+	}
+	withTCC, writerA := newBinding([]interceptor.RTPHeaderExtension{
+		{URI: AudioLevelExtensionURI, ID: 1},
+		{URI: TransportCCExtensionURI, ID: 4},
+	})
+	twoByte, writerB := newBinding([]interceptor.RTPHeaderExtension{
+		{URI: AudioLevelExtensionURI, ID: 15},
+	})
+
+	h := rtp.Header{Version: 2, SSRC: 0xaaaa, Extension: true, ExtensionProfile: rtp.ExtensionProfileOneByte}
+	h.SetExtension(relayExtAudioLevel, []byte{0x85})
+	h.SetExtension(relayExtVideoOrientation, []byte{0x01}) // 两个订阅者都没有协商
+	original := append([]rtp.Extension(nil), h.Extensions...)
+
+	for n := 0; n < 2; n++ {
+		writerA.Write(&h, []byte{0xde, 0xad}, nil)
+		writerB.Write(&h, []byte{0xde, 0xad}, nil)
+	}
+
+	// 写完恢复共享的 header
+	if !h.Extension || h.ExtensionProfile != rtp.ExtensionProfileOneByte || len(h.Extensions) != len(original) {
+		t.Fatalf("Shared header not restored: %+v", h)
+	}
+	if !bytes.Equal(h.GetExtension(relayExtVideoOrientation), []byte{0x01}) {
+		t.Error("Shared header extensions were overwritten")
+	}
+
+	for n, p := range withTCC.packets {
+		if !bytes.Equal(p.GetExtension(1), []byte{0x85}) || p.GetExtension(relayExtVideoOrientation) != nil {
+			t.Errorf("Subscriber A packet %d: unexpected extensions %+v", n, p.Extensions)
+		}
+		if seq := p.GetExtension(4); len(seq) != 2 || binary.BigEndian.Uint16(seq) != uint16(n) {
+			t.Errorf("Subscriber A packet %d: expected transport-cc seq %d, got %v", n, n, seq)
+		}
+	}
+	for n, p := range twoByte.packets {
+		if p.ExtensionProfile != rtp.ExtensionProfileTwoByte || !bytes.Equal(p.GetExtension(15), []byte{0x85}) || len(p.Extensions) != 1 {
+			t.Errorf("Subscriber B packet %d: unexpected extensions %#x %+v", n, p.ExtensionProfile, p.Extensions)
+		}
+	}
+
+	if stats := rewriter.GetStats(); stats.Packets != 4 || stats.Stripped != 4 || stats.TransportCC != 2 {
+		t.Errorf("Unexpected stats %+v", stats)
+	}
+}
+
+func TestRelayRoomNegotiatesHeaderExtensions(t *testing.T) {
+	for _, transportCC := range []bool{false, true} {
+		config := DefaultHeaderExtensionConfig()
+		config.TransportCC = transportCC
+		room, err := NewRelayRoom("ext-room", nil, WithHeaderExtensions(config))
+		if err != nil {
+			t.Fatal(err)
+		}
+		room.BecomeRelay("relay")
+
+		// 订阅者提供音量 / 视频方向 / transport-cc
+		m := &webrtc.MediaEngine{}
+		if err := m.RegisterDefaultCodecs(); err != nil {
+			t.Fatal(err)
+		}
+		offered := HeaderExtensionConfig{AudioLevel: true, VideoOrientation: true, TransportCC: true}
+		if err := offered.Register(m); err != nil {
+			t.Fatal(err)
+		}
+		pc, err := webrtc.NewAPI(webrtc.WithMediaEngine(m)).NewPeerConnection(webrtc.Configuration{})
+		if err != nil {
+			t.Fatal(err)
+		}
+		for _, kind := range []webrtc.RTPCodecType{webrtc.RTPCodecTypeAudio, webrtc.RTPCodecTypeVideo} {
+			pc.AddTransceiverFromKind(kind, webrtc.RTPTransceiverInit{Direction: webrtc.RTPTransceiverDirectionRecvonly})
+		}
+		offer, _ := pc.CreateOffer(nil)
+		pc.SetLocalDescription(offer)
+
+		answer, err := room.AddSubscriber("sub-1", offer.SDP)
+		if err != nil {
+			t.Fatalf("AddSubscriber failed: %v", err)
+		}
+		if !strings.Contains(answer, AudioLevelExtensionURI) || !strings.Contains(answer, VideoOrientationExtensionURI) {
+			t.Error("Answer should negotiate audio level and video orientation")
+		}
+		if strings.Contains(answer, TransportCCExtensionURI) != transportCC {
+			t.Errorf("transport-cc negotiated=%v, expected %v", !transportCC, transportCC)
+		}
+		if room.GetStatus().HeaderExtensions == nil {
+			t.Error("Built-in API should rewrite header extensions")
+		}
+
+		pc.Close()
+		room.Close()
+	}
+}
+
+// BenchmarkHeaderExtensionRewrite 每个订阅者每个包的改写开销（应为 0 次分配）
+func BenchmarkHeaderExtensionRewrite(b *testing.B) {
+	i, err := NewHeaderExtensionRewriter().NewInterceptor("")
+	if err != nil {
+		b.Fatal(err)
+	}
+	discard := interceptor.RTPWriterFunc(func(_ *rtp.Header, payload []byte, _ interceptor.Attributes) (int, error) {
+		return len(payload), nil
+	})
+	writer := i.BindLocalStream(&interceptor.StreamInfo{SSRC: 0xaaaa, RTPHeaderExtensions: []interceptor.RTPHeaderExtension{
+		{URI: AudioLevelExtensionURI, ID: 1},
+		{URI: TransportCCExtensionURI, ID: 3},
+	}}, discard)
+
+	h := upstreamHeader(b)
+	NewIngressExtensionMap(upstreamExtensions).Rewrite(&h, h.Extensions, 0, nil)
+	payload := make([]byte, 160)
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for n := 0; n < b.N; n++ {
+		writer.Write(&h, payload, nil)
+	}
+}
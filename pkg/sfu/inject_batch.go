@@ -0,0 +1,73 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Inject Batch - 批量注入 RTP 包
+ * Dart 把一批 RTP 包顺序写进原生暂存区（PacketArena），一次 FFI 调用全部注入，
+ * 不再每个包 calloc/free + GoBytes。
+ *
+ * 记录格式：
+ *   len(2, 小端) + flags(1) + reserved(1) + RTP 数据(len)
+ *   flags bit0: 视频；bit1: 本地分享源（否则为 SFU 源）
+ */
+package sfu
+
+import "encoding/binary"
+
+const (
+	// InjectRecordHeaderSize 记录头长度
+	InjectRecordHeaderSize = 4
+
+	// InjectFlagVideo 视频包
+	InjectFlagVideo = 1 << 0
+	// InjectFlagLocal 来自本地分享者（否则来自 SFU）
+	InjectFlagLocal = 1 << 1
+)
+
+// AppendInjectRecord 追加一条注入记录
+func AppendInjectRecord(dst []byte, isVideo, fromLocal bool, packet []byte) []byte {
+	var flags byte
+	if isVideo {
+		flags |= InjectFlagVideo
+	}
+	if fromLocal {
+		flags |= InjectFlagLocal
+	}
+	dst = binary.LittleEndian.AppendUint16(dst, uint16(len(packet)))
+	dst = append(dst, flags, 0)
+	return append(dst, packet...)
+}
+
+// InjectBatch 按记录格式批量注入
+// 单个包解析/发送失败不影响后续包；返回成功注入的包数，记录格式错误时停止并返回 ErrInvalidInjectRecord。
+// data 在返回后不再被引用，调用方可以立即复用（Inject* 内部的抓包、Pacer 都会拷贝）。
+func (ss *SourceSwitcher) InjectBatch(data []byte) (int, error) {
+	injected := 0
+	for len(data) > 0 {
+		if len(data) < InjectRecordHeaderSize {
+			return injected, ErrInvalidInjectRecord
+		}
+		n := int(binary.LittleEndian.Uint16(data))
+		flags := data[2]
+		if n == 0 || len(data) < InjectRecordHeaderSize+n {
+			return injected, ErrInvalidInjectRecord
+		}
+		packet := data[InjectRecordHeaderSize : InjectRecordHeaderSize+n]
+		data = data[InjectRecordHeaderSize+n:]
+
+		var err error
+		if flags&InjectFlagLocal != 0 {
+			err = ss.InjectLocalPacket(flags&InjectFlagVideo != 0, packet)
+		} else {
+			err = ss.InjectSFUPacket(flags&InjectFlagVideo != 0, packet)
+		}
+		if err == ErrForwarderClosed {
+			return injected, err
+		}
+		if err == nil {
+			injected++
+		}
+	}
+	return injected, nil
+}
@@ -0,0 +1,97 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Inject Batch Tests
+ */
+package sfu
+
+import (
+	"testing"
+)
+
+func TestSourceSwitcherInjectBatch(t *testing.T) {
+	switcher, err := NewSourceSwitcher("batch-room")
+	if err != nil {
+		t.Fatalf("Failed to create SourceSwitcher: %v", err)
+	}
+	defer switcher.Close()
+
+	var batch []byte
+	for i := 0; i < 10; i++ {
+		batch = AppendInjectRecord(batch, true, false, createTestRTPPacket(uint16(i), 200))
+	}
+	// 本地源的包在 SFU 为活跃源时只记录不转发
+	batch = AppendInjectRecord(batch, true, true, createTestRTPPacket(100, 200))
+	// 无法解析的包跳过，不影响后续记录
+	batch = AppendInjectRecord(batch, false, false, []byte{0x80, 0x01})
+	batch = AppendInjectRecord(batch, true, false, createTestRTPPacket(10, 200))
+
+	injected, err := switcher.InjectBatch(batch)
+	if err != nil {
+		t.Fatalf("InjectBatch failed: %v", err)
+	}
+	if injected != 12 {
+		t.Errorf("Expected 12 injected packets, got %d", injected)
+	}
+
+	sfuPackets, _ := switcher.Stats()
+	if sfuPackets != 11 {
+		t.Errorf("Expected 11 forwarded SFU packets, got %d", sfuPackets)
+	}
+}
+
+func TestSourceSwitcherInjectBatchInvalid(t *testing.T) {
+	switcher, err := NewSourceSwitcher("batch-room")
+	if err != nil {
+		t.Fatalf("Failed to create SourceSwitcher: %v", err)
+	}
+	defer switcher.Close()
+
+	valid := AppendInjectRecord(nil, true, false, createTestRTPPacket(1, 100))
+	inputs := map[string][]byte{
+		"short header": {0x01, 0x00},
+		"zero length":  {0x00, 0x00, 0x01, 0x00},
+		"truncated":    valid[:len(valid)-1],
+	}
+	for name, data := range inputs {
+		if _, err := switcher.InjectBatch(data); err != ErrInvalidInjectRecord {
+			t.Errorf("%s: expected ErrInvalidInjectRecord, got %v", name, err)
+		}
+	}
+
+	// 格式错误之前的记录已经注入
+	data := append(append([]byte(nil), valid...), 0xff)
+	if injected, err := switcher.InjectBatch(data); injected != 1 || err != ErrInvalidInjectRecord {
+		t.Errorf("Expected 1 injected + ErrInvalidInjectRecord, got %d, %v", injected, err)
+	}
+
+	switcher.Close()
+	if _, err := switcher.InjectBatch(valid); err != ErrForwarderClosed {
+		t.Errorf("Expected ErrForwarderClosed, got %v", err)
+	}
+}
+
+// BenchmarkInjectBatch 一次注入 32 个包
+func BenchmarkInjectBatch(b *testing.B) {
+	switcher, err := NewSourceSwitcher("bench-room")
+	if err != nil {
+		b.Fatal(err)
+	}
+	defer switcher.Close()
+
+	var batch []byte
+	for i := 0; i < 32; i++ {
+		batch = AppendInjectRecord(batch, true, false, createTestRTPPacket(uint16(i), 1200))
+	}
+	b.SetBytes(int64(len(batch)))
+	b.ReportAllocs()
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		if _, err := switcher.InjectBatch(batch); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
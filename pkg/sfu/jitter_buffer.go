@@ -29,6 +29,8 @@ type JitterBufferConfig struct {
 	TargetDelay time.Duration
 	// 最大缓冲包数
 	MaxPackets int
+	// 内存预算（nil 时不统计）：缓冲中的包计入占用，压力下容量减半
+	Memory *MemoryGovernor
 }
 
 // DefaultJitterBufferConfig 默认配置（禁用）
@@ -47,6 +49,7 @@ type BufferedPacket struct {
 	Packet       *rtp.Packet
 	ReceivedTime time.Time
 	index        int // heap index
+	size         int64
 }
 
 // PacketHeap RTP 包堆（按序号排序）
@@ -91,7 +94,8 @@ type JitterBuffer struct {
 	config JitterBufferConfig
 
 	// 包缓冲区（堆）
-	packets PacketHeap
+	packets       PacketHeap
+	bufferedBytes int64
 
 	// 序号跟踪
 	lastSeqNum      uint16
@@ -192,11 +196,14 @@ func (jb *JitterBuffer) Push(packet *rtp.Packet) {
 		}
 	}
 
-	// 检查缓冲区是否满
-	if len(jb.packets) >= jb.config.MaxPackets {
+	// 检查缓冲区是否满（内存压力下容量减半）
+	maxPackets := jb.config.MaxPackets
+	if jb.config.Memory.Pressure() >= MemoryPressureShrink {
+		maxPackets = (maxPackets + 1) / 2
+	}
+	for len(jb.packets) >= maxPackets && len(jb.packets) > 0 {
 		// 丢弃最旧的包
-		oldest := heap.Pop(&jb.packets).(*BufferedPacket)
-		_ = oldest
+		jb.popLocked()
 		jb.packetsDropped++
 	}
 
@@ -204,8 +211,27 @@ func (jb *JitterBuffer) Push(packet *rtp.Packet) {
 	buffered := &BufferedPacket{
 		Packet:       packet,
 		ReceivedTime: now,
+		size:         int64(packet.MarshalSize()),
 	}
 	heap.Push(&jb.packets, buffered)
+	jb.bufferedBytes += buffered.size
+	jb.config.Memory.Reserve(MemoryClassJitterBuffer, buffered.size)
+}
+
+// popLocked 取出最早的包并释放其内存占用
+func (jb *JitterBuffer) popLocked() *BufferedPacket {
+	packet := heap.Pop(&jb.packets).(*BufferedPacket)
+	jb.bufferedBytes -= packet.size
+	jb.config.Memory.Release(MemoryClassJitterBuffer, packet.size)
+	return packet
+}
+
+// releaseAllLocked 清空缓冲区并释放全部内存占用
+func (jb *JitterBuffer) releaseAllLocked() {
+	jb.config.Memory.Release(MemoryClassJitterBuffer, jb.bufferedBytes)
+	jb.bufferedBytes = 0
+	jb.packets = make(PacketHeap, 0, jb.config.MaxPackets)
+	heap.Init(&jb.packets)
 }
 
 // Start 启动输出
@@ -251,7 +277,7 @@ func (jb *JitterBuffer) tryOutput() {
 
 		// 如果已经达到目标延迟，输出
 		if age >= jb.currentDelay {
-			packet := heap.Pop(&jb.packets).(*BufferedPacket)
+			packet := jb.popLocked()
 
 			// 更新序号
 			if !jb.initialized || int16(packet.Packet.SequenceNumber-jb.lastSeqNum) > 0 {
@@ -291,7 +317,7 @@ func (jb *JitterBuffer) Pop() *rtp.Packet {
 		return nil
 	}
 
-	packet := heap.Pop(&jb.packets).(*BufferedPacket)
+	packet := jb.popLocked()
 	jb.lastSeqNum = packet.Packet.SequenceNumber
 	jb.initialized = true
 	return packet.Packet
@@ -329,6 +355,7 @@ func (jb *JitterBuffer) IsEnabled() bool {
 type JitterBufferStats struct {
 	Enabled         bool   `json:"enabled"`
 	BufferedPackets int    `json:"buffered_packets"`
+	BufferedBytes   int64  `json:"buffered_bytes"`
 	CurrentDelay    int64  `json:"current_delay_ms"`
 	Jitter          int64  `json:"jitter_ms"`
 	PacketsReceived uint64 `json:"packets_received"`
@@ -344,6 +371,7 @@ func (jb *JitterBuffer) GetStats() JitterBufferStats {
 	return JitterBufferStats{
 		Enabled:         jb.config.Enabled,
 		BufferedPackets: len(jb.packets),
+		BufferedBytes:   jb.bufferedBytes,
 		CurrentDelay:    jb.currentDelay.Milliseconds(),
 		Jitter:          jb.jitter.Milliseconds(),
 		PacketsReceived: jb.packetsReceived,
@@ -357,8 +385,7 @@ func (jb *JitterBuffer) Flush() {
 	jb.mu.Lock()
 	defer jb.mu.Unlock()
 
-	jb.packets = make(PacketHeap, 0, jb.config.MaxPackets)
-	heap.Init(&jb.packets)
+	jb.releaseAllLocked()
 }
 
 // Close 关闭
@@ -369,6 +396,7 @@ func (jb *JitterBuffer) Close() {
 		return
 	}
 	jb.closed = true
+	jb.releaseAllLocked()
 	jb.mu.Unlock()
 
 	close(jb.stopCh)
@@ -59,6 +59,12 @@ func DefaultKeepaliveConfig() KeepaliveConfig {
 	}
 }
 
+// PingRound 一轮心跳需要 ping 的 Peer
+type PingRound struct {
+	Seq     uint64   `json:"seq"`
+	PeerIDs []string `json:"peers"`
+}
+
 // PeerHeartbeat 单个 Peer 的心跳状态
 type PeerHeartbeat struct {
 	mu sync.RWMutex
@@ -68,6 +74,7 @@ type PeerHeartbeat struct {
 	lastPing    time.Time     // 上次发送 ping 的时间
 	lastPong    time.Time     // 上次收到 pong 的时间
 	rtt         time.Duration // 往返时间
+	pingSeq     uint64        // 上次 ping 所属的轮次
 	missedPongs int           // 连续丢失的 pong 次数
 	totalPings  uint64
 	totalPongs  uint64
@@ -91,12 +98,29 @@ func (h *PeerHeartbeat) MarkPingSent() {
 	h.totalPings++
 }
 
+// markPingRound 标记已在第 seq 轮发送 ping
+func (h *PeerHeartbeat) markPingRound(seq uint64, now time.Time) {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	h.lastPing = now
+	h.pingSeq = seq
+	h.totalPings++
+}
+
 // MarkPongReceived 标记收到 pong
 func (h *PeerHeartbeat) MarkPongReceived() {
+	h.markPongRound(0)
+}
+
+// markPongRound 标记收到第 seq 轮的 pong
+// seq 为 0 表示未知轮次；过期轮次的 pong 只刷新存活状态，不更新 RTT
+func (h *PeerHeartbeat) markPongRound(seq uint64) {
 	h.mu.Lock()
 	defer h.mu.Unlock()
 	now := time.Now()
-	h.rtt = now.Sub(h.lastPing)
+	if seq == 0 || seq == h.pingSeq {
+		h.rtt = now.Sub(h.lastPing)
+	}
 	h.lastPong = now
 	h.missedPongs = 0
 	h.totalPongs++
@@ -149,19 +173,42 @@ type KeepaliveManager struct {
 	onPeerSlow    func(peerID string, rtt time.Duration)
 	onPeerOffline func(peerID string)
 	onPing        func(peerID string) // 需要发送 ping 时触发
+	onPingRound   func(round PingRound)
+
+	// 当前 ping 轮次
+	pingSeq atomic.Uint64
 
 	// 控制
-	stopCh chan struct{}
-	closed bool
+	intervalCh chan time.Duration
+	stopCh     chan struct{}
+	closed     bool
 }
 
 // NewKeepaliveManager 创建心跳管理器
 func NewKeepaliveManager(config KeepaliveConfig) *KeepaliveManager {
 	return &KeepaliveManager{
-		config: config,
-		peers:  make(map[string]*PeerHeartbeat),
-		stopCh: make(chan struct{}),
+		config:     config,
+		peers:      make(map[string]*PeerHeartbeat),
+		intervalCh: make(chan time.Duration, 1),
+		stopCh:     make(chan struct{}),
+	}
+}
+
+// SetInterval 调整心跳间隔（运行中立即生效，超时判定不变）
+func (m *KeepaliveManager) SetInterval(interval time.Duration) {
+	if interval <= 0 {
+		return
+	}
+	m.mu.Lock()
+	m.config.Interval = interval
+	m.mu.Unlock()
+
+	// 只保留最新的间隔
+	select {
+	case <-m.intervalCh:
+	default:
 	}
+	m.intervalCh <- interval
 }
 
 // SetOnPeerOnline 设置 Peer 上线回调
@@ -193,6 +240,14 @@ func (m *KeepaliveManager) SetOnPing(fn func(peerID string)) {
 	m.onPing = fn
 }
 
+// SetOnPingRound 设置批量 ping 回调
+// 每个心跳周期只触发一次，携带本轮所有需要 ping 的 Peer（在 onPing 之前触发）
+func (m *KeepaliveManager) SetOnPingRound(fn func(round PingRound)) {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	m.onPingRound = fn
+}
+
 // AddPeer 添加需要监控的 Peer
 func (m *KeepaliveManager) AddPeer(peerID string) {
 	m.mu.Lock()
@@ -212,6 +267,22 @@ func (m *KeepaliveManager) RemovePeer(peerID string) {
 
 // HandlePong 处理收到的 pong
 func (m *KeepaliveManager) HandlePong(peerID string) {
+	m.handlePong(peerID, 0)
+}
+
+// HandlePongBatch 批量处理第 seq 轮的 pong（seq 为 0 表示未知轮次）
+func (m *KeepaliveManager) HandlePongBatch(seq uint64, peerIDs []string) {
+	for _, peerID := range peerIDs {
+		m.handlePong(peerID, seq)
+	}
+}
+
+// CurrentPingSeq 当前 ping 轮次（尚未发送过返回 0）
+func (m *KeepaliveManager) CurrentPingSeq() uint64 {
+	return m.pingSeq.Load()
+}
+
+func (m *KeepaliveManager) handlePong(peerID string, seq uint64) {
 	m.mu.RLock()
 	peer, exists := m.peers[peerID]
 	m.mu.RUnlock()
@@ -221,7 +292,7 @@ func (m *KeepaliveManager) HandlePong(peerID string) {
 	}
 
 	oldStatus := peer.GetStatus()
-	peer.MarkPongReceived()
+	peer.markPongRound(seq)
 	newStatus := peer.GetStatus()
 
 	// 状态变化回调
@@ -290,13 +361,19 @@ func (m *KeepaliveManager) Start() {
 
 // runLoop 心跳检测循环
 func (m *KeepaliveManager) runLoop() {
-	ticker := time.NewTicker(m.config.Interval)
+	m.mu.RLock()
+	interval := m.config.Interval
+	m.mu.RUnlock()
+
+	ticker := time.NewTicker(interval)
 	defer ticker.Stop()
 
 	for {
 		select {
 		case <-m.stopCh:
 			return
+		case interval := <-m.intervalCh:
+			ticker.Reset(interval)
 		case <-ticker.C:
 			m.checkAll()
 		}
@@ -311,10 +388,17 @@ func (m *KeepaliveManager) checkAll() {
 		peers = append(peers, peer)
 	}
 	onPing := m.onPing
+	onPingRound := m.onPingRound
 	onOffline := m.onPeerOffline
 	m.mu.RUnlock()
 
 	now := time.Now()
+	pingEnabled := onPing != nil || onPingRound != nil
+	seq := m.pingSeq.Add(1)
+	var round PingRound
+	if onPingRound != nil {
+		round = PingRound{Seq: seq, PeerIDs: make([]string, 0, len(peers))}
+	}
 
 	for _, peer := range peers {
 		// 检查是否超时
@@ -338,9 +422,20 @@ func (m *KeepaliveManager) checkAll() {
 			}
 		}
 
-		// 发送 ping
-		if onPing != nil {
-			peer.MarkPingSent()
+		if pingEnabled {
+			peer.markPingRound(seq, now)
+			if onPingRound != nil {
+				round.PeerIDs = append(round.PeerIDs, peer.peerID)
+			}
+		}
+	}
+
+	// 发送 ping：整轮一次回调，再逐个回调（兼容旧接口）
+	if onPingRound != nil && len(round.PeerIDs) > 0 {
+		onPingRound(round)
+	}
+	if onPing != nil {
+		for _, peer := range peers {
 			onPing(peer.peerID)
 		}
 	}
@@ -138,6 +138,68 @@ func TestKeepaliveAllPeerInfo(t *testing.T) {
 	}
 }
 
+func TestKeepalivePingRound(t *testing.T) {
+	km := NewKeepaliveManager(DefaultKeepaliveConfig())
+	defer km.Stop()
+
+	var rounds []PingRound
+	var pings int
+	km.SetOnPingRound(func(round PingRound) {
+		rounds = append(rounds, round)
+	})
+	km.SetOnPing(func(peerID string) {
+		pings++
+	})
+
+	for i := 0; i < 30; i++ {
+		km.AddPeer("peer-" + string(rune('a'+i)))
+	}
+	km.checkAll()
+	km.checkAll()
+
+	// 每轮只回调一次，携带全部 Peer
+	if len(rounds) != 2 {
+		t.Fatalf("Expected 2 ping rounds, got %d", len(rounds))
+	}
+	if len(rounds[0].PeerIDs) != 30 || rounds[0].Seq != 1 || rounds[1].Seq != 2 {
+		t.Errorf("Unexpected rounds: seq=%d/%d peers=%d", rounds[0].Seq, rounds[1].Seq, len(rounds[0].PeerIDs))
+	}
+	if pings != 60 {
+		t.Errorf("Expected per-peer callback to still fire, got %d", pings)
+	}
+	if km.CurrentPingSeq() != 2 {
+		t.Errorf("Expected seq 2, got %d", km.CurrentPingSeq())
+	}
+}
+
+func TestKeepaliveHandlePongBatch(t *testing.T) {
+	km := NewKeepaliveManager(DefaultKeepaliveConfig())
+	defer km.Stop()
+	km.SetOnPingRound(func(round PingRound) {})
+
+	km.AddPeer("peer-1")
+	km.AddPeer("peer-2")
+	km.checkAll()
+	time.Sleep(20 * time.Millisecond)
+	km.HandlePongBatch(1, []string{"peer-1", "peer-2", "unknown"})
+
+	for _, peerID := range []string{"peer-1", "peer-2"} {
+		if rtt := km.GetPeerRTT(peerID); rtt < 20*time.Millisecond {
+			t.Errorf("%s: expected RTT >= 20ms, got %v", peerID, rtt)
+		}
+	}
+
+	// 过期轮次的 pong 只刷新存活，不更新 RTT
+	km.checkAll()
+	km.HandlePongBatch(1, []string{"peer-1"})
+	if rtt := km.GetPeerRTT("peer-1"); rtt < 20*time.Millisecond {
+		t.Errorf("Stale pong should not update RTT, got %v", rtt)
+	}
+	if km.GetPeerStatus("peer-1") != PeerStatusOnline {
+		t.Error("Stale pong should keep peer online")
+	}
+}
+
 // ==========================================
 // Benchmarks
 // ==========================================
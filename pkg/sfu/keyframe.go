@@ -0,0 +1,120 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Keyframe Detection - 从 RTP 负载判断关键帧
+ * 只看负载头部几个字节，不解码：
+ *   VP8：payload descriptor 之后 VP8 payload header 的 P 位为 0（分区起始包）
+ *   VP9：descriptor 中 P=0 且 B=1
+ *   H264：IDR / SPS，包括 STAP-A 聚合包和 FU-A 起始分片
+ *   AV1：aggregation header 的 N 位（新的编码视频序列）
+ *
+ * 非参考帧（丢弃后不影响后续帧解码）：VP8 descriptor 的 N 位，H264 NRI 为 0。
+ * VP9 / AV1 需要解析依赖描述扩展头，这里不判断。
+ */
+package sfu
+
+import (
+	"strings"
+
+	"github.com/pion/webrtc/v4"
+)
+
+// IsKeyframe 判断 RTP 负载是否是关键帧的起始包
+func IsKeyframe(mimeType string, payload []byte) bool {
+	if len(payload) == 0 {
+		return false
+	}
+	switch {
+	case strings.EqualFold(mimeType, webrtc.MimeTypeVP8):
+		return isVP8Keyframe(payload)
+	case strings.EqualFold(mimeType, webrtc.MimeTypeVP9):
+		return isVP9Keyframe(payload)
+	case strings.EqualFold(mimeType, webrtc.MimeTypeH264):
+		return isH264Keyframe(payload)
+	case strings.EqualFold(mimeType, webrtc.MimeTypeAV1):
+		return payload[0]&0x08 != 0
+	}
+	return false
+}
+
+func isVP8Keyframe(payload []byte) bool {
+	// X R N S R PID
+	b0 := payload[0]
+	if b0&0x10 == 0 || b0&0x07 != 0 {
+		return false // 不是第一个分区的起始包
+	}
+	i := 1
+	if b0&0x80 != 0 {
+		if len(payload) <= i {
+			return false
+		}
+		x := payload[i]
+		i++
+		if x&0x80 != 0 { // PictureID
+			if len(payload) <= i {
+				return false
+			}
+			if payload[i]&0x80 != 0 {
+				i += 2
+			} else {
+				i++
+			}
+		}
+		if x&0x40 != 0 { // TL0PICIDX
+			i++
+		}
+		if x&0x30 != 0 { // TID / KEYIDX
+			i++
+		}
+	}
+	if len(payload) <= i {
+		return false
+	}
+	return payload[i]&0x01 == 0
+}
+
+func isVP9Keyframe(payload []byte) bool {
+	// I P L F B E V Z
+	b0 := payload[0]
+	return b0&0x40 == 0 && b0&0x08 != 0
+}
+
+func isH264Keyframe(payload []byte) bool {
+	switch payload[0] & 0x1f {
+	case 5, 7: // IDR, SPS
+		return true
+	case 24: // STAP-A
+		for i := 1; i+2 < len(payload); {
+			size := int(payload[i])<<8 | int(payload[i+1])
+			i += 2
+			if size == 0 || i+size > len(payload) {
+				return false
+			}
+			if t := payload[i] & 0x1f; t == 5 || t == 7 {
+				return true
+			}
+			i += size
+		}
+	case 28: // FU-A
+		return len(payload) > 1 && payload[1]&0x80 != 0 && payload[1]&0x1f == 5
+	}
+	return false
+}
+
+// IsNonReferenceFrame 判断 RTP 负载是否属于非参考帧（可丢弃）
+func IsNonReferenceFrame(mimeType string, payload []byte) bool {
+	if len(payload) == 0 {
+		return false
+	}
+	switch {
+	case strings.EqualFold(mimeType, webrtc.MimeTypeVP8):
+		// X R N S R PID
+		return payload[0]&0x20 != 0
+	case strings.EqualFold(mimeType, webrtc.MimeTypeH264):
+		// F NRI Type：STAP-A / FU-A 的 NRI 与其中的 NAL 一致（聚合包取最大值）
+		return payload[0]&0x60 == 0
+	}
+	return false
+}
@@ -0,0 +1,77 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Keyframe Detection Tests
+ */
+package sfu
+
+import (
+	"testing"
+
+	"github.com/pion/webrtc/v4"
+)
+
+func TestIsKeyframe(t *testing.T) {
+	cases := []struct {
+		name    string
+		mime    string
+		payload []byte
+		want    bool
+	}{
+		{"vp8 key", webrtc.MimeTypeVP8, []byte{0x10, 0x00, 0x9d, 0x01, 0x2a}, true},
+		{"vp8 key with picture id", webrtc.MimeTypeVP8, []byte{0x90, 0x80, 0x81, 0x23, 0x00}, true},
+		{"vp8 key with all extensions", webrtc.MimeTypeVP8, []byte{0x90, 0xf0, 0x05, 0x01, 0x20, 0x00}, true},
+		{"vp8 delta", webrtc.MimeTypeVP8, []byte{0x10, 0x01}, false},
+		{"vp8 continuation", webrtc.MimeTypeVP8, []byte{0x00, 0x00}, false},
+		{"vp8 truncated", webrtc.MimeTypeVP8, []byte{0x90, 0x80}, false},
+		{"vp9 key", webrtc.MimeTypeVP9, []byte{0x88}, true},
+		{"vp9 inter", webrtc.MimeTypeVP9, []byte{0xc8}, false},
+		{"vp9 key middle", webrtc.MimeTypeVP9, []byte{0x80}, false},
+		{"h264 idr", webrtc.MimeTypeH264, []byte{0x65, 0x88}, true},
+		{"h264 sps", webrtc.MimeTypeH264, []byte{0x67, 0x42}, true},
+		{"h264 non-idr", webrtc.MimeTypeH264, []byte{0x41, 0x9a}, false},
+		{"h264 stap-a sps", webrtc.MimeTypeH264, []byte{0x78, 0x00, 0x02, 0x67, 0x42, 0x00, 0x02, 0x68, 0xce}, true},
+		{"h264 stap-a other", webrtc.MimeTypeH264, []byte{0x78, 0x00, 0x02, 0x06, 0x05}, false},
+		{"h264 fu-a idr start", webrtc.MimeTypeH264, []byte{0x7c, 0x85, 0x00}, true},
+		{"h264 fu-a idr middle", webrtc.MimeTypeH264, []byte{0x7c, 0x05, 0x00}, false},
+		{"av1 new sequence", webrtc.MimeTypeAV1, []byte{0x18}, true},
+		{"av1 delta", webrtc.MimeTypeAV1, []byte{0x10}, false},
+		{"audio", webrtc.MimeTypeOpus, []byte{0xff}, false},
+		{"empty", webrtc.MimeTypeVP8, nil, false},
+	}
+	for _, c := range cases {
+		if got := IsKeyframe(c.mime, c.payload); got != c.want {
+			t.Errorf("%s: IsKeyframe = %v, want %v", c.name, got, c.want)
+		}
+	}
+}
+
+func TestIsKeyframeMimeCase(t *testing.T) {
+	if !IsKeyframe("video/vp8", []byte{0x10, 0x00}) {
+		t.Error("Mime type match should be case-insensitive")
+	}
+}
+
+func TestIsNonReferenceFrame(t *testing.T) {
+	cases := []struct {
+		name    string
+		mime    string
+		payload []byte
+		want    bool
+	}{
+		{"vp8 non-reference", webrtc.MimeTypeVP8, []byte{0x30, 0x01}, true},
+		{"vp8 reference", webrtc.MimeTypeVP8, []byte{0x10, 0x01}, false},
+		{"h264 nri 0", webrtc.MimeTypeH264, []byte{0x01, 0x9a}, true},
+		{"h264 non-idr reference", webrtc.MimeTypeH264, []byte{0x41, 0x9a}, false},
+		{"h264 fu-a nri 0", webrtc.MimeTypeH264, []byte{0x1c, 0x81}, true},
+		{"vp9 unsupported", webrtc.MimeTypeVP9, []byte{0xc8}, false},
+		{"empty", webrtc.MimeTypeVP8, nil, false},
+	}
+	for _, c := range cases {
+		if got := IsNonReferenceFrame(c.mime, c.payload); got != c.want {
+			t.Errorf("%s: IsNonReferenceFrame = %v, want %v", c.name, got, c.want)
+		}
+	}
+}
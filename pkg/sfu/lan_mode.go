@@ -0,0 +1,66 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * LAN Mode - 局域网快速连接
+ * Relay 与订阅者在同一局域网内，完整 ICE（STUN 收集、双向连通性检查、默认超时）只会拖慢建连。
+ * 局域网模式下 RelayRoom 作为 ICE-lite 端：
+ *
+ *   - 只收集 host 候选（可选 mDNS），不访问 STUN/TURN
+ *   - 不主动做连通性检查，订阅者（完整 ICE，controlling）的第一个检查成功即可提名
+ *   - 断开 / 失败判定和保活间隔按局域网调短，Relay 掉线后订阅者更快进入故障切换
+ */
+package sfu
+
+import (
+	"time"
+
+	"github.com/pion/ice/v4"
+	"github.com/pion/webrtc/v4"
+)
+
+// LANModeConfig 局域网模式配置
+type LANModeConfig struct {
+	// 收集 mDNS 候选（隐藏本机 IP，订阅者需要能解析 .local 地址）
+	MulticastDNS bool
+	// 只在这些网卡上收集候选（例如 wlan0 / en0），为空时不限制
+	Interfaces []string
+	// ICE 断开判定时间
+	DisconnectedTimeout time.Duration
+	// ICE 失败判定时间
+	FailedTimeout time.Duration
+	// ICE 保活间隔
+	KeepaliveInterval time.Duration
+}
+
+// DefaultLANModeConfig 返回默认配置
+func DefaultLANModeConfig() LANModeConfig {
+	return LANModeConfig{
+		DisconnectedTimeout: 1 * time.Second,
+		FailedTimeout:       3 * time.Second,
+		KeepaliveInterval:   500 * time.Millisecond,
+	}
+}
+
+// Apply 把局域网模式写入 SettingEngine（使用 WithWebRTCAPI 自定义 API 时自行调用）
+func (c LANModeConfig) Apply(se *webrtc.SettingEngine) {
+	se.SetLite(true)
+	se.SetNetworkTypes([]webrtc.NetworkType{webrtc.NetworkTypeUDP4, webrtc.NetworkTypeUDP6})
+	se.SetICETimeouts(c.DisconnectedTimeout, c.FailedTimeout, c.KeepaliveInterval)
+
+	if c.MulticastDNS {
+		se.SetICEMulticastDNSMode(ice.MulticastDNSModeQueryAndGather)
+	}
+
+	if len(c.Interfaces) > 0 {
+		allowed := make(map[string]struct{}, len(c.Interfaces))
+		for _, name := range c.Interfaces {
+			allowed[name] = struct{}{}
+		}
+		se.SetInterfaceFilter(func(name string) bool {
+			_, ok := allowed[name]
+			return ok
+		})
+	}
+}
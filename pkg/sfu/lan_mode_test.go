@@ -0,0 +1,235 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * LAN Mode Tests
+ */
+package sfu
+
+import (
+	"strings"
+	"sync"
+	"testing"
+	"time"
+
+	"github.com/pion/logging"
+	"github.com/pion/transport/v3/vnet"
+	"github.com/pion/webrtc/v4"
+)
+
+// lanTestNetwork 虚拟局域网：Relay 1.2.3.4，订阅者 1.2.3.5
+type lanTestNetwork struct {
+	router   *vnet.Router
+	relayAPI *webrtc.API
+	subAPI   *webrtc.API
+}
+
+func newLANTestNetwork(tb testing.TB, lan *LANModeConfig) *lanTestNetwork {
+	tb.Helper()
+	router, err := vnet.NewRouter(&vnet.RouterConfig{
+		CIDR:          "1.2.3.0/24",
+		LoggerFactory: logging.NewDefaultLoggerFactory(),
+	})
+	if err != nil {
+		tb.Fatal(err)
+	}
+	apiFor := func(ip string, lan *LANModeConfig) *webrtc.API {
+		n, err := vnet.NewNet(&vnet.NetConfig{StaticIP: ip})
+		if err != nil {
+			tb.Fatal(err)
+		}
+		if err := router.AddNet(n); err != nil {
+			tb.Fatal(err)
+		}
+		se := webrtc.SettingEngine{}
+		se.SetNet(n)
+		if lan != nil {
+			lan.Apply(&se)
+		}
+		return webrtc.NewAPI(webrtc.WithSettingEngine(se))
+	}
+	network := &lanTestNetwork{
+		router:   router,
+		relayAPI: apiFor("1.2.3.4", lan),
+		subAPI:   apiFor("1.2.3.5", nil),
+	}
+	if err := router.Start(); err != nil {
+		tb.Fatal(err)
+	}
+	tb.Cleanup(func() { router.Stop() })
+	return network
+}
+
+// newLANTestRoom 创建 Relay 房间；完整 ICE 时配置一个虚拟网络中不存在的 STUN 服务器（与默认配置一样需要收集 srflx）
+func newLANTestRoom(tb testing.TB, network *lanTestNetwork, lan *LANModeConfig) *RelayRoom {
+	tb.Helper()
+	opts := []RelayRoomOption{WithWebRTCAPI(network.relayAPI)}
+	if lan != nil {
+		opts = append(opts, WithLANMode(*lan))
+	}
+	room, err := NewRelayRoom("lan-room", []webrtc.ICEServer{{URLs: []string{"stun:1.2.3.100:3478"}}}, opts...)
+	if err != nil {
+		tb.Fatal(err)
+	}
+	tb.Cleanup(func() { room.Close() })
+	room.BecomeRelay("relay")
+	return room
+}
+
+// connectLANSubscriber 订阅者连接 Relay，返回从提交 Offer 到 ICE 连通的耗时和 Relay 发出的候选
+func connectLANSubscriber(tb testing.TB, network *lanTestNetwork, room *RelayRoom, peerID string) (time.Duration, []string) {
+	tb.Helper()
+
+	pc, err := network.subAPI.NewPeerConnection(webrtc.Configuration{})
+	if err != nil {
+		tb.Fatal(err)
+	}
+	defer pc.Close()
+
+	connected := make(chan struct{})
+	var once sync.Once
+	pc.OnICEConnectionStateChange(func(state webrtc.ICEConnectionState) {
+		if state == webrtc.ICEConnectionStateConnected {
+			once.Do(func() { close(connected) })
+		}
+	})
+
+	var (
+		iceMu      sync.Mutex
+		remoteSet  bool
+		pending    []webrtc.ICECandidateInit
+		candidates []string
+	)
+	room.SetCallbacks(nil, nil, func(roomID, id string, c *webrtc.ICECandidate) {
+		if c == nil || id != peerID {
+			return
+		}
+		iceMu.Lock()
+		defer iceMu.Unlock()
+		candidate := c.ToJSON()
+		candidates = append(candidates, candidate.Candidate)
+		if !remoteSet {
+			pending = append(pending, candidate)
+			return
+		}
+		pc.AddICECandidate(candidate)
+	}, nil, nil)
+
+	pc.AddTransceiverFromKind(webrtc.RTPCodecTypeVideo, webrtc.RTPTransceiverInit{
+		Direction: webrtc.RTPTransceiverDirectionRecvonly,
+	})
+	offer, err := pc.CreateOffer(nil)
+	if err != nil {
+		tb.Fatal(err)
+	}
+	gathered := webrtc.GatheringCompletePromise(pc)
+	pc.SetLocalDescription(offer)
+	<-gathered
+
+	start := time.Now()
+	answer, err := room.AddSubscriber(peerID, pc.LocalDescription().SDP)
+	if err != nil {
+		tb.Fatalf("AddSubscriber failed: %v", err)
+	}
+	if err := pc.SetRemoteDescription(webrtc.SessionDescription{Type: webrtc.SDPTypeAnswer, SDP: answer}); err != nil {
+		tb.Fatalf("SetRemoteDescription failed: %v", err)
+	}
+	iceMu.Lock()
+	remoteSet = true
+	for _, c := range pending {
+		pc.AddICECandidate(c)
+	}
+	iceMu.Unlock()
+
+	select {
+	case <-connected:
+	case <-time.After(10 * time.Second):
+		tb.Fatal("Subscriber did not connect")
+	}
+	elapsed := time.Since(start)
+
+	room.RemoveSubscriber(peerID)
+	iceMu.Lock()
+	defer iceMu.Unlock()
+	return elapsed, candidates
+}
+
+func TestRelayRoomLANMode(t *testing.T) {
+	if testing.Short() {
+		t.Skip("跳过虚拟网络测试")
+	}
+
+	lan := DefaultLANModeConfig()
+	network := newLANTestNetwork(t, &lan)
+	room := newLANTestRoom(t, network, &lan)
+
+	if !room.GetStatus().LANMode {
+		t.Error("Status should report LAN mode")
+	}
+
+	_, candidates := connectLANSubscriber(t, network, room, "sub-1")
+	if len(candidates) == 0 {
+		t.Fatal("Relay should send host candidates")
+	}
+	for _, c := range candidates {
+		if !strings.Contains(c, "typ host") {
+			t.Errorf("LAN mode should only gather host candidates, got %s", c)
+		}
+	}
+}
+
+func TestRelayRoomLANModeAnswerIsLite(t *testing.T) {
+	lan := DefaultLANModeConfig()
+	room, err := NewRelayRoom("lan-room", []webrtc.ICEServer{{URLs: []string{"stun:stun.l.google.com:19302"}}}, WithLANMode(lan))
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer room.Close()
+	room.BecomeRelay("relay")
+
+	pc, err := webrtc.NewPeerConnection(webrtc.Configuration{})
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer pc.Close()
+	pc.AddTransceiverFromKind(webrtc.RTPCodecTypeVideo, webrtc.RTPTransceiverInit{
+		Direction: webrtc.RTPTransceiverDirectionRecvonly,
+	})
+	offer, _ := pc.CreateOffer(nil)
+	pc.SetLocalDescription(offer)
+
+	answer, err := room.AddSubscriber("sub-1", offer.SDP)
+	if err != nil {
+		t.Fatalf("AddSubscriber failed: %v", err)
+	}
+	if !strings.Contains(answer, "a=ice-lite") {
+		t.Error("LAN mode answer should advertise ice-lite")
+	}
+}
+
+// BenchmarkRelayRoomTimeToConnected 虚拟局域网中订阅者从提交 Offer 到 ICE 连通的耗时：完整 ICE vs 局域网模式
+func BenchmarkRelayRoomTimeToConnected(b *testing.B) {
+	lan := DefaultLANModeConfig()
+	cases := []struct {
+		name string
+		lan  *LANModeConfig
+	}{
+		{"full", nil},
+		{"lan", &lan},
+	}
+	for _, c := range cases {
+		b.Run(c.name, func(b *testing.B) {
+			network := newLANTestNetwork(b, c.lan)
+			room := newLANTestRoom(b, network, c.lan)
+
+			var total time.Duration
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				elapsed, _ := connectLANSubscriber(b, network, room, "sub")
+				total += elapsed
+			}
+			b.ReportMetric(float64(total)/float64(time.Millisecond)/float64(b.N), "connect_ms/op")
+		})
+	}
+}
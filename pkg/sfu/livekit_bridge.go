@@ -11,6 +11,7 @@
 package sfu
 
 import (
+	"context"
 	"fmt"
 	"sync"
 	"sync/atomic"
@@ -18,6 +19,10 @@ import (
 
 	"github.com/livekit/protocol/livekit"
 	lksdk "github.com/livekit/server-sdk-go/v2"
+	"github.com/maiguangyang/relay_core/pkg/utils"
+	"github.com/pion/interceptor"
+	"github.com/pion/rtcp"
+	"github.com/pion/rtp"
 	"github.com/pion/webrtc/v4"
 )
 
@@ -32,6 +37,23 @@ const (
 	LiveKitBridgeStateFailed
 )
 
+const (
+	// bridgeReadQueueSize 每个轨道读取协程与转发协程之间的队列长度
+	bridgeReadQueueSize = 64
+	// bridgeForwardBatch 转发协程一次最多处理的包数
+	bridgeForwardBatch = 16
+)
+
+// rtpReader 轨道原始 RTP 读取接口（*webrtc.TrackRemote）
+type rtpReader interface {
+	Read(b []byte) (int, interceptor.Attributes, error)
+}
+
+// rtcpReader 轨道 RTCP 读取接口（*webrtc.TrackRemote）
+type rtcpReader interface {
+	ReadRTCP() ([]rtcp.Packet, interceptor.Attributes, error)
+}
+
 func (s LiveKitBridgeState) String() string {
 	switch s {
 	case LiveKitBridgeStateIdle:
@@ -65,6 +87,12 @@ type LiveKitBridge struct {
 	// 上次请求关键帧的时间，用于节流
 	lastKeyframeRequest time.Time
 
+	// 按局域网订阅者的视口和带宽选择上游质量
+	quality *UpstreamQualityController
+
+	// 备用路径：只拉 LOW 层，保持最低码率（订阅者双路接收）
+	standby atomic.Bool
+
 	// 统计
 	videoPacketsReceived uint64
 	audioPacketsReceived uint64
@@ -74,16 +102,26 @@ type LiveKitBridge struct {
 	onStateChanged func(roomID string, state LiveKitBridgeState)
 	onError        func(roomID string, err error)
 
+	// 读取协程通过 ctx 感知关闭，不在每个包上加锁
+	ctx    context.Context
+	cancel context.CancelFunc
+
 	closed bool
 }
 
 // NewLiveKitBridge 创建新的桥接器
 func NewLiveKitBridge(roomID string, switcher *SourceSwitcher) *LiveKitBridge {
-	return &LiveKitBridge{
+	ctx, cancel := context.WithCancel(context.Background())
+	b := &LiveKitBridge{
 		roomID:   roomID,
 		switcher: switcher,
 		state:    LiveKitBridgeStateIdle,
+		quality:  NewUpstreamQualityController(DefaultUpstreamQualityConfig()),
+		ctx:      ctx,
+		cancel:   cancel,
 	}
+	b.quality.SetOnSwitch(b.applyVideoQuality)
+	return b
 }
 
 // SetCallbacks 设置回调
@@ -170,24 +208,22 @@ func (b *LiveKitBridge) onTrackSubscribed(
 
 	isVideo := track.Kind() == webrtc.RTPCodecTypeVideo
 
-	// 对视频轨道请求最高质量（解决屏幕共享模糊问题）
+	// 对视频轨道请求订阅者需要的质量（没有订阅者上报时为 HIGH，解决屏幕共享模糊问题）
 	// 注意: Go SDK 的 RemoteTrackPublication 不支持 SetVideoFPS，只能设置 Quality
 	if isVideo {
-		// 立即请求 HIGH 质量
-		pub.SetVideoQuality(livekit.VideoQuality_HIGH)
-		fmt.Printf("[Bridge] Video quality requested: HIGH for track %s (source: %s)\n", track.ID(), pub.Source())
+		quality := b.videoQuality()
+		pub.SetVideoQuality(livekit.VideoQuality(quality))
+		utils.Info("[Bridge] Video quality requested: %s for track %s (source: %s)", quality, track.ID(), pub.Source())
 
-		// 延迟再次请求，确保 SFU 切换到最高质量
+		// 延迟再次请求，确保 SFU 切换到请求的质量
 		go func() {
 			// 500ms 后再次请求
 			time.Sleep(500 * time.Millisecond)
-			pub.SetVideoQuality(livekit.VideoQuality_HIGH)
-			fmt.Printf("[Bridge] Video quality re-requested (500ms): HIGH for track %s\n", track.ID())
+			pub.SetVideoQuality(livekit.VideoQuality(b.videoQuality()))
 
 			// 2秒后再次请求，确保稳定
 			time.Sleep(1500 * time.Millisecond)
-			pub.SetVideoQuality(livekit.VideoQuality_HIGH)
-			fmt.Printf("[Bridge] Video quality re-requested (2s): HIGH for track %s\n", track.ID())
+			pub.SetVideoQuality(livekit.VideoQuality(b.videoQuality()))
 		}()
 	}
 
@@ -215,11 +251,31 @@ func (b *LiveKitBridge) onTrackSubscribed(
 			if err := b.switcher.SetAudioCodec(codec.RTPCodecCapability); err != nil {
 				// 设置编码器失败，记录但继续转发
 			}
+
+			// 活跃发言者检测：关联参与者，并使用 SFU 协商的音量扩展头 ID
+			observer := b.switcher.GetAudioLevelObserver()
+			observer.RegisterSource(uint32(track.SSRC()), rp.Identity())
+			if receiver := pub.Receiver(); receiver != nil {
+				var levelID uint8 // 没有协商时为 0，不解析音量
+				for _, ext := range receiver.GetParameters().HeaderExtensions {
+					if ext.URI == AudioLevelExtensionURI {
+						levelID = uint8(ext.ID)
+					}
+				}
+				observer.SetExtensionID(levelID)
+			}
 		}
 	}
 
-	// 启动 RTP 读取循环
-	go b.readRTPLoop(track, isVideo, rp.Identity())
+	// SFU 协商的扩展头 ID，转发时改写为房间内部 ID
+	if receiver := pub.Receiver(); receiver != nil && b.switcher != nil {
+		b.switcher.SetHeaderExtensions(SourceTypeSFU, isVideo, receiver.GetParameters().HeaderExtensions)
+	}
+
+	// 每个轨道独立的读取协程 + 转发协程
+	go b.readRTPLoop(b.ctx, track, track.ID(), track.Codec().MimeType, isVideo)
+	// 上游 SR 用于生成改写后的下行 SR（音视频同步）
+	go b.readRTCPLoop(b.ctx, track)
 }
 
 // onTrackUnsubscribed 轨道取消订阅回调
@@ -229,55 +285,120 @@ func (b *LiveKitBridge) onTrackUnsubscribed(
 	rp *lksdk.RemoteParticipant,
 ) {
 	atomic.AddInt32(&b.tracksSubscribed, -1)
-}
 
-// readRTPLoop 循环读取 RTP 包并转发到 SourceSwitcher
-func (b *LiveKitBridge) readRTPLoop(track *webrtc.TrackRemote, isVideo bool, participantID string) {
-	packetCount := uint64(0)
+	if b.switcher == nil {
+		return
+	}
+	b.switcher.GetSenderReportClock().ForgetSenderReports(uint32(track.SSRC()))
+	if track.Kind() == webrtc.RTPCodecTypeAudio {
+		b.switcher.GetAudioLevelObserver().UnregisterSource(uint32(track.SSRC()))
+	}
+}
 
+// readRTPLoop 读取协程：track.Read 直接读进缓冲池的 buffer，交给本轨道的转发协程
+// 关闭通过 ctx 通知；阻塞中的 Read 在房间断开、轨道结束时返回错误
+func (b *LiveKitBridge) readRTPLoop(ctx context.Context, reader rtpReader, trackID, mimeType string, isVideo bool) {
+	queue := make(chan []byte, bridgeReadQueueSize)
+	done := make(chan struct{})
+	go func() {
+		defer close(done)
+		b.forwardRTPLoop(queue, mimeType, isVideo)
+	}()
+	defer func() {
+		close(queue)
+		<-done
+	}()
+
+	first := true
 	for {
-		// 检查是否已关闭
-		b.mu.RLock()
-		if b.closed {
-			b.mu.RUnlock()
+		buf := globalBufferPool.GetBuffer()
+		n, _, err := reader.Read(buf)
+		if err != nil {
+			globalBufferPool.PutBuffer(buf)
+			if ctx.Err() == nil {
+				// 轨道结束或连接断开
+				utils.Warn("[Bridge] Read error for track %s: %v", trackID, err)
+			}
 			return
 		}
-		b.mu.RUnlock()
+		if ctx.Err() != nil {
+			globalBufferPool.PutBuffer(buf)
+			return
+		}
+		if first {
+			first = false
+			utils.Info("[Bridge] First RTP packet received for track %s", trackID)
+		}
 
-		// 读取 RTP 包
-		pkt, _, err := track.ReadRTP()
-		if err != nil {
-			// 轨道结束或连接断开
-			fmt.Printf("[Bridge] ReadRTP error for track %s: %v\n", track.ID(), err)
+		select {
+		case queue <- buf[:n]:
+		case <-ctx.Done():
+			globalBufferPool.PutBuffer(buf)
 			return
 		}
+	}
+}
 
-		packetCount++
-		if packetCount == 1 {
-			fmt.Printf("[Bridge] First RTP packet received for track %s\n", track.ID())
+// readRTCPLoop 读取上游 RTCP，把 SR 交给 SourceSwitcher（轨道结束或断开时 ReadRTCP 返回错误）
+func (b *LiveKitBridge) readRTCPLoop(ctx context.Context, reader rtcpReader) {
+	for {
+		packets, _, err := reader.ReadRTCP()
+		if err != nil || ctx.Err() != nil {
+			return
 		}
+		if b.switcher == nil {
+			continue
+		}
+		for _, packet := range packets {
+			if sr, ok := packet.(*rtcp.SenderReport); ok {
+				b.switcher.ObserveSenderReport(sr.SSRC, sr.NTPTime, sr.RTPTime)
+			}
+		}
+	}
+}
 
-		// 每 100 个包打印一次
-		if packetCount%100 == 1 {
+// forwardRTPLoop 转发协程：每次取出队列中已就绪的一批包注入 SourceSwitcher，
+// 流量和包数统计按批累加；注入后 buffer 立即归还（Inject* 内部会拷贝）
+func (b *LiveKitBridge) forwardRTPLoop(queue <-chan []byte, mimeType string, isVideo bool) {
+	batch := make([][]byte, 0, bridgeForwardBatch)
+	var packet rtp.Packet
+
+	for head := range queue {
+		batch = append(batch[:0], head)
+	drain:
+		for len(batch) < bridgeForwardBatch {
+			select {
+			case next, ok := <-queue:
+				if !ok {
+					break drain
+				}
+				batch = append(batch, next)
+			default:
+				break drain
+			}
 		}
 
-		// 序列化 RTP 包
-		data, err := pkt.Marshal()
-		if err != nil {
-			continue
+		bytes := 0
+		for _, data := range batch {
+			// 上游切层后，新层的关键帧到达才算切换完成（只在等待期间解析包头）
+			if isVideo && b.quality.AwaitingKeyframe() &&
+				packet.Unmarshal(data) == nil && IsKeyframe(mimeType, packet.Payload) {
+				b.quality.OnKeyframe()
+			}
+			if b.switcher != nil {
+				b.switcher.InjectSFUPacket(isVideo, data)
+			}
+			bytes += len(data)
+			globalBufferPool.PutBuffer(data)
 		}
 
-		// 注入到 SourceSwitcher
 		if b.switcher != nil {
-			b.switcher.InjectSFUPacket(isVideo, data)
-		} else if packetCount == 1 {
+			b.switcher.GetBandwidthAccountant().AddWANIngress(bytes, isVideo)
 		}
-
-		// 更新统计
 		if isVideo {
-			atomic.AddUint64(&b.videoPacketsReceived, 1)
+			atomic.AddUint64(&b.videoPacketsReceived, uint64(len(batch)))
 		} else {
-			atomic.AddUint64(&b.audioPacketsReceived, 1)
+			atomic.AddUint64(&b.audioPacketsReceived, uint64(len(batch)))
 		}
 	}
 }
@@ -299,12 +420,14 @@ func (b *LiveKitBridge) Disconnect() {
 		b.mu.Unlock()
 		return
 	}
-	b.closed = true // 先标记关闭，让 readRTPLoop 尽快退出
+	b.closed = true
+	b.cancel() // 先通知关闭，让 readRTPLoop 尽快退出
 	room := b.room
 	b.room = nil
 	b.state = LiveKitBridgeStateDisconnected
 	b.mu.Unlock()
 
+	b.quality.Close()
 	if room != nil {
 		// 异步断开，避免阻塞调用线程
 		go room.Disconnect()
@@ -321,10 +444,12 @@ func (b *LiveKitBridge) Close() {
 		return
 	}
 	b.closed = true
+	b.cancel()
 	room := b.room
 	b.room = nil
 	b.mu.Unlock()
 
+	b.quality.Close()
 	if room != nil {
 		room.Disconnect()
 	}
@@ -373,7 +498,7 @@ func (b *LiveKitBridge) doRequestKeyframe(room *lksdk.Room) {
 
 					// 恢复订阅 - SFU 会发送新的关键帧
 					remotePub.SetEnabled(true)
-					remotePub.SetVideoQuality(livekit.VideoQuality_HIGH)
+					remotePub.SetVideoQuality(livekit.VideoQuality(b.videoQuality()))
 					fmt.Printf("[Bridge] Keyframe requested (toggle) for track %s\n", remotePub.SID())
 					return // 只处理第一个视频轨道
 				}
@@ -382,6 +507,77 @@ func (b *LiveKitBridge) doRequestKeyframe(room *lksdk.Room) {
 	}
 }
 
+// UpdateSubscriberViewport 更新局域网订阅者的视口尺寸和带宽估计
+// width/height 为 0 表示未知，bandwidthBps 为 0 表示未知
+func (b *LiveKitBridge) UpdateSubscriberViewport(peerID string, width, height int, bandwidthBps uint64) {
+	b.quality.UpdateSubscriber(peerID, width, height, bandwidthBps)
+}
+
+// SetSubscriberMaxQuality 设置局域网订阅者的质量上限（缩略图模式），与视口上报一样超过 ReportTTL 后失效
+func (b *LiveKitBridge) SetSubscriberMaxQuality(peerID string, quality UpstreamQuality) {
+	b.quality.SetSubscriberMaxQuality(peerID, quality)
+}
+
+// ClearSubscriberMaxQuality 清除局域网订阅者的质量上限
+func (b *LiveKitBridge) ClearSubscriberMaxQuality(peerID string) {
+	b.quality.ClearSubscriberMaxQuality(peerID)
+}
+
+// SetSubscriberPaused 局域网订阅者暂停 / 恢复视频，暂停期间不参与上游质量需求（保留最后一次视口上报）
+func (b *LiveKitBridge) SetSubscriberPaused(peerID string, paused bool) {
+	b.quality.SetSubscriberPaused(peerID, paused)
+}
+
+// SetMaxUpstreamQuality 设置向上游请求的质量上限（设备过热 / 低电量时降低）
+func (b *LiveKitBridge) SetMaxUpstreamQuality(quality UpstreamQuality) {
+	b.quality.SetMaxQuality(quality)
+}
+
+// SetStandby 设置备用模式：备用时只向上游请求 LOW 层，恢复后按订阅者需求选择质量
+// 轨道保持订阅（而不是 SetEnabled(false)），切换到该路径时无需等待 SFU 恢复转发
+func (b *LiveKitBridge) SetStandby(standby bool) {
+	if b.standby.Swap(standby) == standby {
+		return
+	}
+	b.applyVideoQuality(b.quality.Current())
+}
+
+// videoQuality 当前应向上游请求的视频质量
+func (b *LiveKitBridge) videoQuality() UpstreamQuality {
+	if b.standby.Load() {
+		return UpstreamQualityLow
+	}
+	return b.quality.Current()
+}
+
+// RemoveSubscriberViewport 订阅者离开
+func (b *LiveKitBridge) RemoveSubscriberViewport(peerID string) {
+	b.quality.RemoveSubscriber(peerID)
+}
+
+// applyVideoQuality 向上游请求新的视频质量（所有远端视频轨道）
+func (b *LiveKitBridge) applyVideoQuality(quality UpstreamQuality) {
+	b.mu.RLock()
+	room := b.room
+	b.mu.RUnlock()
+
+	if room == nil {
+		return
+	}
+	if b.standby.Load() {
+		quality = UpstreamQualityLow
+	}
+
+	for _, p := range room.GetRemoteParticipants() {
+		for _, pub := range p.TrackPublications() {
+			if remotePub, ok := pub.(*lksdk.RemoteTrackPublication); ok && remotePub.Kind() == lksdk.TrackKindVideo {
+				remotePub.SetVideoQuality(livekit.VideoQuality(quality))
+			}
+		}
+	}
+	utils.Info("[Bridge] Upstream video quality switched to %s", quality)
+}
+
 // GetState 获取当前状态
 func (b *LiveKitBridge) GetState() LiveKitBridgeState {
 	b.mu.RLock()
@@ -398,11 +594,13 @@ func (b *LiveKitBridge) IsConnected() bool {
 
 // LiveKitBridgeStatus 桥接器状态信息
 type LiveKitBridgeStatus struct {
-	RoomID               string `json:"room_id"`
-	State                string `json:"state"`
-	TracksSubscribed     int32  `json:"tracks_subscribed"`
-	VideoPacketsReceived uint64 `json:"video_packets_received"`
-	AudioPacketsReceived uint64 `json:"audio_packets_received"`
+	RoomID               string                `json:"room_id"`
+	State                string                `json:"state"`
+	TracksSubscribed     int32                 `json:"tracks_subscribed"`
+	VideoPacketsReceived uint64                `json:"video_packets_received"`
+	AudioPacketsReceived uint64                `json:"audio_packets_received"`
+	UpstreamQuality      UpstreamQualityStatus `json:"upstream_quality"`
+	Standby              bool                  `json:"standby"`
 }
 
 // GetStatus 获取状态信息
@@ -416,6 +614,8 @@ func (b *LiveKitBridge) GetStatus() LiveKitBridgeStatus {
 		TracksSubscribed:     atomic.LoadInt32(&b.tracksSubscribed),
 		VideoPacketsReceived: atomic.LoadUint64(&b.videoPacketsReceived),
 		AudioPacketsReceived: atomic.LoadUint64(&b.audioPacketsReceived),
+		UpstreamQuality:      b.quality.GetStatus(),
+		Standby:              b.standby.Load(),
 	}
 }
 
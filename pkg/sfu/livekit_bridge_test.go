@@ -0,0 +1,135 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * LiveKitBridge Tests
+ */
+package sfu
+
+import (
+	"io"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/pion/interceptor"
+	"github.com/pion/rtcp"
+)
+
+// fakeRTPReader 依次返回预置的包，读完后返回 io.EOF；loop 为 true 时循环返回
+type fakeRTPReader struct {
+	packets [][]byte
+	next    int
+	loop    bool
+	reads   atomic.Int64
+}
+
+func (r *fakeRTPReader) Read(b []byte) (int, interceptor.Attributes, error) {
+	if r.next >= len(r.packets) {
+		if !r.loop {
+			return 0, nil, io.EOF
+		}
+		r.next = 0
+		time.Sleep(time.Millisecond)
+	}
+	n := copy(b, r.packets[r.next])
+	r.next++
+	r.reads.Add(1)
+	return n, nil, nil
+}
+
+func TestLiveKitBridgeReadRTPLoopForwards(t *testing.T) {
+	switcher, err := NewSourceSwitcher("bridge-room")
+	if err != nil {
+		t.Fatalf("Failed to create SourceSwitcher: %v", err)
+	}
+	defer switcher.Close()
+
+	bridge := NewLiveKitBridge("bridge-room", switcher)
+	defer bridge.Close()
+
+	reader := &fakeRTPReader{}
+	bytes := 0
+	for i := 0; i < 100; i++ {
+		packet := vp8FramePacket(uint16(i), uint32(i*3000), i == 0)
+		reader.packets = append(reader.packets, packet)
+		bytes += len(packet)
+	}
+
+	// 读到 EOF 后返回，返回前转发协程已处理完队列中的包
+	bridge.readRTPLoop(bridge.ctx, reader, "video-track", "video/VP8", true)
+
+	status := bridge.GetStatus()
+	if status.VideoPacketsReceived != 100 || status.AudioPacketsReceived != 0 {
+		t.Errorf("Expected 100 video packets, got %+v", status)
+	}
+	if got := switcher.GetBandwidthAccountant().GetStats().WANIngressBytes; got != uint64(bytes) {
+		t.Errorf("Expected %d WAN ingress bytes, got %d", bytes, got)
+	}
+}
+
+func TestLiveKitBridgeReadRTPLoopStopsOnClose(t *testing.T) {
+	bridge := NewLiveKitBridge("bridge-room", nil)
+	reader := &fakeRTPReader{
+		packets: [][]byte{vp8FramePacket(1, 3000, false)},
+		loop:    true,
+	}
+
+	done := make(chan struct{})
+	go func() {
+		defer close(done)
+		bridge.readRTPLoop(bridge.ctx, reader, "video-track", "video/VP8", true)
+	}()
+
+	time.Sleep(20 * time.Millisecond)
+	bridge.Close()
+
+	select {
+	case <-done:
+	case <-time.After(time.Second):
+		t.Fatal("readRTPLoop should exit after Close")
+	}
+	if reader.reads.Load() == 0 {
+		t.Error("Reader should have been read before Close")
+	}
+}
+
+// fakeRTCPReader 依次返回预置的 RTCP 复合包，读完后返回 io.EOF
+type fakeRTCPReader struct {
+	batches [][]rtcp.Packet
+}
+
+func (r *fakeRTCPReader) ReadRTCP() ([]rtcp.Packet, interceptor.Attributes, error) {
+	if len(r.batches) == 0 {
+		return nil, nil, io.EOF
+	}
+	batch := r.batches[0]
+	r.batches = r.batches[1:]
+	return batch, nil, nil
+}
+
+func TestLiveKitBridgeReadRTCPLoopObservesSenderReports(t *testing.T) {
+	switcher, err := NewSourceSwitcher("bridge-room")
+	if err != nil {
+		t.Fatalf("Failed to create SourceSwitcher: %v", err)
+	}
+	defer switcher.Close()
+
+	bridge := NewLiveKitBridge("bridge-room", switcher)
+	defer bridge.Close()
+
+	ntp := toNTPTime(time.Now())
+	reader := &fakeRTCPReader{batches: [][]rtcp.Packet{
+		{&rtcp.SenderReport{SSRC: 0x1234, NTPTime: ntp, RTPTime: 9000}, &rtcp.SourceDescription{}},
+		{&rtcp.ReceiverReport{SSRC: 0x1234}},
+	}}
+	bridge.readRTCPLoop(bridge.ctx, reader)
+
+	if got := switcher.GetSenderReportClock().GetStats().UpstreamReports; got != 1 {
+		t.Errorf("Expected 1 upstream SR, got %d", got)
+	}
+	if _, ok := switcher.GetSenderReportClock().captureTime(0x1234, 9000, 90000); !ok {
+		t.Error("Upstream SR should be recorded for its SSRC")
+	}
+}
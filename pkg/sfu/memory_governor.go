@@ -0,0 +1,271 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Memory Governor - 全局内存预算
+ * 移动端 Relay 服务多个订阅者时，缓冲池、抖动缓冲和每个订阅者的发送状态没有总上限，
+ * 容易被系统 OOM 杀掉。MemoryGovernor 按类别统计这些内存，超出预算比例时逐级降级：
+ *
+ *   Shrink      缓冲池归还的 buffer 直接交给 GC，抖动缓冲容量减半
+ *   DropFrames  视频转发丢弃非参考帧（VP8 N 位 / H264 NRI=0），输出序列号保持连续
+ *   Refuse      拒绝新订阅者（已连接的不受影响）
+ *
+ * 降级阈值带迟滞，避免在阈值附近来回切换。Budget 为 0 时只统计不降级。
+ * 订阅者发送状态（pion 的 SRTP / SCTP / ICE 状态）无法精确测量，按固定估计值计入。
+ */
+package sfu
+
+import (
+	"sync"
+	"sync/atomic"
+)
+
+// MemoryClass 内存类别
+type MemoryClass int
+
+const (
+	MemoryClassBufferPool   MemoryClass = iota // 缓冲池借出的 buffer
+	MemoryClassJitterBuffer                    // 抖动缓冲中的包
+	MemoryClassSubscriber                      // 订阅者发送状态（估计值）
+	memoryClassCount
+)
+
+// MemoryPressure 内存压力等级
+type MemoryPressure int32
+
+const (
+	MemoryPressureNormal     MemoryPressure = iota // 正常
+	MemoryPressureShrink                           // 缩小缓冲
+	MemoryPressureDropFrames                       // 丢弃非参考帧
+	MemoryPressureRefuse                           // 拒绝新订阅者
+)
+
+func (p MemoryPressure) String() string {
+	switch p {
+	case MemoryPressureShrink:
+		return "shrink"
+	case MemoryPressureDropFrames:
+		return "drop_frames"
+	case MemoryPressureRefuse:
+		return "refuse"
+	default:
+		return "normal"
+	}
+}
+
+// MemoryGovernorConfig 内存预算配置
+type MemoryGovernorConfig struct {
+	// 总预算（字节），0 表示不限制
+	Budget int64
+	// 各降级等级的触发比例（占预算）
+	ShrinkRatio     float64
+	DropFramesRatio float64
+	RefuseRatio     float64
+	// 迟滞：使用率低于触发比例减去该值后才退出该等级
+	Hysteresis float64
+	// 每个订阅者发送状态的估计字节数
+	SubscriberBytes int64
+}
+
+// DefaultMemoryGovernorConfig 返回默认配置（不限制，只统计）
+func DefaultMemoryGovernorConfig() MemoryGovernorConfig {
+	return MemoryGovernorConfig{
+		Budget:          0,
+		ShrinkRatio:     0.7,
+		DropFramesRatio: 0.85,
+		RefuseRatio:     0.95,
+		Hysteresis:      0.05,
+		SubscriberBytes: 256 * 1024,
+	}
+}
+
+// MemoryGovernorStats 内存预算统计
+type MemoryGovernorStats struct {
+	Budget             int64  `json:"budget_bytes"`
+	Used               int64  `json:"used_bytes"`
+	Peak               int64  `json:"peak_bytes"`
+	BufferPool         int64  `json:"buffer_pool_bytes"`
+	JitterBuffer       int64  `json:"jitter_buffer_bytes"`
+	Subscribers        int64  `json:"subscriber_bytes"`
+	Pressure           string `json:"pressure"`
+	LevelChanges       uint64 `json:"level_changes"`
+	RefusedSubscribers uint64 `json:"refused_subscribers"`
+	DroppedPackets     uint64 `json:"dropped_packets"`
+}
+
+// MemoryGovernor 全局内存预算
+type MemoryGovernor struct {
+	mu sync.Mutex
+
+	// 热路径每次 Reserve / Release 都要读配置，用原子指针避免加锁
+	config atomic.Pointer[MemoryGovernorConfig]
+
+	used     [memoryClassCount]atomic.Int64
+	peak     atomic.Int64
+	pressure atomic.Int32
+
+	levelChanges   atomic.Uint64
+	refused        atomic.Uint64
+	droppedPackets atomic.Uint64
+
+	onPressureChange func(pressure MemoryPressure)
+}
+
+// 全局内存预算实例
+var globalMemoryGovernor = NewMemoryGovernor(DefaultMemoryGovernorConfig())
+
+// GetMemoryGovernor 获取全局内存预算实例
+func GetMemoryGovernor() *MemoryGovernor {
+	return globalMemoryGovernor
+}
+
+// NewMemoryGovernor 创建内存预算
+func NewMemoryGovernor(config MemoryGovernorConfig) *MemoryGovernor {
+	g := &MemoryGovernor{}
+	g.config.Store(&config)
+	return g
+}
+
+// SetConfig 更新配置并立即重新评估压力等级
+func (g *MemoryGovernor) SetConfig(config MemoryGovernorConfig) {
+	g.mu.Lock()
+	g.config.Store(&config)
+	g.mu.Unlock()
+	g.evaluate()
+}
+
+// SetBudget 只更新总预算
+func (g *MemoryGovernor) SetBudget(budget int64) {
+	g.mu.Lock()
+	config := *g.config.Load()
+	config.Budget = budget
+	g.config.Store(&config)
+	g.mu.Unlock()
+	g.evaluate()
+}
+
+// SetOnPressureChange 设置压力等级变化回调
+func (g *MemoryGovernor) SetOnPressureChange(fn func(pressure MemoryPressure)) {
+	g.mu.Lock()
+	defer g.mu.Unlock()
+	g.onPressureChange = fn
+}
+
+// Reserve 记录占用
+func (g *MemoryGovernor) Reserve(class MemoryClass, n int64) {
+	if g == nil || n <= 0 {
+		return
+	}
+	g.used[class].Add(n)
+	total := g.Used()
+	for {
+		peak := g.peak.Load()
+		if total <= peak || g.peak.CompareAndSwap(peak, total) {
+			break
+		}
+	}
+	g.evaluate()
+}
+
+// Release 释放占用
+func (g *MemoryGovernor) Release(class MemoryClass, n int64) {
+	if g == nil || n <= 0 {
+		return
+	}
+	g.used[class].Add(-n)
+	g.evaluate()
+}
+
+// Used 当前总占用
+func (g *MemoryGovernor) Used() int64 {
+	var total int64
+	for i := range g.used {
+		total += g.used[i].Load()
+	}
+	return total
+}
+
+// Pressure 当前压力等级（热路径调用，无锁）
+func (g *MemoryGovernor) Pressure() MemoryPressure {
+	if g == nil {
+		return MemoryPressureNormal
+	}
+	return MemoryPressure(g.pressure.Load())
+}
+
+// AdmitSubscriber 是否允许新订阅者加入，拒绝时计数
+func (g *MemoryGovernor) AdmitSubscriber() bool {
+	if g.Pressure() >= MemoryPressureRefuse {
+		g.refused.Add(1)
+		return false
+	}
+	return true
+}
+
+// SubscriberBytes 每个订阅者计入的估计字节数
+func (g *MemoryGovernor) SubscriberBytes() int64 {
+	if g == nil {
+		return 0
+	}
+	return g.config.Load().SubscriberBytes
+}
+
+// NoteDroppedPacket 记录因内存压力丢弃的包
+func (g *MemoryGovernor) NoteDroppedPacket() {
+	if g != nil {
+		g.droppedPackets.Add(1)
+	}
+}
+
+// GetStats 获取统计
+func (g *MemoryGovernor) GetStats() MemoryGovernorStats {
+	return MemoryGovernorStats{
+		Budget:             g.config.Load().Budget,
+		Used:               g.Used(),
+		Peak:               g.peak.Load(),
+		BufferPool:         g.used[MemoryClassBufferPool].Load(),
+		JitterBuffer:       g.used[MemoryClassJitterBuffer].Load(),
+		Subscribers:        g.used[MemoryClassSubscriber].Load(),
+		Pressure:           g.Pressure().String(),
+		LevelChanges:       g.levelChanges.Load(),
+		RefusedSubscribers: g.refused.Load(),
+		DroppedPackets:     g.droppedPackets.Load(),
+	}
+}
+
+// evaluate 按使用率重新计算压力等级
+func (g *MemoryGovernor) evaluate() {
+	current := MemoryPressure(g.pressure.Load())
+	config := g.config.Load()
+	if config.Budget <= 0 && current == MemoryPressureNormal {
+		return
+	}
+
+	next := MemoryPressureNormal
+	if config.Budget > 0 {
+		ratio := float64(g.Used()) / float64(config.Budget)
+		thresholds := [...]float64{config.ShrinkRatio, config.DropFramesRatio, config.RefuseRatio}
+		for i, threshold := range thresholds {
+			level := MemoryPressure(i + 1)
+			// 已处于该等级时，低于 threshold - Hysteresis 才退出
+			if level <= current {
+				threshold -= config.Hysteresis
+			}
+			if ratio >= threshold {
+				next = level
+			}
+		}
+	}
+	if next == current || !g.pressure.CompareAndSwap(int32(current), int32(next)) {
+		return
+	}
+	g.levelChanges.Add(1)
+
+	g.mu.Lock()
+	fn := g.onPressureChange
+	g.mu.Unlock()
+	if fn != nil {
+		fn(next)
+	}
+}
@@ -0,0 +1,172 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Memory Governor Tests
+ */
+package sfu
+
+import (
+	"testing"
+
+	"github.com/pion/rtp"
+)
+
+func newTestMemoryGovernor(budget int64) *MemoryGovernor {
+	config := DefaultMemoryGovernorConfig()
+	config.Budget = budget
+	return NewMemoryGovernor(config)
+}
+
+func TestMemoryGovernorPressureLevels(t *testing.T) {
+	g := newTestMemoryGovernor(1000)
+
+	var changes []MemoryPressure
+	g.SetOnPressureChange(func(p MemoryPressure) {
+		changes = append(changes, p)
+	})
+
+	steps := []struct {
+		reserve int64
+		want    MemoryPressure
+	}{
+		{600, MemoryPressureNormal},
+		{100, MemoryPressureShrink},     // 70%
+		{150, MemoryPressureDropFrames}, // 85%
+		{100, MemoryPressureRefuse},     // 95%
+	}
+	for _, step := range steps {
+		g.Reserve(MemoryClassJitterBuffer, step.reserve)
+		if got := g.Pressure(); got != step.want {
+			t.Fatalf("After reserving to %d: pressure %s, want %s", g.Used(), got, step.want)
+		}
+	}
+	if g.AdmitSubscriber() {
+		t.Error("Refuse level should not admit subscribers")
+	}
+
+	// 迟滞：略低于触发比例不退出
+	g.Release(MemoryClassJitterBuffer, 20) // 93%
+	if got := g.Pressure(); got != MemoryPressureRefuse {
+		t.Errorf("Expected refuse to hold within hysteresis, got %s", got)
+	}
+	g.Release(MemoryClassJitterBuffer, 50) // 88%
+	if got := g.Pressure(); got != MemoryPressureDropFrames {
+		t.Errorf("Expected drop_frames, got %s", got)
+	}
+	g.Release(MemoryClassJitterBuffer, 880)
+	if got := g.Pressure(); got != MemoryPressureNormal {
+		t.Errorf("Expected normal, got %s", got)
+	}
+
+	if len(changes) != 5 {
+		t.Errorf("Expected 5 pressure changes, got %v", changes)
+	}
+	stats := g.GetStats()
+	if stats.Used != 0 || stats.Peak != 950 || stats.RefusedSubscribers != 1 {
+		t.Errorf("Unexpected stats %+v", stats)
+	}
+}
+
+func TestMemoryGovernorUnlimited(t *testing.T) {
+	g := newTestMemoryGovernor(0)
+	g.Reserve(MemoryClassSubscriber, 1<<40)
+	if g.Pressure() != MemoryPressureNormal || !g.AdmitSubscriber() {
+		t.Error("Zero budget should never degrade")
+	}
+
+	// 运行中设置预算立即生效
+	g.SetBudget(1 << 40)
+	if g.Pressure() != MemoryPressureRefuse {
+		t.Errorf("Expected refuse after SetBudget, got %s", g.Pressure())
+	}
+}
+
+func TestBufferPoolMemoryShrink(t *testing.T) {
+	g := newTestMemoryGovernor(10 * DefaultRTPBufferSize)
+	pool := NewBufferPoolWithGovernor(g)
+
+	buf := pool.GetBuffer()
+	if used := g.GetStats().BufferPool; used != DefaultRTPBufferSize {
+		t.Errorf("Expected %d bytes in use, got %d", DefaultRTPBufferSize, used)
+	}
+	pool.PutBuffer(buf)
+	if used := g.GetStats().BufferPool; used != 0 {
+		t.Errorf("Expected 0 bytes in use, got %d", used)
+	}
+
+	// 压力下归还的 buffer 不再入池
+	g.Reserve(MemoryClassSubscriber, 8*DefaultRTPBufferSize)
+	buf = pool.GetBuffer()
+	pool.PutBuffer(buf)
+	if dropped := pool.GetStats().Dropped; dropped != 1 {
+		t.Errorf("Expected 1 dropped buffer, got %d", dropped)
+	}
+}
+
+func TestJitterBufferMemoryAccounting(t *testing.T) {
+	g := newTestMemoryGovernor(0)
+	config := DefaultJitterBufferConfig()
+	config.Enabled = true
+	config.MaxPackets = 10
+	config.Memory = g
+
+	jb := NewJitterBuffer(config)
+	for i := 0; i < 10; i++ {
+		jb.Push(&rtp.Packet{
+			Header:  rtp.Header{Version: 2, SequenceNumber: uint16(i), Timestamp: uint32(i * 3000)},
+			Payload: make([]byte, 100),
+		})
+	}
+	if used := g.GetStats().JitterBuffer; used != 10*112 {
+		t.Errorf("Expected %d bytes buffered, got %d", 10*112, used)
+	}
+
+	// 压力下容量减半
+	g.SetBudget(10 * 112)
+	jb.Push(&rtp.Packet{
+		Header:  rtp.Header{Version: 2, SequenceNumber: 10, Timestamp: 30000},
+		Payload: make([]byte, 100),
+	})
+	if stats := jb.GetStats(); stats.BufferedPackets != 5 || stats.BufferedBytes != 5*112 {
+		t.Errorf("Expected 5 packets after shrink, got %+v", stats)
+	}
+
+	jb.Close()
+	if used := g.GetStats().JitterBuffer; used != 0 {
+		t.Errorf("Expected 0 bytes after close, got %d", used)
+	}
+}
+
+func TestRelayRoomRefuseSubscriberOverBudget(t *testing.T) {
+	g := newTestMemoryGovernor(0)
+	room, err := NewRelayRoom("memory-room", nil, WithMemoryGovernor(g))
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer room.Close()
+	room.BecomeRelay("relay-1")
+
+	if _, err := room.AddSubscriber("sub-1", subscriberOffer(t)); err != nil {
+		t.Fatalf("AddSubscriber failed: %v", err)
+	}
+	subscriberBytes := g.SubscriberBytes()
+	if used := g.GetStats().Subscribers; used != subscriberBytes {
+		t.Errorf("Expected %d subscriber bytes, got %d", subscriberBytes, used)
+	}
+
+	// 预算只够一个订阅者
+	g.SetBudget(subscriberBytes)
+	if _, err := room.AddSubscriber("sub-2", subscriberOffer(t)); err != ErrMemoryBudgetExceeded {
+		t.Errorf("Expected ErrMemoryBudgetExceeded, got %v", err)
+	}
+
+	room.RemoveSubscriber("sub-1")
+	if used := g.GetStats().Subscribers; used != 0 {
+		t.Errorf("Expected 0 subscriber bytes after remove, got %d", used)
+	}
+	if _, err := room.AddSubscriber("sub-2", subscriberOffer(t)); err != nil {
+		t.Errorf("AddSubscriber after release failed: %v", err)
+	}
+}
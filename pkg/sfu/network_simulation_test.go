@@ -9,6 +9,10 @@
 package sfu
 
 import (
+	"encoding/binary"
+	"strings"
+	"sync"
+	"sync/atomic"
 	"testing"
 	"time"
 
@@ -235,3 +239,169 @@ func TestNetwork_Renegotiation(t *testing.T) {
 func TestNetwork_Latency(t *testing.T) {
 	// TODO: Implement valid ChunkFilter for delay
 }
+
+// constrainedLink 模拟 Wi-Fi AP：固定出口速率 + 尾部丢弃的有限队列
+type constrainedLink struct {
+	mu sync.Mutex
+
+	dstIP        string
+	bytesPerSec  float64
+	queueBytes   float64
+	backlog      float64
+	lastDrain    time.Time
+	droppedBytes int
+}
+
+func (l *constrainedLink) filter(c vnet.Chunk) bool {
+	if !strings.HasPrefix(c.DestinationAddr().String(), l.dstIP+":") {
+		return true
+	}
+
+	l.mu.Lock()
+	defer l.mu.Unlock()
+
+	now := time.Now()
+	if !l.lastDrain.IsZero() {
+		l.backlog -= now.Sub(l.lastDrain).Seconds() * l.bytesPerSec
+		if l.backlog < 0 {
+			l.backlog = 0
+		}
+	}
+	l.lastDrain = now
+
+	size := float64(len(c.UserData()))
+	if l.backlog+size > l.queueBytes {
+		l.droppedBytes += len(c.UserData())
+		return false
+	}
+	l.backlog += size
+	return true
+}
+
+// runConstrainedLinkSession 在受限链路上发送关键帧突发，返回发送/接收的视频包数
+func runConstrainedLinkSession(t *testing.T, paced bool) (sent, received int) {
+	t.Helper()
+
+	wan, err := vnet.NewRouter(&vnet.RouterConfig{
+		CIDR:          "1.2.3.0/24",
+		LoggerFactory: logging.NewDefaultLoggerFactory(),
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	// 8 Mbps 出口，30KB 队列
+	link := &constrainedLink{dstIP: "1.2.3.5", bytesPerSec: 1_000_000, queueBytes: 30_000}
+	wan.AddChunkFilter(link.filter)
+
+	net1, _ := vnet.NewNet(&vnet.NetConfig{StaticIP: "1.2.3.4"})
+	wan.AddNet(net1)
+	net2, _ := vnet.NewNet(&vnet.NetConfig{StaticIP: "1.2.3.5"})
+	wan.AddNet(net2)
+	if err := wan.Start(); err != nil {
+		t.Fatal(err)
+	}
+	defer wan.Stop()
+
+	se1 := webrtc.SettingEngine{}
+	se1.SetNet(net1)
+	relay, err := NewRelayRoom("pacer-room", nil, WithWebRTCAPI(webrtc.NewAPI(webrtc.WithSettingEngine(se1))))
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer relay.Close()
+	relay.BecomeRelay("relay-1")
+
+	switcher := relay.GetSourceSwitcher()
+	if !paced {
+		switcher.SetPacerConfig(PacerConfig{Enabled: false})
+	}
+
+	se2 := webrtc.SettingEngine{}
+	se2.SetNet(net2)
+	clientPC, err := webrtc.NewAPI(webrtc.WithSettingEngine(se2)).NewPeerConnection(webrtc.Configuration{})
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer clientPC.Close()
+
+	var receivedPackets atomic.Int64
+	clientPC.OnTrack(func(track *webrtc.TrackRemote, _ *webrtc.RTPReceiver) {
+		for {
+			if _, _, err := track.ReadRTP(); err != nil {
+				return
+			}
+			receivedPackets.Add(1)
+		}
+	})
+
+	connected := make(chan struct{})
+	var once sync.Once
+	clientPC.OnConnectionStateChange(func(s webrtc.PeerConnectionState) {
+		if s == webrtc.PeerConnectionStateConnected {
+			once.Do(func() { close(connected) })
+		}
+	})
+
+	relay.SetCallbacks(nil, nil, func(roomID, peerID string, c *webrtc.ICECandidate) {
+		if c != nil {
+			clientPC.AddICECandidate(c.ToJSON())
+		}
+	}, nil, nil)
+	clientPC.OnICECandidate(func(c *webrtc.ICECandidate) {
+		if c != nil {
+			relay.AddICECandidate("client-1", c.ToJSON())
+		}
+	})
+
+	clientPC.AddTransceiverFromKind(webrtc.RTPCodecTypeVideo, webrtc.RTPTransceiverInit{
+		Direction: webrtc.RTPTransceiverDirectionRecvonly,
+	})
+	offer, _ := clientPC.CreateOffer(nil)
+	clientPC.SetLocalDescription(offer)
+	answer, err := relay.AddSubscriber("client-1", offer.SDP)
+	if err != nil {
+		t.Fatalf("AddSubscriber failed: %v", err)
+	}
+	clientPC.SetRemoteDescription(webrtc.SessionDescription{Type: webrtc.SDPTypeAnswer, SDP: answer})
+
+	select {
+	case <-connected:
+	case <-time.After(10 * time.Second):
+		t.Fatal("Connection timeout")
+	}
+	time.Sleep(200 * time.Millisecond)
+
+	// 每 400ms 一个 100 包的关键帧（约 2.2 Mbps 平均码率）
+	seq := uint16(0)
+	for burst := 0; burst < 10; burst++ {
+		for i := 0; i < 100; i++ {
+			pkt := createTestRTPPacket(seq, 1100)
+			binary.BigEndian.PutUint32(pkt[4:], uint32(burst)*36000)
+			switcher.InjectSFUPacket(true, pkt)
+			seq++
+			sent++
+		}
+		time.Sleep(400 * time.Millisecond)
+	}
+	time.Sleep(time.Second)
+
+	return sent, int(receivedPackets.Load())
+}
+
+func TestNetwork_PacerConstrainedLink(t *testing.T) {
+	if testing.Short() {
+		t.Skip("skipping constrained link simulation in short mode")
+	}
+
+	sent, unpacedRecv := runConstrainedLinkSession(t, false)
+	_, pacedRecv := runConstrainedLinkSession(t, true)
+
+	unpacedLoss := 1 - float64(unpacedRecv)/float64(sent)
+	pacedLoss := 1 - float64(pacedRecv)/float64(sent)
+	t.Logf("Keyframe bursts over 8 Mbps / 30KB link: unpaced loss=%.1f%%, paced loss=%.1f%%",
+		unpacedLoss*100, pacedLoss*100)
+
+	if pacedLoss >= unpacedLoss/2 {
+		t.Errorf("Expected pacing to at least halve burst loss: unpaced=%.3f paced=%.3f", unpacedLoss, pacedLoss)
+	}
+}
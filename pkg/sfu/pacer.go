@@ -0,0 +1,373 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Pacer - 输出平滑发送
+ * 1080p 关键帧有上百个包，一次性写给所有订阅者会冲爆 Wi-Fi AP 的队列造成突发丢包。
+ * Pacer 是房间级的漏桶：
+ * - 视频包排队，按 "倍率 x 估计码率" 的速率发出
+ * - 音频包不排队，直接发送并占用预算（音频优先）
+ * - 单个协程按固定间隔批量出队，队列为空时阻塞等待，不会每包一个 goroutine/timer
+ */
+package sfu
+
+import (
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// PacerConfig Pacer 配置
+type PacerConfig struct {
+	Enabled bool
+
+	// Multiplier 发送速率 = Multiplier x 估计的视频码率
+	Multiplier float64
+	// MinRate / MaxRate 发送速率上下限 (bps)
+	MinRate int64
+	MaxRate int64
+
+	// Interval 出队间隔（批量发送的粒度）
+	Interval time.Duration
+	// MaxQueueDelay 排队超过该时长的包不再等待预算
+	MaxQueueDelay time.Duration
+	// MaxQueuePackets 队列上限，满时丢弃新到的包（绕过队列直接发送会与出队协程乱序）
+	MaxQueuePackets int
+}
+
+// DefaultPacerConfig 默认 Pacer 配置
+func DefaultPacerConfig() PacerConfig {
+	return PacerConfig{
+		Enabled:         true,
+		Multiplier:      2.5,
+		MinRate:         2_000_000,
+		MaxRate:         50_000_000,
+		Interval:        5 * time.Millisecond,
+		MaxQueueDelay:   150 * time.Millisecond,
+		MaxQueuePackets: 1024,
+	}
+}
+
+const (
+	// pacerRateWindow 码率估计窗口
+	pacerRateWindow = 500 * time.Millisecond
+	// pacerBurstWindow 预算上限（允许的突发长度）
+	pacerBurstWindow = 10 * time.Millisecond
+)
+
+// pacedWriter 被平滑的输出（*webrtc.TrackLocalStaticRTP 实现了该接口）
+type pacedWriter interface {
+	Write(b []byte) (int, error)
+}
+
+// pacedPacket 排队中的包（buf 来自全局 RTP 缓冲池）
+type pacedPacket struct {
+	w        pacedWriter
+	buf      []byte
+	n        int
+	enqueued time.Time
+	onSent   func() // 写出成功后调用（可为 nil）
+}
+
+// PacerStats Pacer 统计
+type PacerStats struct {
+	Enabled        bool    `json:"enabled"`
+	RateBps        int64   `json:"rate_bps"`
+	EstimateBps    int64   `json:"estimate_bps"`
+	QueuedPackets  int     `json:"queued_packets"`
+	PacedPackets   uint64  `json:"paced_packets"`
+	DirectPackets  uint64  `json:"direct_packets"`
+	Overflows      uint64  `json:"overflows"` // 队列满时丢弃的包数
+	WriteErrors    uint64  `json:"write_errors"`
+	MaxQueueDelay  float64 `json:"max_queue_delay_ms"`
+	PeakQueueDepth int     `json:"peak_queue_depth"`
+}
+
+// Pacer 房间级漏桶发送器
+type Pacer struct {
+	mu sync.Mutex
+
+	config PacerConfig
+
+	// 环形队列
+	queue []pacedPacket
+	head  int
+	count int
+
+	// 漏桶
+	budget     float64 // 字节，可为负（音频透支）
+	lastRefill time.Time
+
+	// 码率估计
+	windowBytes int64
+	windowStart time.Time
+	estimateBps int64
+
+	// 仅出队协程使用
+	batch    []pacedPacket
+	inflight bool // 出队协程正在发送一批（此时直接发送会乱序）
+
+	// 统计
+	pacedPackets   uint64
+	directPackets  uint64
+	overflows      uint64
+	writeErrors    atomic.Uint64
+	maxQueueDelay  time.Duration
+	peakQueueDepth int
+
+	wake    chan struct{}
+	closeCh chan struct{}
+	doneCh  chan struct{}
+	closed  bool
+}
+
+// NewPacer 创建并启动 Pacer
+func NewPacer(config PacerConfig) *Pacer {
+	if config.Interval <= 0 {
+		config.Interval = 5 * time.Millisecond
+	}
+	if config.MaxQueuePackets <= 0 {
+		config.MaxQueuePackets = 1024
+	}
+	if config.Multiplier <= 0 {
+		config.Multiplier = 1
+	}
+	now := time.Now()
+	p := &Pacer{
+		config:      config,
+		queue:       make([]pacedPacket, config.MaxQueuePackets),
+		batch:       make([]pacedPacket, 0, config.MaxQueuePackets),
+		lastRefill:  now,
+		windowStart: now,
+		wake:        make(chan struct{}, 1),
+		closeCh:     make(chan struct{}),
+		doneCh:      make(chan struct{}),
+	}
+	go p.run()
+	return p
+}
+
+// rateLocked 当前发送速率 (bps)
+func (p *Pacer) rateLocked() int64 {
+	rate := int64(float64(p.estimateBps) * p.config.Multiplier)
+	if rate < p.config.MinRate {
+		rate = p.config.MinRate
+	}
+	if p.config.MaxRate > 0 && rate > p.config.MaxRate {
+		rate = p.config.MaxRate
+	}
+	return rate
+}
+
+// refillLocked 按经过的时间补充预算
+func (p *Pacer) refillLocked(now time.Time) {
+	elapsed := now.Sub(p.lastRefill)
+	if elapsed <= 0 {
+		return
+	}
+	p.lastRefill = now
+
+	bytesPerSec := float64(p.rateLocked()) / 8
+	p.budget += bytesPerSec * elapsed.Seconds()
+	if limit := bytesPerSec * pacerBurstWindow.Seconds(); p.budget > limit {
+		p.budget = limit
+	}
+}
+
+// observeLocked 更新视频码率估计
+func (p *Pacer) observeLocked(n int, now time.Time) {
+	p.windowBytes += int64(n)
+	elapsed := now.Sub(p.windowStart)
+	if elapsed < pacerRateWindow {
+		return
+	}
+	sample := int64(float64(p.windowBytes*8) / elapsed.Seconds())
+	if p.estimateBps == 0 {
+		p.estimateBps = sample
+	} else {
+		p.estimateBps = (p.estimateBps*3 + sample) / 4
+	}
+	p.windowBytes = 0
+	p.windowStart = now
+}
+
+// EnqueueVideo 视频包排队发送
+// buf 来自 GetRTPBuffer 或 GetRTPLargeBuffer，所有权转移给 Pacer（发送后归还全局缓冲池），n 为有效长度；
+// onSent 在该包真正写出后调用（被丢弃时不调用）
+func (p *Pacer) EnqueueVideo(w pacedWriter, buf []byte, n int, onSent func()) {
+	now := time.Now()
+
+	p.mu.Lock()
+	if p.closed {
+		p.mu.Unlock()
+		putPacedBuffer(buf)
+		return
+	}
+	p.observeLocked(n, now)
+	p.refillLocked(now)
+
+	// 队列为空且有预算：直接发送，不引入延迟
+	if p.count == 0 && !p.inflight && p.budget > 0 {
+		p.budget -= float64(n)
+		p.directPackets++
+		p.mu.Unlock()
+		p.write(pacedPacket{w: w, buf: buf, n: n, onSent: onSent})
+		return
+	}
+
+	// 队列已满：丢弃并计数，SN 已分配，订阅者按丢包处理（NACK / FEC）
+	if p.count == len(p.queue) {
+		p.overflows++
+		p.mu.Unlock()
+		putPacedBuffer(buf)
+		return
+	}
+	p.queue[(p.head+p.count)%len(p.queue)] = pacedPacket{w: w, buf: buf, n: n, enqueued: now, onSent: onSent}
+	p.count++
+	if p.count > p.peakQueueDepth {
+		p.peakQueueDepth = p.count
+	}
+	p.mu.Unlock()
+
+	select {
+	case p.wake <- struct{}{}:
+	default:
+	}
+}
+
+// OnAudio 音频包直接发送，只占用预算
+func (p *Pacer) OnAudio(n int) {
+	now := time.Now()
+	p.mu.Lock()
+	p.refillLocked(now)
+	p.budget -= float64(n)
+	p.mu.Unlock()
+}
+
+// popLocked 弹出队头
+func (p *Pacer) popLocked() pacedPacket {
+	pkt := p.queue[p.head]
+	p.queue[p.head] = pacedPacket{}
+	p.head = (p.head + 1) % len(p.queue)
+	p.count--
+	return pkt
+}
+
+// run 出队协程：队列非空时按 Interval 批量出队，空闲时阻塞
+func (p *Pacer) run() {
+	defer close(p.doneCh)
+
+	timer := time.NewTimer(p.config.Interval)
+	timer.Stop()
+
+	for {
+		select {
+		case <-p.closeCh:
+			return
+		case <-p.wake:
+		}
+
+		for {
+			timer.Reset(p.config.Interval)
+			select {
+			case <-p.closeCh:
+				timer.Stop()
+				return
+			case <-timer.C:
+			}
+			if p.drain(time.Now()) == 0 {
+				break
+			}
+		}
+	}
+}
+
+// drain 出队一批，返回剩余排队数
+func (p *Pacer) drain(now time.Time) int {
+	p.mu.Lock()
+	p.refillLocked(now)
+	deadline := now.Add(-p.config.MaxQueueDelay)
+
+	p.batch = p.batch[:0]
+	for p.count > 0 {
+		pkt := p.queue[p.head]
+		overdue := p.config.MaxQueueDelay > 0 && pkt.enqueued.Before(deadline)
+		if p.budget <= 0 && !overdue {
+			break
+		}
+		p.popLocked()
+		p.budget -= float64(pkt.n)
+		if delay := now.Sub(pkt.enqueued); delay > p.maxQueueDelay {
+			p.maxQueueDelay = delay
+		}
+		p.batch = append(p.batch, pkt)
+	}
+	p.pacedPackets += uint64(len(p.batch))
+	p.inflight = len(p.batch) > 0
+	p.mu.Unlock()
+
+	for i := range p.batch {
+		p.write(p.batch[i])
+		p.batch[i] = pacedPacket{}
+	}
+
+	p.mu.Lock()
+	p.inflight = false
+	remaining := p.count
+	p.mu.Unlock()
+	return remaining
+}
+
+// write 发送并归还缓冲区
+func (p *Pacer) write(pkt pacedPacket) {
+	if _, err := pkt.w.Write(pkt.buf[:pkt.n]); err != nil {
+		p.writeErrors.Add(1)
+	} else if pkt.onSent != nil {
+		pkt.onSent()
+	}
+	putPacedBuffer(pkt.buf)
+}
+
+// putPacedBuffer 按容量归还标准或大缓冲区
+func putPacedBuffer(buf []byte) {
+	globalBufferPool.PutBufferWithSize(buf)
+}
+
+// GetStats 获取统计
+func (p *Pacer) GetStats() PacerStats {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	return PacerStats{
+		Enabled:        p.config.Enabled,
+		RateBps:        p.rateLocked(),
+		EstimateBps:    p.estimateBps,
+		QueuedPackets:  p.count,
+		PacedPackets:   p.pacedPackets,
+		DirectPackets:  p.directPackets,
+		Overflows:      p.overflows,
+		WriteErrors:    p.writeErrors.Load(),
+		MaxQueueDelay:  float64(p.maxQueueDelay) / float64(time.Millisecond),
+		PeakQueueDepth: p.peakQueueDepth,
+	}
+}
+
+// Close 停止 Pacer，丢弃未发送的包
+func (p *Pacer) Close() {
+	p.mu.Lock()
+	if p.closed {
+		p.mu.Unlock()
+		return
+	}
+	p.closed = true
+	close(p.closeCh)
+	p.mu.Unlock()
+
+	<-p.doneCh
+
+	p.mu.Lock()
+	for p.count > 0 {
+		putPacedBuffer(p.popLocked().buf)
+	}
+	p.mu.Unlock()
+}
@@ -0,0 +1,275 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Pacer Tests
+ */
+package sfu
+
+import (
+	"encoding/binary"
+	"sync"
+	"testing"
+	"time"
+)
+
+// timingWriter 记录每个包的发送时间和序号
+type timingWriter struct {
+	mu    sync.Mutex
+	times []time.Time
+	seqs  []uint16
+}
+
+func (w *timingWriter) Write(b []byte) (int, error) {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	w.times = append(w.times, time.Now())
+	w.seqs = append(w.seqs, binary.BigEndian.Uint16(b[2:]))
+	return len(b), nil
+}
+
+func (w *timingWriter) snapshot() ([]time.Time, []uint16) {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	return append([]time.Time(nil), w.times...), append([]uint16(nil), w.seqs...)
+}
+
+// enqueuePacket 从缓冲池取 buffer 构造测试包
+func enqueuePacket(p *Pacer, w pacedWriter, seq uint16, size int) {
+	buf := GetRTPBuffer()
+	n := copy(buf, createTestRTPPacket(seq, size))
+	p.EnqueueVideo(w, buf, n, nil)
+}
+
+func waitForPackets(t *testing.T, w *timingWriter, n int, timeout time.Duration) {
+	t.Helper()
+	deadline := time.Now().Add(timeout)
+	for time.Now().Before(deadline) {
+		if times, _ := w.snapshot(); len(times) >= n {
+			return
+		}
+		time.Sleep(5 * time.Millisecond)
+	}
+	times, _ := w.snapshot()
+	t.Fatalf("Timed out: %d/%d packets sent", len(times), n)
+}
+
+func TestPacerSpreadsBurst(t *testing.T) {
+	config := DefaultPacerConfig()
+	config.MinRate = 8_000_000 // 1 MB/s
+	config.MaxRate = 8_000_000
+	config.MaxQueueDelay = time.Second
+	p := NewPacer(config)
+	defer p.Close()
+
+	w := &timingWriter{}
+	// 100 x 1200B = 120KB，1MB/s 下约 120ms
+	for i := 0; i < 100; i++ {
+		enqueuePacket(p, w, uint16(i), 1200)
+	}
+	waitForPackets(t, w, 100, 2*time.Second)
+
+	times, seqs := w.snapshot()
+	if spread := times[len(times)-1].Sub(times[0]); spread < 80*time.Millisecond {
+		t.Errorf("Burst not paced: spread=%v", spread)
+	}
+	for i, seq := range seqs {
+		if seq != uint16(i) {
+			t.Fatalf("Packet order changed at %d: got seq %d", i, seq)
+		}
+	}
+
+	stats := p.GetStats()
+	if stats.PacedPackets == 0 || stats.PeakQueueDepth < 50 {
+		t.Errorf("Unexpected stats: %+v", stats)
+	}
+}
+
+func TestPacerDirectWhenIdle(t *testing.T) {
+	p := NewPacer(DefaultPacerConfig())
+	defer p.Close()
+
+	w := &timingWriter{}
+	for i := 0; i < 5; i++ {
+		enqueuePacket(p, w, uint16(i), 200)
+		time.Sleep(10 * time.Millisecond)
+	}
+	if times, _ := w.snapshot(); len(times) != 5 {
+		t.Errorf("Expected low-rate packets to be sent immediately, got %d", len(times))
+	}
+	if stats := p.GetStats(); stats.DirectPackets != 5 {
+		t.Errorf("Expected 5 direct packets, got %+v", stats)
+	}
+}
+
+func TestPacerMaxQueueDelay(t *testing.T) {
+	config := DefaultPacerConfig()
+	config.MinRate = 80_000 // 10 KB/s，按预算需要 12 秒
+	config.MaxRate = 80_000
+	config.MaxQueueDelay = 50 * time.Millisecond
+	p := NewPacer(config)
+	defer p.Close()
+
+	w := &timingWriter{}
+	start := time.Now()
+	for i := 0; i < 100; i++ {
+		enqueuePacket(p, w, uint16(i), 1200)
+	}
+	waitForPackets(t, w, 100, time.Second)
+	if elapsed := time.Since(start); elapsed > 500*time.Millisecond {
+		t.Errorf("Queue delay bound not enforced: %v", elapsed)
+	}
+}
+
+func TestPacerAudioConsumesBudget(t *testing.T) {
+	config := DefaultPacerConfig()
+	config.MinRate = 800_000 // 100 KB/s
+	config.MaxRate = 800_000
+	p := NewPacer(config)
+	defer p.Close()
+
+	// 音频透支预算后，视频必须排队
+	p.OnAudio(10_000)
+	w := &timingWriter{}
+	enqueuePacket(p, w, 1, 1200)
+	if times, _ := w.snapshot(); len(times) != 0 {
+		t.Error("Expected video to wait behind audio")
+	}
+	waitForPackets(t, w, 1, time.Second)
+}
+
+func TestPacerOverflowAndClose(t *testing.T) {
+	config := DefaultPacerConfig()
+	config.MinRate = 8_000
+	config.MaxRate = 8_000
+	config.MaxQueuePackets = 8
+	config.MaxQueueDelay = time.Minute
+	p := NewPacer(config)
+
+	w := &timingWriter{}
+	for i := 0; i < 20; i++ {
+		enqueuePacket(p, w, uint16(i), 1200)
+	}
+	if stats := p.GetStats(); stats.Overflows == 0 || stats.QueuedPackets > 8 {
+		t.Errorf("Unexpected overflow stats: %+v", stats)
+	}
+	p.Close()
+
+	// 关闭后不再发送
+	enqueuePacket(p, w, 100, 1200)
+	_, seqs := w.snapshot()
+	for _, seq := range seqs {
+		if seq == 100 {
+			t.Error("Packet sent after Close")
+		}
+	}
+}
+
+// slowWriter 每个包发送耗时 delay，放大出队协程发送一批时的竞争窗口
+type slowWriter struct {
+	timingWriter
+	delay time.Duration
+}
+
+func (w *slowWriter) Write(b []byte) (int, error) {
+	time.Sleep(w.delay)
+	return w.timingWriter.Write(b)
+}
+
+// TestPacerOverflowKeepsOrder 队列满时丢包而不是绕过队列，发出的序号始终递增
+func TestPacerOverflowKeepsOrder(t *testing.T) {
+	config := DefaultPacerConfig()
+	config.MinRate = 8_000
+	config.MaxRate = 8_000
+	config.MaxQueuePackets = 8
+	config.MaxQueueDelay = time.Millisecond // 几乎立即超时，出队协程持续发送
+	p := NewPacer(config)
+	defer p.Close()
+
+	w := &slowWriter{delay: 200 * time.Microsecond}
+	const total = 300
+	for i := 0; i < total; i++ {
+		enqueuePacket(p, w, uint16(i), 1200)
+		if i%16 == 0 {
+			time.Sleep(time.Millisecond)
+		}
+	}
+
+	stats := p.GetStats()
+	if stats.Overflows == 0 {
+		t.Fatalf("Expected the queue to overflow, got %+v", stats)
+	}
+	waitForPackets(t, &w.timingWriter, total-int(stats.Overflows), 5*time.Second)
+
+	_, seqs := w.snapshot()
+	for i := 1; i < len(seqs); i++ {
+		if seqs[i] <= seqs[i-1] {
+			t.Fatalf("Packet %d sent out of order after %d", seqs[i], seqs[i-1])
+		}
+	}
+}
+
+// TestPacerLargePacketQueued 超过标准缓冲区的包同样排队（不插到排队包之前），写出后才回调 onSent
+func TestPacerLargePacketQueued(t *testing.T) {
+	config := DefaultPacerConfig()
+	config.MinRate = 8_000_000 // 1 MB/s
+	config.MaxRate = 8_000_000
+	config.MaxQueueDelay = time.Second
+	p := NewPacer(config)
+	defer p.Close()
+
+	w := &timingWriter{}
+	for i := 0; i < 50; i++ {
+		enqueuePacket(p, w, uint16(i), 1200)
+	}
+
+	sent := make(chan int, 1)
+	buf := GetRTPLargeBuffer()
+	n := copy(buf, createTestRTPPacket(50, 4000))
+	p.EnqueueVideo(w, buf, n, func() {
+		times, _ := w.snapshot()
+		sent <- len(times)
+	})
+
+	select {
+	case written := <-sent:
+		if written != 51 {
+			t.Errorf("onSent should follow the write of the packet itself, %d packets written", written)
+		}
+	case <-time.After(2 * time.Second):
+		t.Fatal("Large packet was never sent")
+	}
+
+	_, seqs := w.snapshot()
+	for i, seq := range seqs {
+		if seq != uint16(i) {
+			t.Fatalf("Packet order changed at %d: got seq %d", i, seq)
+		}
+	}
+}
+
+// BenchmarkPacerEnqueue 入队开销（队列由出队协程持续排空）
+func BenchmarkPacerEnqueue(b *testing.B) {
+	config := DefaultPacerConfig()
+	config.MinRate = 10_000_000_000
+	config.MaxRate = 10_000_000_000
+	p := NewPacer(config)
+	defer p.Close()
+
+	w := &timingWriter{}
+	data := createTestRTPPacket(1, 1200)
+	b.ReportAllocs()
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		buf := GetRTPBuffer()
+		n := copy(buf, data)
+		p.EnqueueVideo(w, buf, n, nil)
+		if i%4096 == 0 {
+			w.mu.Lock()
+			w.times, w.seqs = w.times[:0], w.seqs[:0]
+			w.mu.Unlock()
+		}
+	}
+}
@@ -0,0 +1,435 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Relay Handoff - 计划内 Relay 移交（先建后断）
+ * Relay 主动离开（应用退到后台、低电量、用户离开）时，订阅者不再等待心跳超时和故障切换：
+ *
+ *   1. 旧 Relay 选出继任者（在线 Peer 中选举分数最高者），通过控制通道 / 信令广播 Handoff
+ *   2. 继任者创建 RelayRoom 并连接 LiveKitBridge；订阅者保留旧连接，同时向继任者预协商
+ *   3. 继任者转发出第一个上游关键帧后接管（epoch + 1 的 Relay 声明，经继任者订阅旧 Relay 的
+ *      控制通道送达旧 Relay，不可用时由外部经信令声明）；
+ *      订阅者在新连接上收到关键帧后切换渲染，再关闭旧连接
+ *   4. 旧 Relay 收到继任者声明后继续转发，订阅者全部迁移（或 HandoffDrain 超时）后
+ *      才关闭 RelayRoom 和 LiveKitBridge
+ *
+ * 继任者在 HandoffTimeout 内没有接管时放弃移交，旧 Relay 继续服务，故障切换仍然兜底。
+ */
+package sfu
+
+import (
+	"time"
+
+	"github.com/maiguangyang/relay_core/pkg/utils"
+)
+
+// HandoffPhase 移交阶段
+type HandoffPhase int
+
+const (
+	HandoffIdle      HandoffPhase = iota // 无移交
+	HandoffNominated                     // 旧 Relay：已指定继任者，继续转发
+	HandoffPreparing                     // 继任者：RelayRoom 已就绪，等待上游关键帧
+	HandoffDraining                      // 旧 Relay：继任者已接管，等待订阅者迁移
+)
+
+func (p HandoffPhase) String() string {
+	switch p {
+	case HandoffNominated:
+		return "nominated"
+	case HandoffPreparing:
+		return "preparing"
+	case HandoffDraining:
+		return "draining"
+	default:
+		return "idle"
+	}
+}
+
+// HandoffStatus 移交状态
+type HandoffStatus struct {
+	Phase  string `json:"phase"`
+	Peer   string `json:"peer,omitempty"` // 旧 Relay 侧为继任者，继任者侧为旧 Relay
+	Epoch  uint64 `json:"epoch,omitempty"`
+	Reason string `json:"reason,omitempty"`
+}
+
+// relayHandoff 进行中的移交（由 ProxyModeCoordinator.mu 保护）
+type relayHandoff struct {
+	phase  HandoffPhase
+	peerID string
+	epoch  uint64 // 移交完成后的纪元号
+	reason string
+	timer  *time.Timer
+}
+
+func (h *relayHandoff) status() HandoffStatus {
+	return HandoffStatus{
+		Phase:  h.phase.String(),
+		Peer:   h.peerID,
+		Epoch:  h.epoch,
+		Reason: h.reason,
+	}
+}
+
+// StartHandoff 发起计划内移交，返回继任者 ID
+// 旧 Relay 在继任者接管、订阅者迁移完成之前继续转发
+func (pmc *ProxyModeCoordinator) StartHandoff(reason string) (string, error) {
+	successor, score := pmc.pickSuccessor()
+
+	pmc.mu.Lock()
+	if !pmc.isRelay || pmc.relayRoom == nil {
+		pmc.mu.Unlock()
+		return "", ErrNotRelay
+	}
+	if pmc.handoff.phase != HandoffIdle {
+		pmc.mu.Unlock()
+		return "", ErrHandoffInProgress
+	}
+	if successor == "" {
+		pmc.mu.Unlock()
+		return "", ErrNoHandoffCandidate
+	}
+	epoch := pmc.epoch + 1
+	pmc.handoff = relayHandoff{
+		phase:  HandoffNominated,
+		peerID: successor,
+		epoch:  epoch,
+		reason: reason,
+		timer:  time.AfterFunc(pmc.config.HandoffTimeout, func() { pmc.abortHandoff(epoch) }),
+	}
+	room := pmc.relayRoom
+	peers := make([]string, 0, len(pmc.peers))
+	for peerID := range pmc.peers {
+		peers = append(peers, peerID)
+	}
+	pmc.mu.Unlock()
+
+	// 控制通道可达的订阅者直接通知，其余 Peer（包括不在本机订阅的继任者）交给信令
+	msg := ControlMessage{Type: ControlMessageHandoff, Epoch: epoch, Score: score, PeerID: successor}
+	room.BroadcastControl(msg)
+	pending := peers[:0]
+	for _, peerID := range peers {
+		if !room.HasControlChannel(peerID) {
+			pending = append(pending, peerID)
+		}
+	}
+
+	utils.Info("[Coordinator] Handoff started: %s -> %s (epoch %d, reason %s)", pmc.localPeerID, successor, epoch, reason)
+	pmc.emitEvent(CoordinatorEvent{
+		Type:   CoordinatorEventHandoff,
+		RoomID: pmc.roomID,
+		PeerID: successor,
+		Data: map[string]interface{}{
+			"phase":     "nominated",
+			"relay":     pmc.localPeerID,
+			"successor": successor,
+			"epoch":     epoch,
+			"score":     score,
+			"reason":    reason,
+			"peers":     pending,
+		},
+	})
+	return successor, nil
+}
+
+// HandleHandoff 处理旧 Relay 的移交通知（来自控制通道或信令）
+// 本机是继任者时准备接管，否则通知外部向继任者预协商（保留当前连接）
+func (pmc *ProxyModeCoordinator) HandleHandoff(relayID, successorID string, epoch uint64) error {
+	pmc.mu.RLock()
+	stale := epoch <= pmc.epoch
+	pmc.mu.RUnlock()
+	if stale {
+		return ErrStaleHandoff
+	}
+
+	if successorID == pmc.localPeerID {
+		return pmc.prepareHandoff(relayID, epoch)
+	}
+
+	pmc.emitEvent(CoordinatorEvent{
+		Type:   CoordinatorEventHandoff,
+		RoomID: pmc.roomID,
+		PeerID: successorID,
+		Data: map[string]interface{}{
+			"phase":     "migrate",
+			"relay":     relayID,
+			"successor": successorID,
+			"epoch":     epoch,
+		},
+	})
+	return nil
+}
+
+// SetRelayControlSender 设置发往当前 Relay 的控制消息发送函数
+// 本机订阅当前 Relay 的 P2P 连接由外部持有（Dart 层 RelayControlChannel）；
+// 继任者接管时经它把声明送达旧 Relay，未设置或发送失败时由外部经信令补发
+func (pmc *ProxyModeCoordinator) SetRelayControlSender(fn func(relayID string, msg ControlMessage) error) {
+	pmc.mu.Lock()
+	defer pmc.mu.Unlock()
+	pmc.relayControl = fn
+}
+
+// HandleRelayControl 处理本机订阅的 Relay 经控制通道发来的消息
+func (pmc *ProxyModeCoordinator) HandleRelayControl(relayID string, msg ControlMessage) error {
+	switch msg.Type {
+	case ControlMessagePong:
+		pmc.HandlePong(relayID)
+	case ControlMessageClaim:
+		claimer := msg.PeerID
+		if claimer == "" {
+			claimer = relayID
+		}
+		pmc.ReceiveRelayClaim(claimer, msg.Epoch, msg.Score)
+	case ControlMessageHandoff:
+		return pmc.HandleHandoff(relayID, msg.PeerID, msg.Epoch)
+	}
+	return nil
+}
+
+// sendRelayControl 经本机订阅的控制通道向 Relay 发送消息
+func (pmc *ProxyModeCoordinator) sendRelayControl(relayID string, msg ControlMessage) error {
+	pmc.mu.RLock()
+	send := pmc.relayControl
+	pmc.mu.RUnlock()
+	if send == nil {
+		return ErrControlChannelNotOpen
+	}
+	return send(relayID, msg)
+}
+
+// GetHandoffStatus 获取移交状态
+func (pmc *ProxyModeCoordinator) GetHandoffStatus() HandoffStatus {
+	pmc.mu.RLock()
+	defer pmc.mu.RUnlock()
+	return pmc.handoff.status()
+}
+
+// pickSuccessor 选出继任者：在线 Peer 中选举分数最高者（同分按 PeerID 字典序大者）
+func (pmc *ProxyModeCoordinator) pickSuccessor() (string, float64) {
+	best, bestScore := "", 0.0
+	for _, c := range pmc.elector.GetCandidates() {
+		if c.PeerID == pmc.localPeerID {
+			continue
+		}
+		pmc.mu.RLock()
+		known := pmc.peers[c.PeerID]
+		pmc.mu.RUnlock()
+		if !known || pmc.keepalive.GetPeerStatus(c.PeerID) == PeerStatusOffline {
+			continue
+		}
+		if best == "" || c.Score > bestScore || (c.Score == bestScore && c.PeerID > best) {
+			best, bestScore = c.PeerID, c.Score
+		}
+	}
+	return best, bestScore
+}
+
+// prepareHandoff 继任者：创建 RelayRoom，等待上游关键帧后接管
+func (pmc *ProxyModeCoordinator) prepareHandoff(relayID string, epoch uint64) error {
+	pmc.mu.Lock()
+	if pmc.handoff.phase != HandoffIdle {
+		pmc.mu.Unlock()
+		return ErrHandoffInProgress
+	}
+	pmc.handoff = relayHandoff{
+		phase:  HandoffPreparing,
+		peerID: relayID,
+		epoch:  epoch,
+		timer:  time.AfterFunc(pmc.config.HandoffTimeout, func() { pmc.abortHandoff(epoch) }),
+	}
+	pmc.mu.Unlock()
+
+	if _, err := pmc.ensureRelayRoom(); err != nil {
+		pmc.abortHandoff(epoch)
+		return err
+	}
+
+	// 在第一个关键帧之后接管：此时预协商的订阅者可以立即解码
+	keyframe := pmc.switcher.NextKeyframe()
+	go func() {
+		select {
+		case <-keyframe:
+			pmc.commitHandoff(epoch)
+		case <-pmc.stopCh:
+		}
+	}()
+
+	// 外部收到 prepare 后连接 LiveKitBridge，订阅者开始向本机预协商
+	pmc.emitEvent(CoordinatorEvent{
+		Type:   CoordinatorEventHandoff,
+		RoomID: pmc.roomID,
+		PeerID: relayID,
+		Data: map[string]interface{}{
+			"phase": "prepare",
+			"relay": relayID,
+			"epoch": epoch,
+		},
+	})
+	return nil
+}
+
+// commitHandoff 继任者接管
+func (pmc *ProxyModeCoordinator) commitHandoff(epoch uint64) {
+	pmc.mu.Lock()
+	h := pmc.handoff
+	if h.phase != HandoffPreparing || h.epoch != epoch {
+		pmc.mu.Unlock()
+		return
+	}
+	h.timer.Stop()
+	pmc.handoff = relayHandoff{}
+	pmc.isRelay = true
+	pmc.currentRelayID = pmc.localPeerID
+	pmc.epoch = epoch
+	room := pmc.relayRoom
+	pmc.mu.Unlock()
+
+	pmc.failover.SetCurrentRelay(pmc.localPeerID, epoch)
+	claim := pmc.relayClaim()
+	if room != nil {
+		room.BroadcastControl(claim)
+	}
+	// 旧 Relay 不在本机房间里：经本机订阅它的控制通道送达，送不出去时由外部经信令声明
+	claimPending := pmc.sendRelayControl(h.peerID, claim) != nil
+
+	utils.Info("[Coordinator] Handoff committed: %s took over from %s (epoch %d)", pmc.localPeerID, h.peerID, epoch)
+	pmc.emitEvent(CoordinatorEvent{
+		Type:   CoordinatorEventHandoff,
+		RoomID: pmc.roomID,
+		PeerID: pmc.localPeerID,
+		Data: map[string]interface{}{
+			"phase":         "committed",
+			"relay":         h.peerID,
+			"successor":     pmc.localPeerID,
+			"epoch":         epoch,
+			"score":         claim.Score,
+			"claim_pending": claimPending,
+		},
+	})
+	pmc.emitEvent(CoordinatorEvent{
+		Type:   CoordinatorEventBecomeRelay,
+		RoomID: pmc.roomID,
+		PeerID: pmc.localPeerID,
+		Data: map[string]interface{}{
+			"epoch":   epoch,
+			"handoff": true,
+		},
+	})
+}
+
+// handleSuccessorClaim 旧 Relay 收到继任者的声明：进入迁移等待
+func (pmc *ProxyModeCoordinator) handleSuccessorClaim(peerID string, epoch uint64) {
+	pmc.mu.Lock()
+	h := &pmc.handoff
+	if h.phase != HandoffNominated || peerID != h.peerID || epoch < h.epoch {
+		pmc.mu.Unlock()
+		return
+	}
+	h.timer.Stop()
+	h.phase = HandoffDraining
+	drainEpoch := h.epoch
+	h.timer = time.AfterFunc(pmc.config.HandoffDrain, func() { pmc.finishHandoff(drainEpoch) })
+	pmc.mu.Unlock()
+
+	// 订阅者可能已经全部迁移
+	pmc.checkHandoffDrained()
+}
+
+// checkHandoffDrained 订阅者全部离开后立即结束移交
+// 继任者自己订阅本机的连接不需要迁移，随 RelayRoom 关闭
+func (pmc *ProxyModeCoordinator) checkHandoffDrained() {
+	pmc.mu.RLock()
+	draining := pmc.handoff.phase == HandoffDraining
+	epoch := pmc.handoff.epoch
+	successor := pmc.handoff.peerID
+	room := pmc.relayRoom
+	pmc.mu.RUnlock()
+
+	if !draining || room == nil {
+		return
+	}
+	for _, peerID := range room.GetSubscribers() {
+		if peerID != successor {
+			return
+		}
+	}
+	pmc.finishHandoff(epoch)
+}
+
+// finishHandoff 旧 Relay 关闭 RelayRoom 和 LiveKitBridge
+func (pmc *ProxyModeCoordinator) finishHandoff(epoch uint64) {
+	pmc.mu.Lock()
+	h := pmc.handoff
+	if h.phase != HandoffDraining || h.epoch != epoch {
+		pmc.mu.Unlock()
+		return
+	}
+	h.timer.Stop()
+	pmc.handoff = relayHandoff{}
+	room := pmc.relayRoom
+	pmc.relayRoom = nil
+	pmc.mu.Unlock()
+
+	remaining := 0
+	if room != nil {
+		for _, peerID := range room.GetSubscribers() {
+			if peerID != h.peerID {
+				remaining++
+			}
+		}
+		room.Close()
+	}
+	DestroyBridge(pmc.roomID)
+
+	utils.Info("[Coordinator] Handoff completed: %s -> %s (epoch %d, %d subscribers not migrated)", pmc.localPeerID, h.peerID, epoch, remaining)
+	pmc.emitEvent(CoordinatorEvent{
+		Type:   CoordinatorEventHandoff,
+		RoomID: pmc.roomID,
+		PeerID: h.peerID,
+		Data: map[string]interface{}{
+			"phase":     "completed",
+			"relay":     pmc.localPeerID,
+			"successor": h.peerID,
+			"epoch":     epoch,
+			"remaining": remaining,
+		},
+	})
+}
+
+// abortHandoff 继任者未能按时接管：旧 Relay 继续服务，继任者释放已创建的资源
+func (pmc *ProxyModeCoordinator) abortHandoff(epoch uint64) {
+	pmc.mu.Lock()
+	h := pmc.handoff
+	if (h.phase != HandoffNominated && h.phase != HandoffPreparing) || h.epoch != epoch {
+		pmc.mu.Unlock()
+		return
+	}
+	h.timer.Stop()
+	pmc.handoff = relayHandoff{}
+	var room *RelayRoom
+	if h.phase == HandoffPreparing && !pmc.isRelay {
+		room = pmc.relayRoom
+		pmc.relayRoom = nil
+	}
+	pmc.mu.Unlock()
+
+	if room != nil {
+		room.Close()
+		DestroyBridge(pmc.roomID)
+	}
+
+	utils.Warn("[Coordinator] Handoff aborted in phase %s (epoch %d)", h.phase, epoch)
+	pmc.emitEvent(CoordinatorEvent{
+		Type:   CoordinatorEventHandoff,
+		RoomID: pmc.roomID,
+		PeerID: h.peerID,
+		Data: map[string]interface{}{
+			"phase": "aborted",
+			"from":  h.phase.String(),
+			"peer":  h.peerID,
+			"epoch": epoch,
+		},
+	})
+}
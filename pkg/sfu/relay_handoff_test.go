@@ -0,0 +1,224 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Relay Handoff Tests
+ */
+package sfu
+
+import (
+	"testing"
+	"time"
+
+	"github.com/maiguangyang/relay_core/pkg/election"
+	"github.com/pion/rtp"
+)
+
+// vp8FramePacket 构造一个单包 VP8 帧
+func vp8FramePacket(seq uint16, ts uint32, keyframe bool) []byte {
+	payload := []byte{0x10, 0x01, 0x00, 0x00, 0x00}
+	if keyframe {
+		payload = []byte{0x10, 0x00, 0x9d, 0x01, 0x2a}
+	}
+	packet := &rtp.Packet{
+		Header: rtp.Header{
+			Version:        2,
+			Marker:         true,
+			PayloadType:    96,
+			SequenceNumber: seq,
+			Timestamp:      ts,
+			SSRC:           0x1234,
+		},
+		Payload: payload,
+	}
+	data, _ := packet.Marshal()
+	return data
+}
+
+func newHandoffCoordinator(t *testing.T, localPeerID string) (*ProxyModeCoordinator, chan CoordinatorEvent) {
+	t.Helper()
+	config := DefaultCoordinatorConfig()
+	config.HandoffTimeout = 300 * time.Millisecond
+	config.HandoffDrain = 300 * time.Millisecond
+
+	pmc, err := NewProxyModeCoordinator("handoff-room", localPeerID, config)
+	if err != nil {
+		t.Fatalf("Failed to create coordinator: %v", err)
+	}
+	t.Cleanup(pmc.Close)
+
+	events := make(chan CoordinatorEvent, 16)
+	pmc.SetOnEvent(func(event CoordinatorEvent) {
+		if event.Type == CoordinatorEventHandoff {
+			events <- event
+		}
+	})
+	return pmc, events
+}
+
+// waitHandoffPhase 等待指定阶段的移交事件（事件异步发出，顺序不保证）
+func waitHandoffPhase(t *testing.T, events chan CoordinatorEvent, phase string) CoordinatorEvent {
+	t.Helper()
+	deadline := time.After(2 * time.Second)
+	for {
+		select {
+		case event := <-events:
+			if event.Data["phase"] == phase {
+				return event
+			}
+		case <-deadline:
+			t.Fatalf("Handoff phase %s not emitted", phase)
+		}
+	}
+}
+
+func TestCoordinatorHandoffErrors(t *testing.T) {
+	pmc, events := newHandoffCoordinator(t, "relay-a")
+
+	if _, err := pmc.StartHandoff("test"); err != ErrNotRelay {
+		t.Errorf("Expected ErrNotRelay, got %v", err)
+	}
+
+	pmc.SetCurrentRelay("relay-a", 1)
+	pmc.handleBecomeRelay()
+	if _, err := pmc.StartHandoff("test"); err != ErrNoHandoffCandidate {
+		t.Errorf("Expected ErrNoHandoffCandidate, got %v", err)
+	}
+
+	if err := pmc.HandleHandoff("relay-x", "relay-a", 1); err != ErrStaleHandoff {
+		t.Errorf("Expected ErrStaleHandoff, got %v", err)
+	}
+
+	// 非继任者：通知外部向继任者预协商
+	if err := pmc.HandleHandoff("relay-x", "peer-b", 2); err != nil {
+		t.Fatalf("HandleHandoff failed: %v", err)
+	}
+	event := waitHandoffPhase(t, events, "migrate")
+	if event.PeerID != "peer-b" || event.Data["relay"] != "relay-x" {
+		t.Errorf("Unexpected migrate event %+v", event)
+	}
+}
+
+func TestCoordinatorHandoffNominateAndDrain(t *testing.T) {
+	pmc, events := newHandoffCoordinator(t, "relay-a")
+	pmc.AddPeer("peer-b", int(election.DeviceTypePC), int(election.ConnectionTypeEthernet), int(election.PowerStatePluggedIn))
+	pmc.AddPeer("peer-c", int(election.DeviceTypeMobile), int(election.ConnectionTypeCellular), int(election.PowerStateBattery))
+	pmc.SetCurrentRelay("relay-a", 1)
+	pmc.handleBecomeRelay()
+
+	successor, err := pmc.StartHandoff("battery")
+	if err != nil {
+		t.Fatalf("StartHandoff failed: %v", err)
+	}
+	if successor != "peer-b" {
+		t.Errorf("Expected peer-b as successor, got %s", successor)
+	}
+	event := waitHandoffPhase(t, events, "nominated")
+	if event.Data["epoch"] != uint64(2) || len(event.Data["peers"].([]string)) != 2 {
+		t.Errorf("Unexpected nominated event %+v", event.Data)
+	}
+	if _, err := pmc.StartHandoff("battery"); err != ErrHandoffInProgress {
+		t.Errorf("Expected ErrHandoffInProgress, got %v", err)
+	}
+
+	// 继任者声明接管，没有订阅者需要迁移：立即关闭 RelayRoom
+	pmc.ReceiveRelayClaim("peer-b", 2, 90)
+	event = waitHandoffPhase(t, events, "completed")
+	if event.Data["remaining"] != 0 {
+		t.Errorf("Unexpected completed event %+v", event.Data)
+	}
+	if pmc.GetRelayRoom() != nil || pmc.IsRelay() {
+		t.Error("Old relay should release its RelayRoom after handoff")
+	}
+	if status := pmc.GetHandoffStatus(); status.Phase != "idle" {
+		t.Errorf("Expected idle handoff, got %+v", status)
+	}
+}
+
+func TestCoordinatorHandoffAbort(t *testing.T) {
+	// 旧 Relay：继任者未接管，继续服务
+	relay, relayEvents := newHandoffCoordinator(t, "relay-a")
+	relay.AddPeer("peer-b", int(election.DeviceTypePC), int(election.ConnectionTypeWiFi), int(election.PowerStatePluggedIn))
+	relay.SetCurrentRelay("relay-a", 1)
+	relay.handleBecomeRelay()
+	if _, err := relay.StartHandoff("thermal"); err != nil {
+		t.Fatalf("StartHandoff failed: %v", err)
+	}
+	event := waitHandoffPhase(t, relayEvents, "aborted")
+	if event.Data["from"] != "nominated" {
+		t.Errorf("Unexpected aborted event %+v", event.Data)
+	}
+	if relay.GetRelayRoom() == nil || !relay.IsRelay() {
+		t.Error("Relay should keep serving after an aborted handoff")
+	}
+
+	// 继任者：没有等到上游关键帧，释放 RelayRoom
+	successor, events := newHandoffCoordinator(t, "peer-b")
+	successor.SetCurrentRelay("relay-a", 1)
+	if err := successor.HandleHandoff("relay-a", "peer-b", 2); err != nil {
+		t.Fatalf("HandleHandoff failed: %v", err)
+	}
+	waitHandoffPhase(t, events, "prepare")
+	if successor.GetRelayRoom() == nil {
+		t.Fatal("Successor should create its RelayRoom while preparing")
+	}
+	if status := successor.GetHandoffStatus(); status.Phase != "preparing" || status.Peer != "relay-a" {
+		t.Errorf("Unexpected status %+v", status)
+	}
+	event = waitHandoffPhase(t, events, "aborted")
+	if event.Data["from"] != "preparing" {
+		t.Errorf("Unexpected aborted event %+v", event.Data)
+	}
+	if successor.GetRelayRoom() != nil || successor.IsRelay() {
+		t.Error("Successor should release its RelayRoom after an aborted handoff")
+	}
+}
+
+func TestCoordinatorHandoffCommitOnKeyframe(t *testing.T) {
+	pmc, events := newHandoffCoordinator(t, "peer-b")
+	pmc.SetCurrentRelay("relay-a", 1)
+
+	// 继任者订阅旧 Relay 的控制通道：Handoff 经它到达，接管声明经它送回
+	claims := make(chan ControlMessage, 1)
+	pmc.SetRelayControlSender(func(relayID string, msg ControlMessage) error {
+		if relayID == "relay-a" {
+			claims <- msg
+		}
+		return nil
+	})
+	handoff := ControlMessage{Type: ControlMessageHandoff, Epoch: 2, PeerID: "peer-b"}
+	if err := pmc.HandleRelayControl("relay-a", handoff); err != nil {
+		t.Fatalf("HandleRelayControl failed: %v", err)
+	}
+	waitHandoffPhase(t, events, "prepare")
+
+	// 非关键帧不触发接管
+	switcher := pmc.GetSourceSwitcher()
+	switcher.InjectSFUPacket(true, vp8FramePacket(1, 3000, false))
+	time.Sleep(50 * time.Millisecond)
+	if pmc.IsRelay() {
+		t.Fatal("Successor should not commit before a keyframe")
+	}
+
+	switcher.InjectSFUPacket(true, vp8FramePacket(2, 6000, true))
+	event := waitHandoffPhase(t, events, "committed")
+	if event.Data["relay"] != "relay-a" || event.Data["epoch"] != uint64(2) || event.Data["claim_pending"] != false {
+		t.Errorf("Unexpected committed event %+v", event.Data)
+	}
+	select {
+	case claim := <-claims:
+		if claim.Type != ControlMessageClaim || claim.Epoch != 2 || claim.PeerID != "peer-b" {
+			t.Errorf("Unexpected claim %+v", claim)
+		}
+	default:
+		t.Error("Claim not sent to the old relay")
+	}
+	if !pmc.IsRelay() {
+		t.Error("Successor should be relay after commit")
+	}
+	status := pmc.GetStatus()
+	if status["epoch"] != uint64(2) || status["current_relay"] != "peer-b" {
+		t.Errorf("Unexpected status %+v", status)
+	}
+}
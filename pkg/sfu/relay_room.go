@@ -16,6 +16,7 @@ import (
 	"time"
 
 	"github.com/maiguangyang/relay_core/pkg/utils"
+	"github.com/pion/interceptor"
 	"github.com/pion/webrtc/v4"
 )
 
@@ -56,6 +57,19 @@ type Subscriber struct {
 	videoSender *webrtc.RTPSender
 	audioSender *webrtc.RTPSender
 
+	// 带内控制通道（订阅者 Offer 中带 relay-ctrl DataChannel 时才有）
+	control *ControlChannel
+
+	// 视频模式（暂停时视频 sender 不绑定 Track）
+	videoMode SubscriberVideoMode
+
+	// 计入内存预算的发送状态估计
+	memoryBytes int64
+
+	// 最近一次 RTCP 反馈：视频 RR 丢包率、REMB 带宽估计
+	fractionLost atomic.Uint32
+	rembBps      atomic.Uint64
+
 	// 统计
 	bytesSent    uint64
 	packetsSent  uint64
@@ -72,8 +86,35 @@ type RelayRoom struct {
 	api    *webrtc.API
 	config webrtc.Configuration
 
-	// 源切换器
-	switcher *SourceSwitcher
+	// 源切换器（ownsSwitcher 为 false 时由外部所有者关闭）
+	switcher     *SourceSwitcher
+	ownsSwitcher bool
+
+	// FEC 控制（仅在使用内置 API 时生效）
+	fec *FECController
+
+	// RTCP 反馈分发；使用内置 API 时作为 interceptor 注册，否则由 readRTCP 直接调用
+	rtcp            *RTCPDispatcher
+	rtcpIntercepted bool
+
+	// 下行 SR 生成（仅在使用内置 API 时生效，按 SourceSwitcher 改写后的时间轴生成）
+	senderReports *SenderReportGenerator
+
+	// 扩展头协商与改写（仅在使用内置 API 时生效）
+	extensionConfig  HeaderExtensionConfig
+	headerExtensions *HeaderExtensionRewriter
+
+	// 是否接受订阅者的 relay-ctrl 控制通道
+	controlEnabled bool
+
+	// 同构订阅者的 Offer 形态缓存 + 预热 PeerConnection
+	warmPool *WarmPool
+
+	// 订阅者 PeerConnection 共享的 DTLS 证书（nil 时由 pion 为每个连接生成）
+	certificates *CertificatePool
+
+	// 局域网模式（ICE-lite，只收集 host 候选），nil 表示完整 ICE
+	lanMode *LANModeConfig
 
 	// 订阅者列表
 	subscribers map[string]*Subscriber
@@ -89,6 +130,17 @@ type RelayRoom struct {
 	onNeedRenegotiate  func(roomID, peerID string, offer string)
 	onError            func(roomID, peerID string, err error)
 	onKeyframeRequest  func(roomID string) // 请求关键帧回调
+	onControlOpen      func(roomID, peerID string)
+	onControlMessage   func(roomID, peerID string, msg ControlMessage)
+	onRTCPFeedback     func(roomID, peerID string, fb RTCPFeedback)
+
+	// 内存预算：订阅者发送状态计入占用，压力过高时拒绝新订阅者
+	memory *MemoryGovernor
+
+	// 最大订阅者数（0 表示不限制），设备过热 / 低电量时由 Coordinator 调整
+	maxSubscribers int
+	// 正在协商、尚未注册的订阅者数（计入上限，避免并发加入同时通过检查）
+	pendingJoins int
 
 	// PLI 节流
 	lastPLIRequest time.Time
@@ -114,11 +166,74 @@ func WithSourceSwitcher(ss *SourceSwitcher) RelayRoomOption {
 	}
 }
 
+// WithFEC 使用自定义 FEC 配置（默认启用自适应 FEC）
+// 仅对内置 API 生效；使用 WithWebRTCAPI 时需自行注册 FECController
+func WithFEC(config FECConfig) RelayRoomOption {
+	return func(r *RelayRoom) {
+		r.fec = NewFECController(config)
+	}
+}
+
+// WithControlChannel 开关带内控制通道（默认开启）
+// 开启后订阅者在 Offer 中创建的 relay-ctrl DataChannel 用于心跳、Relay 声明和关键帧请求
+func WithControlChannel(enabled bool) RelayRoomOption {
+	return func(r *RelayRoom) {
+		r.controlEnabled = enabled
+	}
+}
+
+// WithWarmPool 设置预热 PeerConnection 池（默认开启，Size 为 0 时关闭）
+func WithWarmPool(config WarmPoolConfig) RelayRoomOption {
+	return func(r *RelayRoom) {
+		if config.Size <= 0 {
+			r.warmPool = nil
+			return
+		}
+		r.warmPool = NewWarmPool(config)
+	}
+}
+
+// WithMemoryGovernor 使用指定的内存预算（默认使用全局实例，nil 表示不限制）
+func WithMemoryGovernor(memory *MemoryGovernor) RelayRoomOption {
+	return func(r *RelayRoom) {
+		r.memory = memory
+	}
+}
+
+// WithCertificatePool 使用指定的证书池（默认使用全局实例，nil 表示每个订阅者单独生成证书）
+func WithCertificatePool(pool *CertificatePool) RelayRoomOption {
+	return func(r *RelayRoom) {
+		r.certificates = pool
+	}
+}
+
+// WithLANMode 局域网模式：Relay 作为 ICE-lite 端，只收集 host 候选，忽略 ICE 服务器
+// 仅对内置 API 生效；使用 WithWebRTCAPI 时需自行调用 LANModeConfig.Apply
+func WithLANMode(config LANModeConfig) RelayRoomOption {
+	return func(r *RelayRoom) {
+		r.lanMode = &config
+	}
+}
+
+// WithHeaderExtensions 设置与订阅者协商的扩展头（默认转发音量和视频方向）
+// 仅对内置 API 生效；使用 WithWebRTCAPI 时需自行调用 HeaderExtensionConfig.Register 并注册 HeaderExtensionRewriter
+func WithHeaderExtensions(config HeaderExtensionConfig) RelayRoomOption {
+	return func(r *RelayRoom) {
+		r.extensionConfig = config
+	}
+}
+
 // NewRelayRoom 创建代理房间
 func NewRelayRoom(id string, iceServers []webrtc.ICEServer, opts ...RelayRoomOption) (*RelayRoom, error) {
 	room := &RelayRoom{
-		id:          id,
-		subscribers: make(map[string]*Subscriber),
+		id:              id,
+		subscribers:     make(map[string]*Subscriber),
+		controlEnabled:  true,
+		warmPool:        NewWarmPool(DefaultWarmPoolConfig()),
+		memory:          globalMemoryGovernor,
+		certificates:    globalCertificatePool,
+		rtcp:            NewRTCPDispatcher(),
+		extensionConfig: DefaultHeaderExtensionConfig(),
 		config: webrtc.Configuration{
 			ICEServers: iceServers,
 		},
@@ -129,6 +244,14 @@ func NewRelayRoom(id string, iceServers []webrtc.ICEServer, opts ...RelayRoomOpt
 		opt(room)
 	}
 
+	// 第一个订阅者加入前在后台生成证书
+	room.certificates.Warm()
+
+	// 局域网内不需要 STUN/TURN（ICE-lite 也不能使用 srflx / relay 候选）
+	if room.lanMode != nil {
+		room.config.ICEServers = nil
+	}
+
 	// 只有在没有通过选项提供 SourceSwitcher 时才创建新的
 	if room.switcher == nil {
 		switcher, err := NewSourceSwitcher(id)
@@ -136,8 +259,11 @@ func NewRelayRoom(id string, iceServers []webrtc.ICEServer, opts ...RelayRoomOpt
 			return nil, err
 		}
 		room.switcher = switcher
+		room.ownsSwitcher = true
 	}
 
+	room.rtcp.SetHandler(room.handleRTCPFeedback)
+
 	// 在 switcher 上注册回调（无论是内部创建的还是外部传入的）
 	room.switcher.SetOnTrackChanged(func(videoTrack, audioTrack *webrtc.TrackLocalStaticRTP) {
 		room.UpdateTracks(videoTrack, audioTrack)
@@ -149,7 +275,37 @@ func NewRelayRoom(id string, iceServers []webrtc.ICEServer, opts ...RelayRoomOpt
 		if err := m.RegisterDefaultCodecs(); err != nil {
 			return nil, err
 		}
-		room.api = webrtc.NewAPI(webrtc.WithMediaEngine(m))
+
+		// 每个订阅者独立生成 FEC（FlexFEC 视频 / RED 音频），冗余度随其丢包率自适应
+		if room.fec == nil {
+			room.fec = NewFECController(DefaultFECConfig())
+		}
+		registry := &interceptor.Registry{}
+		if err := room.fec.RegisterCodecs(m); err != nil {
+			return nil, err
+		}
+		registry.Add(room.fec)
+		registry.Add(room.rtcp)
+		room.rtcpIntercepted = true
+
+		room.senderReports = NewSenderReportGenerator(DefaultSenderReportConfig(), room.switcher.GetSenderReportClock())
+		registry.Add(room.senderReports)
+
+		// 扩展头改写最后注册（最外层），FEC 保护改写后的包
+		if err := room.extensionConfig.Register(m); err != nil {
+			return nil, err
+		}
+		room.headerExtensions = NewHeaderExtensionRewriter()
+		registry.Add(room.headerExtensions)
+		room.switcher.EnableHeaderExtensionRewrite()
+
+		apiOpts := []func(*webrtc.API){webrtc.WithMediaEngine(m), webrtc.WithInterceptorRegistry(registry)}
+		if room.lanMode != nil {
+			se := webrtc.SettingEngine{}
+			room.lanMode.Apply(&se)
+			apiOpts = append(apiOpts, webrtc.WithSettingEngine(se))
+		}
+		room.api = webrtc.NewAPI(apiOpts...)
 	}
 
 	return room, nil
@@ -180,6 +336,26 @@ func (r *RelayRoom) SetKeyframeRequestCallback(fn func(roomID string)) {
 	r.onKeyframeRequest = fn
 }
 
+// SetControlCallbacks 设置控制通道回调
+// onOpen: 订阅者的控制通道可用；onMessage: 收到 Pong / Claim（Ping 已自动回复，关键帧请求由房间处理）
+func (r *RelayRoom) SetControlCallbacks(
+	onOpen func(roomID, peerID string),
+	onMessage func(roomID, peerID string, msg ControlMessage),
+) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	r.onControlOpen = onOpen
+	r.onControlMessage = onMessage
+}
+
+// SetRTCPFeedbackCallback 设置 RTCP 反馈回调（PLI / FIR 已由房间转为关键帧请求，这里用于额外的观测）
+// 在 RTCP 读取协程中调用，不应阻塞
+func (r *RelayRoom) SetRTCPFeedbackCallback(fn func(roomID, peerID string, fb RTCPFeedback)) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	r.onRTCPFeedback = fn
+}
+
 // GetSourceSwitcher 返回源切换器
 func (r *RelayRoom) GetSourceSwitcher() *SourceSwitcher {
 	return r.switcher
@@ -220,49 +396,85 @@ func (r *RelayRoom) AddSubscriber(peerID string, offerSDP string) (string, error
 		r.RemoveSubscriber(peerID)
 		r.mu.Lock()
 	}
+	if r.maxSubscribers > 0 && len(r.subscribers)+r.pendingJoins >= r.maxSubscribers {
+		r.mu.Unlock()
+		utils.Warn("[RelayRoom] Refusing subscriber %s: limit %d reached", peerID, r.maxSubscribers)
+		return "", ErrSubscriberLimit
+	}
+	// 在同一把锁内占住名额，注册或失败时释放
+	r.pendingJoins++
 	r.mu.Unlock()
+	reserved := true
+	defer func() {
+		if reserved {
+			r.mu.Lock()
+			r.pendingJoins--
+			r.mu.Unlock()
+		}
+	}()
 
-	// 创建 PeerConnection
-	pc, err := r.api.NewPeerConnection(r.config)
-	if err != nil {
-		return "", err
+	// 内存压力过高时拒绝新订阅者，已连接的订阅者不受影响
+	if r.memory != nil && !r.memory.AdmitSubscriber() {
+		utils.Warn("[RelayRoom] Refusing subscriber %s: memory budget exceeded", peerID)
+		return "", ErrMemoryBudgetExceeded
 	}
 
+	redPayloadType := offerREDPayloadType(offerSDP)
+
+	// 优先使用预热的 PeerConnection，否则现场创建并添加 SourceSwitcher 的 Track
+	var warm *warmPeerConnection
+	if r.warmPool != nil {
+		warm = r.warmPool.take(r.switcher.GetVideoTrack(), r.switcher.GetAudioTrack())
+	}
+	if warm == nil {
+		var err error
+		if warm, err = r.newSubscriberPeerConnection(); err != nil {
+			return "", err
+		}
+	}
+	pc := warm.pc
+
 	sub := &Subscriber{
 		id:           peerID,
 		pc:           pc,
 		state:        SubscriberStateConnecting,
+		videoSender:  warm.videoSender,
+		audioSender:  warm.audioSender,
 		lastActivity: time.Now(),
 	}
 
-	// 添加 SourceSwitcher 的 Track
-	videoTrack := r.switcher.GetVideoTrack()
-	if videoTrack != nil {
-		sender, err := pc.AddTrack(videoTrack)
-		if err != nil {
+	// 协商失败时清理：关闭连接，移除 RTCP 分发和 FEC 的按 SSRC 登记
+	joined := false
+	defer func() {
+		if !joined {
+			r.forgetSenders(sub.videoSender, sub.audioSender)
 			pc.Close()
-			return "", err
 		}
-		sub.videoSender = sender
+	}()
 
-		// 读取 RTCP 反馈（必须消费，否则会阻塞）
-		go r.readRTCP(peerID, sender)
+	// 拉取 RTCP 反馈（必须消费，解析和分发在 RTCPDispatcher 中完成）
+	if sub.videoSender != nil {
+		r.trackSender(peerID, sub.videoSender)
 	}
+	if sub.audioSender != nil {
+		r.trackSender(peerID, sub.audioSender)
 
-	audioTrack := r.switcher.GetAudioTrack()
-	if audioTrack != nil {
-		sender, err := pc.AddTrack(audioTrack)
-		if err != nil {
-			pc.Close()
-			return "", err
+		// 订阅者支持 RED 时，允许 FEC interceptor 在丢包时封装冗余
+		if r.fec != nil {
+			if ssrc, ok := senderSSRC(sub.audioSender); ok {
+				r.fec.SetREDPayloadType(ssrc, redPayloadType)
+			}
 		}
-		sub.audioSender = sender
-		go r.readRTCP(peerID, sender)
 	}
 
 	// 设置 ICE 处理 (必须在 SetLocalDescription 之前)
 	r.setupICEHandlers(sub)
 
+	// 控制通道由订阅者创建，必须在 SetRemoteDescription 之前注册
+	if r.controlEnabled {
+		r.setupControlChannel(sub)
+	}
+
 	// 处理 Offer
 	offer := webrtc.SessionDescription{
 		Type: webrtc.SDPTypeOffer,
@@ -270,29 +482,36 @@ func (r *RelayRoom) AddSubscriber(peerID string, offerSDP string) (string, error
 	}
 
 	if err := pc.SetRemoteDescription(offer); err != nil {
-		pc.Close()
 		return "", err
 	}
 
 	// 创建 Answer
 	answer, err := pc.CreateAnswer(nil)
 	if err != nil {
-		pc.Close()
 		return "", err
 	}
 
 	if err := pc.SetLocalDescription(answer); err != nil {
-		pc.Close()
 		return "", err
 	}
+	joined = true
+
+	// 为后续订阅者预热 PeerConnection
+	if r.warmPool != nil {
+		r.warmPool.refill(r.newSubscriberPeerConnection)
+	}
 
 	// 初始连接完成后，设置协商处理器
 	r.setupNegotiationHandlers(sub)
 
 	// 注册订阅者
+	sub.memoryBytes = r.memory.SubscriberBytes()
 	r.mu.Lock()
+	r.pendingJoins--
+	reserved = false
 	r.subscribers[peerID] = sub
 	r.mu.Unlock()
+	r.memory.Reserve(MemoryClassSubscriber, sub.memoryBytes)
 
 	// 触发回调
 	r.emitSubscriberJoined(peerID)
@@ -302,13 +521,16 @@ func (r *RelayRoom) AddSubscriber(peerID string, offerSDP string) (string, error
 	// 通过 ReplaceTrack 确保新订阅者获得正确的视频轨道
 	currentVideoTrack := r.switcher.GetVideoTrack()
 	currentAudioTrack := r.switcher.GetAudioTrack()
-	if sub.videoSender != nil && currentVideoTrack != nil {
+	sub.mu.Lock()
+	// 注册后可能已被设置为暂停
+	if sub.videoSender != nil && currentVideoTrack != nil && sub.videoMode != SubscriberVideoPaused {
 		if err := sub.videoSender.ReplaceTrack(currentVideoTrack); err != nil {
 			utils.Error("[RelayRoom] ReplaceTrack for new subscriber %s failed: %v", peerID, err)
 		} else {
 			utils.Info("[RelayRoom] ReplaceTrack for new subscriber %s success", peerID)
 		}
 	}
+	sub.mu.Unlock()
 	if sub.audioSender != nil && currentAudioTrack != nil {
 		if err := sub.audioSender.ReplaceTrack(currentAudioTrack); err != nil {
 			utils.Error("[RelayRoom] ReplaceAudioTrack for new subscriber %s failed: %v", peerID, err)
@@ -333,6 +555,37 @@ func (r *RelayRoom) AddSubscriber(peerID string, offerSDP string) (string, error
 	return answer.SDP, nil
 }
 
+// newSubscriberPeerConnection 创建订阅者 PeerConnection 并添加当前的音视频 Track
+func (r *RelayRoom) newSubscriberPeerConnection() (*warmPeerConnection, error) {
+	config := r.config
+	if cert := r.certificates.Get(); cert != nil {
+		config.Certificates = []webrtc.Certificate{*cert}
+	}
+	pc, err := r.api.NewPeerConnection(config)
+	if err != nil {
+		return nil, err
+	}
+
+	w := &warmPeerConnection{
+		pc:         pc,
+		videoTrack: r.switcher.GetVideoTrack(),
+		audioTrack: r.switcher.GetAudioTrack(),
+	}
+	if w.videoTrack != nil {
+		if w.videoSender, err = pc.AddTrack(w.videoTrack); err != nil {
+			pc.Close()
+			return nil, err
+		}
+	}
+	if w.audioTrack != nil {
+		if w.audioSender, err = pc.AddTrack(w.audioTrack); err != nil {
+			pc.Close()
+			return nil, err
+		}
+	}
+	return w, nil
+}
+
 // CreateOfferForSubscriber 为订阅者创建 Offer（用于重协商）
 func (r *RelayRoom) CreateOfferForSubscriber(peerID string) (string, error) {
 	r.mu.RLock()
@@ -407,6 +660,14 @@ func (r *RelayRoom) AddICECandidate(peerID string, candidate webrtc.ICECandidate
 	return sub.pc.AddICECandidate(candidate)
 }
 
+// SetMaxSubscribers 设置最大订阅者数（0 表示不限制）
+// 只拒绝新订阅者，已连接的订阅者不会被断开
+func (r *RelayRoom) SetMaxSubscribers(max int) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	r.maxSubscribers = max
+}
+
 // RemoveSubscriber 移除订阅者
 func (r *RelayRoom) RemoveSubscriber(peerID string) error {
 	r.mu.Lock()
@@ -417,13 +678,19 @@ func (r *RelayRoom) RemoveSubscriber(peerID string) error {
 	}
 	delete(r.subscribers, peerID)
 	r.mu.Unlock()
+	r.memory.Release(MemoryClassSubscriber, sub.memoryBytes)
 
 	// 关闭连接
 	sub.mu.Lock()
 	sub.closed = true
 	pc := sub.pc
+	videoSender := sub.videoSender
+	audioSender := sub.audioSender
 	sub.mu.Unlock()
 
+	r.forgetSenders(videoSender, audioSender)
+	r.bandwidthAccountant().RemoveSubscriber(peerID)
+
 	if pc != nil {
 		pc.Close()
 	}
@@ -486,6 +753,11 @@ func (r *RelayRoom) UpdateTracks(videoTrack, audioTrack *webrtc.TrackLocalStatic
 	utils.Info("[RelayRoom] UpdateTracks called, subscriber count: %d, videoTrack=%v, audioTrack=%v",
 		len(subscribers), videoTrack != nil, audioTrack != nil)
 
+	// 预热的 PeerConnection 绑定的是旧 Track
+	if r.warmPool != nil {
+		r.warmPool.flush()
+	}
+
 	for _, sub := range subscribers {
 		sub.mu.Lock()
 		if sub.closed {
@@ -498,7 +770,10 @@ func (r *RelayRoom) UpdateTracks(videoTrack, audioTrack *webrtc.TrackLocalStatic
 
 		// 更新视频 Track
 		if videoTrack != nil {
-			if sub.videoSender != nil {
+			if sub.videoMode == SubscriberVideoPaused && sub.videoSender != nil {
+				// 暂停中，恢复时再绑定当前 Track
+				utils.Info("[RelayRoom] Subscriber %s video paused, skipping ReplaceTrack", sub.id)
+			} else if sub.videoSender != nil {
 				// 已有 sender，直接替换 track
 				if err := sub.videoSender.ReplaceTrack(videoTrack); err != nil {
 					utils.Error("[RelayRoom] ReplaceTrack failed for %s: %v", sub.id, err)
@@ -515,7 +790,7 @@ func (r *RelayRoom) UpdateTracks(videoTrack, audioTrack *webrtc.TrackLocalStatic
 					sub.videoSender = sender
 					needRenegotiate = true
 					// 启动 RTCP 读取
-					go r.readRTCP(sub.id, sender)
+					r.trackSender(sub.id, sender)
 					utils.Info("[RelayRoom] AddTrack success for %s, will renegotiate", sub.id)
 				}
 			}
@@ -533,7 +808,7 @@ func (r *RelayRoom) UpdateTracks(videoTrack, audioTrack *webrtc.TrackLocalStatic
 				} else {
 					sub.audioSender = sender
 					needRenegotiate = true
-					go r.readRTCP(sub.id, sender)
+					r.trackSender(sub.id, sender)
 				}
 			}
 		}
@@ -629,6 +904,7 @@ func (r *RelayRoom) Close() error {
 
 	// 关闭所有订阅者
 	for _, sub := range subscribers {
+		r.memory.Release(MemoryClassSubscriber, sub.memoryBytes)
 		sub.mu.Lock()
 		sub.closed = true
 		if sub.pc != nil {
@@ -637,8 +913,12 @@ func (r *RelayRoom) Close() error {
 		sub.mu.Unlock()
 	}
 
-	// 关闭源切换器
-	if r.switcher != nil {
+	if r.warmPool != nil {
+		r.warmPool.Close()
+	}
+
+	// 关闭源切换器（外部传入的由所有者关闭，例如 Relay 移交后 Coordinator 继续使用）
+	if r.switcher != nil && r.ownsSwitcher {
 		r.switcher.Close()
 	}
 
@@ -661,10 +941,13 @@ func (r *RelayRoom) setupICEHandlers(sub *Subscriber) {
 		case webrtc.PeerConnectionStateConnected:
 			sub.state = SubscriberStateConnected
 			sub.lastActivity = time.Now()
+			r.bandwidthAccountant().SubscriberConnected(sub.id)
 		case webrtc.PeerConnectionStateDisconnected:
 			sub.state = SubscriberStateDisconnected
+			r.bandwidthAccountant().SubscriberDisconnected(sub.id)
 		case webrtc.PeerConnectionStateFailed:
 			sub.state = SubscriberStateFailed
+			r.bandwidthAccountant().SubscriberDisconnected(sub.id)
 			// 启动异步清理，避免死锁 (RemoveSubscriber 需要获取 r.mu，而当前持有 sub.mu)
 			go func() {
 				utils.Info("[RelayRoom] Subscriber %s connection failed, removing...", sub.id)
@@ -689,6 +972,99 @@ func (r *RelayRoom) setupICEHandlers(sub *Subscriber) {
 	})
 }
 
+// setupControlChannel 接收订阅者创建的 relay-ctrl DataChannel
+func (r *RelayRoom) setupControlChannel(sub *Subscriber) {
+	sub.pc.OnDataChannel(func(dc *webrtc.DataChannel) {
+		if dc.Label() != ControlChannelLabel {
+			return
+		}
+		control := NewControlChannel(sub.id, dc, r.emitControlOpen, r.handleControlMessage)
+
+		sub.mu.Lock()
+		old := sub.control
+		sub.control = control
+		sub.mu.Unlock()
+
+		if old != nil {
+			old.Close()
+		}
+	})
+}
+
+// handleControlMessage 处理控制通道消息
+func (r *RelayRoom) handleControlMessage(peerID string, msg ControlMessage) {
+	if msg.Type == ControlMessageKeyframeRequest {
+		r.emitKeyframeRequest()
+		return
+	}
+
+	r.mu.RLock()
+	fn := r.onControlMessage
+	r.mu.RUnlock()
+	if fn != nil {
+		fn(r.id, peerID, msg)
+	}
+}
+
+// getControlChannel 获取订阅者的控制通道
+func (r *RelayRoom) getControlChannel(peerID string) *ControlChannel {
+	r.mu.RLock()
+	sub, exists := r.subscribers[peerID]
+	r.mu.RUnlock()
+	if !exists {
+		return nil
+	}
+
+	sub.mu.RLock()
+	defer sub.mu.RUnlock()
+	return sub.control
+}
+
+// HasControlChannel 订阅者的控制通道是否可用
+func (r *RelayRoom) HasControlChannel(peerID string) bool {
+	control := r.getControlChannel(peerID)
+	return control != nil && control.IsOpen()
+}
+
+// SendControl 通过控制通道发送消息
+func (r *RelayRoom) SendControl(peerID string, msg ControlMessage) error {
+	control := r.getControlChannel(peerID)
+	if control == nil {
+		return ErrControlChannelNotOpen
+	}
+	return control.Send(msg)
+}
+
+// SendControlPing 通过控制通道发送 Ping
+func (r *RelayRoom) SendControlPing(peerID string) error {
+	control := r.getControlChannel(peerID)
+	if control == nil {
+		return ErrControlChannelNotOpen
+	}
+	return control.SendPing()
+}
+
+// BroadcastControl 向所有已打开控制通道的订阅者发送消息，返回成功数
+func (r *RelayRoom) BroadcastControl(msg ControlMessage) int {
+	r.mu.RLock()
+	subscribers := make([]*Subscriber, 0, len(r.subscribers))
+	for _, sub := range r.subscribers {
+		subscribers = append(subscribers, sub)
+	}
+	r.mu.RUnlock()
+
+	sent := 0
+	for _, sub := range subscribers {
+		sub.mu.RLock()
+		control := sub.control
+		sub.mu.RUnlock()
+		if control != nil && control.Send(msg) == nil {
+			sent++
+		}
+	}
+	return sent
+}
+
 // setupNegotiationHandlers 设置协商处理器
 func (r *RelayRoom) setupNegotiationHandlers(sub *Subscriber) {
 	// 协商需求（Track 变化时触发）
@@ -728,42 +1104,111 @@ func (r *RelayRoom) setupSubscriberHandlers(sub *Subscriber) {
 	r.setupNegotiationHandlers(sub)
 }
 
-// readRTCP 读取 RTCP 反馈
-func (r *RelayRoom) readRTCP(peerID string, sender *webrtc.RTPSender) {
+// bandwidthAccountant 房间的流量核算（挂在共享的 SourceSwitcher 上，与 LiveKitBridge 共用）
+func (r *RelayRoom) bandwidthAccountant() *BandwidthAccountant {
+	return r.switcher.GetBandwidthAccountant()
+}
+
+// GetBandwidthStats 获取公网 / 局域网流量核算
+func (r *RelayRoom) GetBandwidthStats() BandwidthStats {
+	return r.bandwidthAccountant().GetStats()
+}
+
+// GetFEC 返回 FEC 控制器（使用自定义 API 且未指定 WithFEC 时为 nil）
+func (r *RelayRoom) GetFEC() *FECController {
+	return r.fec
+}
+
+// senderSSRC 获取 sender 的媒体 SSRC
+func senderSSRC(sender *webrtc.RTPSender) (uint32, bool) {
+	if sender == nil {
+		return 0, false
+	}
+	params := sender.GetParameters()
+	if len(params.Encodings) == 0 {
+		return 0, false
+	}
+	return uint32(params.Encodings[0].SSRC), true
+}
+
+// trackSender 登记 sender 的发送 SSRC 并启动 RTCP 拉取
+func (r *RelayRoom) trackSender(peerID string, sender *webrtc.RTPSender) {
+	if ssrc, ok := senderSSRC(sender); ok {
+		r.rtcp.Track(ssrc, peerID)
+	}
+	go r.readRTCP(sender)
+}
+
+// forgetSenders 移除订阅者 sender 在 RTCP 分发和 FEC 中的按 SSRC 登记
+func (r *RelayRoom) forgetSenders(videoSender, audioSender *webrtc.RTPSender) {
+	if r.fec != nil && audioSender != nil {
+		if ssrc, ok := senderSSRC(audioSender); ok {
+			r.fec.Forget(ssrc)
+		}
+	}
+	for _, sender := range []*webrtc.RTPSender{videoSender, audioSender} {
+		if ssrc, ok := senderSSRC(sender); ok {
+			r.rtcp.Forget(ssrc)
+		}
+	}
+}
+
+// readRTCP 拉取 sender 的 RTCP（pion 只在 Read 时让数据流经 interceptor）
+func (r *RelayRoom) readRTCP(sender *webrtc.RTPSender) {
 	rtcpBuf := make([]byte, 1500)
 	for {
 		n, _, err := sender.Read(rtcpBuf)
 		if err != nil {
 			return
 		}
+		// 自定义 API 没有注册分发 interceptor 时在这里解析
+		if !r.rtcpIntercepted {
+			r.rtcp.Dispatch(rtcpBuf[:n])
+		}
+	}
+}
 
-		// 解析 RTCP 包，检测 PLI (Picture Loss Indication) 请求
-		// PLI 表示接收端需要关键帧
-		// RTCP 包格式: https://tools.ietf.org/html/rfc4585
-		// PLI 的 Payload Type 是 206 (PSFB), FMT=1
-		if n >= 4 {
-			// RTCP header: version(2) + padding(1) + FMT(5) + PT(8) + length(16)
-			pt := rtcpBuf[1]
-			// PT=206 是 PSFB (Payload-Specific Feedback)
-			// FMT=1 是 PLI (Picture Loss Indication)
-			fmt := (rtcpBuf[0] >> 0) & 0x1F // 低5位是 FMT
-			if pt == 206 && fmt == 1 {
-				// 节流 PLI 请求，避免频繁请求关键帧
-				// 每隔 300ms 最多转发一次
-				r.mu.Lock()
-				now := time.Now()
-				if now.Sub(r.lastPLIRequest) > 300*time.Millisecond {
-					r.lastPLIRequest = now
-					r.mu.Unlock()
-					utils.Info("[RelayRoom] PLI received from subscriber %s, requesting keyframe from SFU", peerID)
-					r.emitKeyframeRequest()
-				} else {
-					r.mu.Unlock()
-					// 跳过此 PLI，太频繁
-				}
-			}
+// handleRTCPFeedback 处理订阅者的 RTCP 反馈
+func (r *RelayRoom) handleRTCPFeedback(peerID string, fb RTCPFeedback) {
+	switch fb.Type {
+	case RTCPFeedbackPLI, RTCPFeedbackFIR:
+		// 节流关键帧请求，每隔 300ms 最多向上游转发一次
+		r.mu.Lock()
+		now := time.Now()
+		if now.Sub(r.lastPLIRequest) <= 300*time.Millisecond {
+			r.mu.Unlock()
+			break
+		}
+		r.lastPLIRequest = now
+		r.mu.Unlock()
+		utils.Info("[RelayRoom] %s received from subscriber %s, requesting keyframe from SFU", fb.Type, peerID)
+		r.emitKeyframeRequest()
+
+	case RTCPFeedbackReceiverReport, RTCPFeedbackREMB:
+		r.mu.RLock()
+		sub := r.subscribers[peerID]
+		r.mu.RUnlock()
+		if sub == nil {
+			break
+		}
+		if fb.Type == RTCPFeedbackREMB {
+			sub.rembBps.Store(fb.Bitrate)
+			break
+		}
+		sub.mu.RLock()
+		videoSender := sub.videoSender
+		sub.mu.RUnlock()
+		if ssrc, ok := senderSSRC(videoSender); ok && ssrc == fb.MediaSSRC {
+			sub.fractionLost.Store(uint32(fb.FractionLost))
 		}
 	}
+
+	r.mu.RLock()
+	fn := r.onRTCPFeedback
+	r.mu.RUnlock()
+	if fn != nil {
+		fn(r.id, peerID, fb)
+	}
 }
 
 // 回调触发函数
@@ -812,6 +1257,15 @@ func (r *RelayRoom) emitError(peerID string, err error) {
 	}
 }
 
+func (r *RelayRoom) emitControlOpen(peerID string) {
+	r.mu.RLock()
+	fn := r.onControlOpen
+	r.mu.RUnlock()
+	if fn != nil {
+		fn(r.id, peerID)
+	}
+}
+
 func (r *RelayRoom) emitKeyframeRequest() {
 	r.mu.RLock()
 	fn := r.onKeyframeRequest
@@ -827,21 +1281,35 @@ func (r *RelayRoom) emitKeyframeRequest() {
 
 // SubscriberInfo 订阅者信息
 type SubscriberInfo struct {
-	ID           string `json:"id"`
-	State        string `json:"state"`
-	BytesSent    uint64 `json:"bytes_sent"`
-	PacketsSent  uint64 `json:"packets_sent"`
-	LastActivity int64  `json:"last_activity"`
+	ID           string  `json:"id"`
+	State        string  `json:"state"`
+	BytesSent    uint64  `json:"bytes_sent"`
+	PacketsSent  uint64  `json:"packets_sent"`
+	LastActivity int64   `json:"last_activity"`
+	VideoMode    string  `json:"video_mode"`
+	FractionLost float64 `json:"fraction_lost"`      // 视频 RR 丢包率（0~1）
+	RembBps      uint64  `json:"remb_bps,omitempty"` // 订阅者 REMB 带宽估计
+
+	ControlChannel *ControlChannelStats `json:"control_channel,omitempty"`
 }
 
 // RelayRoomStatus 房间状态
 type RelayRoomStatus struct {
-	RoomID          string           `json:"room_id"`
-	IsRelay         bool             `json:"is_relay"`
-	RelayPeerID     string           `json:"relay_peer_id,omitempty"`
-	SubscriberCount int              `json:"subscriber_count"`
-	Subscribers     []SubscriberInfo `json:"subscribers"`
-	SourceSwitcher  interface{}      `json:"source_switcher,omitempty"`
+	RoomID           string                `json:"room_id"`
+	IsRelay          bool                  `json:"is_relay"`
+	LANMode          bool                  `json:"lan_mode"`
+	RelayPeerID      string                `json:"relay_peer_id,omitempty"`
+	SubscriberCount  int                   `json:"subscriber_count"`
+	Subscribers      []SubscriberInfo      `json:"subscribers"`
+	SourceSwitcher   interface{}           `json:"source_switcher,omitempty"`
+	FEC              *FECStats             `json:"fec,omitempty"`
+	Bandwidth        *BandwidthStats       `json:"bandwidth,omitempty"`
+	WarmPool         *WarmPoolStats        `json:"warm_pool,omitempty"`
+	Memory           *MemoryGovernorStats  `json:"memory,omitempty"`
+	Certificate      *CertificatePoolStats `json:"certificate,omitempty"`
+	RTCP             *RTCPStats            `json:"rtcp,omitempty"`
+	SenderReports    *SenderReportStats    `json:"sender_reports,omitempty"`
+	HeaderExtensions *HeaderExtensionStats `json:"header_extensions,omitempty"`
 }
 
 // GetStatus 获取房间状态
@@ -852,27 +1320,78 @@ func (r *RelayRoom) GetStatus() RelayRoomStatus {
 	status := RelayRoomStatus{
 		RoomID:          r.id,
 		IsRelay:         r.isRelay,
+		LANMode:         r.lanMode != nil,
 		RelayPeerID:     r.relayPeerID,
 		SubscriberCount: len(r.subscribers),
 		Subscribers:     make([]SubscriberInfo, 0, len(r.subscribers)),
 	}
 
+	accountant := r.bandwidthAccountant()
 	for _, sub := range r.subscribers {
+		// 订阅者共享同一个 Track，发送量由流量核算按连接区间计算
+		bytesSent, packetsSent := accountant.SubscriberUsage(sub.id)
+		atomic.StoreUint64(&sub.bytesSent, bytesSent)
+		atomic.StoreUint64(&sub.packetsSent, packetsSent)
+
 		sub.mu.RLock()
-		status.Subscribers = append(status.Subscribers, SubscriberInfo{
+		info := SubscriberInfo{
 			ID:           sub.id,
 			State:        sub.state.String(),
-			BytesSent:    atomic.LoadUint64(&sub.bytesSent),
-			PacketsSent:  atomic.LoadUint64(&sub.packetsSent),
+			BytesSent:    bytesSent,
+			PacketsSent:  packetsSent,
 			LastActivity: sub.lastActivity.Unix(),
-		})
+			VideoMode:    sub.videoMode.String(),
+			FractionLost: float64(sub.fractionLost.Load()) / 256,
+			RembBps:      sub.rembBps.Load(),
+		}
+		if sub.control != nil {
+			controlStats := sub.control.GetStats()
+			info.ControlChannel = &controlStats
+		}
 		sub.mu.RUnlock()
+		status.Subscribers = append(status.Subscribers, info)
 	}
 
 	if r.switcher != nil {
 		status.SourceSwitcher = r.switcher.GetStatus()
 	}
 
+	if r.fec != nil {
+		fecStats := r.fec.GetStats()
+		status.FEC = &fecStats
+	}
+
+	bandwidth := accountant.GetStats()
+	status.Bandwidth = &bandwidth
+
+	if r.warmPool != nil {
+		warmPoolStats := r.warmPool.GetStats()
+		status.WarmPool = &warmPoolStats
+	}
+
+	if r.memory != nil {
+		memoryStats := r.memory.GetStats()
+		status.Memory = &memoryStats
+	}
+
+	if r.certificates != nil {
+		certificateStats := r.certificates.GetStats()
+		status.Certificate = &certificateStats
+	}
+
+	rtcpStats := r.rtcp.GetStats()
+	status.RTCP = &rtcpStats
+
+	if r.senderReports != nil {
+		senderReportStats := r.senderReports.GetStats()
+		status.SenderReports = &senderReportStats
+	}
+
+	if r.headerExtensions != nil {
+		headerExtensionStats := r.headerExtensions.GetStats()
+		status.HeaderExtensions = &headerExtensionStats
+	}
+
 	return status
 }
 
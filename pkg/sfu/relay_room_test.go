@@ -164,6 +164,35 @@ func TestRelayRoomClose(t *testing.T) {
 	room.Close()
 }
 
+// TestRelayRoomFailedJoinCleansUp 协商失败的订阅者不残留 RTCP 分发和 FEC 登记
+func TestRelayRoomFailedJoinCleansUp(t *testing.T) {
+	room, err := NewRelayRoom("test-room", nil)
+	if err != nil {
+		t.Fatalf("Failed to create RelayRoom: %v", err)
+	}
+	defer room.Close()
+	room.BecomeRelay("relay-peer")
+
+	// 带 RED 的残缺 Offer：RED 负载类型能解析出来，但 SetRemoteDescription 失败
+	offer := "m=audio 9 UDP/TLS/RTP/SAVPF 63\r\na=rtpmap:63 red/48000/2\r\n"
+	if _, err := room.AddSubscriber("bad-peer", offer); err == nil {
+		t.Fatal("Expected the malformed offer to be rejected")
+	}
+
+	room.rtcp.mu.RLock()
+	tracked := len(room.rtcp.peers)
+	room.rtcp.mu.RUnlock()
+	room.fec.mu.RLock()
+	red := len(room.fec.redPayloadTypes)
+	room.fec.mu.RUnlock()
+	if tracked != 0 || red != 0 {
+		t.Errorf("Failed join left %d RTCP and %d FEC entries", tracked, red)
+	}
+	if room.GetSubscriberCount() != 0 {
+		t.Errorf("Failed join should not register a subscriber")
+	}
+}
+
 // ==========================================
 // Benchmarks
 // ==========================================
@@ -0,0 +1,292 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * RTCP Dispatch - 订阅者 RTCP 反馈分发
+ * 作为 interceptor 注册在 RelayRoom 的 API 上，在 RTCP 读取路径上就地解析整个复合包（不分配内存），
+ * 按类型（PLI / FIR / NACK / REMB / TWCC / RR）分发给房间级处理函数。
+ * 订阅者复合包中排在 SR/RR 后面的 PLI 也能被识别。
+ *
+ * pion 的 RTCP 是按需读取的：sender.Read 被调用时数据才流经 interceptor，
+ * 所以每个 sender 仍需要一个只负责拉取的 goroutine，解析和分发都在这里完成。
+ * 反馈通过本端发送 SSRC 关联到订阅者（Track / Forget 维护）。
+ */
+package sfu
+
+import (
+	"encoding/binary"
+	"sync"
+	"sync/atomic"
+
+	"github.com/pion/interceptor"
+)
+
+const (
+	rtcpTypeRTPFB = 205 // 传输层反馈
+	rtcpTypePSFB  = 206 // 负载相关反馈
+
+	rtcpFmtNACK = 1  // RTPFB: Generic NACK
+	rtcpFmtTWCC = 15 // RTPFB: Transport-wide CC
+	rtcpFmtPLI  = 1  // PSFB: Picture Loss Indication
+	rtcpFmtFIR  = 4  // PSFB: Full Intra Request
+	rtcpFmtAFB  = 15 // PSFB: Application Layer Feedback（REMB）
+)
+
+// RTCPFeedbackType 反馈类型
+type RTCPFeedbackType int
+
+const (
+	RTCPFeedbackPLI RTCPFeedbackType = iota + 1
+	RTCPFeedbackFIR
+	RTCPFeedbackNACK
+	RTCPFeedbackREMB
+	RTCPFeedbackTWCC
+	RTCPFeedbackReceiverReport
+)
+
+func (t RTCPFeedbackType) String() string {
+	switch t {
+	case RTCPFeedbackPLI:
+		return "pli"
+	case RTCPFeedbackFIR:
+		return "fir"
+	case RTCPFeedbackNACK:
+		return "nack"
+	case RTCPFeedbackREMB:
+		return "remb"
+	case RTCPFeedbackTWCC:
+		return "twcc"
+	case RTCPFeedbackReceiverReport:
+		return "rr"
+	default:
+		return "unknown"
+	}
+}
+
+// RTCPFeedback 一条解析后的反馈
+type RTCPFeedback struct {
+	Type RTCPFeedbackType
+	// 反馈针对的媒体 SSRC（本端发送 SSRC）
+	MediaSSRC uint32
+	// RR：丢包率（0~255 表示 0~100%）和抖动
+	FractionLost uint8
+	Jitter       uint32
+	// NACK：请求重传的包数
+	Lost int
+	// REMB：接收端估计带宽（bps）
+	Bitrate uint64
+}
+
+// ParseRTCPFeedback 遍历复合 RTCP 包，逐条回调（不分配内存）
+// 返回 false 表示包格式错误（错误之前已解析的反馈仍会回调）
+func ParseRTCPFeedback(buf []byte, fn func(fb RTCPFeedback)) bool {
+	for len(buf) > 0 {
+		if len(buf) < 4 || buf[0]>>6 != 2 {
+			return false
+		}
+		count := int(buf[0] & 0x1f) // RC 或 FMT
+		pt := buf[1]
+		length := (int(binary.BigEndian.Uint16(buf[2:])) + 1) * 4
+		if length > len(buf) {
+			return false
+		}
+		packet := buf[:length]
+		buf = buf[length:]
+
+		switch pt {
+		case rtcpTypeSR, rtcpTypeRR:
+			offset := 8
+			if pt == rtcpTypeSR {
+				offset = 28
+			}
+			if len(packet) < offset {
+				return false
+			}
+			blocks := packet[offset:]
+			for j := 0; j < count && len(blocks) >= 24; j++ {
+				fn(RTCPFeedback{
+					Type:         RTCPFeedbackReceiverReport,
+					MediaSSRC:    binary.BigEndian.Uint32(blocks[0:]),
+					FractionLost: blocks[4],
+					Jitter:       binary.BigEndian.Uint32(blocks[12:]),
+				})
+				blocks = blocks[24:]
+			}
+
+		case rtcpTypeRTPFB:
+			if len(packet) < 12 {
+				return false
+			}
+			mediaSSRC := binary.BigEndian.Uint32(packet[8:])
+			switch count {
+			case rtcpFmtNACK:
+				lost := 0
+				for fci := packet[12:]; len(fci) >= 4; fci = fci[4:] {
+					lost += 1 + bitCount16(binary.BigEndian.Uint16(fci[2:]))
+				}
+				fn(RTCPFeedback{Type: RTCPFeedbackNACK, MediaSSRC: mediaSSRC, Lost: lost})
+			case rtcpFmtTWCC:
+				fn(RTCPFeedback{Type: RTCPFeedbackTWCC, MediaSSRC: mediaSSRC})
+			}
+
+		case rtcpTypePSFB:
+			if len(packet) < 12 {
+				return false
+			}
+			mediaSSRC := binary.BigEndian.Uint32(packet[8:])
+			switch count {
+			case rtcpFmtPLI:
+				fn(RTCPFeedback{Type: RTCPFeedbackPLI, MediaSSRC: mediaSSRC})
+			case rtcpFmtFIR:
+				// FIR 的媒体 SSRC 在每个 FCI 条目中
+				for fci := packet[12:]; len(fci) >= 8; fci = fci[8:] {
+					fn(RTCPFeedback{Type: RTCPFeedbackFIR, MediaSSRC: binary.BigEndian.Uint32(fci)})
+				}
+			case rtcpFmtAFB:
+				// REMB: "REMB" + SSRC 数(1) + BR Exp(6 bit) + BR Mantissa(18 bit) + SSRC 列表
+				fci := packet[12:]
+				if len(fci) < 8 || string(fci[:4]) != "REMB" {
+					continue
+				}
+				num := int(fci[4])
+				exp := fci[5] >> 2
+				mantissa := uint64(fci[5]&0x03)<<16 | uint64(fci[6])<<8 | uint64(fci[7])
+				bitrate := mantissa << exp
+				ssrcs := fci[8:]
+				for j := 0; j < num && len(ssrcs) >= 4; j++ {
+					fn(RTCPFeedback{Type: RTCPFeedbackREMB, MediaSSRC: binary.BigEndian.Uint32(ssrcs), Bitrate: bitrate})
+					ssrcs = ssrcs[4:]
+				}
+			}
+		}
+	}
+	return true
+}
+
+func bitCount16(v uint16) int {
+	n := 0
+	for ; v != 0; v &= v - 1 {
+		n++
+	}
+	return n
+}
+
+// RTCPStats RTCP 反馈统计
+type RTCPStats struct {
+	Packets   uint64 `json:"packets"` // 复合包数
+	Malformed uint64 `json:"malformed"`
+	PLI       uint64 `json:"pli"`
+	FIR       uint64 `json:"fir"`
+	NACK      uint64 `json:"nack"`
+	NACKLost  uint64 `json:"nack_lost"` // NACK 请求重传的包数
+	REMB      uint64 `json:"remb"`
+	TWCC      uint64 `json:"twcc"`
+	RR        uint64 `json:"rr"`
+}
+
+// RTCPDispatcher 房间级 RTCP 反馈分发（实现 interceptor.Factory，所有订阅者 PeerConnection 共享）
+type RTCPDispatcher struct {
+	mu sync.RWMutex
+
+	// 本端发送 SSRC -> 订阅者 ID
+	peers map[uint32]string
+
+	handler func(peerID string, fb RTCPFeedback)
+
+	packets   atomic.Uint64
+	malformed atomic.Uint64
+	counts    [RTCPFeedbackReceiverReport + 1]atomic.Uint64
+	nackLost  atomic.Uint64
+}
+
+// NewRTCPDispatcher 创建分发器
+func NewRTCPDispatcher() *RTCPDispatcher {
+	return &RTCPDispatcher{
+		peers: make(map[uint32]string),
+	}
+}
+
+// SetHandler 设置反馈处理函数（在 RTCP 读取协程中调用，不应阻塞）
+func (d *RTCPDispatcher) SetHandler(fn func(peerID string, fb RTCPFeedback)) {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	d.handler = fn
+}
+
+// Track 记录订阅者 sender 的发送 SSRC
+func (d *RTCPDispatcher) Track(ssrc uint32, peerID string) {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	d.peers[ssrc] = peerID
+}
+
+// Forget 订阅者离开时清理
+func (d *RTCPDispatcher) Forget(ssrc uint32) {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	delete(d.peers, ssrc)
+}
+
+// Dispatch 解析一个复合 RTCP 包并分发
+func (d *RTCPDispatcher) Dispatch(buf []byte) {
+	d.packets.Add(1)
+
+	d.mu.RLock()
+	handler := d.handler
+	d.mu.RUnlock()
+
+	if !ParseRTCPFeedback(buf, func(fb RTCPFeedback) {
+		d.counts[fb.Type].Add(1)
+		if fb.Type == RTCPFeedbackNACK {
+			d.nackLost.Add(uint64(fb.Lost))
+		}
+		if handler == nil {
+			return
+		}
+		d.mu.RLock()
+		peerID := d.peers[fb.MediaSSRC]
+		d.mu.RUnlock()
+		handler(peerID, fb)
+	}) {
+		d.malformed.Add(1)
+	}
+}
+
+// GetStats 获取统计
+func (d *RTCPDispatcher) GetStats() RTCPStats {
+	return RTCPStats{
+		Packets:   d.packets.Load(),
+		Malformed: d.malformed.Load(),
+		PLI:       d.counts[RTCPFeedbackPLI].Load(),
+		FIR:       d.counts[RTCPFeedbackFIR].Load(),
+		NACK:      d.counts[RTCPFeedbackNACK].Load(),
+		NACKLost:  d.nackLost.Load(),
+		REMB:      d.counts[RTCPFeedbackREMB].Load(),
+		TWCC:      d.counts[RTCPFeedbackTWCC].Load(),
+		RR:        d.counts[RTCPFeedbackReceiverReport].Load(),
+	}
+}
+
+// NewInterceptor 实现 interceptor.Factory（每个 PeerConnection 调用一次）
+func (d *RTCPDispatcher) NewInterceptor(_ string) (interceptor.Interceptor, error) {
+	return &rtcpDispatchInterceptor{dispatcher: d}, nil
+}
+
+// rtcpDispatchInterceptor 在 RTCP 读取路径上分发反馈
+type rtcpDispatchInterceptor struct {
+	interceptor.NoOp
+
+	dispatcher *RTCPDispatcher
+}
+
+// BindRTCPReader 读到的每个复合包交给分发器
+func (i *rtcpDispatchInterceptor) BindRTCPReader(reader interceptor.RTCPReader) interceptor.RTCPReader {
+	return interceptor.RTCPReaderFunc(func(b []byte, a interceptor.Attributes) (int, interceptor.Attributes, error) {
+		n, attr, err := reader.Read(b, a)
+		if err == nil {
+			i.dispatcher.Dispatch(b[:n])
+		}
+		return n, attr, err
+	})
+}
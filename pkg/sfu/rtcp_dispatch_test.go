@@ -0,0 +1,140 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * RTCP Dispatch Tests
+ */
+package sfu
+
+import (
+	"testing"
+
+	"github.com/pion/rtcp"
+)
+
+func marshalRTCP(t testing.TB, packets ...rtcp.Packet) []byte {
+	t.Helper()
+	data, err := rtcp.Marshal(packets)
+	if err != nil {
+		t.Fatalf("Failed to marshal RTCP: %v", err)
+	}
+	return data
+}
+
+func TestParseRTCPFeedbackCompound(t *testing.T) {
+	// libwebrtc 的典型复合包：RR + SDES 在前，PLI 排在后面
+	data := marshalRTCP(t,
+		&rtcp.ReceiverReport{
+			SSRC: 1,
+			Reports: []rtcp.ReceptionReport{
+				{SSRC: 0x1111, FractionLost: 64, Jitter: 90},
+				{SSRC: 0x2222, FractionLost: 0},
+			},
+		},
+		&rtcp.SourceDescription{Chunks: []rtcp.SourceDescriptionChunk{{
+			Source: 1,
+			Items:  []rtcp.SourceDescriptionItem{{Type: rtcp.SDESCNAME, Text: "sub"}},
+		}}},
+		&rtcp.PictureLossIndication{SenderSSRC: 1, MediaSSRC: 0x1111},
+		&rtcp.FullIntraRequest{SenderSSRC: 1, FIR: []rtcp.FIREntry{{SSRC: 0x1111, SequenceNumber: 1}}},
+		&rtcp.TransportLayerNack{SenderSSRC: 1, MediaSSRC: 0x1111, Nacks: []rtcp.NackPair{
+			{PacketID: 100, LostPackets: 0b101}, // 100, 101, 103
+		}},
+		&rtcp.ReceiverEstimatedMaximumBitrate{SenderSSRC: 1, Bitrate: 1500000, SSRCs: []uint32{0x1111}},
+	)
+
+	var got []RTCPFeedback
+	if !ParseRTCPFeedback(data, func(fb RTCPFeedback) { got = append(got, fb) }) {
+		t.Fatal("Compound packet should parse")
+	}
+
+	want := []RTCPFeedbackType{
+		RTCPFeedbackReceiverReport, RTCPFeedbackReceiverReport,
+		RTCPFeedbackPLI, RTCPFeedbackFIR, RTCPFeedbackNACK, RTCPFeedbackREMB,
+	}
+	if len(got) != len(want) {
+		t.Fatalf("Expected %d feedbacks, got %+v", len(want), got)
+	}
+	for i, fb := range got {
+		if fb.Type != want[i] {
+			t.Errorf("Feedback %d: expected %s, got %s", i, want[i], fb.Type)
+		}
+	}
+	if got[0].MediaSSRC != 0x1111 || got[0].FractionLost != 64 || got[0].Jitter != 90 {
+		t.Errorf("Unexpected RR %+v", got[0])
+	}
+	if got[2].MediaSSRC != 0x1111 || got[3].MediaSSRC != 0x1111 {
+		t.Errorf("Unexpected PLI/FIR %+v %+v", got[2], got[3])
+	}
+	if got[4].Lost != 3 {
+		t.Errorf("Expected 3 NACKed packets, got %d", got[4].Lost)
+	}
+	// REMB 尾数 18 位，编码有精度损失
+	if got[5].Bitrate < 1490000 || got[5].Bitrate > 1500000 || got[5].MediaSSRC != 0x1111 {
+		t.Errorf("Unexpected REMB %+v", got[5])
+	}
+}
+
+func TestParseRTCPFeedbackMalformed(t *testing.T) {
+	pli := marshalRTCP(t, &rtcp.PictureLossIndication{SenderSSRC: 1, MediaSSRC: 2})
+
+	count := 0
+	// 长度字段超出缓冲区：前面完整的包仍然分发
+	data := append(append([]byte{}, pli...), 0x81, 0xc9, 0x00, 0x10)
+	if ParseRTCPFeedback(data, func(RTCPFeedback) { count++ }) {
+		t.Error("Truncated packet should be reported as malformed")
+	}
+	if count != 1 {
+		t.Errorf("Expected the leading PLI to be dispatched, got %d", count)
+	}
+
+	if ParseRTCPFeedback([]byte{0x00, 0xc9, 0x00, 0x00}, func(RTCPFeedback) {}) {
+		t.Error("Wrong RTCP version should be reported as malformed")
+	}
+}
+
+func TestRTCPDispatcherRoutesByPeer(t *testing.T) {
+	d := NewRTCPDispatcher()
+	d.Track(0x1111, "sub-1")
+	d.Track(0x2222, "sub-2")
+
+	var peers []string
+	d.SetHandler(func(peerID string, fb RTCPFeedback) {
+		if fb.Type == RTCPFeedbackPLI {
+			peers = append(peers, peerID)
+		}
+	})
+
+	d.Dispatch(marshalRTCP(t,
+		&rtcp.ReceiverReport{SSRC: 1},
+		&rtcp.PictureLossIndication{SenderSSRC: 1, MediaSSRC: 0x2222},
+	))
+	d.Forget(0x2222)
+	d.Dispatch(marshalRTCP(t, &rtcp.PictureLossIndication{SenderSSRC: 1, MediaSSRC: 0x2222}))
+	d.Dispatch([]byte{0x00})
+
+	if len(peers) != 2 || peers[0] != "sub-2" || peers[1] != "" {
+		t.Errorf("Unexpected routing %v", peers)
+	}
+	stats := d.GetStats()
+	if stats.Packets != 3 || stats.Malformed != 1 || stats.PLI != 2 {
+		t.Errorf("Unexpected stats %+v", stats)
+	}
+}
+
+func BenchmarkRTCPDispatch(b *testing.B) {
+	d := NewRTCPDispatcher()
+	d.Track(0x1111, "sub-1")
+	d.SetHandler(func(string, RTCPFeedback) {})
+	data := marshalRTCP(b,
+		&rtcp.ReceiverReport{SSRC: 1, Reports: []rtcp.ReceptionReport{{SSRC: 0x1111}}},
+		&rtcp.PictureLossIndication{SenderSSRC: 1, MediaSSRC: 0x1111},
+	)
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		d.Dispatch(data)
+	}
+}
@@ -0,0 +1,473 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * RTP Capture - RTP 抓包与回放
+ * 旁路记录 SourceSwitcher 收到的 RTP 包（含到达时间），用于离线复现现场问题
+ *
+ * 文件格式：经典 pcap（LINKTYPE_RAW），每个 RTP 包封装为 IPv4/UDP，
+ * 可直接用 Wireshark 打开（Decode As -> RTP）。
+ * 源类型和音视频类型编码在 UDP 目的端口中：
+ *   5004 = SFU 视频, 5006 = SFU 音频, 5008 = 本地视频, 5010 = 本地音频
+ */
+package sfu
+
+import (
+	"bufio"
+	"context"
+	"encoding/binary"
+	"errors"
+	"io"
+	"os"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	"github.com/maiguangyang/relay_core/pkg/utils"
+)
+
+const (
+	pcapMagicMicros   = 0xa1b2c3d4
+	pcapLinkTypeRaw   = 101
+	pcapGlobalHdrLen  = 24
+	pcapRecordHdrLen  = 16
+	captureIPHdrLen   = 20
+	captureUDPHdrLen  = 8
+	captureEncapLen   = captureIPHdrLen + captureUDPHdrLen
+	captureSnapLen    = LargeRTPBufferSize
+	captureSourcePort = 40000
+
+	capturePortSFUVideo   = 5004
+	capturePortSFUAudio   = 5006
+	capturePortLocalVideo = 5008
+	capturePortLocalAudio = 5010
+)
+
+// ErrInvalidCapture 抓包文件格式无效
+var ErrInvalidCapture = errors.New("invalid capture file")
+
+// RTPCaptureConfig 抓包配置
+type RTPCaptureConfig struct {
+	BufferPackets int           // 写入队列容量（满时丢弃新包，不阻塞转发路径）
+	FlushInterval time.Duration // 定期刷盘间隔
+}
+
+// DefaultRTPCaptureConfig 默认抓包配置
+func DefaultRTPCaptureConfig() RTPCaptureConfig {
+	return RTPCaptureConfig{
+		BufferPackets: 4096,
+		FlushInterval: time.Second,
+	}
+}
+
+// capturedPacket 队列中的待写入包（buf 来自全局 BufferPool）
+type capturedPacket struct {
+	at   int64 // UnixNano
+	port uint16
+	buf  []byte
+	n    int
+}
+
+// RTPCapture 后台流式抓包写入器
+// Capture 只做一次拷贝和非阻塞入队，磁盘 IO 全部在后台协程完成
+type RTPCapture struct {
+	mu sync.RWMutex
+
+	out    io.WriteCloser
+	w      *bufio.Writer
+	queue  chan capturedPacket
+	config RTPCaptureConfig
+	done   chan struct{}
+	err    error
+
+	// 统计
+	packetsCaptured atomic.Uint64
+	packetsDropped  atomic.Uint64
+	bytesWritten    atomic.Uint64
+
+	closed bool
+}
+
+// RTPCaptureStats 抓包统计
+type RTPCaptureStats struct {
+	PacketsCaptured uint64 `json:"packets_captured"`
+	PacketsDropped  uint64 `json:"packets_dropped"`
+	BytesWritten    uint64 `json:"bytes_written"`
+}
+
+// NewRTPCaptureFile 创建写入到文件的抓包器
+func NewRTPCaptureFile(path string, config RTPCaptureConfig) (*RTPCapture, error) {
+	f, err := os.Create(path)
+	if err != nil {
+		return nil, err
+	}
+	c, err := NewRTPCapture(f, config)
+	if err != nil {
+		f.Close()
+		return nil, err
+	}
+	return c, nil
+}
+
+// NewRTPCapture 创建抓包器并写入 pcap 文件头
+func NewRTPCapture(out io.WriteCloser, config RTPCaptureConfig) (*RTPCapture, error) {
+	if config.BufferPackets <= 0 {
+		config.BufferPackets = DefaultRTPCaptureConfig().BufferPackets
+	}
+	if config.FlushInterval <= 0 {
+		config.FlushInterval = DefaultRTPCaptureConfig().FlushInterval
+	}
+
+	c := &RTPCapture{
+		out:    out,
+		w:      bufio.NewWriterSize(out, 64*1024),
+		queue:  make(chan capturedPacket, config.BufferPackets),
+		config: config,
+		done:   make(chan struct{}),
+	}
+
+	var hdr [pcapGlobalHdrLen]byte
+	binary.LittleEndian.PutUint32(hdr[0:], pcapMagicMicros)
+	binary.LittleEndian.PutUint16(hdr[4:], 2) // version major
+	binary.LittleEndian.PutUint16(hdr[6:], 4) // version minor
+	binary.LittleEndian.PutUint32(hdr[16:], captureSnapLen)
+	binary.LittleEndian.PutUint32(hdr[20:], pcapLinkTypeRaw)
+	if _, err := c.w.Write(hdr[:]); err != nil {
+		return nil, err
+	}
+
+	go c.writeLoop()
+	return c, nil
+}
+
+// Capture 记录一个 RTP 包（热路径，非阻塞）
+// 队列满时直接丢弃并计数，绝不拖慢转发
+func (c *RTPCapture) Capture(source SourceType, isVideo bool, data []byte) {
+	if len(data) == 0 || len(data) > captureSnapLen-captureEncapLen {
+		return
+	}
+
+	var buf []byte
+	if len(data) <= DefaultRTPBufferSize {
+		buf = GetRTPBuffer()
+	} else {
+		buf = make([]byte, len(data))
+	}
+	n := copy(buf, data)
+	pkt := capturedPacket{
+		at:   time.Now().UnixNano(),
+		port: capturePort(source, isVideo),
+		buf:  buf,
+		n:    n,
+	}
+
+	c.mu.RLock()
+	if c.closed {
+		c.mu.RUnlock()
+		releaseCaptureBuffer(buf)
+		return
+	}
+	select {
+	case c.queue <- pkt:
+	default:
+		c.packetsDropped.Add(1)
+		releaseCaptureBuffer(buf)
+	}
+	c.mu.RUnlock()
+}
+
+// writeLoop 后台写入协程
+func (c *RTPCapture) writeLoop() {
+	defer close(c.done)
+
+	ticker := time.NewTicker(c.config.FlushInterval)
+	defer ticker.Stop()
+
+	for {
+		select {
+		case pkt, ok := <-c.queue:
+			if !ok {
+				return
+			}
+			c.writeRecord(pkt)
+		case <-ticker.C:
+			if c.err == nil {
+				c.err = c.w.Flush()
+			}
+		}
+	}
+}
+
+// writeRecord 写入一条 pcap 记录（伪造 IPv4/UDP 封装）
+func (c *RTPCapture) writeRecord(pkt capturedPacket) {
+	defer releaseCaptureBuffer(pkt.buf)
+
+	if c.err != nil {
+		c.packetsDropped.Add(1)
+		return
+	}
+
+	total := captureEncapLen + pkt.n
+	var hdr [pcapRecordHdrLen + captureEncapLen]byte
+	binary.LittleEndian.PutUint32(hdr[0:], uint32(pkt.at/int64(time.Second)))
+	binary.LittleEndian.PutUint32(hdr[4:], uint32(pkt.at%int64(time.Second)/int64(time.Microsecond)))
+	binary.LittleEndian.PutUint32(hdr[8:], uint32(total))
+	binary.LittleEndian.PutUint32(hdr[12:], uint32(total))
+
+	ip := hdr[pcapRecordHdrLen:]
+	ip[0] = 0x45 // IPv4, IHL=5
+	binary.BigEndian.PutUint16(ip[2:], uint16(total))
+	ip[8] = 64 // TTL
+	ip[9] = 17 // UDP
+	copy(ip[12:16], []byte{127, 0, 0, 1})
+	copy(ip[16:20], []byte{127, 0, 0, 1})
+	binary.BigEndian.PutUint16(ip[10:], ipv4Checksum(ip[:captureIPHdrLen]))
+
+	udp := ip[captureIPHdrLen:]
+	binary.BigEndian.PutUint16(udp[0:], captureSourcePort)
+	binary.BigEndian.PutUint16(udp[2:], pkt.port)
+	binary.BigEndian.PutUint16(udp[4:], uint16(captureUDPHdrLen+pkt.n))
+
+	if _, err := c.w.Write(hdr[:]); err != nil {
+		c.err = err
+		return
+	}
+	if _, err := c.w.Write(pkt.buf[:pkt.n]); err != nil {
+		c.err = err
+		return
+	}
+	c.packetsCaptured.Add(1)
+	c.bytesWritten.Add(uint64(len(hdr) + pkt.n))
+}
+
+// Stats 返回抓包统计
+func (c *RTPCapture) Stats() RTPCaptureStats {
+	return RTPCaptureStats{
+		PacketsCaptured: c.packetsCaptured.Load(),
+		PacketsDropped:  c.packetsDropped.Load(),
+		BytesWritten:    c.bytesWritten.Load(),
+	}
+}
+
+// Close 停止抓包，写完队列中剩余的包并关闭文件
+func (c *RTPCapture) Close() error {
+	c.mu.Lock()
+	if c.closed {
+		c.mu.Unlock()
+		return nil
+	}
+	c.closed = true
+	close(c.queue)
+	c.mu.Unlock()
+
+	<-c.done
+
+	err := c.err
+	if err == nil {
+		err = c.w.Flush()
+	}
+	if cerr := c.out.Close(); err == nil {
+		err = cerr
+	}
+	return err
+}
+
+// CapturedPacket 回放时读出的一个包
+type CapturedPacket struct {
+	Offset  time.Duration // 相对第一个包的到达时间
+	Source  SourceType
+	IsVideo bool
+	Data    []byte // 仅在下一次 Next 调用前有效
+}
+
+// RTPCaptureReader 顺序读取抓包文件
+type RTPCaptureReader struct {
+	r     *bufio.Reader
+	buf   []byte
+	first int64
+	start bool
+}
+
+// NewRTPCaptureReader 创建读取器并校验 pcap 文件头
+func NewRTPCaptureReader(r io.Reader) (*RTPCaptureReader, error) {
+	br := bufio.NewReaderSize(r, 64*1024)
+	var hdr [pcapGlobalHdrLen]byte
+	if _, err := io.ReadFull(br, hdr[:]); err != nil {
+		return nil, err
+	}
+	if binary.LittleEndian.Uint32(hdr[0:]) != pcapMagicMicros ||
+		binary.LittleEndian.Uint32(hdr[20:]) != pcapLinkTypeRaw {
+		return nil, ErrInvalidCapture
+	}
+	return &RTPCaptureReader{
+		r:   br,
+		buf: make([]byte, captureSnapLen),
+	}, nil
+}
+
+// Next 读取下一个包，文件结束时返回 io.EOF
+func (cr *RTPCaptureReader) Next() (CapturedPacket, error) {
+	var hdr [pcapRecordHdrLen]byte
+	if _, err := io.ReadFull(cr.r, hdr[:]); err != nil {
+		return CapturedPacket{}, err
+	}
+
+	at := int64(binary.LittleEndian.Uint32(hdr[0:]))*int64(time.Second) +
+		int64(binary.LittleEndian.Uint32(hdr[4:]))*int64(time.Microsecond)
+	inclLen := int(binary.LittleEndian.Uint32(hdr[8:]))
+	if inclLen < captureEncapLen || inclLen > len(cr.buf) {
+		return CapturedPacket{}, ErrInvalidCapture
+	}
+
+	record := cr.buf[:inclLen]
+	if _, err := io.ReadFull(cr.r, record); err != nil {
+		return CapturedPacket{}, ErrInvalidCapture
+	}
+
+	if !cr.start {
+		cr.first = at
+		cr.start = true
+	}
+
+	pkt := CapturedPacket{
+		Offset: time.Duration(at - cr.first),
+		Data:   record[captureEncapLen:],
+	}
+	switch binary.BigEndian.Uint16(record[captureIPHdrLen+2:]) {
+	case capturePortSFUVideo:
+		pkt.Source, pkt.IsVideo = SourceTypeSFU, true
+	case capturePortSFUAudio:
+		pkt.Source, pkt.IsVideo = SourceTypeSFU, false
+	case capturePortLocalVideo:
+		pkt.Source, pkt.IsVideo = SourceTypeLocal, true
+	case capturePortLocalAudio:
+		pkt.Source, pkt.IsVideo = SourceTypeLocal, false
+	default:
+		return CapturedPacket{}, ErrInvalidCapture
+	}
+	return pkt, nil
+}
+
+// PacketInjector 回放目标（SourceSwitcher / ProxyModeCoordinator 均满足）
+type PacketInjector interface {
+	InjectSFUPacket(isVideo bool, data []byte) error
+	InjectLocalPacket(isVideo bool, data []byte) error
+}
+
+// ReplayStats 回放统计
+type ReplayStats struct {
+	Packets  uint64        `json:"packets"`
+	Bytes    uint64        `json:"bytes"`
+	Errors   uint64        `json:"errors"`
+	Duration time.Duration `json:"duration"`
+}
+
+// ReplayCapture 将抓包文件重新注入目标
+// speed: 1 = 原速, >1 = 加速（如 4 表示 4 倍速）, <=0 = 不等待、全速注入
+func ReplayCapture(ctx context.Context, r io.Reader, target PacketInjector, speed float64) (stats ReplayStats, err error) {
+	cr, err := NewRTPCaptureReader(r)
+	if err != nil {
+		return stats, err
+	}
+
+	start := time.Now()
+	defer func() { stats.Duration = time.Since(start) }()
+
+	var timer *time.Timer
+	defer func() {
+		if timer != nil {
+			timer.Stop()
+		}
+	}()
+
+	for {
+		pkt, err := cr.Next()
+		if err == io.EOF {
+			return stats, nil
+		}
+		if err != nil {
+			return stats, err
+		}
+
+		if speed > 0 {
+			due := time.Duration(float64(pkt.Offset) / speed)
+			if wait := due - time.Since(start); wait > 0 {
+				if timer == nil {
+					timer = time.NewTimer(wait)
+				} else {
+					timer.Reset(wait)
+				}
+				select {
+				case <-ctx.Done():
+					return stats, ctx.Err()
+				case <-timer.C:
+				}
+			}
+		} else if err := ctx.Err(); err != nil {
+			return stats, err
+		}
+
+		var injectErr error
+		if pkt.Source == SourceTypeLocal {
+			injectErr = target.InjectLocalPacket(pkt.IsVideo, pkt.Data)
+		} else {
+			injectErr = target.InjectSFUPacket(pkt.IsVideo, pkt.Data)
+		}
+		if injectErr != nil {
+			stats.Errors++
+			if errors.Is(injectErr, ErrForwarderClosed) {
+				return stats, injectErr
+			}
+			continue
+		}
+		stats.Packets++
+		stats.Bytes += uint64(len(pkt.Data))
+	}
+}
+
+// ReplayCaptureFile 回放抓包文件到目标
+func ReplayCaptureFile(ctx context.Context, path string, target PacketInjector, speed float64) (ReplayStats, error) {
+	f, err := os.Open(path)
+	if err != nil {
+		return ReplayStats{}, err
+	}
+	defer f.Close()
+
+	stats, err := ReplayCapture(ctx, f, target, speed)
+	utils.Info("[Capture] Replayed %s: packets=%d, errors=%d, duration=%v", path, stats.Packets, stats.Errors, stats.Duration)
+	return stats, err
+}
+
+// capturePort 源类型 -> UDP 目的端口
+func capturePort(source SourceType, isVideo bool) uint16 {
+	if source == SourceTypeLocal {
+		if isVideo {
+			return capturePortLocalVideo
+		}
+		return capturePortLocalAudio
+	}
+	if isVideo {
+		return capturePortSFUVideo
+	}
+	return capturePortSFUAudio
+}
+
+// releaseCaptureBuffer 归还缓冲区（非池化的大包直接丢给 GC）
+func releaseCaptureBuffer(buf []byte) {
+	if cap(buf) == DefaultRTPBufferSize {
+		PutRTPBuffer(buf)
+	}
+}
+
+// ipv4Checksum 计算 IPv4 头校验和
+func ipv4Checksum(hdr []byte) uint16 {
+	var sum uint32
+	for i := 0; i+1 < len(hdr); i += 2 {
+		sum += uint32(hdr[i])<<8 | uint32(hdr[i+1])
+	}
+	for sum > 0xffff {
+		sum = (sum >> 16) + (sum & 0xffff)
+	}
+	return ^uint16(sum)
+}
@@ -0,0 +1,272 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * RTP Capture Tests
+ */
+package sfu
+
+import (
+	"bytes"
+	"context"
+	"io"
+	"os"
+	"path/filepath"
+	"sync"
+	"testing"
+	"time"
+)
+
+// nopWriteCloser 包装 bytes.Buffer
+type nopWriteCloser struct{ *bytes.Buffer }
+
+func (nopWriteCloser) Close() error { return nil }
+
+// recordingInjector 记录回放注入的包
+type recordingInjector struct {
+	mu      sync.Mutex
+	sfu     int
+	local   int
+	video   int
+	arrival []time.Time
+}
+
+func (r *recordingInjector) InjectSFUPacket(isVideo bool, data []byte) error {
+	r.record(true, isVideo)
+	return nil
+}
+
+func (r *recordingInjector) InjectLocalPacket(isVideo bool, data []byte) error {
+	r.record(false, isVideo)
+	return nil
+}
+
+func (r *recordingInjector) record(fromSFU, isVideo bool) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	if fromSFU {
+		r.sfu++
+	} else {
+		r.local++
+	}
+	if isVideo {
+		r.video++
+	}
+	r.arrival = append(r.arrival, time.Now())
+}
+
+func TestRTPCaptureRoundTrip(t *testing.T) {
+	var buf bytes.Buffer
+	capture, err := NewRTPCapture(nopWriteCloser{&buf}, DefaultRTPCaptureConfig())
+	if err != nil {
+		t.Fatalf("Failed to create capture: %v", err)
+	}
+
+	capture.Capture(SourceTypeSFU, true, createTestRTPPacket(1, 1200))
+	capture.Capture(SourceTypeSFU, false, createTestRTPPacket(2, 160))
+	capture.Capture(SourceTypeLocal, true, createTestRTPPacket(3, 900))
+	capture.Capture(SourceTypeLocal, false, createTestRTPPacket(4, 100))
+
+	if err := capture.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if stats := capture.Stats(); stats.PacketsCaptured != 4 || stats.PacketsDropped != 0 {
+		t.Fatalf("Unexpected stats: %+v", stats)
+	}
+
+	reader, err := NewRTPCaptureReader(&buf)
+	if err != nil {
+		t.Fatalf("Failed to open capture: %v", err)
+	}
+
+	expected := []struct {
+		source  SourceType
+		isVideo bool
+		seq     uint16
+		size    int
+	}{
+		{SourceTypeSFU, true, 1, 1200},
+		{SourceTypeSFU, false, 2, 160},
+		{SourceTypeLocal, true, 3, 900},
+		{SourceTypeLocal, false, 4, 100},
+	}
+	for i, want := range expected {
+		pkt, err := reader.Next()
+		if err != nil {
+			t.Fatalf("Packet %d: %v", i, err)
+		}
+		if pkt.Source != want.source || pkt.IsVideo != want.isVideo {
+			t.Errorf("Packet %d: got source=%v video=%v", i, pkt.Source, pkt.IsVideo)
+		}
+		if !bytes.Equal(pkt.Data, createTestRTPPacket(want.seq, want.size)) {
+			t.Errorf("Packet %d: payload mismatch", i)
+		}
+	}
+	if _, err := reader.Next(); err != io.EOF {
+		t.Errorf("Expected EOF, got %v", err)
+	}
+}
+
+func TestRTPCaptureInvalidFile(t *testing.T) {
+	if _, err := NewRTPCaptureReader(bytes.NewReader(make([]byte, 24))); err != ErrInvalidCapture {
+		t.Errorf("Expected ErrInvalidCapture, got %v", err)
+	}
+}
+
+func TestRTPCaptureDropsWhenFull(t *testing.T) {
+	pr, pw := io.Pipe()
+	defer pr.Close()
+
+	// 管道无人读取，后台协程会阻塞在第一次刷盘，队列随之填满
+	capture, err := NewRTPCapture(pw, RTPCaptureConfig{BufferPackets: 4, FlushInterval: time.Millisecond})
+	if err != nil {
+		t.Fatalf("Failed to create capture: %v", err)
+	}
+
+	pkt := createTestRTPPacket(1, 1200)
+	start := time.Now()
+	for i := 0; i < 1000; i++ {
+		capture.Capture(SourceTypeSFU, true, pkt)
+	}
+	if elapsed := time.Since(start); elapsed > 500*time.Millisecond {
+		t.Errorf("Capture blocked the caller: %v", elapsed)
+	}
+	if capture.Stats().PacketsDropped == 0 {
+		t.Error("Expected drops when the writer is stalled")
+	}
+
+	go io.Copy(io.Discard, pr)
+	capture.Close()
+}
+
+func TestReplayCaptureSpeed(t *testing.T) {
+	var buf bytes.Buffer
+	capture, _ := NewRTPCapture(nopWriteCloser{&buf}, DefaultRTPCaptureConfig())
+	for i := 0; i < 5; i++ {
+		capture.Capture(SourceTypeSFU, true, createTestRTPPacket(uint16(i), 500))
+		time.Sleep(20 * time.Millisecond)
+	}
+	capture.Capture(SourceTypeLocal, false, createTestRTPPacket(5, 100))
+	capture.Close()
+	data := buf.Bytes()
+
+	// 原速回放应接近录制时长
+	target := &recordingInjector{}
+	stats, err := ReplayCapture(context.Background(), bytes.NewReader(data), target, 1)
+	if err != nil {
+		t.Fatalf("Replay failed: %v", err)
+	}
+	if stats.Packets != 6 || target.sfu != 5 || target.local != 1 || target.video != 5 {
+		t.Fatalf("Unexpected replay result: stats=%+v sfu=%d local=%d video=%d",
+			stats, target.sfu, target.local, target.video)
+	}
+	if stats.Duration < 80*time.Millisecond {
+		t.Errorf("Original-speed replay too fast: %v", stats.Duration)
+	}
+
+	// 全速回放不应等待
+	fast, err := ReplayCapture(context.Background(), bytes.NewReader(data), &recordingInjector{}, 0)
+	if err != nil {
+		t.Fatalf("Max-speed replay failed: %v", err)
+	}
+	if fast.Duration >= stats.Duration/2 {
+		t.Errorf("Max-speed replay not faster: %v vs %v", fast.Duration, stats.Duration)
+	}
+
+	// 取消
+	ctx, cancel := context.WithCancel(context.Background())
+	cancel()
+	if _, err := ReplayCapture(ctx, bytes.NewReader(data), &recordingInjector{}, 1); err != context.Canceled {
+		t.Errorf("Expected context.Canceled, got %v", err)
+	}
+}
+
+func TestSourceSwitcherCapture(t *testing.T) {
+	switcher, err := NewSourceSwitcher("test-room")
+	if err != nil {
+		t.Fatalf("Failed to create SourceSwitcher: %v", err)
+	}
+	defer switcher.Close()
+
+	path := filepath.Join(t.TempDir(), "session.pcap")
+	if err := switcher.StartCapture(path, DefaultRTPCaptureConfig()); err != nil {
+		t.Fatalf("StartCapture failed: %v", err)
+	}
+
+	// 非活跃源的包同样被记录
+	for i := 0; i < 10; i++ {
+		switcher.InjectSFUPacket(true, createTestRTPPacket(uint16(i), 800))
+		switcher.InjectLocalPacket(false, createTestRTPPacket(uint16(i), 120))
+	}
+
+	stats, err := switcher.StopCapture()
+	if err != nil {
+		t.Fatalf("StopCapture failed: %v", err)
+	}
+	if stats.PacketsCaptured != 20 {
+		t.Errorf("Expected 20 captured packets, got %d", stats.PacketsCaptured)
+	}
+
+	// 回放到另一个 SourceSwitcher
+	replayTarget, _ := NewSourceSwitcher("replay-room")
+	defer replayTarget.Close()
+	replay, err := ReplayCaptureFile(context.Background(), path, replayTarget, 0)
+	if err != nil {
+		t.Fatalf("Replay failed: %v", err)
+	}
+	if replay.Packets != 20 {
+		t.Errorf("Expected 20 replayed packets, got %d", replay.Packets)
+	}
+	if sfuPackets, _ := replayTarget.Stats(); sfuPackets != 10 {
+		t.Errorf("Expected 10 forwarded SFU packets, got %d", sfuPackets)
+	}
+}
+
+// BenchmarkSourceSwitcherCaptureTap 开启抓包后的注入开销
+func BenchmarkSourceSwitcherCaptureTap(b *testing.B) {
+	switcher, _ := NewSourceSwitcher("bench-room")
+	defer switcher.Close()
+	switcher.StartCapture(filepath.Join(b.TempDir(), "bench.pcap"), DefaultRTPCaptureConfig())
+
+	packet := createTestRTPPacket(1, 1200)
+	b.ReportAllocs()
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		switcher.InjectSFUPacket(true, packet)
+	}
+}
+
+// BenchmarkReplayCapture 用真实会话驱动转发基准测试
+// RELAY_CAPTURE_FILE=/path/to/session.pcap go test -bench ReplayCapture ./pkg/sfu
+func BenchmarkReplayCapture(b *testing.B) {
+	path := os.Getenv("RELAY_CAPTURE_FILE")
+	if path == "" {
+		b.Skip("RELAY_CAPTURE_FILE not set")
+	}
+	data, err := os.ReadFile(path)
+	if err != nil {
+		b.Fatalf("Failed to read capture: %v", err)
+	}
+
+	room, err := NewRelayRoom("bench-replay", nil)
+	if err != nil {
+		b.Fatalf("Failed to create RelayRoom: %v", err)
+	}
+	defer room.Close()
+
+	b.SetBytes(int64(len(data)))
+	b.ReportAllocs()
+	b.ResetTimer()
+
+	var packets uint64
+	for i := 0; i < b.N; i++ {
+		stats, err := ReplayCapture(context.Background(), bytes.NewReader(data), room.GetSourceSwitcher(), 0)
+		if err != nil {
+			b.Fatalf("Replay failed: %v", err)
+		}
+		packets += stats.Packets
+	}
+	b.ReportMetric(float64(packets)/b.Elapsed().Seconds(), "pkts/s")
+}
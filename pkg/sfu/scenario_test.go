@@ -15,6 +15,11 @@ import (
 	"sync/atomic"
 	"testing"
 	"time"
+
+	"github.com/maiguangyang/relay_core/pkg/election"
+	"github.com/pion/logging"
+	"github.com/pion/transport/v3/vnet"
+	"github.com/pion/webrtc/v4"
 )
 
 // ==========================================
@@ -404,6 +409,238 @@ func TestScenario_LongRunningStability(t *testing.T) {
 	}
 }
 
+// ==========================================
+// 场景 6: 计划内 Relay 移交
+// 订阅者保留旧连接，先向继任者预协商，新连接收到关键帧后切换渲染，
+// 测量整个移交过程中订阅者渲染的最大帧间隔
+// ==========================================
+
+func TestScenario_PlannedHandoffNoFreeze(t *testing.T) {
+	if testing.Short() {
+		t.Skip("跳过虚拟网络移交测试")
+	}
+
+	const (
+		fps       = 30
+		maxFreeze = 100 * time.Millisecond // 30fps 帧间隔 33ms，留出调度抖动
+	)
+
+	wan, err := vnet.NewRouter(&vnet.RouterConfig{
+		CIDR:          "1.2.3.0/24",
+		LoggerFactory: logging.NewDefaultLoggerFactory(),
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	apiFor := func(ip string) *webrtc.API {
+		n, err := vnet.NewNet(&vnet.NetConfig{StaticIP: ip})
+		if err != nil {
+			t.Fatal(err)
+		}
+		if err := wan.AddNet(n); err != nil {
+			t.Fatal(err)
+		}
+		se := webrtc.SettingEngine{}
+		se.SetNet(n)
+		return webrtc.NewAPI(webrtc.WithSettingEngine(se))
+	}
+	apiA, apiB, apiSub := apiFor("1.2.3.4"), apiFor("1.2.3.5"), apiFor("1.2.3.6")
+	if err := wan.Start(); err != nil {
+		t.Fatal(err)
+	}
+	defer wan.Stop()
+
+	config := DefaultCoordinatorConfig()
+	config.HandoffDrain = 3 * time.Second
+	pmcA, err := NewProxyModeCoordinator("handoff-scenario", "relay-a", config)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer pmcA.Close()
+	pmcB, err := NewProxyModeCoordinator("handoff-scenario", "relay-b", config)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer pmcB.Close()
+	pmcA.SetRelayRoomOptions(WithWebRTCAPI(apiA))
+	pmcB.SetRelayRoomOptions(WithWebRTCAPI(apiB))
+
+	pmcA.AddPeer("relay-b", int(election.DeviceTypePC), int(election.ConnectionTypeEthernet), int(election.PowerStatePluggedIn))
+	pmcA.SetCurrentRelay("relay-a", 1)
+	pmcA.handleBecomeRelay()
+	pmcB.SetCurrentRelay("relay-a", 1)
+
+	// 上游模拟：30fps 单包帧；Relay 请求关键帧时下一帧为关键帧（模拟 LiveKit 响应 PLI）
+	var forceKey, upstreamB atomic.Bool
+	forceKey.Store(true)
+	requestKeyframe := func(roomID string) { forceKey.Store(true) }
+	pmcA.GetRelayRoom().SetKeyframeRequestCallback(requestKeyframe)
+
+	stop := make(chan struct{})
+	var wg sync.WaitGroup
+	wg.Add(1)
+	go func() {
+		defer wg.Done()
+		ticker := time.NewTicker(time.Second / fps)
+		defer ticker.Stop()
+		for seq := uint16(0); ; seq++ {
+			select {
+			case <-stop:
+				return
+			case <-ticker.C:
+			}
+			pkt := vp8FramePacket(seq, uint32(seq)*(90000/fps), forceKey.Swap(false))
+			pmcA.GetSourceSwitcher().InjectSFUPacket(true, pkt)
+			if upstreamB.Load() {
+				pmcB.GetSourceSwitcher().InjectSFUPacket(true, pkt)
+			}
+		}
+	}()
+	defer func() {
+		close(stop)
+		wg.Wait()
+	}()
+
+	// 订阅者渲染：每条连接从关键帧开始解码；继任者连接解码后切换渲染
+	var (
+		renderMu    sync.Mutex
+		rendering   = "relay-a"
+		synced      = map[string]bool{}
+		renderTimes []time.Time
+	)
+	switched := make(chan struct{})
+	render := func(source string) func(payload []byte) {
+		return func(payload []byte) {
+			renderMu.Lock()
+			defer renderMu.Unlock()
+			if !synced[source] {
+				if !IsKeyframe(webrtc.MimeTypeVP8, payload) {
+					return
+				}
+				synced[source] = true
+			}
+			if source != rendering {
+				if source != "relay-b" {
+					return
+				}
+				rendering = source
+				close(switched)
+			}
+			renderTimes = append(renderTimes, time.Now())
+		}
+	}
+	rendered := func() int {
+		renderMu.Lock()
+		defer renderMu.Unlock()
+		return len(renderTimes)
+	}
+
+	// 继任者订阅旧 Relay（与 Dart 层的 P2P 连接相同）：Handoff 经控制通道到达，接管声明经它送回
+	relayBToA, controlBToA := connectHandoffSubscriber(t, pmcA, apiB, "relay-b", func([]byte) {}, func(msg ControlMessage) {
+		pmcB.HandleRelayControl("relay-a", msg)
+	})
+	defer relayBToA.Close()
+	pmcB.SetRelayControlSender(func(relayID string, msg ControlMessage) error {
+		if relayID != "relay-a" {
+			return ErrControlChannelNotOpen
+		}
+		return controlBToA.Send(MarshalControlMessage(msg))
+	})
+
+	// 继任者的应用层：prepare 时连接上游（模拟 LiveKitBridge），之后接受订阅者预协商
+	prepared := make(chan struct{})
+	pmcB.SetOnEvent(func(event CoordinatorEvent) {
+		if event.Type != CoordinatorEventHandoff || event.Data["phase"] != "prepare" {
+			return
+		}
+		pmcB.GetRelayRoom().SetKeyframeRequestCallback(requestKeyframe)
+		upstreamB.Store(true)
+		close(prepared)
+	})
+
+	handoffs := make(chan ControlMessage, 1)
+	pcA, _ := connectHandoffSubscriber(t, pmcA, apiSub, "sub-1", render("relay-a"), func(msg ControlMessage) {
+		if msg.Type == ControlMessageHandoff {
+			select {
+			case handoffs <- msg:
+			default:
+			}
+		}
+	})
+	defer pcA.Close()
+	waitScenario(t, "subscriber rendering from relay-a", func() bool {
+		roomA := pmcA.GetRelayRoom()
+		return rendered() >= fps/2 && roomA.HasControlChannel("sub-1") && roomA.HasControlChannel("relay-b")
+	})
+
+	// 1. 旧 Relay 指定继任者，订阅者和继任者都经控制通道收到通知
+	successor, err := pmcA.StartHandoff("scenario")
+	if err != nil || successor != "relay-b" {
+		t.Fatalf("StartHandoff = %q, %v", successor, err)
+	}
+	var msg ControlMessage
+	select {
+	case msg = <-handoffs:
+	case <-time.After(2 * time.Second):
+		t.Fatal("Handoff not delivered over the control channel")
+	}
+	if msg.PeerID != "relay-b" || msg.Epoch != 2 {
+		t.Fatalf("Unexpected handoff message %+v", msg)
+	}
+
+	// 2. 继任者创建 RelayRoom 并连接上游后，订阅者保留旧连接向继任者预协商
+	select {
+	case <-prepared:
+	case <-time.After(2 * time.Second):
+		t.Fatal("Successor did not prepare")
+	}
+	pcB, _ := connectHandoffSubscriber(t, pmcB, apiSub, "sub-1", render("relay-b"), nil)
+	defer pcB.Close()
+
+	// 3. 新连接收到关键帧后切换渲染；继任者转发关键帧后接管，声明经控制通道送达旧 Relay
+	select {
+	case <-switched:
+	case <-time.After(10 * time.Second):
+		t.Fatal("Subscriber did not switch to relay-b")
+	}
+	waitScenario(t, "relay-b commit", pmcB.IsRelay)
+	waitScenario(t, "relay-a receiving the claim", func() bool { return !pmcA.IsRelay() })
+
+	// 4. 订阅者关闭旧连接，旧 Relay 在迁移完成（或 HandoffDrain 超时）后关闭
+	if pmcA.GetRelayRoom() == nil {
+		t.Fatal("Old relay closed before its subscriber switched")
+	}
+	pcA.Close()
+	waitScenario(t, "relay-a teardown", func() bool { return pmcA.GetRelayRoom() == nil })
+
+	before := rendered()
+	time.Sleep(500 * time.Millisecond)
+	if rendered()-before < fps/3 {
+		t.Errorf("Rendering stalled after handoff: %d frames in 500ms", rendered()-before)
+	}
+
+	renderMu.Lock()
+	var maxGap time.Duration
+	for i := 1; i < len(renderTimes); i++ {
+		if gap := renderTimes[i].Sub(renderTimes[i-1]); gap > maxGap {
+			maxGap = gap
+		}
+	}
+	frames := len(renderTimes)
+	renderMu.Unlock()
+
+	t.Logf("=== 计划内移交测试 ===")
+	t.Logf("渲染帧数: %d", frames)
+	t.Logf("最大帧间隔: %v", maxGap)
+
+	if maxGap > maxFreeze {
+		t.Errorf("移交期间画面冻结 %v (期望 < %v)", maxGap, maxFreeze)
+	}
+	if pmcA.IsRelay() || !pmcB.IsRelay() {
+		t.Error("relay-b should be the only relay after handoff")
+	}
+}
+
 // ==========================================
 // 辅助函数
 // ==========================================
@@ -440,3 +677,116 @@ func createTestRTPPacket(seq uint16, size int) []byte {
 
 	return packet
 }
+
+// handoffICERoutes 按订阅者分发 RelayRoom 的 ICE 候选（房间只有一个候选回调）
+var handoffICERoutes sync.Map // *RelayRoom -> *sync.Map(peerID -> func(webrtc.ICECandidateInit))
+
+// connectHandoffSubscriber 订阅者连接到 Coordinator 的 RelayRoom（带控制通道），每帧回调 onFrame
+func connectHandoffSubscriber(t *testing.T, pmc *ProxyModeCoordinator, api *webrtc.API, peerID string,
+	onFrame func(payload []byte), onControl func(msg ControlMessage)) (*webrtc.PeerConnection, *webrtc.DataChannel) {
+	t.Helper()
+
+	room := pmc.GetRelayRoom()
+	pc, err := api.NewPeerConnection(webrtc.Configuration{})
+	if err != nil {
+		t.Fatal(err)
+	}
+	pc.OnTrack(func(track *webrtc.TrackRemote, _ *webrtc.RTPReceiver) {
+		for {
+			pkt, _, err := track.ReadRTP()
+			if err != nil {
+				return
+			}
+			onFrame(pkt.Payload)
+		}
+	})
+
+	// Relay 端 Candidate 在设置 Answer 之前到达时先缓存
+	var (
+		iceMu     sync.Mutex
+		remoteSet bool
+		pending   []webrtc.ICECandidateInit
+	)
+	v, loaded := handoffICERoutes.LoadOrStore(room, &sync.Map{})
+	routes := v.(*sync.Map)
+	routes.Store(peerID, func(c webrtc.ICECandidateInit) {
+		iceMu.Lock()
+		defer iceMu.Unlock()
+		if !remoteSet {
+			pending = append(pending, c)
+			return
+		}
+		pc.AddICECandidate(c)
+	})
+	if !loaded {
+		room.SetCallbacks(nil, func(roomID, peerID string) {
+			pmc.HandleSubscriberLeft(peerID)
+		}, func(roomID, peerID string, c *webrtc.ICECandidate) {
+			if c == nil {
+				return
+			}
+			if route, ok := routes.Load(peerID); ok {
+				route.(func(webrtc.ICECandidateInit))(c.ToJSON())
+			}
+		}, nil, nil)
+	}
+
+	ordered := false
+	maxRetransmits := uint16(0)
+	dc, err := pc.CreateDataChannel(ControlChannelLabel, &webrtc.DataChannelInit{
+		Ordered:        &ordered,
+		MaxRetransmits: &maxRetransmits,
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	dc.OnMessage(func(m webrtc.DataChannelMessage) {
+		msg, err := UnmarshalControlMessage(m.Data)
+		if err != nil {
+			return
+		}
+		if msg.Type == ControlMessagePing {
+			msg.Type = ControlMessagePong
+			dc.Send(MarshalControlMessage(msg))
+			return
+		}
+		if onControl != nil {
+			onControl(msg)
+		}
+	})
+
+	pc.AddTransceiverFromKind(webrtc.RTPCodecTypeVideo, webrtc.RTPTransceiverInit{
+		Direction: webrtc.RTPTransceiverDirectionRecvonly,
+	})
+	offer, _ := pc.CreateOffer(nil)
+	gathered := webrtc.GatheringCompletePromise(pc)
+	pc.SetLocalDescription(offer)
+	<-gathered
+
+	answer, err := room.AddSubscriber(peerID, pc.LocalDescription().SDP)
+	if err != nil {
+		t.Fatalf("AddSubscriber failed: %v", err)
+	}
+	if err := pc.SetRemoteDescription(webrtc.SessionDescription{Type: webrtc.SDPTypeAnswer, SDP: answer}); err != nil {
+		t.Fatalf("SetRemoteDescription failed: %v", err)
+	}
+	iceMu.Lock()
+	remoteSet = true
+	for _, c := range pending {
+		pc.AddICECandidate(c)
+	}
+	iceMu.Unlock()
+	return pc, dc
+}
+
+// waitScenario 轮询等待条件成立
+func waitScenario(t *testing.T, what string, cond func() bool) {
+	t.Helper()
+	deadline := time.Now().Add(10 * time.Second)
+	for !cond() {
+		if time.Now().After(deadline) {
+			t.Fatalf("Timed out waiting for %s", what)
+		}
+		time.Sleep(20 * time.Millisecond)
+	}
+}
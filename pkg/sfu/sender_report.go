@@ -0,0 +1,472 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Sender Report - 下行 RTCP SR 生成
+ * SourceSwitcher 改写了输出 SN/TS，上游的 SR 不能直接转发；没有 SR 时接收端无法做音视频同步，
+ * 只能靠加大 jitter buffer 兜底。这里为每条输出轨道维护「输出 RTP 时间戳 -> 本地墙钟」的映射：
+ *
+ *   - 上游有 SR（LiveKit 桥接）时按 SR 换算包的采集时间，上游 NTP 时钟通过偏移估计换算到本地时钟
+ *   - 没有 SR（本地分享）时以第一个包的到达时间作为采集时间
+ *   - 切换源 / 输入 SSRC 变化 / 收到新的上游 SR 时，下一个包重新锚定映射
+ *
+ * SenderReportGenerator 作为 interceptor 注册在 RelayRoom 的 API 上，按映射为每个订阅者的每条轨道定时发送 SR。
+ */
+package sfu
+
+import (
+	"strings"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	"github.com/pion/interceptor"
+	"github.com/pion/rtcp"
+	"github.com/pion/rtp"
+)
+
+const (
+	// ntpEpochOffset NTP 纪元（1900）与 Unix 纪元（1970）相差的秒数
+	ntpEpochOffset = 2208988800
+
+	// clockOffsetResetThreshold 上游时钟偏移样本比当前估计大出这么多时认为上游换了时钟，直接重置
+	clockOffsetResetThreshold = time.Second
+	// clockOffsetFollowDivisor 偏移估计向较大样本缓慢跟随（时钟漂移），向较小样本立即收敛（时延最小）
+	clockOffsetFollowDivisor = 64
+)
+
+// toNTPTime 本地时间转换为 64 位 NTP 时间戳
+func toNTPTime(t time.Time) uint64 {
+	nsec := uint64(t.UnixNano())
+	sec := nsec / uint64(time.Second)
+	frac := (nsec - sec*uint64(time.Second)) << 32 / uint64(time.Second)
+	return (sec+ntpEpochOffset)<<32 | frac
+}
+
+// fromNTPTime 64 位 NTP 时间戳转换为本地时间
+func fromNTPTime(ntp uint64) time.Time {
+	sec := int64(ntp>>32) - ntpEpochOffset
+	nsec := int64((ntp & 0xffffffff) * uint64(time.Second) >> 32)
+	return time.Unix(sec, nsec)
+}
+
+// rtpTicks 时长换算为 RTP 时钟刻度（可为负，四舍五入，避免与 rtpDuration 往返时少一个刻度）
+func rtpTicks(d time.Duration, clockRate uint32) int64 {
+	sec := int64(d / time.Second)
+	rem := int64(d%time.Second) * int64(clockRate)
+	half := int64(time.Second / 2)
+	if rem < 0 {
+		half = -half
+	}
+	return sec*int64(clockRate) + (rem+half)/int64(time.Second)
+}
+
+// rtpDuration RTP 时钟刻度换算为时长（ticks 为有符号差值）
+func rtpDuration(ticks int32, clockRate uint32) time.Duration {
+	return time.Duration(int64(ticks) * int64(time.Second) / int64(clockRate))
+}
+
+// upstreamReport 上游最近一次 SR
+type upstreamReport struct {
+	ntp time.Time // 上游 NTP 时钟
+	rtp uint32
+}
+
+// SenderReportStats SR 生成统计
+type SenderReportStats struct {
+	ReportsSent     uint64 `json:"reports_sent"`
+	UpstreamReports uint64 `json:"upstream_reports"` // 收到的上游 SR 数
+	VideoRebases    uint64 `json:"video_rebases"`    // 视频映射重新锚定次数
+	AudioRebases    uint64 `json:"audio_rebases"`
+	VideoUpstream   bool   `json:"video_upstream"` // 当前视频映射来自上游 SR（否则为本地到达时间）
+	AudioUpstream   bool   `json:"audio_upstream"`
+	ClockOffsetMs   int64  `json:"clock_offset_ms"` // 上游 NTP 时钟到本地时钟的偏移（含单向时延）
+}
+
+// SenderReportClock 一个 SourceSwitcher 的音视频时间轴：记录上游 SR，维护两条输出轨道的映射
+// 音视频共用同一个上游时钟偏移估计，保证两条轨道换算到本地时钟后仍然对齐
+type SenderReportClock struct {
+	mu sync.RWMutex
+
+	// 输入 SSRC -> 最近的上游 SR
+	upstream map[uint32]upstreamReport
+
+	// 上游 NTP 时钟 -> 本地时钟
+	offset      time.Duration
+	offsetValid bool
+
+	video *MediaClock
+	audio *MediaClock
+
+	upstreamReports atomic.Uint64
+}
+
+// NewSenderReportClock 创建时间轴
+func NewSenderReportClock(videoClockRate, audioClockRate uint32) *SenderReportClock {
+	c := &SenderReportClock{
+		upstream: make(map[uint32]upstreamReport),
+	}
+	c.video = newMediaClock(c, videoClockRate)
+	c.audio = newMediaClock(c, audioClockRate)
+	return c
+}
+
+// Video 返回视频轨道的映射
+func (c *SenderReportClock) Video() *MediaClock {
+	return c.video
+}
+
+// Audio 返回音频轨道的映射
+func (c *SenderReportClock) Audio() *MediaClock {
+	return c.audio
+}
+
+// forMimeType 按编码类型选择映射（非音视频返回 nil）
+func (c *SenderReportClock) forMimeType(mimeType string) *MediaClock {
+	mimeType = strings.ToLower(mimeType)
+	switch {
+	case strings.HasPrefix(mimeType, "video/"):
+		return c.video
+	case strings.HasPrefix(mimeType, "audio/"):
+		return c.audio
+	default:
+		return nil
+	}
+}
+
+// ObserveSenderReport 记录上游 SR（输入 SSRC 的 NTP / RTP 时间戳对）
+func (c *SenderReportClock) ObserveSenderReport(ssrc uint32, ntpTime uint64, rtpTime uint32) {
+	c.observeSenderReport(ssrc, ntpTime, rtpTime, time.Now())
+}
+
+func (c *SenderReportClock) observeSenderReport(ssrc uint32, ntpTime uint64, rtpTime uint32, now time.Time) {
+	ntp := fromNTPTime(ntpTime)
+	sample := now.Sub(ntp)
+
+	c.mu.Lock()
+	c.upstream[ssrc] = upstreamReport{ntp: ntp, rtp: rtpTime}
+	switch {
+	case !c.offsetValid, sample < c.offset, sample-c.offset > clockOffsetResetThreshold:
+		c.offset = sample
+		c.offsetValid = true
+	default:
+		c.offset += (sample - c.offset) / clockOffsetFollowDivisor
+	}
+	c.mu.Unlock()
+
+	c.upstreamReports.Add(1)
+	c.video.markStaleFor(ssrc)
+	c.audio.markStaleFor(ssrc)
+}
+
+// ForgetSenderReports 上游轨道结束时清理
+func (c *SenderReportClock) ForgetSenderReports(ssrc uint32) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	delete(c.upstream, ssrc)
+}
+
+// captureTime 按上游 SR 换算输入包的采集时间（本地时钟）
+func (c *SenderReportClock) captureTime(ssrc, timestamp, clockRate uint32) (time.Time, bool) {
+	c.mu.RLock()
+	defer c.mu.RUnlock()
+	sr, ok := c.upstream[ssrc]
+	if !ok || clockRate == 0 {
+		return time.Time{}, false
+	}
+	return sr.ntp.Add(c.offset + rtpDuration(int32(timestamp-sr.rtp), clockRate)), true
+}
+
+// GetStats 获取统计（ReportsSent 由 SenderReportGenerator 填写）
+func (c *SenderReportClock) GetStats() SenderReportStats {
+	c.mu.RLock()
+	offset := c.offset
+	c.mu.RUnlock()
+
+	videoRebases, videoUpstream := c.video.stats()
+	audioRebases, audioUpstream := c.audio.stats()
+	return SenderReportStats{
+		UpstreamReports: c.upstreamReports.Load(),
+		VideoRebases:    videoRebases,
+		AudioRebases:    audioRebases,
+		VideoUpstream:   videoUpstream,
+		AudioUpstream:   audioUpstream,
+		ClockOffsetMs:   offset.Milliseconds(),
+	}
+}
+
+// MediaClock 一条输出轨道的「输出 RTP 时间戳 -> 本地墙钟」映射
+// 由 SourceSwitcher 在写包路径上锚定，由 SR interceptor 读取
+type MediaClock struct {
+	mu sync.RWMutex
+
+	parent    *SenderReportClock
+	clockRate uint32
+
+	anchorTs   uint32
+	anchorTime time.Time
+	valid      bool
+	upstream   bool
+	rebases    uint64
+
+	// 热路径只做两次原子读：当前输入 SSRC 未变且没有待处理的重新锚定时直接返回
+	ssrc  atomic.Uint32
+	stale atomic.Bool
+}
+
+func newMediaClock(parent *SenderReportClock, clockRate uint32) *MediaClock {
+	c := &MediaClock{parent: parent, clockRate: clockRate}
+	c.stale.Store(true)
+	return c
+}
+
+// SetClockRate 编码变化时更新时钟频率，下一个包重新锚定
+func (c *MediaClock) SetClockRate(clockRate uint32) {
+	if clockRate == 0 {
+		return
+	}
+	c.mu.Lock()
+	changed := c.clockRate != clockRate
+	c.clockRate = clockRate
+	c.mu.Unlock()
+	if changed {
+		c.stale.Store(true)
+	}
+}
+
+// MarkStale 下一个包重新锚定（切换源、SN/TS offset 重新计算时调用）
+func (c *MediaClock) MarkStale() {
+	c.stale.Store(true)
+}
+
+func (c *MediaClock) markStaleFor(ssrc uint32) {
+	if c.ssrc.Load() == ssrc {
+		c.stale.Store(true)
+	}
+}
+
+// Stale 返回输入 SSRC 的包是否需要重新锚定
+func (c *MediaClock) Stale(ssrc uint32) bool {
+	return c.stale.Load() || c.ssrc.Load() != ssrc
+}
+
+// Anchor 用一个已改写的包锚定映射：inTs 为输入时间戳，outTs 为输出时间戳
+// 有上游 SR 时采集时间按 SR 换算，否则取到达时间 now
+func (c *MediaClock) Anchor(ssrc, inTs, outTs uint32, now time.Time) {
+	// 先清标记：锚定期间到达的新 SR 会再次置位，不会丢失
+	c.ssrc.Store(ssrc)
+	c.stale.Store(false)
+
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	capture, upstream := c.parent.captureTime(ssrc, inTs, c.clockRate)
+	if !upstream {
+		capture = now
+	}
+	c.anchorTs = outTs
+	c.anchorTime = capture
+	c.valid = true
+	c.upstream = upstream
+	c.rebases++
+}
+
+// Project 返回输入包在当前输出时间轴上对应的时间戳（用于切换源时延续时间轴）
+func (c *MediaClock) Project(ssrc, inTs uint32, now time.Time) (uint32, bool) {
+	c.mu.RLock()
+	defer c.mu.RUnlock()
+	capture, ok := c.parent.captureTime(ssrc, inTs, c.clockRate)
+	if !ok {
+		capture = now
+	}
+	return c.timestampAtLocked(capture)
+}
+
+// TimestampAt 返回本地时间 t 对应的输出 RTP 时间戳
+func (c *MediaClock) TimestampAt(t time.Time) (uint32, bool) {
+	c.mu.RLock()
+	defer c.mu.RUnlock()
+	return c.timestampAtLocked(t)
+}
+
+func (c *MediaClock) timestampAtLocked(t time.Time) (uint32, bool) {
+	if !c.valid || c.clockRate == 0 {
+		return 0, false
+	}
+	return c.anchorTs + uint32(rtpTicks(t.Sub(c.anchorTime), c.clockRate)), true
+}
+
+// timeOf 返回输出 RTP 时间戳对应的本地时间（接收端按 SR 得到的采集时间）
+func (c *MediaClock) timeOf(ts uint32) (time.Time, bool) {
+	c.mu.RLock()
+	defer c.mu.RUnlock()
+	if !c.valid || c.clockRate == 0 {
+		return time.Time{}, false
+	}
+	return c.anchorTime.Add(rtpDuration(int32(ts-c.anchorTs), c.clockRate)), true
+}
+
+func (c *MediaClock) stats() (rebases uint64, upstream bool) {
+	c.mu.RLock()
+	defer c.mu.RUnlock()
+	return c.rebases, c.upstream
+}
+
+// SenderReportConfig SR 生成配置
+type SenderReportConfig struct {
+	// 发送间隔（接收端一般需要两个 SR 才能建立映射，间隔越短同步越快）
+	Interval time.Duration
+}
+
+// DefaultSenderReportConfig 返回默认配置
+func DefaultSenderReportConfig() SenderReportConfig {
+	return SenderReportConfig{
+		Interval: 1 * time.Second,
+	}
+}
+
+// SenderReportGenerator 房间级 SR 生成（实现 interceptor.Factory，所有订阅者 PeerConnection 共享）
+type SenderReportGenerator struct {
+	config SenderReportConfig
+	clock  *SenderReportClock
+
+	sent atomic.Uint64
+}
+
+// NewSenderReportGenerator 创建 SR 生成器
+func NewSenderReportGenerator(config SenderReportConfig, clock *SenderReportClock) *SenderReportGenerator {
+	if config.Interval <= 0 {
+		config.Interval = DefaultSenderReportConfig().Interval
+	}
+	return &SenderReportGenerator{
+		config: config,
+		clock:  clock,
+	}
+}
+
+// GetStats 获取统计
+func (g *SenderReportGenerator) GetStats() SenderReportStats {
+	stats := g.clock.GetStats()
+	stats.ReportsSent = g.sent.Load()
+	return stats
+}
+
+// NewInterceptor 实现 interceptor.Factory（每个 PeerConnection 调用一次）
+func (g *SenderReportGenerator) NewInterceptor(_ string) (interceptor.Interceptor, error) {
+	return &senderReportInterceptor{
+		generator: g,
+		streams:   make(map[uint32]*senderReportStream),
+		close:     make(chan struct{}),
+	}, nil
+}
+
+// senderReportStream 一个订阅者的一条发送流
+type senderReportStream struct {
+	ssrc    uint32
+	clock   *MediaClock
+	packets atomic.Uint32
+	octets  atomic.Uint32
+}
+
+// senderReportInterceptor 统计发送流的包数 / 字节数，定时按映射写出 SR
+type senderReportInterceptor struct {
+	interceptor.NoOp
+
+	generator *SenderReportGenerator
+
+	mu      sync.Mutex
+	streams map[uint32]*senderReportStream
+
+	close     chan struct{}
+	closeOnce sync.Once
+	wg        sync.WaitGroup
+}
+
+// BindRTCPWriter 启动定时发送
+func (i *senderReportInterceptor) BindRTCPWriter(writer interceptor.RTCPWriter) interceptor.RTCPWriter {
+	i.wg.Add(1)
+	go i.loop(writer)
+	return writer
+}
+
+// BindLocalStream 按编码类型关联音视频映射，统计发送计数
+func (i *senderReportInterceptor) BindLocalStream(info *interceptor.StreamInfo, writer interceptor.RTPWriter) interceptor.RTPWriter {
+	clock := i.generator.clock.forMimeType(info.MimeType)
+	if clock == nil {
+		return writer
+	}
+	stream := &senderReportStream{ssrc: info.SSRC, clock: clock}
+
+	i.mu.Lock()
+	i.streams[info.SSRC] = stream
+	i.mu.Unlock()
+
+	return interceptor.RTPWriterFunc(func(header *rtp.Header, payload []byte, a interceptor.Attributes) (int, error) {
+		stream.packets.Add(1)
+		stream.octets.Add(uint32(len(payload)))
+		return writer.Write(header, payload, a)
+	})
+}
+
+// UnbindLocalStream 移除发送流
+func (i *senderReportInterceptor) UnbindLocalStream(info *interceptor.StreamInfo) {
+	i.mu.Lock()
+	defer i.mu.Unlock()
+	delete(i.streams, info.SSRC)
+}
+
+// Close 停止定时发送
+func (i *senderReportInterceptor) Close() error {
+	i.closeOnce.Do(func() { close(i.close) })
+	i.wg.Wait()
+	return nil
+}
+
+func (i *senderReportInterceptor) loop(writer interceptor.RTCPWriter) {
+	defer i.wg.Done()
+
+	ticker := time.NewTicker(i.generator.config.Interval)
+	defer ticker.Stop()
+
+	var streams []*senderReportStream
+	for {
+		select {
+		case <-i.close:
+			return
+		case now := <-ticker.C:
+			streams = i.sendReports(writer, now, streams[:0])
+		}
+	}
+}
+
+// sendReports 为已经发过包的流写出 SR，返回复用的切片
+func (i *senderReportInterceptor) sendReports(writer interceptor.RTCPWriter, now time.Time, streams []*senderReportStream) []*senderReportStream {
+	i.mu.Lock()
+	for _, s := range i.streams {
+		streams = append(streams, s)
+	}
+	i.mu.Unlock()
+
+	ntpTime := toNTPTime(now)
+	for _, s := range streams {
+		packets := s.packets.Load()
+		if packets == 0 {
+			continue
+		}
+		rtpTime, ok := s.clock.TimestampAt(now)
+		if !ok {
+			continue
+		}
+		sr := &rtcp.SenderReport{
+			SSRC:        s.ssrc,
+			NTPTime:     ntpTime,
+			RTPTime:     rtpTime,
+			PacketCount: packets,
+			OctetCount:  s.octets.Load(),
+		}
+		if _, err := writer.Write([]rtcp.Packet{sr}, interceptor.Attributes{}); err == nil {
+			i.generator.sent.Add(1)
+		}
+	}
+	return streams
+}
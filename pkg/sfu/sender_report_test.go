@@ -0,0 +1,253 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Sender Report Tests
+ */
+package sfu
+
+import (
+	"fmt"
+	"testing"
+	"time"
+
+	"github.com/pion/interceptor"
+	"github.com/pion/rtcp"
+	"github.com/pion/rtp"
+)
+
+// syncTestTolerance 接收端按 SR 还原的采集时间允许的误差
+const syncTestTolerance = 5 * time.Millisecond
+
+// syncTestSource 模拟一个音视频源：RTP 时间戳按采集时间推进，视频可以比音频晚到
+type syncTestSource struct {
+	videoSSRC  uint32
+	audioSSRC  uint32
+	videoBase  uint32
+	audioBase  uint32
+	epoch      time.Time
+	videoDelay time.Duration // 视频比音频多出的网络时延
+
+	videoSeq uint16
+	audioSeq uint16
+}
+
+func (s *syncTestSource) packet(tb testing.TB, isVideo bool, capture time.Time) []byte {
+	tb.Helper()
+	header := rtp.Header{Version: 2}
+	if isVideo {
+		s.videoSeq++
+		header.PayloadType = 96
+		header.SequenceNumber = s.videoSeq
+		header.Timestamp = s.videoBase + uint32(rtpTicks(capture.Sub(s.epoch), 90000))
+		header.SSRC = s.videoSSRC
+	} else {
+		s.audioSeq++
+		header.PayloadType = 111
+		header.SequenceNumber = s.audioSeq
+		header.Timestamp = s.audioBase + uint32(rtpTicks(capture.Sub(s.epoch), 48000))
+		header.SSRC = s.audioSSRC
+	}
+	data, err := (&rtp.Packet{Header: header, Payload: make([]byte, 100)}).Marshal()
+	if err != nil {
+		tb.Fatal(err)
+	}
+	return data
+}
+
+// senderReports 发送端在 now 时刻发出的音视频 SR（发送端 NTP 时钟比本地快 ahead）
+func (s *syncTestSource) senderReports(clock *SenderReportClock, now time.Time, ahead time.Duration) {
+	ntp := toNTPTime(now.Add(ahead))
+	clock.observeSenderReport(s.videoSSRC, ntp, s.videoBase+uint32(rtpTicks(now.Sub(s.epoch), 90000)), now)
+	clock.observeSenderReport(s.audioSSRC, ntp, s.audioBase+uint32(rtpTicks(now.Sub(s.epoch), 48000)), now)
+}
+
+func TestNTPTimeRoundTrip(t *testing.T) {
+	now := time.Unix(1790000000, 123456789)
+	if got := fromNTPTime(toNTPTime(now)); got.Sub(now).Abs() > time.Microsecond {
+		t.Errorf("Expected %v, got %v", now, got)
+	}
+	if ticks := rtpTicks(-20*time.Millisecond, 48000); ticks != -960 {
+		t.Errorf("Expected -960 ticks, got %d", ticks)
+	}
+}
+
+// TestSenderReportSyncAcrossLocalShareCycles 反复切换 SFU / 本地分享，
+// 接收端按 SR 映射还原的音视频采集时间不随切换累积偏差
+func TestSenderReportSyncAcrossLocalShareCycles(t *testing.T) {
+	switcher, err := NewSourceSwitcher("sr-room")
+	if err != nil {
+		t.Fatalf("Failed to create SourceSwitcher: %v", err)
+	}
+	defer switcher.Close()
+	clock := switcher.GetSenderReportClock()
+
+	// 上游 NTP 时钟与本地不同步，视频比音频晚到 40ms：只有按 SR 换算才能对齐
+	const clockAhead = 7 * time.Second
+	sfu := &syncTestSource{
+		videoSSRC:  0x1001,
+		audioSSRC:  0x1002,
+		videoBase:  1000,
+		audioBase:  5000,
+		epoch:      time.Now(),
+		videoDelay: 40 * time.Millisecond,
+	}
+
+	var (
+		lastVideoSn uint16
+		lastVideoTs uint32
+		forwarded   int
+	)
+	run := func(phase string, src *syncTestSource, inject func(bool, []byte) error) {
+		var videoCapture, audioCapture time.Time
+		for step := 0; step < 12; step++ {
+			now := time.Now()
+			if step%2 == 0 {
+				audioCapture = now
+				inject(false, src.packet(t, false, audioCapture))
+			}
+			if step%3 == 0 {
+				videoCapture = now.Add(-src.videoDelay)
+				inject(true, src.packet(t, true, videoCapture))
+
+				// 输出 SN 连续、TS 不回滚
+				if forwarded > 0 {
+					if switcher.lastVideoSn != lastVideoSn+1 {
+						t.Errorf("%s: SN jumped from %d to %d", phase, lastVideoSn, switcher.lastVideoSn)
+					}
+					if int32(switcher.lastVideoTs-lastVideoTs) <= 0 {
+						t.Errorf("%s: TS went backwards from %d to %d", phase, lastVideoTs, switcher.lastVideoTs)
+					}
+				}
+				lastVideoSn, lastVideoTs = switcher.lastVideoSn, switcher.lastVideoTs
+				forwarded++
+			}
+			time.Sleep(10 * time.Millisecond)
+		}
+
+		videoAt, ok := clock.Video().timeOf(switcher.lastVideoTs)
+		if !ok {
+			t.Fatalf("%s: video clock not anchored", phase)
+		}
+		audioAt, ok := clock.Audio().timeOf(switcher.lastAudioTs)
+		if !ok {
+			t.Fatalf("%s: audio clock not anchored", phase)
+		}
+		videoErr := videoAt.Sub(videoCapture)
+		audioErr := audioAt.Sub(audioCapture)
+		if videoErr.Abs() > syncTestTolerance || audioErr.Abs() > syncTestTolerance {
+			t.Errorf("%s: capture time error video=%v audio=%v", phase, videoErr, audioErr)
+		}
+		if skew := videoErr - audioErr; skew.Abs() > syncTestTolerance {
+			t.Errorf("%s: A/V skew %v", phase, skew)
+		}
+	}
+
+	sfu.senderReports(clock, time.Now(), clockAhead)
+	run("sfu-0", sfu, switcher.InjectSFUPacket)
+
+	for cycle := 1; cycle <= 5; cycle++ {
+		// 本地分享：没有 SR，按本地采集（到达）时间锚定；每次分享都是新的 SSRC 和时间戳起点
+		local := &syncTestSource{
+			videoSSRC: 0x2000 + uint32(cycle)*2,
+			audioSSRC: 0x2001 + uint32(cycle)*2,
+			videoBase: uint32(cycle) * 0x10000000,
+			audioBase: uint32(cycle) * 0x01000000,
+			epoch:     time.Now(),
+		}
+		switcher.StartLocalShare(fmt.Sprintf("sharer-%d", cycle))
+		run(fmt.Sprintf("local-%d", cycle), local, switcher.InjectLocalPacket)
+		if stats := clock.GetStats(); stats.VideoUpstream || stats.AudioUpstream {
+			t.Errorf("local-%d: mapping should come from local capture clock, got %+v", cycle, stats)
+		}
+
+		switcher.StopLocalShare()
+		sfu.senderReports(clock, time.Now(), clockAhead)
+		run(fmt.Sprintf("sfu-%d", cycle), sfu, switcher.InjectSFUPacket)
+		if stats := clock.GetStats(); !stats.VideoUpstream || !stats.AudioUpstream {
+			t.Errorf("sfu-%d: mapping should come from upstream SR, got %+v", cycle, stats)
+		}
+	}
+
+	stats := clock.GetStats()
+	if stats.UpstreamReports != 12 || stats.VideoRebases < 11 || stats.AudioRebases < 11 {
+		t.Errorf("Unexpected stats %+v", stats)
+	}
+	// NTP 换算有亚纳秒截断，允许 1ms 误差
+	if diff := stats.ClockOffsetMs + clockAhead.Milliseconds(); diff < -1 || diff > 1 {
+		t.Errorf("Expected clock offset %dms, got %dms", -clockAhead.Milliseconds(), stats.ClockOffsetMs)
+	}
+}
+
+// fakeRTCPWriter 记录写出的 RTCP 包
+type fakeRTCPWriter struct {
+	packets []rtcp.Packet
+}
+
+func (w *fakeRTCPWriter) Write(packets []rtcp.Packet, _ interceptor.Attributes) (int, error) {
+	w.packets = append(w.packets, packets...)
+	return 0, nil
+}
+
+func TestSenderReportInterceptorWritesRewrittenSR(t *testing.T) {
+	clock := NewSenderReportClock(90000, 48000)
+	generator := NewSenderReportGenerator(DefaultSenderReportConfig(), clock)
+	i, err := generator.NewInterceptor("")
+	if err != nil {
+		t.Fatal(err)
+	}
+	sri := i.(*senderReportInterceptor)
+	defer sri.Close()
+
+	discard := interceptor.RTPWriterFunc(func(_ *rtp.Header, payload []byte, _ interceptor.Attributes) (int, error) {
+		return len(payload), nil
+	})
+	video := sri.BindLocalStream(&interceptor.StreamInfo{SSRC: 0xaaaa, MimeType: "video/VP8"}, discard)
+	sri.BindLocalStream(&interceptor.StreamInfo{SSRC: 0xbbbb, MimeType: "audio/opus"}, discard) // 还没发过包
+	sri.BindLocalStream(&interceptor.StreamInfo{SSRC: 0xcccc, MimeType: "application/x-test"}, discard)
+
+	// 输入时间戳 100 改写为 9000 后发出
+	base := time.Now()
+	clock.Video().Anchor(0x1234, 100, 9000, base)
+	for n := 0; n < 3; n++ {
+		video.Write(&rtp.Header{SSRC: 0xaaaa}, make([]byte, 100), nil)
+	}
+
+	writer := &fakeRTCPWriter{}
+	at := base.Add(500 * time.Millisecond)
+	sri.sendReports(writer, at, nil)
+
+	if len(writer.packets) != 1 {
+		t.Fatalf("Expected 1 SR, got %d", len(writer.packets))
+	}
+	sr, ok := writer.packets[0].(*rtcp.SenderReport)
+	if !ok {
+		t.Fatalf("Expected SenderReport, got %T", writer.packets[0])
+	}
+	if sr.SSRC != 0xaaaa || sr.PacketCount != 3 || sr.OctetCount != 300 {
+		t.Errorf("Unexpected SR %+v", sr)
+	}
+	// 500ms @ 90kHz：SR 的时间戳落在改写后的时间轴上
+	if sr.RTPTime != 9000+45000 {
+		t.Errorf("Expected RTP time %d, got %d", 9000+45000, sr.RTPTime)
+	}
+	if got := fromNTPTime(sr.NTPTime); got.Sub(at).Abs() > time.Microsecond {
+		t.Errorf("Expected NTP time %v, got %v", at, got)
+	}
+	if stats := generator.GetStats(); stats.ReportsSent != 1 || stats.VideoRebases != 1 {
+		t.Errorf("Unexpected stats %+v", stats)
+	}
+}
+
+func TestRelayRoomRegistersSenderReports(t *testing.T) {
+	room, err := NewRelayRoom("sr-room", nil)
+	if err != nil {
+		t.Fatalf("Failed to create RelayRoom: %v", err)
+	}
+	defer room.Close()
+
+	if room.GetStatus().SenderReports == nil {
+		t.Error("Built-in API should generate sender reports")
+	}
+}
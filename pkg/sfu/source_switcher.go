@@ -70,6 +70,7 @@ type SourceSwitcher struct {
 	lastVideoTs   uint32 // Output TS
 	videoSynced   bool   // 是否已同步过至少一个包
 	videoReset    bool   // 标记是否需要重置同步
+	lastVideoSSRC uint32 // 上一个转发的输入 SSRC，变化时重新计算 offset
 
 	audioSnOffset uint16
 	audioTsOffset uint32
@@ -77,6 +78,32 @@ type SourceSwitcher struct {
 	lastAudioTs   uint32
 	audioSynced   bool
 	audioReset    bool
+	lastAudioSSRC uint32 // 上一个转发的输入 SSRC，变化时重新计算 offset
+	lastAudioWall time.Time
+
+	// 输出 RTP 时间戳 -> 墙钟映射（下行 SR 使用）
+	reports *SenderReportClock
+
+	// 扩展头改写：上游 ID -> 房间内部 ID，下标为 [SourceType][isVideo]（nil 表示全部剥离，本地分享默认按内部 ID 保留）
+	rewriteExtensions atomic.Bool
+	extensionMaps     [2][2]atomic.Pointer[HeaderExtensionMap]
+
+	// 静音抑制（DTX / 舒适噪声 / -127dBov 帧）
+	suppressSilence    atomic.Bool
+	audioSilentPackets uint64
+	audioSuppressed    uint64
+
+	// 活跃发言者检测（多路上游音频只转发主发言者）
+	audioLevels *AudioLevelObserver
+
+	// 输出平滑（nil 表示关闭）
+	pacer *Pacer
+
+	// 公网 / 局域网流量核算
+	bandwidth *BandwidthAccountant
+
+	// 内存预算：压力过高时丢弃非参考帧
+	memory *MemoryGovernor
 
 	// 统计
 	packetsFromSFU   uint64
@@ -85,6 +112,12 @@ type SourceSwitcher struct {
 	// 下游错误日志节流
 	lastWriteErrorTime int64 // UnixNano, atomic
 
+	// 可选抓包旁路（nil 表示未开启）
+	capture atomic.Pointer[RTPCapture]
+
+	// 等待下一个视频关键帧（nil 表示无人等待，热路径只做一次原子读）
+	keyframeWaiter atomic.Pointer[chan struct{}]
+
 	// 回调
 	onSourceChanged func(roomID string, sourceType SourceType, sharerID string)
 	onTrackChanged  func(videoTrack, audioTrack *webrtc.TrackLocalStaticRTP)
@@ -115,11 +148,21 @@ func NewSourceSwitcher(roomID string) (*SourceSwitcher, error) {
 	}
 
 	ss := &SourceSwitcher{
-		roomID:     roomID,
-		videoTrack: videoTrack,
-		audioTrack: audioTrack,
+		roomID:      roomID,
+		videoTrack:  videoTrack,
+		audioTrack:  audioTrack,
+		audioLevels: NewAudioLevelObserver(DefaultAudioLevelConfig()),
+		bandwidth:   NewBandwidthAccountant(),
+		memory:      globalMemoryGovernor,
+		reports:     NewSenderReportClock(videoTrack.Codec().ClockRate, audioTrack.Codec().ClockRate),
+	}
+	if config := DefaultPacerConfig(); config.Enabled {
+		ss.pacer = NewPacer(config)
 	}
 	ss.activeSource.Store(int32(SourceTypeSFU))
+	local := newLocalExtensionMap()
+	ss.extensionMaps[SourceTypeLocal][extensionSlot(true)].Store(local)
+	ss.extensionMaps[SourceTypeLocal][extensionSlot(false)].Store(local)
 
 	return ss, nil
 }
@@ -138,6 +181,101 @@ func (ss *SourceSwitcher) SetOnTrackChanged(fn func(videoTrack, audioTrack *webr
 	ss.onTrackChanged = fn
 }
 
+// SetOnActiveSpeakersChanged 设置活跃发言者变化回调
+func (ss *SourceSwitcher) SetOnActiveSpeakersChanged(fn func(roomID string, speakers []ActiveSpeaker)) {
+	if fn == nil {
+		ss.audioLevels.SetOnSpeakersChanged(nil)
+		return
+	}
+	roomID := ss.roomID
+	ss.audioLevels.SetOnSpeakersChanged(func(speakers []ActiveSpeaker) {
+		fn(roomID, speakers)
+	})
+}
+
+// SetSilenceSuppression 开关静音抑制
+// 开启后静音帧每 400ms 只转发一个，被抑制的包从输出序列号中扣除，接收端不会误判丢包
+func (ss *SourceSwitcher) SetSilenceSuppression(enabled bool) {
+	ss.suppressSilence.Store(enabled)
+}
+
+// SetPacerConfig 更新输出平滑配置（Enabled=false 关闭）
+// 旧 Pacer 中排队的包会被丢弃，请在没有关键帧突发时调用
+func (ss *SourceSwitcher) SetPacerConfig(config PacerConfig) {
+	var pacer *Pacer
+	if config.Enabled {
+		pacer = NewPacer(config)
+	}
+
+	ss.mu.Lock()
+	if ss.closed {
+		ss.mu.Unlock()
+		if pacer != nil {
+			pacer.Close()
+		}
+		return
+	}
+	old := ss.pacer
+	ss.pacer = pacer
+	ss.mu.Unlock()
+
+	if old != nil {
+		old.Close()
+	}
+}
+
+// GetPacerStats 获取输出平滑统计
+func (ss *SourceSwitcher) GetPacerStats() PacerStats {
+	ss.mu.RLock()
+	pacer := ss.pacer
+	ss.mu.RUnlock()
+	if pacer == nil {
+		return PacerStats{}
+	}
+	return pacer.GetStats()
+}
+
+// GetAudioLevelObserver 返回活跃发言者检测器
+func (ss *SourceSwitcher) GetAudioLevelObserver() *AudioLevelObserver {
+	return ss.audioLevels
+}
+
+// GetBandwidthAccountant 返回公网 / 局域网流量核算
+func (ss *SourceSwitcher) GetBandwidthAccountant() *BandwidthAccountant {
+	return ss.bandwidth
+}
+
+// GetSenderReportClock 返回输出轨道的时间轴（SR 生成使用）
+func (ss *SourceSwitcher) GetSenderReportClock() *SenderReportClock {
+	return ss.reports
+}
+
+// ObserveSenderReport 记录上游 SR，之后该 SSRC 的包按 SR 换算采集时间
+func (ss *SourceSwitcher) ObserveSenderReport(ssrc uint32, ntpTime uint64, rtpTime uint32) {
+	ss.reports.ObserveSenderReport(ssrc, ntpTime, rtpTime)
+}
+
+// EnableHeaderExtensionRewrite 开启入口扩展头改写（出口需要配合 HeaderExtensionRewriter）
+// 未开启时扩展头原样转发
+func (ss *SourceSwitcher) EnableHeaderExtensionRewrite() {
+	ss.rewriteExtensions.Store(true)
+}
+
+// SetHeaderExtensions 设置上游协商的扩展头，转发时改写为房间内部 ID
+func (ss *SourceSwitcher) SetHeaderExtensions(source SourceType, isVideo bool, extensions []webrtc.RTPHeaderExtensionParameter) {
+	if source != SourceTypeSFU && source != SourceTypeLocal {
+		return
+	}
+	ss.extensionMaps[source][extensionSlot(isVideo)].Store(NewIngressExtensionMap(extensions))
+}
+
+func extensionSlot(isVideo bool) int {
+	if isVideo {
+		return 1
+	}
+	return 0
+}
+
 // GetVideoTrack 返回视频 Track 供订阅者使用
 func (ss *SourceSwitcher) GetVideoTrack() *webrtc.TrackLocalStaticRTP {
 	return ss.videoTrack
@@ -213,6 +351,7 @@ func (ss *SourceSwitcher) SetVideoCodec(codec webrtc.RTPCodecCapability) error {
 	ss.videoReset = false
 	ss.videoSnOffset = 0
 	ss.videoTsOffset = 0
+	ss.reports.video.SetClockRate(codec.ClockRate)
 
 	// 复制回调和 track 引用，以便在锁外调用
 	callback = ss.onTrackChanged
@@ -252,6 +391,7 @@ func (ss *SourceSwitcher) SetAudioCodec(codec webrtc.RTPCodecCapability) error {
 	}
 
 	ss.audioTrack = newTrack
+	ss.reports.audio.SetClockRate(codec.ClockRate)
 	// 复制回调和 track 引用，以便在锁外调用
 	callback = ss.onTrackChanged
 	videoTrack = ss.videoTrack
@@ -281,6 +421,7 @@ func (ss *SourceSwitcher) GetLocalSharerID() string {
 
 // InjectSFUPacket 注入来自 SFU 的 RTP 包
 // 当活跃源是 SFU 时，数据会被转发给订阅者
+// data 在返回后不再被引用（抓包、Pacer 均会拷贝），调用方可以复用
 func (ss *SourceSwitcher) InjectSFUPacket(isVideo bool, data []byte) error {
 	ss.mu.RLock()
 	if ss.closed {
@@ -290,6 +431,10 @@ func (ss *SourceSwitcher) InjectSFUPacket(isVideo bool, data []byte) error {
 	ss.sfuActive = true
 	ss.mu.RUnlock()
 
+	if c := ss.capture.Load(); c != nil {
+		c.Capture(SourceTypeSFU, isVideo, data)
+	}
+
 	// 只有当活跃源是 SFU 时才转发
 	if ss.GetActiveSource() != SourceTypeSFU {
 		return nil
@@ -300,6 +445,7 @@ func (ss *SourceSwitcher) InjectSFUPacket(isVideo bool, data []byte) error {
 
 // InjectLocalPacket 注入来自本地分享者的 RTP 包
 // 当活跃源是 Local 时，数据会被转发给订阅者
+// data 在返回后不再被引用（抓包、Pacer 均会拷贝），调用方可以复用
 func (ss *SourceSwitcher) InjectLocalPacket(isVideo bool, data []byte) error {
 	ss.mu.RLock()
 	if ss.closed {
@@ -309,6 +455,10 @@ func (ss *SourceSwitcher) InjectLocalPacket(isVideo bool, data []byte) error {
 	ss.localActive = true
 	ss.mu.RUnlock()
 
+	if c := ss.capture.Load(); c != nil {
+		c.Capture(SourceTypeLocal, isVideo, data)
+	}
+
 	// 只有当活跃源是 Local 时才转发
 	if ss.GetActiveSource() != SourceTypeLocal {
 		return nil
@@ -333,6 +483,7 @@ func (ss *SourceSwitcher) writePacket(isVideo bool, data []byte, fromSFU bool) e
 	} else {
 		track = ss.audioTrack
 	}
+	pacer := ss.pacer
 	ss.mu.RUnlock()
 
 	if track == nil {
@@ -341,9 +492,17 @@ func (ss *SourceSwitcher) writePacket(isVideo bool, data []byte, fromSFU bool) e
 
 	// 写入 Track（转发给所有订阅者）
 	// RTP Rewriting 核心逻辑
+	inputTs := packet.Timestamp
 	if isVideo {
+		// 输入 SSRC 变化（切换源 / 上游重建轨道）时重新对齐，保证输出 SN/TS 连续
+		if ss.videoSynced && packet.SSRC != ss.lastVideoSSRC {
+			ss.videoReset = true
+		}
+		ss.lastVideoSSRC = packet.SSRC
+
 		// 处理同步重置
 		if ss.videoReset {
+			ss.reports.video.MarkStale()
 			if ss.videoSynced {
 				// 如果之前同步过，计算新的 offset 以连接上一次的 output
 				// new_output_sn = old_output_sn + 1
@@ -351,9 +510,13 @@ func (ss *SourceSwitcher) writePacket(isVideo bool, data []byte, fromSFU bool) e
 				// => new_offset = old_output_sn + 1 - input_sn
 				ss.videoSnOffset = ss.lastVideoSn + 1 - packet.SequenceNumber
 
-				// 时间戳同理，增加一个小 delta (比如 3000 samples @ 90k = 33ms)
-				// 这个 delta 不是很关键，只要不回滚即可
-				ss.videoTsOffset = ss.lastVideoTs + 3000 - packet.Timestamp
+				// 时间戳沿 SR 时间轴延续：新包落在它采集时刻对应的输出时间戳上，接收端的 RTP/NTP 映射不跳变
+				// 还没有映射（或会回滚）时增加一个小 delta (3000 samples @ 90k = 33ms)
+				next := ss.lastVideoTs + 3000
+				if ts, ok := ss.reports.video.Project(packet.SSRC, packet.Timestamp, time.Now()); ok && int32(ts-ss.lastVideoTs) > 0 {
+					next = ts
+				}
+				ss.videoTsOffset = next - packet.Timestamp
 
 				utils.Info("[Switcher] Video stream reset recovered: sn_offset=%d, ts_offset=%d", ss.videoSnOffset, ss.videoTsOffset)
 			} else {
@@ -369,6 +532,14 @@ func (ss *SourceSwitcher) writePacket(isVideo bool, data []byte, fromSFU bool) e
 			ss.videoSynced = true
 		}
 
+		// 内存压力下丢弃非参考帧：从 SN offset 中扣除，输出序列号保持连续
+		if ss.memory.Pressure() >= MemoryPressureDropFrames &&
+			IsNonReferenceFrame(track.Codec().MimeType, packet.Payload) {
+			ss.videoSnOffset--
+			ss.memory.NoteDroppedPacket()
+			return nil
+		}
+
 		// 应用 Offset
 		packet.SequenceNumber += ss.videoSnOffset
 		packet.Timestamp += ss.videoTsOffset
@@ -377,12 +548,46 @@ func (ss *SourceSwitcher) writePacket(isVideo bool, data []byte, fromSFU bool) e
 		ss.lastVideoSn = packet.SequenceNumber
 		ss.lastVideoTs = packet.Timestamp
 
+		if ss.reports.video.Stale(packet.SSRC) {
+			ss.reports.video.Anchor(packet.SSRC, inputTs, packet.Timestamp, time.Now())
+		}
+
 	} else {
+		now := time.Now()
+		var levelExt []byte
+		if id := ss.audioLevels.ExtensionID(); id != 0 {
+			levelExt = packet.GetExtension(id)
+		}
+
+		// 多路上游音频共用一条输出轨道：只转发选中的发言者
+		if !ss.audioLevels.Observe(packet.SSRC, levelExt, now) {
+			return nil
+		}
+		// 输入 SSRC 变化（切换发言者/切换源）时重新对齐，保证输出 SN/TS 连续
+		if ss.audioSynced && packet.SSRC != ss.lastAudioSSRC {
+			ss.audioReset = true
+		}
+		ss.lastAudioSSRC = packet.SSRC
+
+		// 静音抑制：被丢弃的包从 SN offset 中扣除，输出序列号保持连续；TS 间隙按 DTX 语义保留
+		if isSilentAudio(packet.PayloadType, packet.Payload, levelExt) {
+			atomic.AddUint64(&ss.audioSilentPackets, 1)
+			if ss.suppressSilence.Load() && ss.audioSynced && !ss.audioReset &&
+				now.Sub(ss.lastAudioWall) < silenceKeepaliveInterval {
+				ss.audioSnOffset--
+				atomic.AddUint64(&ss.audioSuppressed, 1)
+				return nil
+			}
+		}
+
 		// 音频同理 (简化处理，音频通常容忍度高一些，但为了完美也加上)
 		if ss.audioReset {
+			ss.reports.audio.MarkStale()
 			if ss.audioSynced {
+				// 时间戳按真实间隔推进（DTX / 切换期间的静音不会被压缩成一帧）
+				gap := audioGapTicks(now.Sub(ss.lastAudioWall), track.Codec().ClockRate)
 				ss.audioSnOffset = ss.lastAudioSn + 1 - packet.SequenceNumber
-				ss.audioTsOffset = ss.lastAudioTs + 960 - packet.Timestamp // 20ms @ 48k
+				ss.audioTsOffset = ss.lastAudioTs + gap - packet.Timestamp
 			} else {
 				ss.audioSnOffset = 0
 				ss.audioTsOffset = 0
@@ -400,9 +605,23 @@ func (ss *SourceSwitcher) writePacket(isVideo bool, data []byte, fromSFU bool) e
 
 		ss.lastAudioSn = packet.SequenceNumber
 		ss.lastAudioTs = packet.Timestamp
+		ss.lastAudioWall = now
+
+		if ss.reports.audio.Stale(packet.SSRC) {
+			ss.reports.audio.Anchor(packet.SSRC, inputTs, packet.Timestamp, now)
+		}
+	}
+
+	// 上游扩展头改写为房间内部 ID（包是私有解析的，原地改写）
+	if packet.Extension && ss.rewriteExtensions.Load() {
+		source := SourceTypeLocal
+		if fromSFU {
+			source = SourceTypeSFU
+		}
+		ss.extensionMaps[source][extensionSlot(isVideo)].Load().Rewrite(&packet.Header, packet.Extensions, 0, nil)
 	}
 
-	if err := track.WriteRTP(packet); err != nil {
+	if err := ss.output(track, pacer, isVideo, packet); err != nil {
 		// 节流错误日志：每秒只打印一次
 		now := time.Now().UnixNano()
 		last := atomic.LoadInt64(&ss.lastWriteErrorTime)
@@ -413,6 +632,7 @@ func (ss *SourceSwitcher) writePacket(isVideo bool, data []byte, fromSFU bool) e
 		}
 		return err
 	}
+	ss.bandwidth.AddForwarded(packet.MarshalSize(), isVideo)
 
 	if ss.packetsFromSFU%100 == 0 {
 		// fmt.Printf("[Switcher] Wrote packet to track (isVideo: %v, fromSFU: %v)\n", isVideo, fromSFU)
@@ -428,10 +648,102 @@ func (ss *SourceSwitcher) writePacket(isVideo bool, data []byte, fromSFU bool) e
 	return nil
 }
 
+// output 写入 Track：视频经过 Pacer 排队，音频直接发送并占用 Pacer 预算
+// NextKeyframe 的等待方在关键帧真正写出后才被通知（而不是入队时）
+func (ss *SourceSwitcher) output(track *webrtc.TrackLocalStaticRTP, pacer *Pacer, isVideo bool, packet *rtp.Packet) error {
+	var onSent func()
+	if isVideo {
+		if waiter := ss.keyframeWaiter.Load(); waiter != nil && IsKeyframe(track.Codec().MimeType, packet.Payload) {
+			onSent = func() {
+				if ss.keyframeWaiter.CompareAndSwap(waiter, nil) {
+					close(*waiter)
+				}
+			}
+		}
+	}
+
+	if pacer == nil || !isVideo {
+		if pacer != nil {
+			pacer.OnAudio(packet.MarshalSize())
+		}
+		if err := track.WriteRTP(packet); err != nil {
+			return err
+		}
+		if onSent != nil {
+			onSent()
+		}
+		return nil
+	}
+
+	// 超过标准缓冲区的包（聚合包等）用大缓冲区排队，绕过队列会与排队中的包乱序
+	var buf []byte
+	if packet.MarshalSize() > DefaultRTPBufferSize {
+		buf = GetRTPLargeBuffer()
+	} else {
+		buf = GetRTPBuffer()
+	}
+	n, err := packet.MarshalTo(buf)
+	if err != nil {
+		putPacedBuffer(buf)
+		return err
+	}
+	pacer.EnqueueVideo(track, buf, n, onSent)
+	return nil
+}
+
+// NextKeyframe 返回在下一个视频关键帧写出（经过 Pacer 时为出队发送）后关闭的 channel（一次性）
+// 多个调用方在同一个关键帧之前调用时共享同一个 channel
+func (ss *SourceSwitcher) NextKeyframe() <-chan struct{} {
+	for {
+		if waiter := ss.keyframeWaiter.Load(); waiter != nil {
+			return *waiter
+		}
+		ch := make(chan struct{})
+		if ss.keyframeWaiter.CompareAndSwap(nil, &ch) {
+			return ch
+		}
+	}
+}
+
+// StartCapture 开始抓包，记录所有注入的 RTP 包（无论当前活跃源）
+// 如果已在抓包，先停止旧的抓包
+func (ss *SourceSwitcher) StartCapture(path string, config RTPCaptureConfig) error {
+	ss.mu.RLock()
+	closed := ss.closed
+	ss.mu.RUnlock()
+	if closed {
+		return ErrForwarderClosed
+	}
+
+	c, err := NewRTPCaptureFile(path, config)
+	if err != nil {
+		return err
+	}
+	if old := ss.capture.Swap(c); old != nil {
+		old.Close()
+	}
+	utils.Info("[Switcher] Capture started: room=%s, path=%s", ss.roomID, path)
+	return nil
+}
+
+// StopCapture 停止抓包并返回统计
+func (ss *SourceSwitcher) StopCapture() (RTPCaptureStats, error) {
+	c := ss.capture.Swap(nil)
+	if c == nil {
+		return RTPCaptureStats{}, nil
+	}
+	err := c.Close()
+	stats := c.Stats()
+	utils.Info("[Switcher] Capture stopped: room=%s, captured=%d, dropped=%d",
+		ss.roomID, stats.PacketsCaptured, stats.PacketsDropped)
+	return stats, err
+}
+
 // StartLocalShare 开始本地分享（切换到 Local 源）
 func (ss *SourceSwitcher) StartLocalShare(sharerID string) {
 	ss.mu.Lock()
 	ss.localSharerID = sharerID
+	ss.resetSyncLocked()
 	ss.mu.Unlock()
 
 	// 原子切换源
@@ -452,6 +764,7 @@ func (ss *SourceSwitcher) StopLocalShare() {
 	sharerID := ss.localSharerID
 	ss.localSharerID = ""
 	ss.localActive = false
+	ss.resetSyncLocked()
 	ss.mu.Unlock()
 
 	// 原子切换源
@@ -473,6 +786,10 @@ func (ss *SourceSwitcher) SwitchToSource(sourceType SourceType) {
 		return
 	}
 
+	ss.mu.Lock()
+	ss.resetSyncLocked()
+	ss.mu.Unlock()
+
 	ss.activeSource.Store(int32(sourceType))
 
 	// 触发回调
@@ -485,6 +802,12 @@ func (ss *SourceSwitcher) SwitchToSource(sourceType SourceType) {
 	}
 }
 
+// resetSyncLocked 切换源后下一个包重新计算 SN/TS offset 并重新锚定 SR 时间轴（调用方持有锁）
+func (ss *SourceSwitcher) resetSyncLocked() {
+	ss.videoReset = true
+	ss.audioReset = true
+}
+
 // IsLocalSharing 返回是否正在本地分享
 func (ss *SourceSwitcher) IsLocalSharing() bool {
 	return ss.GetActiveSource() == SourceTypeLocal
@@ -498,8 +821,15 @@ func (ss *SourceSwitcher) Stats() (sfuPackets, localPackets uint64) {
 // Close 关闭源切换器
 func (ss *SourceSwitcher) Close() {
 	ss.mu.Lock()
-	defer ss.mu.Unlock()
 	ss.closed = true
+	pacer := ss.pacer
+	ss.pacer = nil
+	ss.mu.Unlock()
+
+	if pacer != nil {
+		pacer.Close()
+	}
+	ss.StopCapture()
 }
 
 // SourceSwitcherStatus 源切换器状态
@@ -512,6 +842,14 @@ type SourceSwitcherStatus struct {
 	LocalActive   bool       `json:"local_active"`
 	SFUPackets    uint64     `json:"sfu_packets"`
 	LocalPackets  uint64     `json:"local_packets"`
+
+	AudioLevels AudioLevelStats `json:"audio_levels"`
+
+	Pacer PacerStats `json:"pacer"`
+
+	SilenceSuppression bool   `json:"silence_suppression"`
+	AudioSilentPackets uint64 `json:"audio_silent_packets"`
+	AudioSuppressed    uint64 `json:"audio_suppressed"`
 }
 
 // GetStatus 获取状态
@@ -521,6 +859,11 @@ func (ss *SourceSwitcher) GetStatus() SourceSwitcherStatus {
 
 	sfuPackets, localPackets := ss.Stats()
 
+	var pacerStats PacerStats
+	if ss.pacer != nil {
+		pacerStats = ss.pacer.GetStats()
+	}
+
 	return SourceSwitcherStatus{
 		RoomID:        ss.roomID,
 		ActiveSource:  ss.GetActiveSource(),
@@ -530,6 +873,13 @@ func (ss *SourceSwitcher) GetStatus() SourceSwitcherStatus {
 		LocalActive:   ss.localActive,
 		SFUPackets:    sfuPackets,
 		LocalPackets:  localPackets,
+		AudioLevels:   ss.audioLevels.GetStats(),
+
+		Pacer: pacerStats,
+
+		SilenceSuppression: ss.suppressSilence.Load(),
+		AudioSilentPackets: atomic.LoadUint64(&ss.audioSilentPackets),
+		AudioSuppressed:    atomic.LoadUint64(&ss.audioSuppressed),
 	}
 }
 
@@ -0,0 +1,241 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Subscriber Fallback - 订阅者双路接收
+ * 订阅者经局域网 Relay 接收时，可以同时保留一路直连 SFU 的备用订阅（LiveKitBridge 备用模式，只拉 LOW 层）：
+ *
+ *   Relay 媒体停顿超过 StallTimeout（或 Relay 连接断开）  -> 立即切到直连路径，直连恢复正常质量
+ *   新 Relay 的媒体连续到达 RecoverHold                    -> 切回 Relay，直连回到备用模式
+ *
+ * 备用路径始终有媒体流动，切换时不需要等待 SFU 恢复转发或关键帧，代价是一路 LOW 层的公网带宽。
+ * Relay 媒体进度由外部上报（累计包数），本组件只负责判定和切换。
+ */
+package sfu
+
+import (
+	"sync"
+	"time"
+)
+
+// FallbackPath 订阅者当前渲染的路径
+type FallbackPath int
+
+const (
+	FallbackPathRelay  FallbackPath = iota // 局域网 Relay
+	FallbackPathDirect                     // 直连 SFU
+)
+
+func (p FallbackPath) String() string {
+	if p == FallbackPathDirect {
+		return "direct"
+	}
+	return "relay"
+}
+
+// SubscriberFallbackConfig 双路接收配置
+type SubscriberFallbackConfig struct {
+	// Relay 媒体停顿多久切到直连（30fps 下约 3 帧）
+	StallTimeout time.Duration
+	// 切到直连后，Relay 媒体需要连续到达多久才切回
+	RecoverHold time.Duration
+}
+
+// DefaultSubscriberFallbackConfig 返回默认配置
+func DefaultSubscriberFallbackConfig() SubscriberFallbackConfig {
+	return SubscriberFallbackConfig{
+		StallTimeout: 100 * time.Millisecond,
+		RecoverHold:  2 * time.Second,
+	}
+}
+
+// fallbackUpstream 备用路径的上游（*LiveKitBridge）
+type fallbackUpstream interface {
+	SetStandby(standby bool)
+}
+
+// SubscriberFallbackStatus 双路接收状态
+type SubscriberFallbackStatus struct {
+	Path         string  `json:"path"`
+	LastReason   string  `json:"last_reason,omitempty"`
+	Switches     uint64  `json:"switches"`
+	RelayPackets uint64  `json:"relay_packets"`
+	DirectMs     int64   `json:"direct_ms"` // 累计在直连路径上的时间
+	StallMs      float64 `json:"stall_timeout_ms"`
+}
+
+// SubscriberFallback 订阅者双路接收控制器
+type SubscriberFallback struct {
+	mu sync.Mutex
+
+	config   SubscriberFallbackConfig
+	upstream fallbackUpstream
+
+	path       FallbackPath
+	lastReason string
+	switches   uint64
+
+	relayPackets uint64
+	lastRelay    time.Time // 最近一次 Relay 媒体进度
+	healthySince time.Time // 直连期间 Relay 媒体连续到达的起点
+
+	directSince time.Time
+	directTime  time.Duration
+
+	stallTimer *time.Timer
+	closed     bool
+
+	onSwitch func(path FallbackPath, reason string)
+}
+
+// NewSubscriberFallback 创建双路接收控制器，初始渲染 Relay 路径，上游进入备用模式
+func NewSubscriberFallback(config SubscriberFallbackConfig, upstream fallbackUpstream) *SubscriberFallback {
+	f := &SubscriberFallback{
+		config:   config,
+		upstream: upstream,
+	}
+	if upstream != nil {
+		upstream.SetStandby(true)
+	}
+	return f
+}
+
+// SetOnSwitch 设置路径切换回调
+func (f *SubscriberFallback) SetOnSwitch(fn func(path FallbackPath, reason string)) {
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	f.onSwitch = fn
+}
+
+// ReportRelayPackets 上报 Relay 路径累计收到的包数（例如 inbound-rtp 的 packetsReceived）
+// 计数变化即视为 Relay 媒体仍在流动；第一次上报后开始停顿检测。上报间隔应明显小于 StallTimeout
+func (f *SubscriberFallback) ReportRelayPackets(total uint64) {
+	f.progress(time.Now(), total)
+}
+
+// RelayLost Relay 连接断开（控制通道关闭、P2P 连接失败、收到移交通知等），立即切到直连
+func (f *SubscriberFallback) RelayLost(reason string) {
+	f.mu.Lock()
+	if f.closed || f.path == FallbackPathDirect {
+		f.mu.Unlock()
+		return
+	}
+	fn := f.switchLocked(time.Now(), FallbackPathDirect, reason)
+	f.mu.Unlock()
+
+	f.notify(fn, FallbackPathDirect, reason)
+}
+
+// Path 当前渲染的路径
+func (f *SubscriberFallback) Path() FallbackPath {
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	return f.path
+}
+
+// GetStatus 获取状态
+func (f *SubscriberFallback) GetStatus() SubscriberFallbackStatus {
+	f.mu.Lock()
+	defer f.mu.Unlock()
+
+	direct := f.directTime
+	if f.path == FallbackPathDirect {
+		direct += time.Since(f.directSince)
+	}
+	return SubscriberFallbackStatus{
+		Path:         f.path.String(),
+		LastReason:   f.lastReason,
+		Switches:     f.switches,
+		RelayPackets: f.relayPackets,
+		DirectMs:     direct.Milliseconds(),
+		StallMs:      float64(f.config.StallTimeout) / float64(time.Millisecond),
+	}
+}
+
+// Close 停止停顿检测
+func (f *SubscriberFallback) Close() {
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	f.closed = true
+	if f.stallTimer != nil {
+		f.stallTimer.Stop()
+		f.stallTimer = nil
+	}
+}
+
+// progress 处理 Relay 媒体进度
+func (f *SubscriberFallback) progress(now time.Time, total uint64) {
+	f.mu.Lock()
+	// 计数变小说明 Relay 连接已更换（新连接从 0 开始计数）
+	if f.closed || total == 0 || total == f.relayPackets {
+		f.mu.Unlock()
+		return
+	}
+	f.relayPackets = total
+
+	// 直连期间：Relay 媒体中间出现停顿则重新计时
+	if f.healthySince.IsZero() || now.Sub(f.lastRelay) > f.config.StallTimeout {
+		f.healthySince = now
+	}
+	f.lastRelay = now
+
+	if f.stallTimer == nil {
+		f.stallTimer = time.AfterFunc(f.config.StallTimeout, f.checkStall)
+	} else {
+		f.stallTimer.Reset(f.config.StallTimeout)
+	}
+
+	var fn func(path FallbackPath, reason string)
+	if f.path == FallbackPathDirect && now.Sub(f.healthySince) >= f.config.RecoverHold {
+		fn = f.switchLocked(now, FallbackPathRelay, "recovered")
+	}
+	f.mu.Unlock()
+
+	if fn != nil {
+		f.notify(fn, FallbackPathRelay, "recovered")
+	}
+}
+
+// checkStall 停顿检测定时器到期
+func (f *SubscriberFallback) checkStall() {
+	f.evaluateStall(time.Now())
+}
+
+func (f *SubscriberFallback) evaluateStall(now time.Time) {
+	f.mu.Lock()
+	if f.closed || f.path == FallbackPathDirect || f.lastRelay.IsZero() ||
+		now.Sub(f.lastRelay) < f.config.StallTimeout {
+		f.mu.Unlock()
+		return
+	}
+	fn := f.switchLocked(now, FallbackPathDirect, "stall")
+	f.mu.Unlock()
+
+	f.notify(fn, FallbackPathDirect, "stall")
+}
+
+// switchLocked 切换路径，返回需要在锁外调用的回调
+func (f *SubscriberFallback) switchLocked(now time.Time, path FallbackPath, reason string) func(FallbackPath, string) {
+	if path == FallbackPathDirect {
+		f.directSince = now
+		f.healthySince = time.Time{}
+	} else {
+		f.directTime += now.Sub(f.directSince)
+	}
+	f.path = path
+	f.lastReason = reason
+	f.switches++
+	return f.onSwitch
+}
+
+// notify 调整上游并通知外部切换渲染
+func (f *SubscriberFallback) notify(fn func(FallbackPath, string), path FallbackPath, reason string) {
+	// 直连路径在渲染时恢复正常质量，不渲染时回到备用模式
+	if f.upstream != nil {
+		f.upstream.SetStandby(path == FallbackPathRelay)
+	}
+	if fn != nil {
+		fn(path, reason)
+	}
+}
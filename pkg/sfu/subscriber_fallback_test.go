@@ -0,0 +1,160 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Subscriber Fallback Tests
+ */
+package sfu
+
+import (
+	"sync"
+	"testing"
+	"time"
+)
+
+// fakeFallbackUpstream 记录备用模式切换
+type fakeFallbackUpstream struct {
+	mu      sync.Mutex
+	standby []bool
+}
+
+func (u *fakeFallbackUpstream) SetStandby(standby bool) {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	u.standby = append(u.standby, standby)
+}
+
+func (u *fakeFallbackUpstream) last() bool {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	return u.standby[len(u.standby)-1]
+}
+
+func newTestSubscriberFallback() (*SubscriberFallback, *fakeFallbackUpstream, *[]string) {
+	upstream := &fakeFallbackUpstream{}
+	f := NewSubscriberFallback(DefaultSubscriberFallbackConfig(), upstream)
+	switches := &[]string{}
+	f.SetOnSwitch(func(path FallbackPath, reason string) {
+		*switches = append(*switches, path.String()+"/"+reason)
+	})
+	return f, upstream, switches
+}
+
+// 按模拟时间回放：Relay 停顿 -> 直连 -> 新 Relay 稳定后切回
+func TestSubscriberFallbackStallAndRecover(t *testing.T) {
+	f, upstream, switches := newTestSubscriberFallback()
+	defer f.Close()
+	if !upstream.last() {
+		t.Fatal("Direct path should start in standby")
+	}
+
+	start := time.Now()
+	frame := 33 * time.Millisecond
+	packets := uint64(0)
+	at := func(d time.Duration) time.Time { return start.Add(d) }
+
+	// 正常接收 1 秒
+	for i := 0; i < 30; i++ {
+		packets += 3
+		f.progress(at(time.Duration(i)*frame), packets)
+	}
+	last := time.Duration(29) * frame
+
+	// 停顿未到阈值不切换
+	f.evaluateStall(at(last + 90*time.Millisecond))
+	if f.Path() != FallbackPathRelay {
+		t.Fatal("Should stay on relay before StallTimeout")
+	}
+	f.evaluateStall(at(last + 100*time.Millisecond))
+	if f.Path() != FallbackPathDirect || upstream.last() {
+		t.Fatal("Should switch to direct after StallTimeout and leave standby")
+	}
+
+	// 新 Relay：计数从 0 开始；中间出现停顿则重新计时
+	base := last + 3*time.Second
+	packets = 0
+	for i := 0; i < 30; i++ {
+		packets += 3
+		f.progress(at(base+time.Duration(i)*frame), packets)
+	}
+	base += 30*frame + 500*time.Millisecond // 停顿 500ms
+	for i := 0; i < 60; i++ {
+		packets += 3
+		f.progress(at(base+time.Duration(i)*frame), packets)
+		if i < 59 && f.Path() != FallbackPathDirect {
+			t.Fatalf("Switched back too early at frame %d", i)
+		}
+	}
+	packets += 3
+	f.progress(at(base+61*frame), packets)
+	if f.Path() != FallbackPathRelay || !upstream.last() {
+		t.Fatal("Should switch back to relay after RecoverHold and re-enter standby")
+	}
+
+	want := []string{"direct/stall", "relay/recovered"}
+	if len(*switches) != len(want) || (*switches)[0] != want[0] || (*switches)[1] != want[1] {
+		t.Errorf("Unexpected switches %v", *switches)
+	}
+	if status := f.GetStatus(); status.Switches != 2 || status.DirectMs < 3000 || status.Path != "relay" {
+		t.Errorf("Unexpected status %+v", status)
+	}
+}
+
+func TestSubscriberFallbackRelayLost(t *testing.T) {
+	f, upstream, switches := newTestSubscriberFallback()
+	defer f.Close()
+
+	// 第一次上报之前不做停顿检测
+	f.evaluateStall(time.Now().Add(time.Hour))
+	if f.Path() != FallbackPathRelay {
+		t.Fatal("Should not fall back before relay media was ever reported")
+	}
+
+	f.ReportRelayPackets(10)
+	f.RelayLost("control_closed")
+	if f.Path() != FallbackPathDirect || upstream.last() {
+		t.Fatal("RelayLost should switch to direct immediately")
+	}
+	f.RelayLost("control_closed")
+
+	// 断开前的计数继续增长不算恢复：需要连续 RecoverHold
+	f.ReportRelayPackets(20)
+	if f.Path() != FallbackPathDirect {
+		t.Error("Should not switch back immediately")
+	}
+	if len(*switches) != 1 || (*switches)[0] != "direct/control_closed" {
+		t.Errorf("Unexpected switches %v", *switches)
+	}
+}
+
+// 真实定时器：停止上报后一个 StallTimeout 内切到直连
+func TestSubscriberFallbackStallTimer(t *testing.T) {
+	upstream := &fakeFallbackUpstream{}
+	config := DefaultSubscriberFallbackConfig()
+	config.StallTimeout = 40 * time.Millisecond
+	f := NewSubscriberFallback(config, upstream)
+	defer f.Close()
+
+	switched := make(chan time.Time, 1)
+	f.SetOnSwitch(func(path FallbackPath, reason string) {
+		if path == FallbackPathDirect {
+			switched <- time.Now()
+		}
+	})
+
+	for i := uint64(1); i <= 5; i++ {
+		f.ReportRelayPackets(i)
+		time.Sleep(10 * time.Millisecond)
+	}
+	stalled := time.Now()
+
+	select {
+	case at := <-switched:
+		if gap := at.Sub(stalled); gap > 200*time.Millisecond {
+			t.Errorf("Fallback took %v", gap)
+		}
+	case <-time.After(time.Second):
+		t.Fatal("Stall timer did not switch to direct")
+	}
+}
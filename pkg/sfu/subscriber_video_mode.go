@@ -0,0 +1,99 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Subscriber Video Mode - 按订阅者的可见性选择性转发视频
+ * 订阅者应用切到后台或视频窗口被隐藏时，Relay 停止向其转发视频（音频不受影响）：
+ * 视频 RTPSender 解绑共享 Track（ReplaceTrack(nil)），不需要重协商；
+ * 恢复时重新绑定当前 Track 并立即请求关键帧。
+ * 所有订阅者共享同一路视频，缩略图模式不单独降码率，而是由 LiveKitBridge
+ * 的上游质量控制按所有订阅者的视口选择 simulcast 层。
+ */
+package sfu
+
+// SubscriberVideoMode 订阅者视频模式
+type SubscriberVideoMode int
+
+const (
+	SubscriberVideoFull      SubscriberVideoMode = iota // 全尺寸
+	SubscriberVideoThumbnail                            // 缩略图
+	SubscriberVideoPaused                               // 暂停（不转发视频）
+)
+
+func (m SubscriberVideoMode) String() string {
+	switch m {
+	case SubscriberVideoThumbnail:
+		return "thumbnail"
+	case SubscriberVideoPaused:
+		return "paused"
+	default:
+		return "full"
+	}
+}
+
+// SetSubscriberVideoMode 设置订阅者的视频模式
+// 暂停时停止转发视频，从暂停恢复时重新绑定当前视频 Track 并请求关键帧
+func (r *RelayRoom) SetSubscriberVideoMode(peerID string, mode SubscriberVideoMode) error {
+	r.mu.RLock()
+	sub, exists := r.subscribers[peerID]
+	r.mu.RUnlock()
+	if !exists {
+		return ErrPeerNotFound
+	}
+
+	sub.mu.Lock()
+	if sub.closed {
+		sub.mu.Unlock()
+		return ErrPeerClosed
+	}
+	old := sub.videoMode
+	if old == mode {
+		sub.mu.Unlock()
+		return nil
+	}
+
+	resumed := false
+	if sub.videoSender != nil {
+		switch {
+		case mode == SubscriberVideoPaused:
+			if err := sub.videoSender.ReplaceTrack(nil); err != nil {
+				sub.mu.Unlock()
+				return err
+			}
+			// 音频照常转发，只停止计入视频
+			r.bandwidthAccountant().SetSubscriberVideoPaused(peerID, true)
+		case old == SubscriberVideoPaused:
+			if track := r.switcher.GetVideoTrack(); track != nil {
+				if err := sub.videoSender.ReplaceTrack(track); err != nil {
+					sub.mu.Unlock()
+					return err
+				}
+			}
+			r.bandwidthAccountant().SetSubscriberVideoPaused(peerID, false)
+			resumed = true
+		}
+	}
+	sub.videoMode = mode
+	sub.mu.Unlock()
+
+	// 恢复后订阅者的解码器需要新的关键帧
+	if resumed {
+		go r.emitKeyframeRequest()
+	}
+	return nil
+}
+
+// GetSubscriberVideoMode 获取订阅者的视频模式
+func (r *RelayRoom) GetSubscriberVideoMode(peerID string) (SubscriberVideoMode, bool) {
+	r.mu.RLock()
+	sub, exists := r.subscribers[peerID]
+	r.mu.RUnlock()
+	if !exists {
+		return SubscriberVideoFull, false
+	}
+
+	sub.mu.RLock()
+	defer sub.mu.RUnlock()
+	return sub.videoMode, true
+}
@@ -0,0 +1,87 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Subscriber Video Mode Tests
+ */
+package sfu
+
+import (
+	"sync/atomic"
+	"testing"
+	"time"
+)
+
+func TestRelayRoomSubscriberVideoMode(t *testing.T) {
+	room, err := NewRelayRoom("mode-room", nil)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer room.Close()
+	room.BecomeRelay("relay-1")
+
+	var keyframes atomic.Int32
+	room.SetKeyframeRequestCallback(func(roomID string) {
+		keyframes.Add(1)
+	})
+
+	if err := room.SetSubscriberVideoMode("missing", SubscriberVideoPaused); err != ErrPeerNotFound {
+		t.Errorf("Expected ErrPeerNotFound, got %v", err)
+	}
+
+	if _, err := room.AddSubscriber("sub-1", subscriberOffer(t)); err != nil {
+		t.Fatalf("AddSubscriber failed: %v", err)
+	}
+	sub := room.subscribers["sub-1"]
+	videoTrack := room.GetSourceSwitcher().GetVideoTrack()
+
+	// 等待 AddSubscriber 的预测性关键帧请求结束
+	time.Sleep(700 * time.Millisecond)
+	before := keyframes.Load()
+
+	if err := room.SetSubscriberVideoMode("sub-1", SubscriberVideoPaused); err != nil {
+		t.Fatalf("Pause failed: %v", err)
+	}
+	if sub.videoSender.Track() != nil {
+		t.Error("Paused subscriber should not be bound to the video track")
+	}
+	if sub.audioSender.Track() == nil {
+		t.Error("Audio should keep flowing while video is paused")
+	}
+
+	// 暂停期间 Track 切换不恢复转发
+	room.UpdateTracks(videoTrack, nil)
+	if sub.videoSender.Track() != nil {
+		t.Error("UpdateTracks should not rebind a paused subscriber")
+	}
+	if mode, _ := room.GetSubscriberVideoMode("sub-1"); mode != SubscriberVideoPaused {
+		t.Errorf("Expected paused, got %s", mode)
+	}
+
+	if err := room.SetSubscriberVideoMode("sub-1", SubscriberVideoFull); err != nil {
+		t.Fatalf("Resume failed: %v", err)
+	}
+	if sub.videoSender.Track() != videoTrack {
+		t.Error("Resumed subscriber should be bound to the current video track")
+	}
+
+	deadline := time.Now().Add(time.Second)
+	for keyframes.Load() == before {
+		if time.Now().After(deadline) {
+			t.Fatal("Expected keyframe request on resume")
+		}
+		time.Sleep(10 * time.Millisecond)
+	}
+
+	// 缩略图只记录模式，不解绑
+	if err := room.SetSubscriberVideoMode("sub-1", SubscriberVideoThumbnail); err != nil {
+		t.Fatal(err)
+	}
+	if sub.videoSender.Track() == nil {
+		t.Error("Thumbnail subscriber should keep receiving video")
+	}
+	if info := room.GetStatus().Subscribers[0]; info.VideoMode != "thumbnail" {
+		t.Errorf("Expected thumbnail in status, got %s", info.VideoMode)
+	}
+}
@@ -0,0 +1,455 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Upstream Quality - Relay 向上游 SFU 请求的视频质量
+ * 局域网内所有订阅者共享同一路上游视频，Relay 按订阅者上报的视口尺寸和带宽估计
+ * 选择需要的最低 simulcast 层：所有人都在看缩略图时不再从公网拉 HIGH 层。
+ *
+ * 决策规则：
+ *   - 需求：所有订阅者中最大的视口对应的质量（未知视口按 HIGH），订阅者的质量上限（缩略图模式）封顶；
+ *     上报超过 ReportTTL 的订阅者不参与决策，暂停视频的订阅者需求为 0
+ *   - 没有人在看（所有订阅者暂停或已离开）时请求 LOW；只有从未有过订阅者的房间按 HIGH（与未启用时一致）
+ *   - 带宽上限：共享 Track 必须能送达每个订阅者，按已知带宽估计中的最小值封顶
+ *   - 迟滞：升级要求带宽有余量且目标持续 UpgradeHold，降级持续 DowngradeHold 后执行
+ *   - 关键帧对齐：上游切层要等到新层的关键帧才生效，切换后在看到关键帧之前不做下一次切换
+ *   - 定时重评估：迟滞、关键帧超时、上报过期到期时由控制器自己的定时器重新评估，不依赖新的上报
+ */
+package sfu
+
+import (
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// UpstreamQuality 上游视频质量（数值与 livekit.VideoQuality 一致）
+type UpstreamQuality int
+
+const (
+	UpstreamQualityLow UpstreamQuality = iota
+	UpstreamQualityMedium
+	UpstreamQualityHigh
+)
+
+func (q UpstreamQuality) String() string {
+	switch q {
+	case UpstreamQualityLow:
+		return "low"
+	case UpstreamQualityMedium:
+		return "medium"
+	default:
+		return "high"
+	}
+}
+
+// UpstreamQualityConfig 上游质量控制配置
+type UpstreamQualityConfig struct {
+	// 视口不超过该尺寸时使用 LOW 层（缩略图）
+	LowMaxWidth  int
+	LowMaxHeight int
+	// 视口不超过该尺寸时使用 MEDIUM 层
+	MediumMaxWidth  int
+	MediumMaxHeight int
+
+	// 各层的名义码率 (bps)，用于和带宽估计比较
+	LowBitrate    uint64
+	MediumBitrate uint64
+	HighBitrate   uint64
+
+	// 升级时要求的带宽余量（估计带宽 >= 名义码率 x UpgradeHeadroom）
+	UpgradeHeadroom float64
+	// 目标质量持续多久后执行升级 / 降级
+	UpgradeHold   time.Duration
+	DowngradeHold time.Duration
+	// 切换后等待关键帧的最长时间，超时视为已生效
+	KeyframeTimeout time.Duration
+	// 订阅者超过该时间未上报则不再参与决策
+	ReportTTL time.Duration
+}
+
+// DefaultUpstreamQualityConfig 返回默认配置
+func DefaultUpstreamQualityConfig() UpstreamQualityConfig {
+	return UpstreamQualityConfig{
+		LowMaxWidth:     480,
+		LowMaxHeight:    270,
+		MediumMaxWidth:  960,
+		MediumMaxHeight: 540,
+		LowBitrate:      150_000,
+		MediumBitrate:   500_000,
+		HighBitrate:     2_500_000,
+		UpgradeHeadroom: 1.3,
+		UpgradeHold:     5 * time.Second,
+		DowngradeHold:   time.Second,
+		KeyframeTimeout: 3 * time.Second,
+		ReportTTL:       15 * time.Second,
+	}
+}
+
+// subscriberViewport 订阅者上报的视口和带宽
+type subscriberViewport struct {
+	width     int
+	height    int
+	bandwidth uint64 // bps，0 表示未知
+	updated   time.Time
+
+	capped     bool            // 是否设置了质量上限
+	maxQuality UpstreamQuality // 质量上限
+	paused     bool            // 视频已暂停（后台 / 不可见），不产生需求
+}
+
+// UpstreamQualityStatus 上游质量状态
+type UpstreamQualityStatus struct {
+	Current       string `json:"current"`
+	Target        string `json:"target"`
+	Max           string `json:"max"`
+	Subscribers   int    `json:"subscribers"`
+	MinBandwidth  uint64 `json:"min_bandwidth_bps"`
+	Switches      uint64 `json:"switches"`
+	AwaitKeyframe bool   `json:"await_keyframe"`
+}
+
+// UpstreamQualityController 上游质量控制器
+type UpstreamQualityController struct {
+	mu sync.Mutex
+
+	config      UpstreamQualityConfig
+	subscribers map[string]*subscriberViewport
+	seen        bool // 是否有过订阅者
+
+	current        UpstreamQuality
+	target         UpstreamQuality
+	maxQuality     UpstreamQuality // 外部上限（设备过热 / 低电量时降低）
+	candidate      UpstreamQuality
+	candidateSince time.Time
+
+	// 在 mu 内修改，转发路径上无锁读取
+	awaitKeyframe atomic.Bool
+	switchedAt    time.Time
+	switches      uint64
+
+	evalTimer *time.Timer
+	closed    bool
+
+	onSwitch func(quality UpstreamQuality)
+}
+
+// NewUpstreamQualityController 创建控制器（初始为 HIGH，与未启用时的行为一致）
+func NewUpstreamQualityController(config UpstreamQualityConfig) *UpstreamQualityController {
+	return &UpstreamQualityController{
+		config:      config,
+		subscribers: make(map[string]*subscriberViewport),
+		current:     UpstreamQualityHigh,
+		target:      UpstreamQualityHigh,
+		candidate:   UpstreamQualityHigh,
+		maxQuality:  UpstreamQualityHigh,
+	}
+}
+
+// SetOnSwitch 设置切换回调（需要向上游请求新的质量）
+func (c *UpstreamQualityController) SetOnSwitch(fn func(quality UpstreamQuality)) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.onSwitch = fn
+}
+
+// UpdateSubscriber 更新订阅者的视口尺寸和带宽估计
+// width/height 为 0 表示未知（按 HIGH 处理），bandwidthBps 为 0 表示未知
+func (c *UpstreamQualityController) UpdateSubscriber(peerID string, width, height int, bandwidthBps uint64) {
+	c.evaluate(time.Now(), func() {
+		s := c.subscriberLocked(peerID)
+		s.width = width
+		s.height = height
+		s.bandwidth = bandwidthBps
+		s.updated = time.Now()
+	})
+}
+
+// SetSubscriberMaxQuality 设置订阅者的质量上限（缩略图模式），与视口上报一样超过 ReportTTL 后不再参与决策
+func (c *UpstreamQualityController) SetSubscriberMaxQuality(peerID string, quality UpstreamQuality) {
+	c.evaluate(time.Now(), func() {
+		s := c.subscriberLocked(peerID)
+		s.capped = true
+		s.maxQuality = quality
+		s.updated = time.Now()
+	})
+}
+
+// ClearSubscriberMaxQuality 清除订阅者的质量上限
+func (c *UpstreamQualityController) ClearSubscriberMaxQuality(peerID string) {
+	c.evaluate(time.Now(), func() {
+		if s, ok := c.subscribers[peerID]; ok {
+			s.capped = false
+		}
+	})
+}
+
+// SetSubscriberPaused 订阅者视频暂停 / 恢复
+// 暂停期间保留最后一次上报的视口和带宽，恢复后直接按该上报计入需求
+func (c *UpstreamQualityController) SetSubscriberPaused(peerID string, paused bool) {
+	c.evaluate(time.Now(), func() {
+		if !paused {
+			if s, ok := c.subscribers[peerID]; ok && s.paused {
+				s.paused = false
+				s.updated = time.Now()
+			}
+			return
+		}
+		c.subscriberLocked(peerID).paused = true
+	})
+}
+
+func (c *UpstreamQualityController) subscriberLocked(peerID string) *subscriberViewport {
+	s, ok := c.subscribers[peerID]
+	if !ok {
+		s = &subscriberViewport{}
+		c.subscribers[peerID] = s
+		c.seen = true
+	}
+	return s
+}
+
+// RemoveSubscriber 移除订阅者
+func (c *UpstreamQualityController) RemoveSubscriber(peerID string) {
+	c.evaluate(time.Now(), func() {
+		delete(c.subscribers, peerID)
+	})
+}
+
+// SetMaxQuality 设置质量上限（与订阅者需求取较低者，迟滞规则不变）
+func (c *UpstreamQualityController) SetMaxQuality(quality UpstreamQuality) {
+	c.evaluate(time.Now(), func() {
+		c.maxQuality = quality
+	})
+}
+
+// Evaluate 重新评估（迟滞或上报过期到期时由定时器触发）
+func (c *UpstreamQualityController) Evaluate() {
+	c.evaluate(time.Now(), nil)
+}
+
+// OnKeyframe 上游视频收到关键帧，上一次切换已生效
+func (c *UpstreamQualityController) OnKeyframe() {
+	c.mu.Lock()
+	c.awaitKeyframe.Store(false)
+	c.mu.Unlock()
+	c.Evaluate()
+}
+
+// AwaitingKeyframe 是否在等待切换后的关键帧（每个视频包调用，不加锁）
+func (c *UpstreamQualityController) AwaitingKeyframe() bool {
+	return c.awaitKeyframe.Load()
+}
+
+// Current 当前请求的质量
+func (c *UpstreamQualityController) Current() UpstreamQuality {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	return c.current
+}
+
+// GetStatus 获取状态
+func (c *UpstreamQualityController) GetStatus() UpstreamQualityStatus {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+
+	_, minBandwidth := c.demandLocked(time.Now())
+	return UpstreamQualityStatus{
+		Current:       c.current.String(),
+		Target:        c.target.String(),
+		Max:           c.maxQuality.String(),
+		Subscribers:   len(c.subscribers),
+		MinBandwidth:  minBandwidth,
+		Switches:      c.switches,
+		AwaitKeyframe: c.awaitKeyframe.Load(),
+	}
+}
+
+// Close 停止重评估定时器
+func (c *UpstreamQualityController) Close() {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.closed = true
+	if c.evalTimer != nil {
+		c.evalTimer.Stop()
+		c.evalTimer = nil
+	}
+}
+
+// evaluate 在锁内执行 update，然后按迟滞规则决定是否切换
+func (c *UpstreamQualityController) evaluate(now time.Time, update func()) {
+	c.mu.Lock()
+	if c.closed {
+		c.mu.Unlock()
+		return
+	}
+	if update != nil {
+		update()
+	}
+
+	switched := c.switchLocked(now)
+	c.scheduleLocked(now)
+	target := c.current
+	fn := c.onSwitch
+	c.mu.Unlock()
+
+	if switched && fn != nil {
+		fn(target)
+	}
+}
+
+// switchLocked 按迟滞和关键帧规则决定是否切换，返回是否切换
+func (c *UpstreamQualityController) switchLocked(now time.Time) bool {
+	target := c.targetLocked(now)
+	c.target = target
+	if target == c.current {
+		c.candidate = target
+		return false
+	}
+	if target != c.candidate {
+		c.candidate = target
+		c.candidateSince = now
+	}
+
+	if now.Sub(c.candidateSince) < c.holdLocked(target) {
+		return false
+	}
+	if c.awaitKeyframe.Load() && now.Sub(c.switchedAt) < c.config.KeyframeTimeout {
+		return false
+	}
+
+	c.current = target
+	c.awaitKeyframe.Store(true)
+	c.switchedAt = now
+	c.switches++
+	return true
+}
+
+func (c *UpstreamQualityController) holdLocked(target UpstreamQuality) time.Duration {
+	if target > c.current {
+		return c.config.UpgradeHold
+	}
+	return c.config.DowngradeHold
+}
+
+// scheduleLocked 在下一个到期时间（迟滞、关键帧超时、最早的上报过期）重新评估
+func (c *UpstreamQualityController) scheduleLocked(now time.Time) {
+	var wait time.Duration
+	consider := func(d time.Duration) {
+		if d > 0 && (wait == 0 || d < wait) {
+			wait = d
+		}
+	}
+
+	if c.target != c.current {
+		consider(c.holdLocked(c.target) - now.Sub(c.candidateSince))
+		if c.awaitKeyframe.Load() {
+			consider(c.config.KeyframeTimeout - now.Sub(c.switchedAt))
+		}
+	}
+	if c.config.ReportTTL > 0 {
+		for _, s := range c.subscribers {
+			if s.paused {
+				continue
+			}
+			// 超过 ReportTTL 才算过期
+			consider(c.config.ReportTTL - now.Sub(s.updated) + time.Millisecond)
+		}
+	}
+
+	if c.evalTimer != nil {
+		c.evalTimer.Stop()
+		c.evalTimer = nil
+	}
+	if wait > 0 {
+		c.evalTimer = time.AfterFunc(wait, c.Evaluate)
+	}
+}
+
+// targetLocked 计算目标质量
+func (c *UpstreamQualityController) targetLocked(now time.Time) UpstreamQuality {
+	demand, minBandwidth := c.demandLocked(now)
+	if demand > c.maxQuality {
+		demand = c.maxQuality
+	}
+	if minBandwidth == 0 {
+		return demand
+	}
+	for q := demand; q > UpstreamQualityLow; q-- {
+		need := float64(c.bitrate(q))
+		if q > c.current {
+			need *= c.config.UpgradeHeadroom
+		}
+		if float64(minBandwidth) >= need {
+			return q
+		}
+	}
+	return UpstreamQualityLow
+}
+
+// demandLocked 订阅者视口需要的最高质量，以及已知带宽估计中的最小值
+func (c *UpstreamQualityController) demandLocked(now time.Time) (UpstreamQuality, uint64) {
+	if len(c.subscribers) == 0 {
+		if c.seen {
+			return UpstreamQualityLow, 0
+		}
+		return UpstreamQualityHigh, 0
+	}
+
+	demand := UpstreamQualityLow
+	var minBandwidth uint64
+	active, expired := 0, 0
+	for _, s := range c.subscribers {
+		if s.paused {
+			continue
+		}
+		if c.config.ReportTTL > 0 && now.Sub(s.updated) > c.config.ReportTTL {
+			expired++
+			continue
+		}
+		active++
+		q := c.viewportQuality(s.width, s.height)
+		if s.bandwidth > 0 && (minBandwidth == 0 || s.bandwidth < minBandwidth) {
+			minBandwidth = s.bandwidth
+		}
+		if s.capped && q > s.maxQuality {
+			q = s.maxQuality
+		}
+		if q > demand {
+			demand = q
+		}
+	}
+	if active == 0 {
+		// 只剩上报过期的订阅者：视口未知，按 HIGH；全部暂停：没有人在看
+		if expired > 0 {
+			return UpstreamQualityHigh, 0
+		}
+		return UpstreamQualityLow, 0
+	}
+	return demand, minBandwidth
+}
+
+func (c *UpstreamQualityController) viewportQuality(width, height int) UpstreamQuality {
+	switch {
+	case width <= 0 || height <= 0:
+		return UpstreamQualityHigh
+	case width <= c.config.LowMaxWidth && height <= c.config.LowMaxHeight:
+		return UpstreamQualityLow
+	case width <= c.config.MediumMaxWidth && height <= c.config.MediumMaxHeight:
+		return UpstreamQualityMedium
+	default:
+		return UpstreamQualityHigh
+	}
+}
+
+func (c *UpstreamQualityController) bitrate(q UpstreamQuality) uint64 {
+	switch q {
+	case UpstreamQualityLow:
+		return c.config.LowBitrate
+	case UpstreamQualityMedium:
+		return c.config.MediumBitrate
+	default:
+		return c.config.HighBitrate
+	}
+}
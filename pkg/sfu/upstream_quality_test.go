@@ -0,0 +1,205 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Upstream Quality Tests
+ */
+package sfu
+
+import (
+	"testing"
+	"time"
+)
+
+func newTestUpstreamQuality(t *testing.T) (*UpstreamQualityController, *[]UpstreamQuality) {
+	var switches []UpstreamQuality
+	c := NewUpstreamQualityController(DefaultUpstreamQualityConfig())
+	c.SetOnSwitch(func(q UpstreamQuality) {
+		switches = append(switches, q)
+	})
+	t.Cleanup(c.Close)
+	return c, &switches
+}
+
+func TestUpstreamQualityThumbnailDowngrade(t *testing.T) {
+	c, switches := newTestUpstreamQuality(t)
+	now := time.Now()
+
+	c.UpdateSubscriber("sub-1", 320, 180, 0)
+	c.UpdateSubscriber("sub-2", 480, 270, 0)
+	if len(*switches) != 0 {
+		t.Fatal("Downgrade should wait for DowngradeHold")
+	}
+	if status := c.GetStatus(); status.Target != "low" || status.Current != "high" {
+		t.Errorf("Unexpected status %+v", status)
+	}
+
+	c.evaluate(now.Add(2*time.Second), nil)
+	if len(*switches) != 1 || (*switches)[0] != UpstreamQualityLow {
+		t.Fatalf("Expected switch to LOW, got %v", *switches)
+	}
+
+	// 一个订阅者切到全屏：需要等待关键帧和升级迟滞
+	c.UpdateSubscriber("sub-2", 1920, 1080, 0)
+	c.evaluate(now.Add(3*time.Second), nil)
+	if len(*switches) != 1 {
+		t.Fatal("Upgrade should wait for UpgradeHold")
+	}
+	c.OnKeyframe()
+	c.evaluate(now.Add(10*time.Second), nil)
+	if len(*switches) != 2 || (*switches)[1] != UpstreamQualityHigh {
+		t.Fatalf("Expected switch to HIGH, got %v", *switches)
+	}
+}
+
+func TestUpstreamQualityKeyframeAligned(t *testing.T) {
+	c, switches := newTestUpstreamQuality(t)
+	now := time.Now()
+
+	c.UpdateSubscriber("sub-1", 320, 180, 0)
+	c.evaluate(now.Add(4*time.Second), nil) // -> LOW，等待关键帧
+	if !c.AwaitingKeyframe() {
+		t.Fatal("Expected to await keyframe after switch")
+	}
+
+	c.UpdateSubscriber("sub-1", 960, 540, 0)
+	c.evaluate(now.Add(6*time.Second), nil) // 升级迟滞已满足，但仍在等关键帧
+	if len(*switches) != 1 {
+		t.Fatalf("Switch should wait for keyframe, got %v", *switches)
+	}
+
+	// 超过 KeyframeTimeout 后视为已生效
+	c.evaluate(now.Add(8*time.Second), nil)
+	if len(*switches) != 2 || (*switches)[1] != UpstreamQualityMedium {
+		t.Fatalf("Expected switch to MEDIUM, got %v", *switches)
+	}
+}
+
+func TestUpstreamQualityBandwidthCap(t *testing.T) {
+	c, switches := newTestUpstreamQuality(t)
+	now := time.Now()
+
+	// 全屏但带宽只够 MEDIUM
+	c.UpdateSubscriber("sub-1", 1920, 1080, 5_000_000)
+	c.UpdateSubscriber("sub-2", 1920, 1080, 800_000)
+	c.evaluate(now.Add(2*time.Second), nil)
+	if len(*switches) != 1 || (*switches)[0] != UpstreamQualityMedium {
+		t.Fatalf("Expected switch to MEDIUM, got %v", *switches)
+	}
+	c.OnKeyframe()
+
+	// 带宽恢复到刚好够 HIGH 名义码率，但没有余量：不升级
+	c.UpdateSubscriber("sub-2", 1920, 1080, 2_600_000)
+	c.evaluate(now.Add(10*time.Second), nil)
+	if len(*switches) != 1 {
+		t.Fatalf("Upgrade without headroom should not happen, got %v", *switches)
+	}
+
+	c.UpdateSubscriber("sub-2", 1920, 1080, 4_000_000)
+	c.evaluate(now.Add(20*time.Second), nil)
+	if len(*switches) != 2 || (*switches)[1] != UpstreamQualityHigh {
+		t.Fatalf("Expected switch to HIGH, got %v", *switches)
+	}
+}
+
+func TestUpstreamQualityFlapSuppressed(t *testing.T) {
+	c, switches := newTestUpstreamQuality(t)
+
+	// 视口来回变化，目标不持续，不切换
+	for i := 0; i < 10; i++ {
+		c.UpdateSubscriber("sub-1", 320, 180, 0)
+		c.UpdateSubscriber("sub-1", 1920, 1080, 0)
+	}
+	if len(*switches) != 0 {
+		t.Errorf("Expected no switches while flapping, got %v", *switches)
+	}
+
+	// 所有订阅者离开后没有人在看，不再从公网拉 HIGH
+	c.RemoveSubscriber("sub-1")
+	if status := c.GetStatus(); status.Target != "low" || status.Subscribers != 0 {
+		t.Errorf("Unexpected status %+v", status)
+	}
+}
+
+func TestUpstreamQualityReportExpiry(t *testing.T) {
+	config := DefaultUpstreamQualityConfig()
+	config.DowngradeHold = 20 * time.Millisecond
+	config.ReportTTL = 200 * time.Millisecond
+	c := NewUpstreamQualityController(config)
+	defer c.Close()
+
+	switched := make(chan UpstreamQuality, 4)
+	c.SetOnSwitch(func(q UpstreamQuality) { switched <- q })
+
+	// 全屏订阅者的上报先过期，之后只剩缩略图订阅者；两者都不再上报
+	c.UpdateSubscriber("fullscreen", 1920, 1080, 0)
+	time.Sleep(100 * time.Millisecond)
+	c.UpdateSubscriber("thumbnail", 320, 180, 0)
+
+	select {
+	case q := <-switched:
+		if q != UpstreamQualityLow {
+			t.Fatalf("Expected switch to LOW, got %v", q)
+		}
+	case <-time.After(time.Second):
+		t.Fatalf("Expired report should drop the layer without further reports, status %+v", c.GetStatus())
+	}
+}
+
+// TestUpstreamQualitySubscriberCap 缩略图上限与视口上报一起过期
+func TestUpstreamQualitySubscriberCap(t *testing.T) {
+	c, switches := newTestUpstreamQuality(t)
+	now := time.Now()
+
+	c.SetSubscriberMaxQuality("sub-1", UpstreamQualityLow)
+	c.UpdateSubscriber("sub-1", 1920, 1080, 0)
+	c.evaluate(now.Add(2*time.Second), nil)
+	if len(*switches) != 1 || (*switches)[0] != UpstreamQualityLow {
+		t.Fatalf("Expected switch to LOW, got %v", *switches)
+	}
+
+	// 清除上限后按视口计入需求
+	c.ClearSubscriberMaxQuality("sub-1")
+	if status := c.GetStatus(); status.Target != "high" {
+		t.Errorf("Expected HIGH after clearing the cap, status %+v", status)
+	}
+
+	// 上限和上报都超过 ReportTTL：订阅者不再参与决策，视口未知按 HIGH
+	c.SetSubscriberMaxQuality("sub-1", UpstreamQualityLow)
+	c.evaluate(now.Add(time.Minute), nil)
+	if status := c.GetStatus(); status.Target != "high" {
+		t.Errorf("Cap should expire with ReportTTL, status %+v", status)
+	}
+}
+
+// TestUpstreamQualityAllPaused 所有订阅者暂停视频时降到 LOW，恢复后按最后一次上报的视口计入需求
+func TestUpstreamQualityAllPaused(t *testing.T) {
+	c, switches := newTestUpstreamQuality(t)
+	now := time.Now()
+
+	c.UpdateSubscriber("sub-1", 1920, 1080, 0)
+	c.UpdateSubscriber("sub-2", 1280, 720, 0)
+	c.SetSubscriberPaused("sub-1", true)
+	if status := c.GetStatus(); status.Target != "high" {
+		t.Fatalf("One subscriber still watching, status %+v", status)
+	}
+
+	c.SetSubscriberPaused("sub-2", true)
+	c.evaluate(now.Add(2*time.Second), nil)
+	if len(*switches) != 1 || (*switches)[0] != UpstreamQualityLow {
+		t.Fatalf("Expected switch to LOW with every subscriber paused, got %v", *switches)
+	}
+
+	// 暂停期间上报早已过期，仍然保持 LOW
+	c.evaluate(now.Add(time.Minute), nil)
+	if status := c.GetStatus(); status.Target != "low" || len(*switches) != 1 {
+		t.Errorf("Paused subscribers should not count, status %+v switches %v", status, *switches)
+	}
+
+	// 恢复：沿用暂停前的视口，不需要新的上报
+	c.SetSubscriberPaused("sub-1", false)
+	if status := c.GetStatus(); status.Target != "high" || status.Subscribers != 2 {
+		t.Errorf("Expected the last viewport to count after resume, status %+v", status)
+	}
+}
@@ -0,0 +1,157 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Warm Pool - 预热的订阅者 PeerConnection
+ * 订阅者加入时最耗时的是创建 PeerConnection 和添加 Track；SDP 协商本身由 pion 完成，无法跳过
+ * （CreateAnswer 会把 RTPSender 标记为已协商并启动发送）。
+ * 第一个订阅者协商成功后，后台预先创建若干已添加当前 Track 的 PeerConnection，
+ * 之后的 Offer 到达时直接取用，只剩 SDP 协商。Track 变化时预热的连接作废。
+ */
+package sfu
+
+import (
+	"sync"
+	"sync/atomic"
+
+	"github.com/pion/webrtc/v4"
+)
+
+// WarmPoolConfig 预热池配置
+type WarmPoolConfig struct {
+	Size int // 预热 PeerConnection 数量（0 表示关闭）
+}
+
+// DefaultWarmPoolConfig 默认配置
+func DefaultWarmPoolConfig() WarmPoolConfig {
+	return WarmPoolConfig{
+		Size: 2,
+	}
+}
+
+// WarmPoolStats 预热池统计
+type WarmPoolStats struct {
+	Hits   uint64 `json:"hits"`   // 使用预热连接的订阅者数
+	Misses uint64 `json:"misses"` // 现场创建连接的订阅者数
+	Idle   int    `json:"idle"`   // 当前可用的预热连接
+}
+
+// warmPeerConnection 已添加 Track、等待 Offer 的 PeerConnection
+type warmPeerConnection struct {
+	pc          *webrtc.PeerConnection
+	videoTrack  *webrtc.TrackLocalStaticRTP
+	audioTrack  *webrtc.TrackLocalStaticRTP
+	videoSender *webrtc.RTPSender
+	audioSender *webrtc.RTPSender
+}
+
+// WarmPool 预热 PeerConnection 池
+type WarmPool struct {
+	mu sync.Mutex
+
+	config    WarmPoolConfig
+	warm      []*warmPeerConnection
+	refilling bool
+	closed    bool
+
+	hits   atomic.Uint64
+	misses atomic.Uint64
+}
+
+// NewWarmPool 创建预热池
+func NewWarmPool(config WarmPoolConfig) *WarmPool {
+	return &WarmPool{config: config}
+}
+
+// take 取出一个预热的 PeerConnection（Track 已变化的直接丢弃），没有时返回 nil
+func (p *WarmPool) take(videoTrack, audioTrack *webrtc.TrackLocalStaticRTP) *warmPeerConnection {
+	p.mu.Lock()
+	var stale []*warmPeerConnection
+	var found *warmPeerConnection
+	for len(p.warm) > 0 {
+		w := p.warm[len(p.warm)-1]
+		p.warm = p.warm[:len(p.warm)-1]
+		if w.videoTrack == videoTrack && w.audioTrack == audioTrack {
+			found = w
+			break
+		}
+		stale = append(stale, w)
+	}
+	p.mu.Unlock()
+
+	for _, w := range stale {
+		w.pc.Close()
+	}
+	if found != nil {
+		p.hits.Add(1)
+	} else {
+		p.misses.Add(1)
+	}
+	return found
+}
+
+// refill 后台补充预热池（订阅者协商成功后调用，没有订阅者的房间不预热）
+func (p *WarmPool) refill(create func() (*warmPeerConnection, error)) {
+	p.mu.Lock()
+	if p.refilling || p.closed || len(p.warm) >= p.config.Size {
+		p.mu.Unlock()
+		return
+	}
+	p.refilling = true
+	p.mu.Unlock()
+
+	go func() {
+		for {
+			w, err := create()
+
+			p.mu.Lock()
+			if err != nil || p.closed {
+				p.refilling = false
+				p.mu.Unlock()
+				if w != nil {
+					w.pc.Close()
+				}
+				return
+			}
+			p.warm = append(p.warm, w)
+			if len(p.warm) >= p.config.Size {
+				p.refilling = false
+				p.mu.Unlock()
+				return
+			}
+			p.mu.Unlock()
+		}
+	}()
+}
+
+// flush 关闭所有预热的 PeerConnection（Track 变化时调用）
+func (p *WarmPool) flush() {
+	p.mu.Lock()
+	warm := p.warm
+	p.warm = nil
+	p.mu.Unlock()
+
+	for _, w := range warm {
+		w.pc.Close()
+	}
+}
+
+// Close 关闭预热池
+func (p *WarmPool) Close() {
+	p.mu.Lock()
+	p.closed = true
+	p.mu.Unlock()
+	p.flush()
+}
+
+// GetStats 获取统计
+func (p *WarmPool) GetStats() WarmPoolStats {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	return WarmPoolStats{
+		Hits:   p.hits.Load(),
+		Misses: p.misses.Load(),
+		Idle:   len(p.warm),
+	}
+}
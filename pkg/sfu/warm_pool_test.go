@@ -0,0 +1,121 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Warm Pool Tests
+ */
+package sfu
+
+import (
+	"fmt"
+	"strings"
+	"testing"
+	"time"
+
+	"github.com/pion/webrtc/v4"
+)
+
+// subscriberOffer 生成一个与 Dart 端相同形态的订阅者 Offer（仅接收音视频 + relay-ctrl）
+func subscriberOffer(tb testing.TB) string {
+	tb.Helper()
+	pc, err := webrtc.NewPeerConnection(webrtc.Configuration{})
+	if err != nil {
+		tb.Fatal(err)
+	}
+	defer pc.Close()
+
+	for _, kind := range []webrtc.RTPCodecType{webrtc.RTPCodecTypeVideo, webrtc.RTPCodecTypeAudio} {
+		if _, err := pc.AddTransceiverFromKind(kind, webrtc.RTPTransceiverInit{
+			Direction: webrtc.RTPTransceiverDirectionRecvonly,
+		}); err != nil {
+			tb.Fatal(err)
+		}
+	}
+	if _, err := pc.CreateDataChannel(ControlChannelLabel, nil); err != nil {
+		tb.Fatal(err)
+	}
+	offer, err := pc.CreateOffer(nil)
+	if err != nil {
+		tb.Fatal(err)
+	}
+	return offer.SDP
+}
+
+func TestRelayRoomWarmPoolJoin(t *testing.T) {
+	room, err := NewRelayRoom("warm-room", nil)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer room.Close()
+	room.BecomeRelay("relay-1")
+
+	if _, err := room.AddSubscriber("sub-1", subscriberOffer(t)); err != nil {
+		t.Fatalf("AddSubscriber failed: %v", err)
+	}
+
+	// 等待后台预热
+	deadline := time.Now().Add(5 * time.Second)
+	for room.GetStatus().WarmPool.Idle < DefaultWarmPoolConfig().Size {
+		if time.Now().After(deadline) {
+			t.Fatal("Warm pool not filled")
+		}
+		time.Sleep(10 * time.Millisecond)
+	}
+
+	answer, err := room.AddSubscriber("sub-2", subscriberOffer(t))
+	if err != nil {
+		t.Fatalf("AddSubscriber failed: %v", err)
+	}
+	if !strings.Contains(answer, "m=video") || !strings.Contains(answer, "m=audio") {
+		t.Errorf("Answer missing media sections:\n%s", answer)
+	}
+
+	stats := room.GetStatus().WarmPool
+	if stats.Hits != 1 || stats.Misses != 1 {
+		t.Errorf("Unexpected warm pool stats %+v", stats)
+	}
+
+	// Track 变化后预热的连接失效
+	room.UpdateTracks(nil, nil)
+	if idle := room.GetStatus().WarmPool.Idle; idle != 0 {
+		t.Errorf("Expected warm pool to be flushed, got %d", idle)
+	}
+}
+
+// BenchmarkRelayRoomJoin100 100 个同构订阅者加入的 Answer 生成耗时
+func BenchmarkRelayRoomJoin100(b *testing.B) {
+	offer := subscriberOffer(b)
+
+	cases := []struct {
+		name string
+		opts []RelayRoomOption
+	}{
+		{"cold", []RelayRoomOption{WithWarmPool(WarmPoolConfig{})}},
+		{"warm", []RelayRoomOption{WithWarmPool(WarmPoolConfig{Size: 8})}},
+	}
+	for _, bc := range cases {
+		b.Run(bc.name, func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				b.StopTimer()
+				room, err := NewRelayRoom("bench-room", nil, bc.opts...)
+				if err != nil {
+					b.Fatal(err)
+				}
+				room.BecomeRelay("relay-1")
+				b.StartTimer()
+
+				for j := 0; j < 100; j++ {
+					if _, err := room.AddSubscriber(fmt.Sprintf("sub-%d", j), offer); err != nil {
+						b.Fatal(err)
+					}
+				}
+
+				b.StopTimer()
+				room.Close()
+				b.StartTimer()
+			}
+		})
+	}
+}
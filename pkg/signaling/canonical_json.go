@@ -0,0 +1,244 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Canonical JSON - 识别 encoding/json 生成的 Payload
+ * 二进制编码只在 Payload 与 json.Marshal 的输出逐字节一致时才拆成结构化字段，
+ * 解码时按同样规则重新生成，保证无损。这里直接扫描字节，避免 Unmarshal + Marshal 的开销。
+ * 为简单起见只接受 \n \r \t \" \\ 五种转义，其余写法（\u 转义、<>& 等）一律按原样编码。
+ */
+package signaling
+
+import (
+	"encoding/json"
+	"strconv"
+	"strings"
+	"unicode/utf8"
+)
+
+// scanCanonicalString 扫描 s 开头的 JSON 字符串（s[0] 必须是 '"'）
+// 返回结束引号之后的偏移和反转义后的长度；不是规范写法时 ok 为 false
+func scanCanonicalString(s string) (end, n int, ok bool) {
+	if len(s) == 0 || s[0] != '"' {
+		return 0, 0, false
+	}
+	for i := 1; i < len(s); {
+		b := s[i]
+		switch {
+		case b == '"':
+			return i + 1, n, true
+		case b == '\\':
+			if i+1 >= len(s) {
+				return 0, 0, false
+			}
+			switch s[i+1] {
+			case 'n', 'r', 't', '"', '\\':
+			default:
+				return 0, 0, false
+			}
+			i += 2
+			n++
+		case b < utf8.RuneSelf:
+			if !canonicalASCII(b) {
+				return 0, 0, false
+			}
+			i++
+			n++
+		default:
+			r, size := utf8.DecodeRuneInString(s[i:])
+			if r == utf8.RuneError && size == 1 || r == '\u2028' || r == '\u2029' {
+				return 0, 0, false
+			}
+			i += size
+			n += size
+		}
+	}
+	return 0, 0, false
+}
+
+// canonicalASCII encoding/json 不转义的 ASCII 字符
+func canonicalASCII(b byte) bool {
+	return b >= 0x20 && b != '"' && b != '\\' && b != '<' && b != '>' && b != '&'
+}
+
+// appendUnescaped 反转义（quoted 为不含引号、已通过 scanCanonicalString 校验的内容）
+func appendUnescaped(dst []byte, quoted string) []byte {
+	for {
+		i := strings.IndexByte(quoted, '\\')
+		if i < 0 {
+			return append(dst, quoted...)
+		}
+		dst = append(dst, quoted[:i]...)
+		switch quoted[i+1] {
+		case 'n':
+			dst = append(dst, '\n')
+		case 'r':
+			dst = append(dst, '\r')
+		case 't':
+			dst = append(dst, '\t')
+		default:
+			dst = append(dst, quoted[i+1])
+		}
+		quoted = quoted[i+2:]
+	}
+}
+
+// appendEscaped 按 encoding/json 规则转义并加引号
+func appendEscaped(dst []byte, s []byte) []byte {
+	dst = append(dst, '"')
+	start := 0
+	for i := 0; i < len(s); {
+		b := s[i]
+		if b < utf8.RuneSelf {
+			if canonicalASCII(b) {
+				i++
+				continue
+			}
+			dst = append(dst, s[start:i]...)
+			switch b {
+			case '\n':
+				dst = append(dst, '\\', 'n')
+			case '\r':
+				dst = append(dst, '\\', 'r')
+			case '\t':
+				dst = append(dst, '\\', 't')
+			case '"', '\\':
+				dst = append(dst, '\\', b)
+			default:
+				// 规范写法之外的字符（只会出现在异常帧中），交给 encoding/json
+				quoted, _ := json.Marshal(string(s[i : i+1]))
+				dst = append(dst, quoted[1:len(quoted)-1]...)
+			}
+			i++
+			start = i
+			continue
+		}
+		r, size := utf8.DecodeRune(s[i:])
+		if r == utf8.RuneError && size == 1 || r == '\u2028' || r == '\u2029' {
+			dst = append(dst, s[start:i]...)
+			quoted, _ := json.Marshal(string(s[i : i+size]))
+			dst = append(dst, quoted[1:len(quoted)-1]...)
+			i += size
+			start = i
+			continue
+		}
+		i += size
+	}
+	dst = append(dst, s[start:]...)
+	return append(dst, '"')
+}
+
+// ==========================================
+// {"sdp":"..."}
+// ==========================================
+
+const sdpJSONPrefix = `{"sdp":`
+
+// canonicalSDP 识别 json.Marshal(OfferMessage/AnswerMessage) 的输出
+// 返回转义状态下的 SDP 内容（不含引号）和反转义后的长度
+func canonicalSDP(payload string) (quoted string, n int, ok bool) {
+	if len(payload) < len(sdpJSONPrefix)+3 || payload[:len(sdpJSONPrefix)] != sdpJSONPrefix {
+		return "", 0, false
+	}
+	body := payload[len(sdpJSONPrefix):]
+	end, n, ok := scanCanonicalString(body)
+	if !ok || body[end:] != "}" {
+		return "", 0, false
+	}
+	return body[1 : end-1], n, true
+}
+
+// appendSDPJSON 还原 {"sdp":"..."}
+func appendSDPJSON(dst []byte, sdp []byte) []byte {
+	dst = append(dst, sdpJSONPrefix...)
+	dst = appendEscaped(dst, sdp)
+	return append(dst, '}')
+}
+
+// ==========================================
+// CandidateMessage
+// ==========================================
+
+// canonicalCandidate 识别 json.Marshal(CandidateMessage) 的输出
+// 字段顺序固定为 candidate, sdpMid, sdpMLineIndex, usernameFragment，后三者可省略
+func canonicalCandidate(payload string) (CandidateMessage, bool) {
+	var cand CandidateMessage
+	s := payload
+	if len(s) < 2 || s[0] != '{' || s[len(s)-1] != '}' {
+		return cand, false
+	}
+	s = s[1 : len(s)-1]
+
+	value, rest, ok := canonicalStringField(s, `"candidate":`)
+	if !ok {
+		return cand, false
+	}
+	cand.Candidate = value
+	s = rest
+
+	if value, rest, ok := canonicalStringField(s, `,"sdpMid":`); ok {
+		cand.SDPMid = &value
+		s = rest
+	}
+	const indexKey = `,"sdpMLineIndex":`
+	if len(s) > len(indexKey) && s[:len(indexKey)] == indexKey {
+		s = s[len(indexKey):]
+		end := 0
+		for end < len(s) && s[end] >= '0' && s[end] <= '9' {
+			end++
+		}
+		if end == 0 || end > 1 && s[0] == '0' {
+			return cand, false
+		}
+		v, err := strconv.ParseUint(s[:end], 10, 16)
+		if err != nil {
+			return cand, false
+		}
+		index := uint16(v)
+		cand.SDPMLineIndex = &index
+		s = s[end:]
+	}
+	if value, rest, ok := canonicalStringField(s, `,"usernameFragment":`); ok {
+		cand.UsernameFragment = &value
+		s = rest
+	}
+	return cand, s == ""
+}
+
+// canonicalStringField 解析 key + 规范字符串值
+func canonicalStringField(s, key string) (value, rest string, ok bool) {
+	if len(s) <= len(key) || s[:len(key)] != key {
+		return "", s, false
+	}
+	s = s[len(key):]
+	end, n, ok := scanCanonicalString(s)
+	if !ok {
+		return "", s, false
+	}
+	quoted := s[1 : end-1]
+	if n == len(quoted) {
+		// 没有转义，直接引用
+		return quoted, s[end:], true
+	}
+	return string(appendUnescaped(make([]byte, 0, n), quoted)), s[end:], true
+}
+
+// appendCandidateJSON 按 json.Marshal(CandidateMessage) 的格式还原
+func appendCandidateJSON(dst []byte, cand *CandidateMessage) []byte {
+	dst = append(dst, `{"candidate":`...)
+	dst = appendEscaped(dst, []byte(cand.Candidate))
+	if cand.SDPMid != nil {
+		dst = append(dst, `,"sdpMid":`...)
+		dst = appendEscaped(dst, []byte(*cand.SDPMid))
+	}
+	if cand.SDPMLineIndex != nil {
+		dst = append(dst, `,"sdpMLineIndex":`...)
+		dst = strconv.AppendUint(dst, uint64(*cand.SDPMLineIndex), 10)
+	}
+	if cand.UsernameFragment != nil {
+		dst = append(dst, `,"usernameFragment":`...)
+		dst = appendEscaped(dst, []byte(*cand.UsernameFragment))
+	}
+	return append(dst, '}')
+}
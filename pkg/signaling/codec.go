@@ -0,0 +1,658 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Codec - 紧凑二进制信令编码
+ * JSON 信令中 Payload 本身又是一段 JSON 字符串（双重编码），SDP 中的 \r\n 和引号全部被转义。
+ * 二进制格式：
+ *   帧头: 版本(1) + 类型(1)
+ *   字段: key(uvarint: 字段号<<1 | wire) + 值（wire 0: uvarint；wire 1: uvarint 长度 + 字节）
+ * 未知字段会被跳过，新增字段不影响旧版本解码。
+ * 能无损还原时，候选者 Payload 编码为嵌套结构，{"sdp":...} 只保留 SDP 文本；
+ * SDP 可选用共享字典 deflate 压缩。
+ */
+package signaling
+
+import (
+	"bytes"
+	"compress/flate"
+	"encoding/binary"
+	"errors"
+	"io"
+	"sync"
+)
+
+var (
+	// ErrInvalidFrame indicates a malformed binary signaling frame
+	ErrInvalidFrame = errors.New("invalid signaling frame")
+
+	// ErrUnsupportedVersion indicates an unknown codec version
+	ErrUnsupportedVersion = errors.New("unsupported signaling codec version")
+
+	// ErrUnknownDictionary indicates the SDP dictionary ID is not known locally
+	ErrUnknownDictionary = errors.New("unknown SDP dictionary")
+
+	// ErrPayloadTooLarge indicates a decompressed payload exceeds the limit
+	ErrPayloadTooLarge = errors.New("signaling payload too large")
+)
+
+const codecVersion = 1
+
+// frameKind 帧类型
+type frameKind byte
+
+const (
+	frameMessage   frameKind = 1
+	frameCandidate frameKind = 2
+	frameRoomInfo  frameKind = 3
+)
+
+const (
+	wireVarint = 0
+	wireBytes  = 1
+)
+
+// payloadForm Message.Payload 的编码形式
+const (
+	payloadRaw       = 0 // 原样字节
+	payloadSDPJSON   = 1 // {"sdp":"..."}，只保留 SDP 文本
+	payloadCandidate = 2 // CandidateMessage JSON，编码为嵌套结构
+)
+
+// Message 字段号
+const (
+	msgFieldTypeCode   = 1
+	msgFieldTypeName   = 2
+	msgFieldRoomID     = 3
+	msgFieldPeerID     = 4
+	msgFieldForm       = 5
+	msgFieldPayload    = 6
+	msgFieldDictionary = 7
+)
+
+// knownMessageTypes 已知消息类型编号（只能追加）
+var knownMessageTypes = []MessageType{
+	MessageTypeOffer,
+	MessageTypeAnswer,
+	MessageTypeCandidate,
+	MessageTypePeerJoined,
+	MessageTypePeerLeft,
+	MessageTypeTrackAdded,
+	MessageTypeError,
+	MessageTypeElection,
+	MessageTypeProxyChange,
+}
+
+func messageTypeCode(t MessageType) uint64 {
+	for i, known := range knownMessageTypes {
+		if known == t {
+			return uint64(i + 1)
+		}
+	}
+	return 0
+}
+
+// CodecConfig 编码配置
+type CodecConfig struct {
+	// CompressSDP 使用共享字典压缩 SDP
+	CompressSDP bool
+	// MinCompressSize 小于该长度的 Payload 不压缩
+	MinCompressSize int
+	// MaxPayloadSize 解压后的 Payload 上限（防止解压炸弹）
+	MaxPayloadSize int
+}
+
+// DefaultCodecConfig 默认编码配置
+func DefaultCodecConfig() CodecConfig {
+	return CodecConfig{
+		CompressSDP:     true,
+		MinCompressSize: 256,
+		MaxPayloadSize:  1 << 20,
+	}
+}
+
+// Codec 二进制信令编解码器（并发安全）
+type Codec struct {
+	config CodecConfig
+
+	// deflate 状态较大，复用
+	writers sync.Pool // *flate.Writer（字典为 currentSDPDictionary）
+	readers sync.Pool // io.ReadCloser（实现 flate.Resetter）
+	buffers sync.Pool // *bytes.Buffer
+}
+
+// NewCodec 创建编解码器
+func NewCodec(config CodecConfig) *Codec {
+	if config.MaxPayloadSize <= 0 {
+		config.MaxPayloadSize = 1 << 20
+	}
+	c := &Codec{config: config}
+	c.buffers.New = func() interface{} { return new(bytes.Buffer) }
+	return c
+}
+
+// ==========================================
+// 基础编码
+// ==========================================
+
+func appendKey(dst []byte, field, wire int) []byte {
+	return binary.AppendUvarint(dst, uint64(field)<<1|uint64(wire))
+}
+
+func appendVarintField(dst []byte, field int, v uint64) []byte {
+	dst = appendKey(dst, field, wireVarint)
+	return binary.AppendUvarint(dst, v)
+}
+
+func appendBytesField(dst []byte, field int, b []byte) []byte {
+	dst = appendKey(dst, field, wireBytes)
+	dst = binary.AppendUvarint(dst, uint64(len(b)))
+	return append(dst, b...)
+}
+
+func appendStringField(dst []byte, field int, s string) []byte {
+	if s == "" {
+		return dst
+	}
+	dst = appendKey(dst, field, wireBytes)
+	dst = binary.AppendUvarint(dst, uint64(len(s)))
+	return append(dst, s...)
+}
+
+// appendNested 嵌套结构：子字段直接编码到 dst，再在前面插入长度前缀
+func appendNested(dst []byte, field int, encode func([]byte) []byte) []byte {
+	dst = appendKey(dst, field, wireBytes)
+	mark := len(dst)
+	dst = encode(dst)
+	bodyLen := len(dst) - mark
+
+	var prefix [binary.MaxVarintLen64]byte
+	n := binary.PutUvarint(prefix[:], uint64(bodyLen))
+	dst = append(dst, prefix[:n]...)
+	copy(dst[mark+n:], dst[mark:mark+bodyLen])
+	copy(dst[mark:], prefix[:n])
+	return dst
+}
+
+// fieldReader 字段迭代器
+type fieldReader struct {
+	data []byte
+	err  error
+
+	field int
+	wire  int
+	value uint64 // wire 0
+	bytes []byte // wire 1（引用 data，不拷贝）
+}
+
+// next 读取下一个字段，结束或出错时返回 false
+func (r *fieldReader) next() bool {
+	if r.err != nil || len(r.data) == 0 {
+		return false
+	}
+	key, n := binary.Uvarint(r.data)
+	if n <= 0 {
+		r.err = ErrInvalidFrame
+		return false
+	}
+	r.data = r.data[n:]
+	r.field = int(key >> 1)
+	r.wire = int(key & 1)
+
+	v, n := binary.Uvarint(r.data)
+	if n <= 0 {
+		r.err = ErrInvalidFrame
+		return false
+	}
+	r.data = r.data[n:]
+
+	if r.wire == wireVarint {
+		r.value = v
+		return true
+	}
+	if v > uint64(len(r.data)) {
+		r.err = ErrInvalidFrame
+		return false
+	}
+	r.bytes = r.data[:v]
+	r.data = r.data[v:]
+	return true
+}
+
+func (r *fieldReader) string() string {
+	if r.wire != wireBytes {
+		r.err = ErrInvalidFrame
+		return ""
+	}
+	return string(r.bytes)
+}
+
+func (r *fieldReader) uint() uint64 {
+	if r.wire != wireVarint {
+		r.err = ErrInvalidFrame
+		return 0
+	}
+	return r.value
+}
+
+// checkHeader 校验帧头，返回字段部分
+func checkHeader(data []byte, kind frameKind) ([]byte, error) {
+	if len(data) < 2 {
+		return nil, ErrInvalidFrame
+	}
+	if data[0] != codecVersion {
+		return nil, ErrUnsupportedVersion
+	}
+	if frameKind(data[1]) != kind {
+		return nil, ErrInvalidFrame
+	}
+	return data[2:], nil
+}
+
+// ==========================================
+// Message
+// ==========================================
+
+// AppendMessage 编码 Message 并追加到 dst
+func (c *Codec) AppendMessage(dst []byte, m *Message) []byte {
+	dst = append(dst, codecVersion, byte(frameMessage))
+
+	if code := messageTypeCode(m.Type); code != 0 {
+		dst = appendVarintField(dst, msgFieldTypeCode, code)
+	} else {
+		dst = appendStringField(dst, msgFieldTypeName, string(m.Type))
+	}
+	dst = appendStringField(dst, msgFieldRoomID, m.RoomID)
+	dst = appendStringField(dst, msgFieldPeerID, m.PeerID)
+
+	if m.Payload == "" {
+		return dst
+	}
+
+	switch m.Type {
+	case MessageTypeCandidate:
+		if cand, ok := canonicalCandidate(m.Payload); ok {
+			dst = appendVarintField(dst, msgFieldForm, payloadCandidate)
+			return appendNested(dst, msgFieldPayload, func(b []byte) []byte {
+				return appendCandidateFields(b, &cand)
+			})
+		}
+	case MessageTypeOffer, MessageTypeAnswer:
+		if quoted, n, ok := canonicalSDP(m.Payload); ok {
+			dst = appendVarintField(dst, msgFieldForm, payloadSDPJSON)
+			if c.shouldCompress(n) {
+				buf := c.buffers.Get().(*bytes.Buffer)
+				buf.Reset()
+				buf.Grow(n)
+				sdp := appendUnescaped(buf.AvailableBuffer(), quoted)
+				dst, ok = c.appendCompressed(dst, sdp)
+				c.buffers.Put(buf)
+				if ok {
+					return dst
+				}
+			}
+			dst = appendKey(dst, msgFieldPayload, wireBytes)
+			dst = binary.AppendUvarint(dst, uint64(n))
+			return appendUnescaped(dst, quoted)
+		}
+	}
+
+	if c.shouldCompress(len(m.Payload)) {
+		buf := c.buffers.Get().(*bytes.Buffer)
+		buf.Reset()
+		buf.WriteString(m.Payload)
+		var ok bool
+		dst, ok = c.appendCompressed(dst, buf.Bytes())
+		c.buffers.Put(buf)
+		if ok {
+			return dst
+		}
+	}
+	return appendStringField(dst, msgFieldPayload, m.Payload)
+}
+
+// MarshalMessage 编码 Message
+func (c *Codec) MarshalMessage(m *Message) []byte {
+	return c.AppendMessage(make([]byte, 0, 64+len(m.Payload)), m)
+}
+
+// UnmarshalMessage 解码 Message
+func (c *Codec) UnmarshalMessage(data []byte, m *Message) error {
+	body, err := checkHeader(data, frameMessage)
+	if err != nil {
+		return err
+	}
+
+	*m = Message{}
+	var (
+		form       uint64
+		dictionary uint64
+		payload    []byte
+	)
+	r := fieldReader{data: body}
+	for r.next() {
+		switch r.field {
+		case msgFieldTypeCode:
+			code := r.uint()
+			if code == 0 || code > uint64(len(knownMessageTypes)) {
+				return ErrInvalidFrame
+			}
+			m.Type = knownMessageTypes[code-1]
+		case msgFieldTypeName:
+			m.Type = MessageType(r.string())
+		case msgFieldRoomID:
+			m.RoomID = r.string()
+		case msgFieldPeerID:
+			m.PeerID = r.string()
+		case msgFieldForm:
+			form = r.uint()
+		case msgFieldDictionary:
+			dictionary = r.uint()
+		case msgFieldPayload:
+			if r.wire != wireBytes {
+				return ErrInvalidFrame
+			}
+			payload = r.bytes
+		}
+	}
+	if r.err != nil {
+		return r.err
+	}
+
+	buf := c.buffers.Get().(*bytes.Buffer)
+	buf.Reset()
+	defer c.buffers.Put(buf)
+	if dictionary != 0 {
+		if err := c.decompress(buf, payload, dictionary); err != nil {
+			return err
+		}
+		payload = buf.Bytes()
+	}
+
+	switch form {
+	case payloadRaw:
+		m.Payload = string(payload)
+	case payloadSDPJSON:
+		// 写在 buf 已有内容之后，不会覆盖解压出的 payload
+		buf.Grow(len(payload) + len(payload)/8 + len(sdpJSONPrefix) + 3)
+		m.Payload = string(appendSDPJSON(buf.AvailableBuffer(), payload))
+	case payloadCandidate:
+		var cand CandidateMessage
+		if err := unmarshalCandidateFields(payload, &cand); err != nil {
+			return err
+		}
+		m.Payload = string(appendCandidateJSON(buf.AvailableBuffer(), &cand))
+	default:
+		return ErrInvalidFrame
+	}
+	return nil
+}
+
+// ==========================================
+// SDP 压缩
+// ==========================================
+
+func (c *Codec) shouldCompress(n int) bool {
+	return c.config.CompressSDP && n >= c.config.MinCompressSize
+}
+
+// appendCompressed 共享字典 deflate 后作为 Payload 字段追加，结果不比原文小时返回 false（dst 不变）
+func (c *Codec) appendCompressed(dst []byte, payload []byte) ([]byte, bool) {
+	buf := c.buffers.Get().(*bytes.Buffer)
+	buf.Reset()
+	defer c.buffers.Put(buf)
+
+	w, _ := c.writers.Get().(*flate.Writer)
+	if w == nil {
+		var err error
+		w, err = flate.NewWriterDict(buf, flate.BestCompression, sdpDictionaries[currentSDPDictionary])
+		if err != nil {
+			return dst, false
+		}
+	} else {
+		w.Reset(buf)
+	}
+	defer c.writers.Put(w)
+
+	if _, err := w.Write(payload); err != nil {
+		return dst, false
+	}
+	if err := w.Close(); err != nil {
+		return dst, false
+	}
+	if buf.Len() >= len(payload) {
+		return dst, false
+	}
+	dst = appendVarintField(dst, msgFieldDictionary, currentSDPDictionary)
+	return appendBytesField(dst, msgFieldPayload, buf.Bytes()), true
+}
+
+// decompress 按字典 ID 解压到 out
+func (c *Codec) decompress(out *bytes.Buffer, data []byte, dictionary uint64) error {
+	dict, ok := sdpDictionaries[dictionary]
+	if !ok {
+		return ErrUnknownDictionary
+	}
+
+	src := bytes.NewReader(data)
+	r, _ := c.readers.Get().(io.ReadCloser)
+	if r == nil {
+		r = flate.NewReaderDict(src, dict)
+	} else if err := r.(flate.Resetter).Reset(src, dict); err != nil {
+		return err
+	}
+	defer c.readers.Put(r)
+
+	n, err := out.ReadFrom(io.LimitReader(r, int64(c.config.MaxPayloadSize)+1))
+	if err != nil {
+		return ErrInvalidFrame
+	}
+	if n > int64(c.config.MaxPayloadSize) {
+		return ErrPayloadTooLarge
+	}
+	return nil
+}
+
+// ==========================================
+// CandidateMessage
+// ==========================================
+
+const (
+	candFieldCandidate        = 1
+	candFieldSDPMid           = 2
+	candFieldSDPMLineIndex    = 3
+	candFieldUsernameFragment = 4
+)
+
+// appendCandidateFields 候选者字段（指针字段按是否为 nil 编码，空字符串也保留）
+func appendCandidateFields(dst []byte, cand *CandidateMessage) []byte {
+	dst = appendStringField(dst, candFieldCandidate, cand.Candidate)
+	if cand.SDPMid != nil {
+		dst = appendBytesField(dst, candFieldSDPMid, []byte(*cand.SDPMid))
+	}
+	if cand.SDPMLineIndex != nil {
+		dst = appendVarintField(dst, candFieldSDPMLineIndex, uint64(*cand.SDPMLineIndex))
+	}
+	if cand.UsernameFragment != nil {
+		dst = appendBytesField(dst, candFieldUsernameFragment, []byte(*cand.UsernameFragment))
+	}
+	return dst
+}
+
+func unmarshalCandidateFields(data []byte, cand *CandidateMessage) error {
+	*cand = CandidateMessage{}
+	r := fieldReader{data: data}
+	for r.next() {
+		switch r.field {
+		case candFieldCandidate:
+			cand.Candidate = r.string()
+		case candFieldSDPMid:
+			mid := r.string()
+			cand.SDPMid = &mid
+		case candFieldSDPMLineIndex:
+			v := r.uint()
+			if v > 0xffff {
+				return ErrInvalidFrame
+			}
+			index := uint16(v)
+			cand.SDPMLineIndex = &index
+		case candFieldUsernameFragment:
+			ufrag := r.string()
+			cand.UsernameFragment = &ufrag
+		}
+	}
+	return r.err
+}
+
+// AppendCandidate 编码 CandidateMessage 并追加到 dst
+func (c *Codec) AppendCandidate(dst []byte, cand *CandidateMessage) []byte {
+	dst = append(dst, codecVersion, byte(frameCandidate))
+	return appendCandidateFields(dst, cand)
+}
+
+// MarshalCandidate 编码 CandidateMessage
+func (c *Codec) MarshalCandidate(cand *CandidateMessage) []byte {
+	return c.AppendCandidate(make([]byte, 0, 32+len(cand.Candidate)), cand)
+}
+
+// UnmarshalCandidate 解码 CandidateMessage
+func (c *Codec) UnmarshalCandidate(data []byte, cand *CandidateMessage) error {
+	body, err := checkHeader(data, frameCandidate)
+	if err != nil {
+		return err
+	}
+	return unmarshalCandidateFields(body, cand)
+}
+
+// ==========================================
+// RoomInfo
+// ==========================================
+
+const (
+	roomFieldRoomID    = 1
+	roomFieldPeer      = 2
+	roomFieldProxyID   = 3
+	roomFieldPeerCount = 4
+
+	peerFieldPeerID = 1
+	peerFieldTrack  = 2
+
+	trackFieldTrackID  = 1
+	trackFieldStreamID = 2
+	trackFieldKind     = 3
+)
+
+func appendTrackFields(dst []byte, track *TrackInfo) []byte {
+	dst = appendStringField(dst, trackFieldTrackID, track.TrackID)
+	dst = appendStringField(dst, trackFieldStreamID, track.StreamID)
+	return appendStringField(dst, trackFieldKind, track.Kind)
+}
+
+func appendPeerFields(dst []byte, peer *PeerInfo) []byte {
+	dst = appendStringField(dst, peerFieldPeerID, peer.PeerID)
+	for i := range peer.Tracks {
+		track := &peer.Tracks[i]
+		dst = appendNested(dst, peerFieldTrack, func(b []byte) []byte {
+			return appendTrackFields(b, track)
+		})
+	}
+	return dst
+}
+
+// AppendRoomInfo 编码 RoomInfo 并追加到 dst
+func (c *Codec) AppendRoomInfo(dst []byte, info *RoomInfo) []byte {
+	dst = append(dst, codecVersion, byte(frameRoomInfo))
+	dst = appendStringField(dst, roomFieldRoomID, info.RoomID)
+	for i := range info.Peers {
+		peer := &info.Peers[i]
+		dst = appendNested(dst, roomFieldPeer, func(b []byte) []byte {
+			return appendPeerFields(b, peer)
+		})
+	}
+	dst = appendStringField(dst, roomFieldProxyID, info.ProxyID)
+	if info.PeerCount != 0 {
+		dst = appendVarintField(dst, roomFieldPeerCount, uint64(info.PeerCount))
+	}
+	return dst
+}
+
+// MarshalRoomInfo 编码 RoomInfo
+func (c *Codec) MarshalRoomInfo(info *RoomInfo) []byte {
+	return c.AppendRoomInfo(make([]byte, 0, 64+32*len(info.Peers)), info)
+}
+
+func unmarshalTrack(data []byte) (TrackInfo, error) {
+	var track TrackInfo
+	r := fieldReader{data: data}
+	for r.next() {
+		switch r.field {
+		case trackFieldTrackID:
+			track.TrackID = r.string()
+		case trackFieldStreamID:
+			track.StreamID = r.string()
+		case trackFieldKind:
+			track.Kind = r.string()
+		}
+	}
+	return track, r.err
+}
+
+func unmarshalPeer(data []byte) (PeerInfo, error) {
+	var peer PeerInfo
+	r := fieldReader{data: data}
+	for r.next() {
+		switch r.field {
+		case peerFieldPeerID:
+			peer.PeerID = r.string()
+		case peerFieldTrack:
+			if r.wire != wireBytes {
+				return peer, ErrInvalidFrame
+			}
+			track, err := unmarshalTrack(r.bytes)
+			if err != nil {
+				return peer, err
+			}
+			peer.Tracks = append(peer.Tracks, track)
+		}
+	}
+	return peer, r.err
+}
+
+// UnmarshalRoomInfo 解码 RoomInfo
+func (c *Codec) UnmarshalRoomInfo(data []byte, info *RoomInfo) error {
+	body, err := checkHeader(data, frameRoomInfo)
+	if err != nil {
+		return err
+	}
+
+	*info = RoomInfo{}
+	r := fieldReader{data: body}
+	for r.next() {
+		switch r.field {
+		case roomFieldRoomID:
+			info.RoomID = r.string()
+		case roomFieldPeer:
+			if r.wire != wireBytes {
+				return ErrInvalidFrame
+			}
+			peer, err := unmarshalPeer(r.bytes)
+			if err != nil {
+				return err
+			}
+			info.Peers = append(info.Peers, peer)
+		case roomFieldProxyID:
+			info.ProxyID = r.string()
+		case roomFieldPeerCount:
+			info.PeerCount = int(r.uint())
+		}
+	}
+	if r.err != nil {
+		return r.err
+	}
+	// JSON 中 peers 没有 omitempty，保持与 encoding/json 解码结果一致
+	if info.Peers == nil {
+		info.Peers = []PeerInfo{}
+	}
+	return nil
+}
@@ -0,0 +1,420 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Codec Tests
+ */
+package signaling
+
+import (
+	"encoding/json"
+	"reflect"
+	"strings"
+	"testing"
+)
+
+// testOfferSDP Chrome 风格的音视频 + DataChannel Offer
+var testOfferSDP = strings.Join([]string{
+	"v=0",
+	"o=- 4611731400430051336 2 IN IP4 127.0.0.1",
+	"s=-",
+	"t=0 0",
+	"a=group:BUNDLE 0 1 2",
+	"a=extmap-allow-mixed",
+	"a=msid-semantic: WMS 3b5e1c2a-7d4f-4a1e-9c0b-8f2d6e5a4b3c",
+	"m=audio 9 UDP/TLS/RTP/SAVPF 111 63 9 0 8 13 110 126",
+	"c=IN IP4 0.0.0.0",
+	"a=rtcp:9 IN IP4 0.0.0.0",
+	"a=ice-ufrag:Fh3k",
+	"a=ice-pwd:q8Zx2Lw9RtYb6NcVm4PaSd1E",
+	"a=ice-options:trickle",
+	"a=fingerprint:sha-256 4E:1A:9C:77:0B:3D:52:E8:6F:A1:C4:29:DB:85:13:F0:6E:2B:97:48:AC:D5:31:0F:8B:64:E2:19:7D:C3:5A:B6",
+	"a=setup:actpass",
+	"a=mid:0",
+	"a=extmap:1 urn:ietf:params:rtp-hdrext:ssrc-audio-level",
+	"a=extmap:2 http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time",
+	"a=extmap:3 http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01",
+	"a=extmap:4 urn:ietf:params:rtp-hdrext:sdes:mid",
+	"a=sendrecv",
+	"a=msid:3b5e1c2a-7d4f-4a1e-9c0b-8f2d6e5a4b3c 9a8b7c6d-5e4f-4321-abcd-ef0123456789",
+	"a=rtcp-mux",
+	"a=rtcp-rsize",
+	"a=rtpmap:111 opus/48000/2",
+	"a=rtcp-fb:111 transport-cc",
+	"a=fmtp:111 minptime=10;useinbandfec=1",
+	"a=rtpmap:63 red/48000/2",
+	"a=fmtp:63 111/111",
+	"a=rtpmap:9 G722/8000",
+	"a=rtpmap:0 PCMU/8000",
+	"a=rtpmap:8 PCMA/8000",
+	"a=rtpmap:13 CN/8000",
+	"a=rtpmap:110 telephone-event/48000",
+	"a=rtpmap:126 telephone-event/8000",
+	"a=ssrc:1723840561 cname:Vq3mXb8TzK0pLw2R",
+	"a=ssrc:1723840561 msid:3b5e1c2a-7d4f-4a1e-9c0b-8f2d6e5a4b3c 9a8b7c6d-5e4f-4321-abcd-ef0123456789",
+	"m=video 9 UDP/TLS/RTP/SAVPF 96 97 102 103 98 99",
+	"c=IN IP4 0.0.0.0",
+	"a=rtcp:9 IN IP4 0.0.0.0",
+	"a=ice-ufrag:Fh3k",
+	"a=ice-pwd:q8Zx2Lw9RtYb6NcVm4PaSd1E",
+	"a=ice-options:trickle",
+	"a=fingerprint:sha-256 4E:1A:9C:77:0B:3D:52:E8:6F:A1:C4:29:DB:85:13:F0:6E:2B:97:48:AC:D5:31:0F:8B:64:E2:19:7D:C3:5A:B6",
+	"a=setup:actpass",
+	"a=mid:1",
+	"a=extmap:9 urn:ietf:params:rtp-hdrext:toffset",
+	"a=extmap:2 http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time",
+	"a=extmap:13 urn:3gpp:video-orientation",
+	"a=extmap:3 http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01",
+	"a=extmap:5 http://www.webrtc.org/experiments/rtp-hdrext/playout-delay",
+	"a=extmap:4 urn:ietf:params:rtp-hdrext:sdes:mid",
+	"a=extmap:10 urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id",
+	"a=extmap:11 urn:ietf:params:rtp-hdrext:sdes:repaired-rtp-stream-id",
+	"a=sendrecv",
+	"a=msid:3b5e1c2a-7d4f-4a1e-9c0b-8f2d6e5a4b3c 1f2e3d4c-5b6a-4789-9876-543210fedcba",
+	"a=rtcp-mux",
+	"a=rtcp-rsize",
+	"a=rtpmap:96 VP8/90000",
+	"a=rtcp-fb:96 goog-remb",
+	"a=rtcp-fb:96 transport-cc",
+	"a=rtcp-fb:96 ccm fir",
+	"a=rtcp-fb:96 nack",
+	"a=rtcp-fb:96 nack pli",
+	"a=rtpmap:97 rtx/90000",
+	"a=fmtp:97 apt=96",
+	"a=rtpmap:102 H264/90000",
+	"a=rtcp-fb:102 goog-remb",
+	"a=rtcp-fb:102 transport-cc",
+	"a=rtcp-fb:102 ccm fir",
+	"a=rtcp-fb:102 nack",
+	"a=rtcp-fb:102 nack pli",
+	"a=fmtp:102 level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42e01f",
+	"a=rtpmap:103 rtx/90000",
+	"a=fmtp:103 apt=102",
+	"a=rtpmap:98 VP9/90000",
+	"a=fmtp:98 profile-id=0",
+	"a=rtpmap:99 rtx/90000",
+	"a=fmtp:99 apt=98",
+	"a=ssrc-group:FID 2958117263 3441029581",
+	"a=ssrc:2958117263 cname:Vq3mXb8TzK0pLw2R",
+	"a=ssrc:3441029581 cname:Vq3mXb8TzK0pLw2R",
+	"m=application 9 UDP/DTLS/SCTP webrtc-datachannel",
+	"c=IN IP4 0.0.0.0",
+	"a=ice-ufrag:Fh3k",
+	"a=ice-pwd:q8Zx2Lw9RtYb6NcVm4PaSd1E",
+	"a=ice-options:trickle",
+	"a=fingerprint:sha-256 4E:1A:9C:77:0B:3D:52:E8:6F:A1:C4:29:DB:85:13:F0:6E:2B:97:48:AC:D5:31:0F:8B:64:E2:19:7D:C3:5A:B6",
+	"a=setup:actpass",
+	"a=mid:2",
+	"a=sctp-port:5000",
+	"a=max-message-size:262144",
+	"",
+}, "\r\n")
+
+func strPtr(s string) *string { return &s }
+func u16Ptr(v uint16) *uint16 { return &v }
+
+func offerMessage(t testing.TB) Message {
+	payload, err := json.Marshal(OfferMessage{SDP: testOfferSDP})
+	if err != nil {
+		t.Fatal(err)
+	}
+	return Message{Type: MessageTypeOffer, RoomID: "room-1", PeerID: "peer-1", Payload: string(payload)}
+}
+
+func candidateMessage(t testing.TB) Message {
+	payload, err := json.Marshal(CandidateMessage{
+		Candidate:        "candidate:842163049 1 udp 1677729535 203.0.113.7 54321 typ srflx raddr 192.168.1.20 rport 54321 generation 0 ufrag Fh3k network-cost 10",
+		SDPMid:           strPtr("0"),
+		SDPMLineIndex:    u16Ptr(0),
+		UsernameFragment: strPtr("Fh3k"),
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	return Message{Type: MessageTypeCandidate, RoomID: "room-1", PeerID: "peer-1", Payload: string(payload)}
+}
+
+func TestCodecMessageRoundTrip(t *testing.T) {
+	messages := []Message{
+		offerMessage(t),
+		candidateMessage(t),
+		{Type: MessageTypePeerJoined, RoomID: "room-1", PeerID: "peer-2"},
+		{Type: MessageType("custom"), PeerID: "peer-3", Payload: "opaque"},
+		// 非规范 JSON（字段顺序、空格）必须原样保留
+		{Type: MessageTypeAnswer, Payload: `{ "sdp" : "v=0\r\n" }`},
+		{Type: MessageTypeCandidate, Payload: `{"sdpMid":"0","candidate":"x"}`},
+		{Type: MessageTypeCandidate, Payload: `{"candidate":"x","sdpMid":""}`},
+		{Type: MessageTypeError, Payload: `{"code":500,"message":"boom"}`},
+	}
+
+	for _, config := range []CodecConfig{DefaultCodecConfig(), {}} {
+		codec := NewCodec(config)
+		for _, msg := range messages {
+			data := codec.MarshalMessage(&msg)
+			var got Message
+			if err := codec.UnmarshalMessage(data, &got); err != nil {
+				t.Fatalf("%s: %v", msg.Type, err)
+			}
+			if got != msg {
+				t.Errorf("%s: got %+v, want %+v", msg.Type, got, msg)
+			}
+		}
+	}
+}
+
+// TestCanonicalJSONMatchesEncodingJSON 快速路径的转义规则必须与 encoding/json 完全一致
+func TestCanonicalJSONMatchesEncodingJSON(t *testing.T) {
+	inputs := []string{
+		"",
+		"v=0\r\nm=audio 9 UDP/TLS/RTP/SAVPF 111\r\n",
+		"tab\there \"quoted\" back\\slash",
+		"html <b>&amp;</b>",
+		"ctrl \x00\x01\x1f\x7f \b\f",
+		"unicode 中文 \u2028 \u2029 😀",
+		"invalid \xff\xfe utf8",
+	}
+	for _, in := range inputs {
+		want, _ := json.Marshal(OfferMessage{SDP: in})
+		if got := appendSDPJSON(nil, []byte(in)); string(got) != string(want) {
+			t.Errorf("appendSDPJSON(%q) = %s, want %s", in, got, want)
+		}
+
+		quoted, n, ok := canonicalSDP(string(want))
+		if !ok {
+			continue
+		}
+		var decoded OfferMessage
+		json.Unmarshal(want, &decoded)
+		if got := appendUnescaped(nil, quoted); string(got) != decoded.SDP || n != len(got) {
+			t.Errorf("appendUnescaped(%q) = %q (n=%d), want %q", quoted, got, n, decoded.SDP)
+		}
+
+		cand := CandidateMessage{Candidate: in, SDPMid: strPtr(in), SDPMLineIndex: u16Ptr(3)}
+		want, _ = json.Marshal(cand)
+		if got := appendCandidateJSON(nil, &cand); string(got) != string(want) {
+			t.Errorf("appendCandidateJSON(%q) = %s, want %s", in, got, want)
+		}
+		if parsed, ok := canonicalCandidate(string(want)); !ok || !reflect.DeepEqual(parsed, cand) {
+			t.Errorf("canonicalCandidate(%s) = %+v, %v", want, parsed, ok)
+		}
+	}
+
+	// 非规范写法不能走结构化编码
+	for _, in := range []string{
+		`{"sdp":"\u0041"}`,
+		`{"sdp":"a\/b"}`,
+		`{"sdp":"<"}`,
+		`{"sdp":"x"} `,
+		`{"candidate":"x","sdpMLineIndex":01}`,
+		`{"candidate":"x","sdpMLineIndex":70000}`,
+		`{"candidate":"x","extra":1}`,
+	} {
+		_, _, sdpOK := canonicalSDP(in)
+		_, candOK := canonicalCandidate(in)
+		if sdpOK || candOK {
+			t.Errorf("%s treated as canonical", in)
+		}
+	}
+}
+
+func TestCodecCandidateRoundTrip(t *testing.T) {
+	codec := NewCodec(DefaultCodecConfig())
+	candidates := []CandidateMessage{
+		{Candidate: "candidate:1 1 udp 2122260223 192.168.1.20 50000 typ host"},
+		{Candidate: "c", SDPMid: strPtr(""), SDPMLineIndex: u16Ptr(0), UsernameFragment: strPtr("")},
+		{Candidate: "c", SDPMid: strPtr("video"), SDPMLineIndex: u16Ptr(65535)},
+	}
+	for i, cand := range candidates {
+		var got CandidateMessage
+		if err := codec.UnmarshalCandidate(codec.MarshalCandidate(&cand), &got); err != nil {
+			t.Fatalf("candidate %d: %v", i, err)
+		}
+		if !reflect.DeepEqual(got, cand) {
+			t.Errorf("candidate %d: got %+v, want %+v", i, got, cand)
+		}
+	}
+}
+
+func TestCodecRoomInfoRoundTrip(t *testing.T) {
+	codec := NewCodec(DefaultCodecConfig())
+	infos := []RoomInfo{
+		{RoomID: "empty", Peers: []PeerInfo{}},
+		{
+			RoomID: "room-1",
+			Peers: []PeerInfo{
+				{PeerID: "peer-1", Tracks: []TrackInfo{
+					{TrackID: "t-audio", StreamID: "s-1", Kind: "audio"},
+					{TrackID: "t-video", StreamID: "s-1", Kind: "video"},
+				}},
+				{PeerID: "peer-2"},
+			},
+			ProxyID:   "peer-1",
+			PeerCount: 2,
+		},
+	}
+	for _, info := range infos {
+		var got RoomInfo
+		if err := codec.UnmarshalRoomInfo(codec.MarshalRoomInfo(&info), &got); err != nil {
+			t.Fatalf("%s: %v", info.RoomID, err)
+		}
+		if !reflect.DeepEqual(got, info) {
+			t.Errorf("%s: got %+v, want %+v", info.RoomID, got, info)
+		}
+	}
+}
+
+func TestCodecInvalid(t *testing.T) {
+	codec := NewCodec(DefaultCodecConfig())
+	msg := offerMessage(t)
+	valid := codec.MarshalMessage(&msg)
+
+	inputs := map[string]struct {
+		data []byte
+		want error
+	}{
+		"empty":       {nil, ErrInvalidFrame},
+		"version":     {[]byte{9, byte(frameMessage)}, ErrUnsupportedVersion},
+		"kind":        {codec.MarshalRoomInfo(&RoomInfo{RoomID: "r"}), ErrInvalidFrame},
+		"truncated":   {valid[:len(valid)-10], ErrInvalidFrame},
+		"bad type":    {[]byte{codecVersion, byte(frameMessage), msgFieldTypeCode << 1, 200}, ErrInvalidFrame},
+		"dictionary":  {[]byte{codecVersion, byte(frameMessage), msgFieldDictionary << 1, 99, msgFieldPayload<<1 | 1, 0}, ErrUnknownDictionary},
+		"bad varint":  {[]byte{codecVersion, byte(frameMessage), 0xff}, ErrInvalidFrame},
+		"wrong wire":  {[]byte{codecVersion, byte(frameMessage), msgFieldRoomID << 1, 1}, ErrInvalidFrame},
+		"unknown frm": {[]byte{codecVersion, byte(frameMessage), msgFieldForm << 1, 9}, ErrInvalidFrame},
+	}
+	for name, in := range inputs {
+		var got Message
+		if err := codec.UnmarshalMessage(in.data, &got); err != in.want {
+			t.Errorf("%s: expected %v, got %v", name, in.want, err)
+		}
+	}
+}
+
+func TestCodecDecompressLimit(t *testing.T) {
+	msg := Message{Type: MessageTypeOffer, Payload: strings.Repeat("a=rtcp-mux\r\n", 1000)}
+	data := NewCodec(DefaultCodecConfig()).MarshalMessage(&msg)
+
+	limited := NewCodec(CodecConfig{MaxPayloadSize: 1024})
+	var got Message
+	if err := limited.UnmarshalMessage(data, &got); err != ErrPayloadTooLarge {
+		t.Errorf("Expected ErrPayloadTooLarge, got %v", err)
+	}
+}
+
+func TestCodecUnknownFieldsSkipped(t *testing.T) {
+	codec := NewCodec(DefaultCodecConfig())
+	msg := Message{Type: MessageTypePeerLeft, PeerID: "peer-1"}
+	data := codec.MarshalMessage(&msg)
+	// 新版本追加的字段
+	data = appendStringField(data, 30, "future")
+	data = appendVarintField(data, 31, 12345)
+
+	var got Message
+	if err := codec.UnmarshalMessage(data, &got); err != nil {
+		t.Fatal(err)
+	}
+	if got != msg {
+		t.Errorf("got %+v, want %+v", got, msg)
+	}
+}
+
+func TestCodecSizeVersusJSON(t *testing.T) {
+	compressed := NewCodec(DefaultCodecConfig())
+	plain := NewCodec(CodecConfig{})
+
+	for _, msg := range []Message{offerMessage(t), candidateMessage(t)} {
+		jsonData, _ := json.Marshal(msg)
+		binData := plain.MarshalMessage(&msg)
+		zData := compressed.MarshalMessage(&msg)
+		t.Logf("%-9s json=%d binary=%d binary+dict=%d", msg.Type, len(jsonData), len(binData), len(zData))
+
+		if len(binData) >= len(jsonData) {
+			t.Errorf("%s: binary (%d) not smaller than JSON (%d)", msg.Type, len(binData), len(jsonData))
+		}
+		if len(zData) > len(binData) {
+			t.Errorf("%s: compression grew payload (%d > %d)", msg.Type, len(zData), len(binData))
+		}
+	}
+
+	// 共享字典压缩后的 Offer 应明显小于原文
+	msg := offerMessage(t)
+	if n := len(compressed.MarshalMessage(&msg)); n*3 > len(testOfferSDP) {
+		t.Errorf("Compressed offer too large: %d of %d", n, len(testOfferSDP))
+	}
+}
+
+func BenchmarkMessageEncodeJSON(b *testing.B) {
+	msg := offerMessage(b)
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		if _, err := json.Marshal(&msg); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
+
+func BenchmarkMessageEncodeBinary(b *testing.B) {
+	msg := offerMessage(b)
+	codec := NewCodec(CodecConfig{})
+	buf := make([]byte, 0, 4096)
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		buf = codec.AppendMessage(buf[:0], &msg)
+	}
+}
+
+func BenchmarkMessageEncodeBinaryCompressed(b *testing.B) {
+	msg := offerMessage(b)
+	codec := NewCodec(DefaultCodecConfig())
+	buf := make([]byte, 0, 4096)
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		buf = codec.AppendMessage(buf[:0], &msg)
+	}
+}
+
+func BenchmarkMessageDecodeJSON(b *testing.B) {
+	msg := offerMessage(b)
+	data, _ := json.Marshal(&msg)
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		var got Message
+		if err := json.Unmarshal(data, &got); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
+
+func BenchmarkMessageDecodeBinary(b *testing.B) {
+	msg := offerMessage(b)
+	codec := NewCodec(CodecConfig{})
+	data := codec.MarshalMessage(&msg)
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		var got Message
+		if err := codec.UnmarshalMessage(data, &got); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
+
+func BenchmarkCandidateEncodeJSON(b *testing.B) {
+	msg := candidateMessage(b)
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		if _, err := json.Marshal(&msg); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
+
+func BenchmarkCandidateEncodeBinary(b *testing.B) {
+	msg := candidateMessage(b)
+	codec := NewCodec(CodecConfig{})
+	buf := make([]byte, 0, 512)
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		buf = codec.AppendMessage(buf[:0], &msg)
+	}
+}
@@ -0,0 +1,60 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * SDP Dictionary - SDP 压缩共享字典
+ * 收发双方必须使用同一份字典，字典内容变化时必须分配新的 ID，旧 ID 不能复用。
+ * deflate 对距离更近的匹配编码更短，所以最常见的片段放在末尾。
+ */
+package signaling
+
+// sdpDictionaryV1 字典 ID 1：Chrome / Safari / pion 常见的 SDP 片段
+const sdpDictionaryV1 = "" +
+	"a=rtpmap:102 H264/90000\r\na=rtcp-fb:102 goog-remb\r\na=rtcp-fb:102 transport-cc\r\n" +
+	"a=rtcp-fb:102 ccm fir\r\na=rtcp-fb:102 nack\r\na=rtcp-fb:102 nack pli\r\n" +
+	"a=fmtp:102 level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42e01f\r\n" +
+	"a=rtpmap:98 VP9/90000\r\na=fmtp:98 profile-id=0\r\na=rtpmap:45 AV1/90000\r\n" +
+	"a=rtpmap:63 red/48000/2\r\na=fmtp:63 111/111\r\na=rtpmap:9 G722/8000\r\n" +
+	"a=rtpmap:0 PCMU/8000\r\na=rtpmap:8 PCMA/8000\r\na=rtpmap:13 CN/8000\r\n" +
+	"a=rtpmap:110 telephone-event/48000\r\na=rtpmap:126 telephone-event/8000\r\n" +
+	"a=rtpmap:118 flexfec-03/90000\r\na=rtpmap:99 rtx/90000\r\na=fmtp:99 apt=98\r\n" +
+	"m=application 9 UDP/DTLS/SCTP webrtc-datachannel\r\na=sctp-port:5000\r\na=max-message-size:262144\r\n" +
+	"a=candidate: 1 udp 2122260223 typ host generation 0 network-id 1\r\n" +
+	" typ srflx raddr 0.0.0.0 rport 0 generation 0 network-id 1 network-cost 10\r\n" +
+	"a=end-of-candidates\r\n" +
+	"a=extmap:4 urn:ietf:params:rtp-hdrext:sdes:mid\r\n" +
+	"a=extmap:2 http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time\r\n" +
+	"a=extmap:3 http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01\r\n" +
+	"a=extmap:1 urn:ietf:params:rtp-hdrext:ssrc-audio-level\r\n" +
+	"a=extmap:9 urn:ietf:params:rtp-hdrext:toffset\r\n" +
+	"a=extmap:13 urn:3gpp:video-orientation\r\n" +
+	"a=extmap:5 http://www.webrtc.org/experiments/rtp-hdrext/playout-delay\r\n" +
+	"a=extmap:6 http://www.webrtc.org/experiments/rtp-hdrext/video-content-type\r\n" +
+	"a=extmap:7 http://www.webrtc.org/experiments/rtp-hdrext/video-timing\r\n" +
+	"a=extmap:8 http://www.webrtc.org/experiments/rtp-hdrext/color-space\r\n" +
+	"a=extmap:10 urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id\r\n" +
+	"a=extmap:11 urn:ietf:params:rtp-hdrext:sdes:repaired-rtp-stream-id\r\n" +
+	"a=ssrc-group:FID \r\na=ssrc: cname:\r\na=ssrc: msid:\r\n" +
+	"a=rtpmap:97 rtx/90000\r\na=fmtp:97 apt=96\r\n" +
+	"a=rtpmap:96 VP8/90000\r\na=rtcp-fb:96 goog-remb\r\na=rtcp-fb:96 transport-cc\r\n" +
+	"a=rtcp-fb:96 ccm fir\r\na=rtcp-fb:96 nack\r\na=rtcp-fb:96 nack pli\r\n" +
+	"m=video 9 UDP/TLS/RTP/SAVPF 96 97 102 103 98 99 45 46 118\r\n" +
+	"a=rtpmap:111 opus/48000/2\r\na=rtcp-fb:111 transport-cc\r\n" +
+	"a=fmtp:111 minptime=10;useinbandfec=1\r\n" +
+	"m=audio 9 UDP/TLS/RTP/SAVPF 111 63 9 0 8 13 110 126\r\n" +
+	"c=IN IP4 0.0.0.0\r\na=rtcp:9 IN IP4 0.0.0.0\r\n" +
+	"a=ice-options:trickle\r\na=fingerprint:sha-256 \r\n" +
+	"a=setup:actpass\r\na=setup:active\r\na=setup:passive\r\n" +
+	"a=sendrecv\r\na=recvonly\r\na=sendonly\r\na=inactive\r\n" +
+	"a=msid:- \r\na=rtcp-mux\r\na=rtcp-rsize\r\na=ice-ufrag:\r\na=ice-pwd:\r\na=mid:\r\n" +
+	"v=0\r\no=- 2 IN IP4 127.0.0.1\r\ns=-\r\nt=0 0\r\n" +
+	"a=group:BUNDLE 0 1\r\na=extmap-allow-mixed\r\na=msid-semantic: WMS\r\n"
+
+// sdpDictionaries 字典 ID -> 字典内容（ID 0 表示不压缩）
+var sdpDictionaries = map[uint64][]byte{
+	1: []byte(sdpDictionaryV1),
+}
+
+// currentSDPDictionary 编码时使用的字典 ID
+const currentSDPDictionary = 1
@@ -17,6 +17,7 @@ import "C"
 
 import (
 	"encoding/json"
+	"strings"
 	"sync"
 	"unsafe"
 
@@ -32,9 +33,17 @@ var (
 	coordinators     sync.Map // roomID -> *sfu.ProxyModeCoordinator
 )
 
+// 事件类型扩展
+const (
+	EventTypeActiveSpeaker  = 30 // 活跃发言者变化
+	EventTypeDeviceThrottle = 31 // 设备负载限制变化，data: {"level","reason","max_subscribers","max_upstream","handoff"}
+	EventTypeHandoff        = 32 // 计划内 Relay 移交，data: {"phase","relay","successor","epoch",...}
+)
+
 // registerSourceSwitcher 注册 SourceSwitcher
 func registerSourceSwitcher(roomID string, ss *sfu.SourceSwitcher) {
 	sourceSwitchers.Store(roomID, ss)
+	bumpSwitcherGeneration(roomID)
 }
 
 // getSourceSwitcher 获取 SourceSwitcher
@@ -50,6 +59,7 @@ func unregisterSourceSwitcher(roomID string) {
 	if v, ok := sourceSwitchers.Load(roomID); ok {
 		v.(*sfu.SourceSwitcher).Close()
 		sourceSwitchers.Delete(roomID)
+		bumpSwitcherGeneration(roomID)
 	}
 }
 
@@ -80,6 +90,11 @@ func SourceSwitcherCreate(roomID *C.char) C.int {
 		emitEvent(EventTypeProxyChange, rID, sharerID, string(data))
 	})
 
+	// 设置活跃发言者回调
+	ss.SetOnActiveSpeakersChanged(func(rID string, speakers []sfu.ActiveSpeaker) {
+		emitActiveSpeakers(rID, speakers)
+	})
+
 	registerSourceSwitcher(goRoomID, ss)
 	utils.Info("SourceSwitcher created for room: %s", goRoomID)
 	return C.int(0)
@@ -108,8 +123,11 @@ func SourceSwitcherInjectSFU(roomID *C.char, isVideo C.int, data unsafe.Pointer,
 		return C.int(-1)
 	}
 
-	// 转换 C 数据为 Go slice
-	goData := C.GoBytes(data, dataLen)
+	if data == nil || dataLen <= 0 {
+		return C.int(-1)
+	}
+	// 直接引用调用方内存：InjectSFUPacket 返回后不再持有，无需 GoBytes 拷贝
+	goData := unsafe.Slice((*byte)(data), int(dataLen))
 
 	if err := ss.InjectSFUPacket(isVideo != 0, goData); err != nil {
 		return C.int(-1)
@@ -127,7 +145,10 @@ func SourceSwitcherInjectLocal(roomID *C.char, isVideo C.int, data unsafe.Pointe
 		return C.int(-1)
 	}
 
-	goData := C.GoBytes(data, dataLen)
+	if data == nil || dataLen <= 0 {
+		return C.int(-1)
+	}
+	goData := unsafe.Slice((*byte)(data), int(dataLen))
 
 	if err := ss.InjectLocalPacket(isVideo != 0, goData); err != nil {
 		return C.int(-1)
@@ -211,6 +232,121 @@ func SourceSwitcherIsLocalSharing(roomID *C.char) C.int {
 	return C.int(0)
 }
 
+// resolveSourceSwitcher 优先取 Coordinator 内部的 SourceSwitcher，其次取独立实例
+func resolveSourceSwitcher(roomID string) *sfu.SourceSwitcher {
+	if coord := getCoordinator(roomID); coord != nil {
+		if ss := coord.GetSourceSwitcher(); ss != nil {
+			return ss
+		}
+	}
+	return getSourceSwitcher(roomID)
+}
+
+// SourceSwitcherStartCapture 开始抓包（pcap 格式）
+// 记录注入的所有 RTP 包及到达时间，用于离线回放压测
+//
+//export SourceSwitcherStartCapture
+func SourceSwitcherStartCapture(roomID *C.char, path *C.char) C.int {
+	goRoomID := C.GoString(roomID)
+	goPath := C.GoString(path)
+
+	ss := resolveSourceSwitcher(goRoomID)
+	if ss == nil {
+		return C.int(-1)
+	}
+
+	if err := ss.StartCapture(goPath, sfu.DefaultRTPCaptureConfig()); err != nil {
+		utils.Error("Failed to start capture for room %s: %v", goRoomID, err)
+		return C.int(-1)
+	}
+	return C.int(0)
+}
+
+// SourceSwitcherStopCapture 停止抓包
+// 返回 JSON 格式的抓包统计
+//
+//export SourceSwitcherStopCapture
+func SourceSwitcherStopCapture(roomID *C.char) *C.char {
+	goRoomID := C.GoString(roomID)
+
+	ss := resolveSourceSwitcher(goRoomID)
+	if ss == nil {
+		return nil
+	}
+
+	stats, err := ss.StopCapture()
+	if err != nil {
+		utils.Error("Capture for room %s finished with error: %v", goRoomID, err)
+	}
+	data, _ := json.Marshal(stats)
+	return C.CString(string(data))
+}
+
+// SourceSwitcherGetActiveSpeakers 获取当前活跃发言者
+// 返回 JSON 数组（按能量降序）
+//
+//export SourceSwitcherGetActiveSpeakers
+func SourceSwitcherGetActiveSpeakers(roomID *C.char) *C.char {
+	goRoomID := C.GoString(roomID)
+
+	ss := resolveSourceSwitcher(goRoomID)
+	if ss == nil {
+		return nil
+	}
+
+	data, _ := json.Marshal(ss.GetAudioLevelObserver().ActiveSpeakers())
+	return C.CString(string(data))
+}
+
+// SourceSwitcherSetSilenceSuppression 开关静音抑制
+// 开启后 DTX / 静音帧每 400ms 只转发一个，输出序列号保持连续
+//
+//export SourceSwitcherSetSilenceSuppression
+func SourceSwitcherSetSilenceSuppression(roomID *C.char, enabled C.int) C.int {
+	goRoomID := C.GoString(roomID)
+
+	ss := resolveSourceSwitcher(goRoomID)
+	if ss == nil {
+		return C.int(-1)
+	}
+
+	ss.SetSilenceSuppression(enabled != 0)
+	return C.int(0)
+}
+
+// SourceSwitcherSetPacer 配置输出平滑发送
+// multiplier: 发送速率相对估计码率的倍数（<=0 使用默认值）
+//
+//export SourceSwitcherSetPacer
+func SourceSwitcherSetPacer(roomID *C.char, enabled C.int, multiplier C.double) C.int {
+	goRoomID := C.GoString(roomID)
+
+	ss := resolveSourceSwitcher(goRoomID)
+	if ss == nil {
+		return C.int(-1)
+	}
+
+	config := sfu.DefaultPacerConfig()
+	config.Enabled = enabled != 0
+	if multiplier > 0 {
+		config.Multiplier = float64(multiplier)
+	}
+	ss.SetPacerConfig(config)
+	return C.int(0)
+}
+
+// emitActiveSpeakers 发送活跃发言者事件（peerID 为主发言者）
+func emitActiveSpeakers(roomID string, speakers []sfu.ActiveSpeaker) {
+	dominant := ""
+	if len(speakers) > 0 {
+		dominant = speakers[0].ParticipantID
+	}
+	data, _ := json.Marshal(map[string]interface{}{
+		"speakers": speakers,
+	})
+	emitEvent(EventTypeActiveSpeaker, roomID, dominant, string(data))
+}
+
 // ==========================================
 // 增强选举 - 设备信息更新
 // ==========================================
@@ -578,6 +714,14 @@ func CoordinatorEnable(roomID *C.char, localPeerID *C.char) C.int {
 			eventType = EventTypePeerOnline
 		case sfu.CoordinatorEventPeerLeft:
 			eventType = EventTypePeerOffline
+		case sfu.CoordinatorEventActiveSpeaker:
+			eventType = EventTypeActiveSpeaker
+		case sfu.CoordinatorEventPingRound:
+			eventType = EventTypePingRound
+		case sfu.CoordinatorEventDeviceThrottle:
+			eventType = EventTypeDeviceThrottle
+		case sfu.CoordinatorEventHandoff:
+			eventType = EventTypeHandoff
 		default:
 			eventType = EventTypeProxyChange
 		}
@@ -586,6 +730,7 @@ func CoordinatorEnable(roomID *C.char, localPeerID *C.char) C.int {
 	})
 
 	coordinators.Store(goRoomID, pmc)
+	bumpSwitcherGeneration(goRoomID)
 	pmc.Start()
 
 	utils.Info("Coordinator enabled: room=%s, local=%s (auto-failover active)", goRoomID, goLocalPeerID)
@@ -601,6 +746,7 @@ func CoordinatorDisable(roomID *C.char) C.int {
 	if v, ok := coordinators.Load(goRoomID); ok {
 		v.(*sfu.ProxyModeCoordinator).Close()
 		coordinators.Delete(goRoomID)
+		bumpSwitcherGeneration(goRoomID)
 	}
 
 	utils.Info("Coordinator disabled: room=%s", goRoomID)
@@ -661,6 +807,34 @@ func CoordinatorHandlePong(roomID *C.char, peerID *C.char) C.int {
 	return C.int(0)
 }
 
+// CoordinatorHandlePongBatch 批量处理一轮 Pong
+// seq: EventTypePingRound 事件中的轮次（0 表示未知）
+// peerIDs: 以换行符分隔的 Peer ID 列表
+//
+//export CoordinatorHandlePongBatch
+func CoordinatorHandlePongBatch(roomID *C.char, seq C.uint64_t, peerIDs *C.char) C.int {
+	goRoomID := C.GoString(roomID)
+
+	v, ok := coordinators.Load(goRoomID)
+	if !ok {
+		return C.int(-1)
+	}
+
+	ids := strings.Split(C.GoString(peerIDs), "\n")
+	n := 0
+	for _, id := range ids {
+		if id != "" {
+			ids[n] = id
+			n++
+		}
+	}
+
+	pmc := v.(*sfu.ProxyModeCoordinator)
+	pmc.HandlePongBatch(uint64(seq), ids[:n])
+
+	return C.int(n)
+}
+
 // CoordinatorSetRelay 设置当前 Relay（收到外部通知时）
 //
 //export CoordinatorSetRelay
@@ -716,6 +890,100 @@ func CoordinatorUpdateLocalDevice(roomID *C.char, deviceType, connectionType, po
 	return C.int(0)
 }
 
+// CoordinatorUpdateLocalDeviceEx 更新本机设备信息（含温度和电量）
+// thermalState: 0=nominal, 1=fair, 2=serious, 3=critical
+// batteryPercent: 0-100，-1 表示未知
+// 过热或低电量时自动限制订阅者数、降低上游质量、放宽心跳间隔，严重时发出移交请求事件
+//
+//export CoordinatorUpdateLocalDeviceEx
+func CoordinatorUpdateLocalDeviceEx(roomID *C.char, deviceType, connectionType, powerState, thermalState, batteryPercent C.int) C.int {
+	goRoomID := C.GoString(roomID)
+
+	v, ok := coordinators.Load(goRoomID)
+	if !ok {
+		return C.int(-1)
+	}
+
+	thermal := sfu.ThermalState(thermalState)
+	if thermal < sfu.ThermalNominal || thermal > sfu.ThermalCritical {
+		return C.int(-1)
+	}
+
+	pmc := v.(*sfu.ProxyModeCoordinator)
+	pmc.UpdateLocalDeviceInfo(int(deviceType), int(connectionType), int(powerState))
+	pmc.UpdateLocalDeviceState(thermal, int(batteryPercent))
+
+	return C.int(0)
+}
+
+// CoordinatorStartHandoff 发起计划内 Relay 移交（本机需为 Relay）
+// 继任者通过 EventTypeHandoff 事件（phase=nominated）返回，旧 Relay 在订阅者迁移完成前继续转发
+// 返回: 0=成功, -1=协调器不存在, -2=无法移交（非 Relay、移交进行中或没有可用继任者）
+//
+//export CoordinatorStartHandoff
+func CoordinatorStartHandoff(roomID *C.char) C.int {
+	goRoomID := C.GoString(roomID)
+
+	v, ok := coordinators.Load(goRoomID)
+	if !ok {
+		return C.int(-1)
+	}
+
+	pmc := v.(*sfu.ProxyModeCoordinator)
+	if _, err := pmc.StartHandoff("manual"); err != nil {
+		return C.int(-2)
+	}
+
+	return C.int(0)
+}
+
+// CoordinatorHandleHandoff 处理旧 Relay 的移交通知（来自信令或控制通道）
+// 本机为继任者时准备接管，否则发出 phase=migrate 事件，外部应向继任者预协商并保留当前连接
+// 返回: 0=成功, -1=协调器不存在, -2=通知已过期或移交进行中
+//
+//export CoordinatorHandleHandoff
+func CoordinatorHandleHandoff(roomID *C.char, relayID *C.char, successorID *C.char, epoch C.uint64_t) C.int {
+	goRoomID := C.GoString(roomID)
+
+	v, ok := coordinators.Load(goRoomID)
+	if !ok {
+		return C.int(-1)
+	}
+
+	pmc := v.(*sfu.ProxyModeCoordinator)
+	if err := pmc.HandleHandoff(C.GoString(relayID), C.GoString(successorID), uint64(epoch)); err != nil {
+		return C.int(-2)
+	}
+
+	return C.int(0)
+}
+
+// CoordinatorSetLANMode 设置本机成为 Relay 时 RelayRoom 是否使用局域网模式（ICE-lite，只收集 host 候选）
+// 对之后创建的 RelayRoom 生效，已在服务的 RelayRoom 不受影响
+// enabled: 1=开启, 0=关闭; mdns: 1=收集 mDNS 候选
+// 返回: 0=成功, -1=协调器不存在
+//
+//export CoordinatorSetLANMode
+func CoordinatorSetLANMode(roomID *C.char, enabled C.int, mdns C.int) C.int {
+	goRoomID := C.GoString(roomID)
+
+	v, ok := coordinators.Load(goRoomID)
+	if !ok {
+		return C.int(-1)
+	}
+
+	pmc := v.(*sfu.ProxyModeCoordinator)
+	if enabled == 0 {
+		pmc.SetRelayRoomOptions()
+		return C.int(0)
+	}
+	lan := sfu.DefaultLANModeConfig()
+	lan.MulticastDNS = mdns != 0
+	pmc.SetRelayRoomOptions(sfu.WithLANMode(lan))
+
+	return C.int(0)
+}
+
 // CoordinatorInjectSFU 注入 SFU RTP 包
 //
 //export CoordinatorInjectSFU
@@ -727,8 +995,11 @@ func CoordinatorInjectSFU(roomID *C.char, isVideo C.int, data unsafe.Pointer, da
 		return C.int(-1)
 	}
 
+	if data == nil || dataLen <= 0 {
+		return C.int(-1)
+	}
 	pmc := v.(*sfu.ProxyModeCoordinator)
-	goData := C.GoBytes(data, dataLen)
+	goData := unsafe.Slice((*byte)(data), int(dataLen))
 	if err := pmc.InjectSFUPacket(isVideo != 0, goData); err != nil {
 		return C.int(-1)
 	}
@@ -746,8 +1017,11 @@ func CoordinatorInjectLocal(roomID *C.char, isVideo C.int, data unsafe.Pointer,
 		return C.int(-1)
 	}
 
+	if data == nil || dataLen <= 0 {
+		return C.int(-1)
+	}
 	pmc := v.(*sfu.ProxyModeCoordinator)
-	goData := C.GoBytes(data, dataLen)
+	goData := unsafe.Slice((*byte)(data), int(dataLen))
 	if err := pmc.InjectLocalPacket(isVideo != 0, goData); err != nil {
 		return C.int(-1)
 	}
@@ -85,8 +85,24 @@ func RelayRoomCreate(roomID *C.char, iceServersJSON *C.char) C.int {
 		}
 	}
 
+	return createRelayRoom(goRoomID, iceServers)
+}
+
+// RelayRoomCreateLAN 以局域网模式创建代理房间
+// Relay 作为 ICE-lite 端，只收集 host 候选，不使用 STUN/TURN，ICE 超时按局域网调短
+// mdns: 1=收集 mDNS 候选（隐藏本机 IP）, 0=直接使用 IP
+//
+//export RelayRoomCreateLAN
+func RelayRoomCreateLAN(roomID *C.char, mdns C.int) C.int {
+	lan := sfu.DefaultLANModeConfig()
+	lan.MulticastDNS = mdns != 0
+	return createRelayRoom(C.GoString(roomID), nil, sfu.WithLANMode(lan))
+}
+
+// createRelayRoom 创建代理房间并注册回调
+func createRelayRoom(goRoomID string, iceServers []webrtc.ICEServer, extra ...sfu.RelayRoomOption) C.int {
 	// 准备选项 - 如果存在 Coordinator，使用其 SourceSwitcher
-	var opts []sfu.RelayRoomOption
+	opts := append([]sfu.RelayRoomOption{}, extra...)
 	if coord := getCoordinator(goRoomID); coord != nil {
 		if ss := coord.GetSourceSwitcher(); ss != nil {
 			opts = append(opts, sfu.WithSourceSwitcher(ss))
@@ -108,6 +124,12 @@ func RelayRoomCreate(roomID *C.char, iceServersJSON *C.char) C.int {
 		},
 		// onSubscriberLeft
 		func(rID, peerID string) {
+			if bridge := sfu.GetBridge(rID); bridge != nil {
+				bridge.RemoveSubscriberViewport(peerID)
+			}
+			if coord := getCoordinator(rID); coord != nil {
+				coord.HandleSubscriberLeft(peerID)
+			}
 			emitEvent(EventTypeSubscriberLeft, rID, peerID, "")
 		},
 		// onICECandidate
@@ -151,6 +173,10 @@ func RelayRoomCreate(roomID *C.char, iceServersJSON *C.char) C.int {
 	})
 
 	registerRelayRoom(goRoomID, room)
+	// 订阅者连接在这个房间上：由 Coordinator 处理控制通道和计划内移交
+	if coord := getCoordinator(goRoomID); coord != nil {
+		coord.AttachRelayRoom(room)
+	}
 	// 注册 SourceSwitcher，让 LiveKitBridge 能够获取到同一个实例
 	registerSourceSwitcher(goRoomID, room.GetSourceSwitcher())
 	utils.Info("RelayRoom created: %s", goRoomID)
@@ -162,6 +188,11 @@ func RelayRoomCreate(roomID *C.char, iceServersJSON *C.char) C.int {
 //export RelayRoomDestroy
 func RelayRoomDestroy(roomID *C.char) C.int {
 	goRoomID := C.GoString(roomID)
+	if room := getRelayRoom(goRoomID); room != nil {
+		if coord := getCoordinator(goRoomID); coord != nil {
+			coord.DetachRelayRoom(room)
+		}
+	}
 	unregisterRelayRoom(goRoomID)
 	utils.Info("RelayRoom destroyed: %s", goRoomID)
 	return C.int(0)
@@ -409,6 +440,43 @@ func RelayRoomGetStatus(roomID *C.char) *C.char {
 	return C.CString(status.ToJSON())
 }
 
+// RelayRoomSetFECEnabled 开关前向纠错（FlexFEC / RED）
+// 开启后仍按订阅者 RTCP 丢包率自适应，无丢包时不产生冗余
+//
+//export RelayRoomSetFECEnabled
+func RelayRoomSetFECEnabled(roomID *C.char, enabled C.int) C.int {
+	goRoomID := C.GoString(roomID)
+
+	room := getRelayRoom(goRoomID)
+	if room == nil {
+		return C.int(-1)
+	}
+
+	fec := room.GetFEC()
+	if fec == nil {
+		return C.int(-1)
+	}
+
+	fec.SetEnabled(enabled != 0)
+	return C.int(0)
+}
+
+// RelayRoomGetBandwidthStats 获取公网 / 局域网流量核算
+// 包含累计值、节省比例和最近 60 分钟的分钟汇总
+//
+//export RelayRoomGetBandwidthStats
+func RelayRoomGetBandwidthStats(roomID *C.char) *C.char {
+	goRoomID := C.GoString(roomID)
+
+	room := getRelayRoom(goRoomID)
+	if room == nil {
+		return nil
+	}
+
+	data, _ := json.Marshal(room.GetBandwidthStats())
+	return C.CString(string(data))
+}
+
 // ==========================================
 // SourceSwitcher 集成（便捷方法）
 // ==========================================
@@ -512,6 +580,49 @@ func RelayRoomStopLocalShare(roomID *C.char) C.int {
 	return C.int(0)
 }
 
+// RelayRoomSetSubscriberVideoMode 设置订阅者视频模式（无需重协商）
+// mode: 0=全尺寸, 1=缩略图, 2=暂停（应用切后台 / 视频不可见）
+// 缩略图作为订阅者的质量上限（LOW）、暂停作为退出需求，同时交给 LiveKitBridge 参与上游质量选择
+//
+//export RelayRoomSetSubscriberVideoMode
+func RelayRoomSetSubscriberVideoMode(roomID *C.char, peerID *C.char, mode C.int) C.int {
+	goRoomID := C.GoString(roomID)
+	goPeerID := C.GoString(peerID)
+
+	room := getRelayRoom(goRoomID)
+	if room == nil {
+		return C.int(-1)
+	}
+
+	videoMode := sfu.SubscriberVideoMode(mode)
+	if videoMode < sfu.SubscriberVideoFull || videoMode > sfu.SubscriberVideoPaused {
+		return C.int(-1)
+	}
+
+	if err := room.SetSubscriberVideoMode(goPeerID, videoMode); err != nil {
+		utils.Error("Failed to set video mode for %s: %v", goPeerID, err)
+		return C.int(-1)
+	}
+
+	if bridge := sfu.GetBridge(goRoomID); bridge != nil {
+		switch videoMode {
+		case sfu.SubscriberVideoPaused:
+			// 不再接收视频，需求为 0；所有订阅者都暂停时上游降到 LOW
+			bridge.SetSubscriberPaused(goPeerID, true)
+		case sfu.SubscriberVideoThumbnail:
+			bridge.SetSubscriberPaused(goPeerID, false)
+			bridge.SetSubscriberMaxQuality(goPeerID, sfu.UpstreamQualityLow)
+		default:
+			// 保留最后一次视口上报和带宽估计
+			bridge.SetSubscriberPaused(goPeerID, false)
+			bridge.ClearSubscriberMaxQuality(goPeerID)
+		}
+	}
+
+	utils.Info("Subscriber %s video mode: %s", goPeerID, videoMode)
+	return C.int(0)
+}
+
 // unsafePointer 辅助函数
 func unsafePointer(p *C.char) (ptr interface{}) {
 	return p
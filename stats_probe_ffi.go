@@ -4,7 +4,7 @@
  * @Date: 2025-12-24
  *
  * P2/P3 Features FFI Exports
- * 缓冲池、流量统计、网络探测、抖动缓冲的 C 导出函数
+ * 缓冲池、内存预算、流量统计、网络探测、抖动缓冲的 C 导出函数
  */
 package main
 
@@ -50,6 +50,32 @@ func BufferPoolResetStats() {
 	sfu.ResetGlobalBufferPoolStats()
 }
 
+// ==========================================
+// Memory Governor - 全局内存预算
+// ==========================================
+
+// MemoryGovernorSetBudget 设置全局内存预算（字节），0 表示只统计不限制
+// 超过预算的 70% / 85% / 95% 时依次缩小缓冲、丢弃非参考帧、拒绝新订阅者
+//
+//export MemoryGovernorSetBudget
+func MemoryGovernorSetBudget(budgetBytes C.int64_t) C.int {
+	if budgetBytes < 0 {
+		return C.int(-1)
+	}
+	sfu.GetMemoryGovernor().SetBudget(int64(budgetBytes))
+	utils.Info("Memory budget set to %d bytes", int64(budgetBytes))
+	return C.int(0)
+}
+
+// MemoryGovernorGetStats 获取内存预算统计
+//
+//export MemoryGovernorGetStats
+func MemoryGovernorGetStats() *C.char {
+	stats := sfu.GetMemoryGovernor().GetStats()
+	data, _ := json.Marshal(stats)
+	return C.CString(string(data))
+}
+
 // ==========================================
 // Stats - 流量统计
 // ==========================================
@@ -348,6 +374,7 @@ func JitterBufferCreate(key *C.char, enabled C.int, targetDelayMs C.int) C.int {
 	if targetDelayMs > 0 {
 		config.TargetDelay = time.Duration(targetDelayMs) * time.Millisecond
 	}
+	config.Memory = sfu.GetMemoryGovernor()
 
 	jb := sfu.NewJitterBuffer(config)
 	if config.Enabled {
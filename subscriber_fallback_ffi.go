@@ -0,0 +1,193 @@
+/*
+ * @Author: Marlon.M
+ * @Email: maiguangyang@163.com
+ * @Date: 2026-10-17
+ *
+ * Subscriber Fallback FFI Exports
+ * 订阅者双路接收：Relay 路径之外保留一路直连 SFU 的备用订阅
+ *
+ * 备用路径由独立的 LiveKitBridge + SourceSwitcher 拉流，经本机回环 RelayRoom（<roomID>/fallback）
+ * 交给 Dart 渲染；该 RelayRoom 注册在 RelayRoom 实例表中，直接使用 RelayRoom* 函数建立回环连接。
+ */
+package main
+
+/*
+#include <stdlib.h>
+#include <stdint.h>
+*/
+import "C"
+
+import (
+	"encoding/json"
+	"sync"
+
+	"github.com/maiguangyang/relay_core/pkg/sfu"
+	"github.com/maiguangyang/relay_core/pkg/utils"
+)
+
+// 事件类型扩展
+const (
+	EventTypeFallbackPath = 33 // 订阅者渲染路径切换，data: {"path":"relay|direct","reason"}
+)
+
+// subscriberFallback 双路接收实例
+type subscriberFallback struct {
+	controller *sfu.SubscriberFallback
+	bridge     *sfu.LiveKitBridge
+	switcher   *sfu.SourceSwitcher
+	loopbackID string
+}
+
+var subscriberFallbacks sync.Map // roomID -> *subscriberFallback
+
+// fallbackRoomID 回环 RelayRoom 的 ID
+func fallbackRoomID(roomID string) string {
+	return roomID + "/fallback"
+}
+
+func getSubscriberFallback(roomID string) *subscriberFallback {
+	if v, ok := subscriberFallbacks.Load(roomID); ok {
+		return v.(*subscriberFallback)
+	}
+	return nil
+}
+
+// SubscriberFallbackCreate 创建双路接收（订阅者调用）
+// 同时创建回环 RelayRoom <roomID>/fallback，Dart 以 localPeerID 之外的任意 ID 作为订阅者接入
+// 返回: 0=成功, -1=失败
+//
+//export SubscriberFallbackCreate
+func SubscriberFallbackCreate(roomID *C.char, localPeerID *C.char) C.int {
+	goRoomID := C.GoString(roomID)
+	loopbackID := fallbackRoomID(goRoomID)
+
+	destroySubscriberFallback(goRoomID)
+
+	switcher, err := sfu.NewSourceSwitcher(loopbackID)
+	if err != nil {
+		utils.Error("[FallbackFFI] Failed to create SourceSwitcher for %s: %v", goRoomID, err)
+		return C.int(-1)
+	}
+	// 回环连接不需要 STUN
+	room, err := sfu.NewRelayRoom(loopbackID, nil, sfu.WithSourceSwitcher(switcher))
+	if err != nil {
+		switcher.Close()
+		utils.Error("[FallbackFFI] Failed to create loopback RelayRoom for %s: %v", goRoomID, err)
+		return C.int(-1)
+	}
+	room.BecomeRelay(C.GoString(localPeerID))
+
+	// 不注册到全局桥接器表：本机成为 Relay 时 CreateBridge 不会影响备用路径
+	bridge := sfu.NewLiveKitBridge(loopbackID, switcher)
+	room.SetKeyframeRequestCallback(func(string) {
+		bridge.RequestKeyframe()
+	})
+
+	controller := sfu.NewSubscriberFallback(sfu.DefaultSubscriberFallbackConfig(), bridge)
+	controller.SetOnSwitch(func(path sfu.FallbackPath, reason string) {
+		if path == sfu.FallbackPathDirect {
+			// 直连路径开始渲染：立即要一个高质量层的关键帧
+			go bridge.RequestKeyframe()
+		}
+		data, _ := json.Marshal(map[string]string{
+			"path":   path.String(),
+			"reason": reason,
+		})
+		emitEvent(EventTypeFallbackPath, goRoomID, "", string(data))
+	})
+
+	registerRelayRoom(loopbackID, room)
+	subscriberFallbacks.Store(goRoomID, &subscriberFallback{
+		controller: controller,
+		bridge:     bridge,
+		switcher:   switcher,
+		loopbackID: loopbackID,
+	})
+	return C.int(0)
+}
+
+// SubscriberFallbackConnect 备用路径连接 LiveKit（异步，使用只订阅的 Token）
+// 返回: 0=成功启动, -1=未创建
+//
+//export SubscriberFallbackConnect
+func SubscriberFallbackConnect(roomID, url, token *C.char) C.int {
+	fb := getSubscriberFallback(C.GoString(roomID))
+	if fb == nil {
+		return C.int(-1)
+	}
+
+	u := C.GoString(url)
+	t := C.GoString(token)
+	go func() {
+		if err := fb.bridge.Connect(u, t); err != nil {
+			utils.Error("[FallbackFFI] Connect failed: %v", err)
+		}
+	}()
+	return C.int(0)
+}
+
+// SubscriberFallbackReportRelay 上报 Relay 路径累计收到的包数（inbound-rtp packetsReceived）
+// 建议每帧间隔（约 33ms）上报一次；停止增长超过 StallTimeout 即切到直连
+// 返回: 0=成功, -1=未创建
+//
+//export SubscriberFallbackReportRelay
+func SubscriberFallbackReportRelay(roomID *C.char, packetsReceived C.uint64_t) C.int {
+	fb := getSubscriberFallback(C.GoString(roomID))
+	if fb == nil {
+		return C.int(-1)
+	}
+	fb.controller.ReportRelayPackets(uint64(packetsReceived))
+	return C.int(0)
+}
+
+// SubscriberFallbackRelayLost Relay 连接断开（控制通道关闭、P2P 失败、收到移交通知），立即切到直连
+// 返回: 0=成功, -1=未创建
+//
+//export SubscriberFallbackRelayLost
+func SubscriberFallbackRelayLost(roomID *C.char, reason *C.char) C.int {
+	fb := getSubscriberFallback(C.GoString(roomID))
+	if fb == nil {
+		return C.int(-1)
+	}
+	fb.controller.RelayLost(C.GoString(reason))
+	return C.int(0)
+}
+
+// SubscriberFallbackGetStatus 获取双路接收状态
+// 返回: JSON {"path","last_reason","switches","relay_packets","direct_ms","stall_timeout_ms","bridge":{...}}
+// 需要调用 FreeString 释放
+//
+//export SubscriberFallbackGetStatus
+func SubscriberFallbackGetStatus(roomID *C.char) *C.char {
+	fb := getSubscriberFallback(C.GoString(roomID))
+	if fb == nil {
+		return C.CString("{}")
+	}
+
+	data, _ := json.Marshal(struct {
+		sfu.SubscriberFallbackStatus
+		Bridge sfu.LiveKitBridgeStatus `json:"bridge"`
+	}{fb.controller.GetStatus(), fb.bridge.GetStatus()})
+	return C.CString(string(data))
+}
+
+// SubscriberFallbackDestroy 销毁双路接收（断开备用连接并关闭回环 RelayRoom）
+// 返回: 0=成功
+//
+//export SubscriberFallbackDestroy
+func SubscriberFallbackDestroy(roomID *C.char) C.int {
+	destroySubscriberFallback(C.GoString(roomID))
+	return C.int(0)
+}
+
+func destroySubscriberFallback(roomID string) {
+	v, ok := subscriberFallbacks.LoadAndDelete(roomID)
+	if !ok {
+		return
+	}
+	fb := v.(*subscriberFallback)
+	fb.controller.Close()
+	fb.bridge.Close()
+	unregisterRelayRoom(fb.loopbackID)
+	fb.switcher.Close()
+}